@@ -0,0 +1,317 @@
+#######################################################################################################
+# Programmer Name: 	Alexander Densmore
+# Program Name: 	ftclient
+# Program Description:	Implementation of the client side of a client-server file transfer protocol. 
+#			Client receives SERVER_HOST, SERVER_PORT, COMMAND, FILENAME (if applicable),
+#			and DATA_PORT from the command line. Once command-line arguments are validated,
+#			attempts to establish a control connection at SERVER_HOST:SERVER_PORT. Then,
+#			client awaits response at DATA_PORT, printing the response it receives, 
+#			or client receives an error message at SERVER_PORT if the server could not 
+#			fulfill the requested command, printing the error message.
+# *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+#			and -g (get file with filename), I have implemented an option -ltxt (list all files
+#			in current directory with .txt extension). Upon receiving -ltxt command,
+#			server filters current directory listing for only files with .txt extension,
+#			either sending list of such files to client or reporting that there
+#			are no files with .txt extension in the current directory.
+# File Name:		FTBatch.py
+# File Description: 	File containing class definition of FTBatch, which fetches a batch of files from
+#			a server (named in a list file, or every file of a listing) over a number of
+#			concurrent sessions, each run by an FTInfo object on a thread of its own.
+# Course Name: 		CS 372-400: Introduction to Computer Networks
+# Last Modified:	10/18/2026
+######################################################################################################
+
+import concurrent.futures
+import json
+import os
+import queue
+import sys
+import threading
+import time
+import FTInfo
+
+# Global variables to be treated as constants within FTBatch class.
+
+# Flag selecting batch mode as the first command-line argument of ftclient.py, and the number of arguments
+# allowed in batch mode (inclusive of program name and flag).
+BATCH_FLAG = "-b"
+MIN_BATCH_ARGS = 7
+MAX_BATCH_ARGS = 8
+
+# Usage message.
+BATCH_USAGE_MESSAGE = "USAGE: python3 ftclient.py -b SERVER_HOST SERVER_PORT SOURCE DESTINATION DATA_PORT [SESSIONS]"
+BATCH_USAGE_MESSAGE += "\n       (SOURCE is -l or -ltxt to mirror the files the server lists, or a file naming one file per line)"
+BATCH_USAGE_MESSAGE += "\n       (SESSIONS sessions run at once, using data ports DATA_PORT to DATA_PORT + SESSIONS - 1)"
+
+# Default and maximum number of concurrent sessions.
+DEFAULT_SESSIONS = 4
+MAX_SESSIONS = 64
+
+# Name of the file in DESTINATION recording the size and modification time of every file fetched into it,
+# and the suffix of the hidden file into which a file is received before it replaces the old copy.
+MANIFEST_NAME = ".ftmirror"
+PART_SUFFIX = ".ftpart"
+
+
+#######################################################################################################
+# Class Name:		FTBatch
+# Class Description:	Class that instantiates object fetching a batch of files from ftserver into a
+#			directory. Files are fetched by a pool of threads, each running one session
+#			(FTInfo object) at a time with a data port taken from a shared pool. A file whose
+#			copy in the directory is unchanged since it was last fetched (per the manifest)
+#			is skipped.
+# Data Members:		serverNickname (server name passed in on command line)
+#			serverPort (port number at which to contact server, as string)
+#			source (-l or -ltxt to fetch every file listed by the server, or the name of a list file)
+#			destination (directory into which files are fetched)
+#			sessions (number of sessions run at once)
+#			dataPorts (queue of data ports not in use by a session)
+#			manifest (dictionary mapping each file fetched to [size, modification time in ns])
+#			lock (lock protecting manifest and the counts below)
+#			filesFetched, bytesFetched, filesSkipped, filesFailed (counts of outcomes so far)
+# Member Functions:	(see below for definitions and descriptions)
+#######################################################################################################
+
+class FTBatch:
+	
+	#######################################################################################################
+	# Function Name:	__init__
+	# Description:		Constructs new FTBatch object from the command-line arguments, printing
+	#			usage and errors and exiting with code 1 if any is invalid. Creates the
+	#			destination directory if needed, and loads its manifest.
+	# Receives: 		Self-reference and argv, the list of command-line arguments of ftclient.py.
+	# Returns: 		An instantiated FTBatch object.
+	# Pre-Conditions:	argv[1] is BATCH_FLAG.
+	# Post-Conditions: 	All data members have been initialized.
+	######################################################################################################
+	
+	def __init__(self, argv):
+		# List of error messages to be printed in case of errors before exiting.
+		initErrList = []
+		if len(argv) < MIN_BATCH_ARGS or len(argv) > MAX_BATCH_ARGS:
+			print(BATCH_USAGE_MESSAGE, file=sys.stderr)
+			sys.exit(1)
+		
+		# Initialize server and source of file names (each session validates the server's address and port).
+		self.serverNickname = argv[2]
+		self.serverPort = argv[3]
+		self.source = argv[4]
+		if self.source != FTInfo.LIST_FILES and self.source != FTInfo.LIST_TXT_FILES and not os.path.isfile(self.source):
+			initErrList.append("SOURCE invalid (not -l, -ltxt, or a file). You entered: " + self.source)
+		
+		# Initialize number of sessions and pool of data ports, adding error message if invalid.
+		self.sessions = DEFAULT_SESSIONS
+		if len(argv) == MAX_BATCH_ARGS:
+			self.sessions = int(argv[7]) if argv[7].isdigit() else 0
+			if self.sessions < 1 or self.sessions > MAX_SESSIONS:
+				initErrList.append("SESSIONS must be between 1 and " + str(MAX_SESSIONS) + ". You entered: " + argv[7])
+		self.dataPorts = queue.Queue()
+		if not argv[6].isdigit() or int(argv[6]) + self.sessions > 65536:
+			initErrList.append("DATA_PORT invalid. You entered: " + argv[6])
+		else:
+			for dataPort in range(int(argv[6]), int(argv[6]) + self.sessions):
+				self.dataPorts.put(dataPort)
+		
+		# Create destination directory, adding error message on failure.
+		self.destination = argv[5]
+		try:
+			os.makedirs(self.destination, exist_ok=True)
+		except OSError as dirErr:
+			initErrList.append("DESTINATION ERROR: " + str(dirErr))
+		
+		# Print any errors and exit.
+		if len(initErrList) > 0:
+			print(BATCH_USAGE_MESSAGE, file=sys.stderr)
+			print("The command-line arguments entered contained the following error(s):", file=sys.stderr)
+			for err in initErrList:
+				print("\t", err, file=sys.stderr)
+			sys.exit(1)
+		
+		# Load manifest, starting an empty one if there is none (or it cannot be read).
+		self.manifest = {}
+		try:
+			with open(os.path.join(self.destination, MANIFEST_NAME)) as manifestFile:
+				self.manifest = json.load(manifestFile)
+		except (OSError, ValueError):
+			pass
+		
+		# Initialize lock and counts.
+		self.lock = threading.Lock()
+		self.filesFetched = 0
+		self.bytesFetched = 0
+		self.filesSkipped = 0
+		self.filesFailed = 0
+	
+	#######################################################################################################
+	# Function Name:	_runSession
+	# Description:		Internal function which runs one session with the server (as ftclient.py
+	#			does) with a data port taken from the pool, returning the port to the pool
+	#			when the session ends.
+	# Receives: 		A self-reference, the command, the file name (or None), and the path to which
+	#			to write a file received (or None).
+	# Returns: 		The FTInfo object of the session if it succeeded; None if it failed (in which
+	#			case FTInfo has printed the error).
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	The session's sockets are closed, and its data port is back in the pool.
+	######################################################################################################
+	
+	def _runSession(self, command, filename, outputPath):
+		# Build command-line arguments for session.
+		dataPort = self.dataPorts.get()
+		argv = ["ftclient.py", self.serverNickname, self.serverPort, command]
+		if filename != None:
+			argv.append(filename)
+		argv.append(str(dataPort))
+		
+		# Run session. FTInfo exits (raising SystemExit, which ends only this session) on any error.
+		myFT = None
+		try:
+			myFT = FTInfo.FTInfo(argv, quiet=True, outputPath=outputPath)
+			myFT.initiateContact()
+			myFT.makeRequest()
+			myFT.receiveData()
+			return myFT
+		except SystemExit:
+			return None
+		except OSError as sessionErr:
+			print("ERROR FETCHING", filename, ":", sessionErr, file=sys.stderr)
+			return None
+		finally:
+			if myFT != None and myFT.dataSocket != None:
+				myFT.dataSocket.close()
+			self.dataPorts.put(dataPort)
+	
+	#######################################################################################################
+	# Function Name:	_getFilenames
+	# Description:		Internal function which gets the names of the files to fetch: every line of
+	#			the list file, or every file named in the server's listing. Names that are
+	#			not plain file names (empty, ".", "..", or containing "/") are left out.
+	# Receives: 		A self-reference.
+	# Returns: 		The list of file names.
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	If the listing cannot be received, the error has been printed and the process
+	#			has exited with code 2.
+	######################################################################################################
+	
+	def _getFilenames(self):
+		# Read names from list file, or from the server's listing.
+		if self.source == FTInfo.LIST_FILES or self.source == FTInfo.LIST_TXT_FILES:
+			myFT = self._runSession(self.source, None, None)
+			if myFT == None:
+				sys.exit(2)
+			names = "".join(myFT.listing).splitlines()
+		else:
+			with open(self.source) as listFile:
+				names = listFile.read().splitlines()
+		
+		# Leave out names that are not plain file names, and duplicates.
+		return [name for name in dict.fromkeys(names) if name not in ("", ".", "..") and "/" not in name]
+	
+	#######################################################################################################
+	# Function Name:	_isUnchanged
+	# Description:		Internal function which determines whether the copy of a file in the
+	#			destination is unchanged since it was last fetched, i.e. it exists and its size
+	#			and modification time match those recorded in the manifest.
+	# Receives: 		A self-reference and the file name.
+	# Returns: 		True if the file need not be fetched again; False otherwise.
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	None.
+	######################################################################################################
+	
+	def _isUnchanged(self, filename):
+		try:
+			fileInfo = os.stat(os.path.join(self.destination, filename))
+		except OSError:
+			return False
+		with self.lock:
+			return self.manifest.get(filename) == [fileInfo.st_size, fileInfo.st_mtime_ns]
+	
+	#######################################################################################################
+	# Function Name:	_report
+	# Description:		Internal function which prints a line of progress in one write, so that lines
+	#			printed by different threads are not interleaved.
+	# Receives: 		A self-reference and the line to print.
+	# Returns: 		nothing
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	The line has been written to stdout.
+	######################################################################################################
+	
+	def _report(self, line):
+		sys.stdout.write(line + "\n")
+		sys.stdout.flush()
+	
+	#######################################################################################################
+	# Function Name:	_fetchFile
+	# Description:		Internal function run by the thread pool for each file: skips the file if it is
+	#			unchanged, and otherwise receives it into a hidden file in the destination,
+	#			which replaces the old copy (and is recorded in the manifest) once the whole
+	#			file has been received.
+	# Receives: 		A self-reference and the file name.
+	# Returns: 		nothing
+	# Pre-Conditions:	filename is a plain file name.
+	# Post-Conditions: 	The outcome has been printed and counted.
+	######################################################################################################
+	
+	def _fetchFile(self, filename):
+		# Skip file if it is unchanged.
+		if self._isUnchanged(filename):
+			with self.lock:
+				self.filesSkipped += 1
+			self._report("Skipped \"" + filename + "\" (unchanged)")
+			return
+		
+		# Receive file into hidden file, removing it if the session fails.
+		partPath = os.path.join(self.destination, "." + filename + PART_SUFFIX)
+		if self._runSession(FTInfo.GET_FILE, filename, partPath) == None:
+			with self.lock:
+				self.filesFailed += 1
+			try:
+				os.remove(partPath)
+			except OSError:
+				pass
+			return
+		
+		# Replace old copy with file received, and record it in manifest.
+		filePath = os.path.join(self.destination, filename)
+		os.replace(partPath, filePath)
+		fileInfo = os.stat(filePath)
+		with self.lock:
+			self.manifest[filename] = [fileInfo.st_size, fileInfo.st_mtime_ns]
+			self.filesFetched += 1
+			self.bytesFetched += fileInfo.st_size
+		self._report("Fetched \"" + filename + "\" (" + str(fileInfo.st_size) + " bytes)")
+	
+	#######################################################################################################
+	# Function Name:	run
+	# Description:		Fetches every file of the batch over the configured number of concurrent
+	#			sessions, saves the manifest, and prints the aggregate outcome and throughput.
+	# Receives: 		A self-reference.
+	# Returns: 		0 if every file was fetched or skipped; 2 if any failed.
+	# Pre-Conditions:	The object has been initialized.
+	# Post-Conditions: 	The destination holds every file fetched, and its manifest is up to date.
+	######################################################################################################
+	
+	def run(self):
+		# Fetch files on a pool of threads, one session per thread at a time.
+		startTime = time.monotonic()
+		filenames = self._getFilenames()
+		with concurrent.futures.ThreadPoolExecutor(max_workers=self.sessions) as executor:
+			list(executor.map(self._fetchFile, filenames))
+		elapsedSeconds = time.monotonic() - startTime
+		
+		# Save manifest through a temporary file, so that an interrupted save never loses it.
+		manifestPath = os.path.join(self.destination, MANIFEST_NAME)
+		try:
+			with open(manifestPath + PART_SUFFIX, "w") as manifestFile:
+				json.dump(self.manifest, manifestFile)
+			os.replace(manifestPath + PART_SUFFIX, manifestPath)
+		except OSError as manifestErr:
+			print("MANIFEST ERROR:", manifestErr, file=sys.stderr)
+		
+		# Print outcome and throughput.
+		throughput = self.bytesFetched / elapsedSeconds / 1000000 if elapsedSeconds > 0 else 0
+		print("Batch complete: " + str(self.filesFetched) + " fetched (" + str(self.bytesFetched) + " bytes), "
+			+ str(self.filesSkipped) + " skipped, " + str(self.filesFailed) + " failed in "
+			+ "%.2f s (%.2f MB/s over %d sessions)" % (elapsedSeconds, throughput, self.sessions))
+		return 2 if self.filesFailed > 0 else 0
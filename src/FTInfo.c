@@ -28,10 +28,14 @@
  * File Description: 	Implementation of functions utilizing struct FTInfo. See FTInfo.h for struct
  * 			definition and description.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #include "FTInfo.h"
+#include "tlsTransport.h"
+
+/* Static variable holding ID of last session created. */
+static unsigned long long lastSessionId = 0;
 
 
 /***********************************************************************************************
@@ -62,15 +66,33 @@ struct FTInfo* newFTInfo(int controlSocketFD, char* clientHost)
 	 * (will be name of flip server or IPv4 address if this is not a flip server). */
 	myFT->clientNickname = getNickname(clientHost);
 
-	/* Set dataPort, command, and filename to NULL,
+	/* Set dataPort, request, command, filename, and handler to NULL,
 	 * indicating that these have not yet been loaded with data from accepted client connection. */
 	myFT->dataPort = NULL;
+	myFT->request = NULL;
 	myFT->command = NULL;
 	myFT->filename = NULL;
+	myFT->handler = NULL;
 	
 	/* Set dataSocketFD to invalid value of -5 to indicate that it has not been connected to client yet. */
 	myFT->dataSocketFD = -5;
 
+	/* Set shaper to NULL since no transfer to client is in progress yet, requestSize to -1 since
+	 * no request has been received, and next to NULL since this connection is not queued yet. */
+	myFT->shaper = NULL;
+	myFT->requestSize = -1;
+	myFT->bytesSent = 0;
+	myFT->next = NULL;
+	myFT->local = 0;
+	myFT->sharedFile = NULL;
+
+	/* Start timing first phase of session now that connection has been accepted. */
+	myFT->acceptedAt = monotonicNs();
+	myFT->phaseMark = myFT->acceptedAt;
+	myFT->phasesMarked = 0;
+	myFT->messageDeadline = ULLONG_MAX;
+	myFT->sessionId = __atomic_add_fetch(&lastSessionId, 1, __ATOMIC_RELAXED);
+
 	/* Return pointer to newly-allocated struct to calling function. */
 	return myFT;
 }
@@ -134,21 +156,68 @@ char* getNickname(char* clientHost)
 }
 
 
+/***********************************************************************************************
+ * Function Name:	markPhase
+ * Description:		Ends a phase of the session, storing the time since the previous phase
+ * 			ended (or the connection was accepted) as the time spent in phase. The
+ * 			times are added to the latency histograms when the session finishes.
+ * Receives: 		A struct FTInfo pointer and the phase that has just ended.
+ * Returns: 		nothing
+ * Pre-Conditions: 	phase is less than NUM_PHASES.
+ * Post-Conditions: 	The next phase of the session begins now.
+**********************************************************************************************/
+
+void markPhase(struct FTInfo* myFT, int phase)
+{
+	unsigned long long now = monotonicNs();
+	myFT->phaseNs[phase] = now - myFT->phaseMark;
+	myFT->phasesMarked |= 1u << phase;
+	myFT->phaseMark = now;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	remainingMessageMs
+ * Description:		Returns the time left until the message awaited from the client must
+ * 			arrive, so that receiving it does not start the timeout over after the
+ * 			intake poller has already waited for it to start.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		The milliseconds left (at least 1, so that a message already arriving is
+ * 			still received once the deadline has passed), or 0 if there is no limit.
+ * Pre-Conditions: 	myFT->messageDeadline has been set by the scheduler (or left unlimited).
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+int remainingMessageMs(struct FTInfo* myFT)
+{
+	if (myFT->messageDeadline == ULLONG_MAX)
+	{
+		return 0;
+	}
+	unsigned long long now = monotonicNs();
+	unsigned long long remainingMs = (myFT->messageDeadline > now) ? (myFT->messageDeadline - now + 999999) / 1000000 : 1;
+	return (remainingMs > INT_MAX) ? INT_MAX : (int)remainingMs;
+}
+
+
 /***********************************************************************************************
  * Function Name:	deleteFTInfo
  * Description:		Deallocates memory previously allocated for the passed in struct
- * 			FTInfo pointer and closes its data socket (if ever created).
+ * 			FTInfo pointer and closes its control socket and its data socket
+ * 			(if ever created).
  * Receives: 		A struct FTInfo pointer.
  * Returns: 		nothing
  * Pre-Conditions: 	The passed in pointer represents a previously-allocated struct
  * 			FTInfo pointer.
  * Post-Conditions: 	All memory dynamically allocated to the passed-in struct pointer and
- * 			its data members has been freed, and its data socket has been closed
- * 			(if ever created).
+ * 			its data members has been freed, and its control socket and data socket
+ * 			(if ever created) have been closed.
 **********************************************************************************************/
 
 void deleteFTInfo(struct FTInfo* myFT)
 {
+	FT_PROBE(session_end, myFT->sessionId, myFT->bytesSent, FT_PROBE_NAME(myFT));
+
 	/* Free clientHost and clientNickname. */
 	free(myFT->clientHost);
 	myFT->clientHost = NULL;
@@ -163,24 +232,28 @@ void deleteFTInfo(struct FTInfo* myFT)
 		myFT->dataPort = NULL;
 	}
 
-	/* Free command if it is non-null (only would be null if error receiving command from client). */
-	if (myFT->command != NULL)
+	/* Free request if it is non-null (only would be null if error receiving request from client).
+	 * command and filename point into request, so they are not freed separately. */
+	if (myFT->request != NULL)
 	{
-		free(myFT->command);
+		free(myFT->request);
+		myFT->request = NULL;
 		myFT->command = NULL;
-	}
-
-	/* Free filename if it is non-null (may be null either if error receiving command
-	 * or client requests a command that does not involve a specific filename). */
-	if (myFT->filename != NULL)
-	{
-		free(myFT->filename);
 		myFT->filename = NULL;
 	}
 	
+	/* Close control socket unless it has been handed off elsewhere. (The client closes its end first
+	 * once it has received everything, but this process must still release its own descriptor.) */
+	if (myFT->controlSocketFD >= 0)
+	{
+		endTls(myFT->controlSocketFD);
+		close(myFT->controlSocketFD);
+	}
+
 	/* If a dataSocket has been connected to the client, close it. */
 	if (myFT->dataSocketFD >= 0)
 	{
+		endTls(myFT->dataSocketFD);
 		close(myFT->dataSocketFD);
 	}
 
@@ -28,22 +28,34 @@
  * File Description: 	Definition of a struct to keep track of variables used for interaction
  * 			with an indivdioual client program and prototypes of initializer and destroyer.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #ifndef FT_INFO
 #define FT_INFO
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "latencyHistogram.h"
+#include "probes.h"
+#include "tcpSampler.h"
+#include "zeroCopySend.h"
 
 /* Global constants containing IPv4 addresses of each flip server. */
 #define FLIP1 "128.193.54.168"
 #define FLIP2 "128.193.54.182"
 #define FLIP3 "128.193.36.41"
 
+/* Forward declarations of registry entry describing a command (see commandRegistry.h),
+ * of rate limiter for a transfer (see bandwidthShaper.h), and of entry counting the downloads
+ * of a file (see sharedStream.h). */
+struct CommandHandler;
+struct TransferShaper;
+struct SharedFile;
+
 /* Definition of struct containing variables related to communication with an individual
  * client program. See below for variable descriptions. */
 struct FTInfo
@@ -52,14 +64,33 @@ struct FTInfo
 	char* clientHost;	/* Address of client from which a control connection has been accepted. */
 	char* clientNickname;	/* Name of the flip server on which client is running (if applicable) or IP address. */
 	char* dataPort;		/* Port number at which to establish data connection with client. */ 
-	char* command;		/* Requested command to be executed. */
-	char* filename;		/* Name of file to be sent to client (if applicable). */
+	char* request;		/* Request received from client, tokenized in place by parseRequest. */
+	char* command;		/* Requested command to be executed (points into request). */
+	char* filename;		/* Name of file to be sent to client, if applicable (points into request). */
+	const struct CommandHandler* handler;	/* Registry entry for command. */
 	int dataSocketFD;	/* Socket used for data connection to client. */
+	struct TransferShaper* shaper;	/* Rate limiter for data sent to client while a request is fulfilled. */
+	long long requestSize;	/* Size of file named in request, or -1 if unknown or not applicable. */
+	unsigned long long bytesSent;	/* Bytes of data sent to client over data connection. */
+	struct FTInfo* next;	/* Next connection in the scheduler queue holding this one. */
+	unsigned long long acceptedAt;	/* Monotonic time (ns) at which connection was accepted. */
+	unsigned long long phaseMark;	/* Monotonic time (ns) at which the current phase began. */
+	unsigned long long messageDeadline;	/* Monotonic time (ns) by which the message awaited from
+					 * client must arrive (ULLONG_MAX for no limit). */
+	unsigned long long phaseNs[NUM_PHASES];	/* Time spent in each phase marked so far. */
+	unsigned int phasesMarked;	/* Bit mask of phases whose time is stored in phaseNs. */
+	unsigned long long sessionId;	/* Number identifying session in probes (see probes.h). */
+	struct TcpTransfer tcp;		/* TCP sampling state of file transfer in progress. */
+	struct ZeroCopySocket zeroCopy;	/* Zero-copy sends of file transfer in progress. */
+	int local;		/* True if client connected through the Unix-domain socket (see localTransport.h). */
+	struct SharedFile* sharedFile;	/* Entry counting downloads of the file requested, or NULL if not counted. */
 };
 
 /* Function prototypes. */
 struct FTInfo* newFTInfo(int controlSocketFD, char* clientHost);
 char* getNickname(char* clientHost);
+void markPhase(struct FTInfo* myFT, int phase);
+int remainingMessageMs(struct FTInfo* myFT);
 void deleteFTInfo(struct FTInfo* myFT);
 
 #endif
@@ -19,12 +19,17 @@
 #			the connection-related information used throughout execution of the program
 #			and contains methods related to that connection.
 # Course Name: 		CS 372-400: Introduction to Computer Networks
-# Last Modified:	03/09/2020
+# Last Modified:	10/18/2026
 ######################################################################################################
 
+import fcntl
+import os
+import random
 import select
 import socket
+import ssl
 import sys
+import time
 import clientServerMessaging
 import CommandList
 
@@ -36,24 +41,51 @@ MAX_ARGS = 6
 
 # Usage message.
 USAGE_MESSAGE = "USAGE: python3 ftclient.py SERVER_HOST SERVER_PORT COMMAND [FILE_NAME] DATA_PORT"
+USAGE_MESSAGE += "\n       (SERVER_HOST unix:PATH connects to a server on this host through its Unix-domain socket)"
+USAGE_MESSAGE += "\n       (if FT_TLS_CA names a file of trusted certificates, connections are encrypted with TLS)"
 COMMAND_HELP_MESSAGE = "FOR COMMAND HELP: python3 ftclient.py -h"
 
 # Macros for accepted commands.
 GET_FILE = "-g"
 LIST_FILES = "-l"
 LIST_TXT_FILES = "-ltxt"
+PUT_FILE = "-p"
 
 # List of commands accepted on command line with descriptions.
 ACCEPTED_COMMANDS = CommandList.CommandList([
 CommandList.Command(GET_FILE, "Get file with [filename]"), 
 CommandList.Command(LIST_FILES, "List all files in the current directory"),
-CommandList.Command(LIST_TXT_FILES, "List only files with .txt extension")
+CommandList.Command(LIST_TXT_FILES, "List only files with .txt extension"),
+CommandList.Command(PUT_FILE, "Put file with [filename] in the server's directory")
 ])
 
 # Beginning of success message received from server over control socket
 # once all bytes of requested data have been successfully sent.
 SUCCESS_PREFIX = "SUCCESS!"
 
+# Beginning of message received from server in place of connection confirmation when the server
+# is too busy to serve another client. The number of milliseconds after which to retry follows it.
+BUSY_PREFIX = "SERVER BUSY, retry after "
+
+# Maximum number of times to try connecting to a busy server, and the longest delay (in milliseconds)
+# to wait between attempts.
+MAX_CONNECT_ATTEMPTS = 8
+MAX_RETRY_DELAY_MS = 30000
+
+# Beginning of SERVER_HOST naming the Unix-domain socket of a server on this host, and the messages to
+# which a local server attaches the data socket and the descriptor of a requested file.
+LOCAL_HOST_PREFIX = "unix:"
+DATA_SOCKET_MESSAGE = "FTSERVER DATA SOCKET"
+FILE_DESCRIPTOR_MESSAGE = "FTSERVER FILE DESCRIPTOR"
+
+# Environment variable naming the file of certificates trusted to sign the server's certificate. If it is
+# set, the control and data connections to a TCP server are encrypted with TLS.
+TLS_CA_VARIABLE = "FT_TLS_CA"
+
+# ioctl request cloning one file's extents into another (Linux FICLONE), used to copy a file passed by a
+# local server without copying its data on filesystems that support reflinks.
+FICLONE = 0x40049409
+
 
 #######################################################################################################
 # Class Name:		FTInfo
@@ -62,14 +94,21 @@ SUCCESS_PREFIX = "SUCCESS!"
 #			client-server interaction.
 # Data Members:		serverNickname (server name passed in on command line)
 #			serverHost (full server address)
+#			localPath (path of server's Unix-domain socket, or None to connect over TCP)
 #			serverPort (port number at which to contact server, represented as int)
 #			command (the command to be executed by ftserver; must be in ACCEPTED_COMMANDS)
-#			filename (the name of the file to be retrieved from server or None)
+#			filename (the name of the file to be retrieved from or put on server, or None)
+#			uploadSize (the number of bytes in the file to be put on server, or None)
 #			dataPort (the port on which to listen for data connection from server, represented as int)
 #			controlSocket (socket used for control connection to server)
 #			listeningSocket (socket on which to listen for connection from server)
 #			dataSocket (socket used for data connection to server)
 #			messagingPoll (poll object registered to poll for when control or data sockets ready to recv)
+#			tlsContext (SSL context wrapping control and data sockets, or None if not encrypted)
+#			quiet (True to print only errors, as when run by a batch; see FTBatch.py)
+#			outputPath (path to which to write a file received, replacing any file there, or None
+#			to write it to a new file in the current directory named after the file requested)
+#			listing (list of the chunks of a listing received, in order)
 # Member Functions:	(see below for definitions and descriptions)
 #######################################################################################################
 
@@ -161,11 +200,53 @@ class FTInfo:
 		if self.listeningSocket != None:
 			self.listeningSocket.close()
 	
+	#######################################################################################################
+	# Function Name:	_newControlSocket
+	# Description:		Internal function which creates an unconnected socket for the control
+	#			connection: a Unix-domain socket if the server is reached through localPath,
+	#			or a TCP socket otherwise.
+	# Receives: 		A self-reference.
+	# Returns: 		The new socket.
+	# Pre-Conditions:	localPath has been initialized.
+	# Post-Conditions: 	none
+	######################################################################################################
+	
+	def _newControlSocket(self):
+		if self.localPath != None:
+			return socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+		return socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+	
+	#######################################################################################################
+	# Function Name:	_startTls
+	# Description:		Internal function which performs the client side of a TLS handshake on a
+	#			connected socket if connections are encrypted, verifying that the server's
+	#			certificate is signed by a trusted certificate and names serverHost. The server
+	#			is the TLS server on both the control and data connections.
+	# Receives: 		A self-reference and a connected socket.
+	# Returns: 		The socket to use in place of the one received (the same socket if tlsContext
+	#			is None).
+	# Pre-Conditions:	Nothing has been sent or received on the socket.
+	# Post-Conditions: 	Unless the handshake fails (which is reported and causes the process to exit),
+	#			everything sent and received on the socket returned is encrypted.
+	######################################################################################################
+	
+	def _startTls(self, connectedSocket):
+		if self.tlsContext == None:
+			return connectedSocket
+		try:
+			return self.tlsContext.wrap_socket(connectedSocket, server_hostname=self.serverHost)
+		except (OSError, ssl.SSLError) as tlsErr:
+			print("TLS HANDSHAKE ERROR:", tlsErr, file=sys.stderr)
+			connectedSocket.close()
+			self.closeSockets()
+			sys.exit(2)
+	
 	#######################################################################################################
 	# Function Name:	__init__
 	# Description:		Constructs new FTInfo object based on parameters received.
 	# Receives: 		Self-reference and argv, a list of strings representing command-line arguments
-	#			passed into code which called this function.
+	#			passed into code which called this function, and optionally whether to print
+	#			only errors and the path to which to write a file received.
 	# Returns: 		An instantiated FTInfo object.
 	# Pre-Conditions:	argv is a valid list of non-null strings which follows usage instructions
 	#			detailed in USAGE_MESSAGE declared above.
@@ -173,15 +254,24 @@ class FTInfo:
 	#			and are ready to connect to server or listen for connection from server.
 	######################################################################################################
 	
-	def __init__(self, argv):
+	def __init__(self, argv, quiet=False, outputPath=None):
 		# List of error messages to be printed in case of errors before exiting.
 		initErrList = []
 		
+		# Initialize what to print and where to write data received.
+		self.quiet = quiet
+		self.outputPath = outputPath
+		self.listing = []
+		
 		# Initialize serverNickname to that passed in on the command line.
 		self.serverNickname = argv[1]
 		
-		# Initialize serverHost, expanding serverNickname if it is "flip1," "flip2," or "flip3." 
+		# Initialize serverHost, expanding serverNickname if it is "flip1," "flip2," or "flip3." If it names
+		# a Unix-domain socket, store its path in localPath.
 		self.serverHost = self._getFullHostname(self.serverNickname)
+		self.localPath = None
+		if self.serverHost.startswith(LOCAL_HOST_PREFIX):
+			self.localPath = self.serverHost[len(LOCAL_HOST_PREFIX):]
 		
 		# Initialize serverPort, adding error message if invalid.
 		self.serverPort = self._validatePortnum(argv[2])
@@ -194,22 +284,30 @@ class FTInfo:
 			initErrList.append("COMMAND invalid. You entered: " + argv[3])
 			initErrList.append("\t" + COMMAND_HELP_MESSAGE)
 		
-		# If command GET_FILE was entered, then argv[4] is the filename and argv[5] is the data port.
+		# If command GET_FILE or PUT_FILE was entered, then argv[4] is the filename and argv[5] is the data port.
 		# Set these accordingly.
-		if self.command == GET_FILE:
+		self.uploadSize = None
+		if self.command == GET_FILE or self.command == PUT_FILE:
 			# If there are not a total of 6 command-line arguments,
 			# assume user did not enter filename and only provided portnum
 			# after command. Add error to errList and set dataPortIn to argv[4].
 			if len(argv) != MAX_ARGS:
-				initErrList.append("COMMAND ERROR: FILENAME required after -g command before DATA_PORT.")
+				initErrList.append("COMMAND ERROR: FILENAME required after " + self.command + " command before DATA_PORT.")
 				self.filename = None
 				dataPortIn = argv[4]
 			
-			# Otherwise, since correct number of arguments for -g command were passed in,
+			# Otherwise, since correct number of arguments for the command were passed in,
 			# assign values accordingly.
 			else:
 				self.filename = argv[4]
 				dataPortIn = argv[5]
+			
+			# If the file is to be put on the server, get its size, adding error message if it cannot be read.
+			if self.command == PUT_FILE and self.filename != None:
+				try:
+					self.uploadSize = os.stat(self.filename).st_size
+				except OSError as statErr:
+					initErrList.append("FILE ERROR: " + str(statErr))
 		
 		# Otherwise, if the maximum number of arguments were entered,
 		# report error since -l and -ltxt should be followed only by dataPort,
@@ -230,15 +328,40 @@ class FTInfo:
 		if self.dataPort == None:
 			initErrList.append("DATA_PORT invalid. You entered: " + dataPortIn)
 		
+		# If TLS is requested for a TCP server, load the certificates trusted to sign the server's certificate,
+		# adding error message if they cannot be loaded.
+		self.tlsContext = None
+		tlsCAFile = os.environ.get(TLS_CA_VARIABLE)
+		if tlsCAFile and self.localPath == None:
+			try:
+				self.tlsContext = ssl.create_default_context(cafile=tlsCAFile)
+			except (OSError, ssl.SSLError) as tlsErr:
+				initErrList.append("TLS ERROR: could not load " + TLS_CA_VARIABLE + " " + tlsCAFile + ": " + str(tlsErr))
+		
 		# Handle any error messages.
 		self._handleInitErrs(initErrList)
 		
-		# Establish TCP socket which will be connected to server as control socket.
-		self.controlSocket = socket.socket(socket.AF_INET, socket.SOCK_STREAM) 
+		# Establish socket which will be connected to server as control socket.
+		self.controlSocket = self._newControlSocket()
+		
+		# Initialize dataSocket to None as a placeholder for when
+		# a data connection is accepted from the server later.
+		self.dataSocket = None
+		
+		# Initialize messagingPoll to None as a placeholder for when poll is registered
+		# for polling later on for when controlSocket or dataSocket have data ready to receive.
+		self.messagingPoll = None
+		
+		# A local server passes the data socket over the control connection, so there is nothing to listen on.
+		if self.localPath != None:
+			self.listeningSocket = None
+			return
 		
 		# Establish TCP socket which will listen for incoming connection from server
-		# (incoming connection will be data socket).
+		# (incoming connection will be data socket). Allow binding to a data port whose previous connection
+		# is still in TIME_WAIT, so that a port may be reused right away.
 		self.listeningSocket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+		self.listeningSocket.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
 		
 		# Bind listeningSocket to dataPort, reporting error and exiting if one occurs.
 		try:
@@ -257,20 +380,16 @@ class FTInfo:
 			print("LISTEN ERROR:", socketErr, file=sys.stderr)
 			self.closeSockets()
 			sys.exit(2)
-		
-		# Initialize dataSocket to None as a placeholder for when
-		# a data connection is accepted from the server later.
-		self.dataSocket = None
-		
-		# Initialize messagingPoll to None as a placeholder for when poll is registered
-		# for polling later on for when controlSocket or dataSocket have data ready to receive.
-		self.messagingPoll = None
 	
 	#######################################################################################################
 	# Function Name:	initiateContact
 	# Description:		Initiates a control connection with server at serverHost:serverPort,
 	#			sending server port number on which dataPort has been established, receiving
 	#			server response, and validating that expected response was received.
+	#			If the server responds that it is busy, closes the connection and tries
+	#			again after the delay the server suggested, doubling the delay after every
+	#			busy response and adding random jitter so that many clients turned away at
+	#			once do not all retry at the same moment.
 	# Receives: 		A self-reference.
 	# Returns: 		Nothing
 	# Pre-Conditions:	The server at serverHost:serverPort exists and is listening for connections.
@@ -279,22 +398,43 @@ class FTInfo:
 	######################################################################################################
 	
 	def initiateContact(self):
-		# Connect to server at serverHost:serverPort, reporting error and exiting if one occurs.
-		try:
-			self.controlSocket.connect((self.serverHost, self.serverPort))
-		
-		except OSError as socketErr:
-			print("ERROR CONNECTING TO SERVER:", socketErr, file=sys.stderr)
-			self.closeSockets()
-			sys.exit(2)
-		
-		# Send server dataPort via controlSocket
-		dataPortMessage = "DATA_PORT: " + str(self.dataPort)
-		clientServerMessaging.sendMessage(self.controlSocket, dataPortMessage, self)
+		# Try connecting until server accepts the connection or the maximum number of attempts is reached.
+		for attempt in range(MAX_CONNECT_ATTEMPTS):
+			# Connect to server at serverHost:serverPort, reporting error and exiting if one occurs.
+			try:
+				if self.localPath != None:
+					self.controlSocket.connect(self.localPath)
+				else:
+					self.controlSocket.connect((self.serverHost, self.serverPort))
+					self.controlSocket = self._startTls(self.controlSocket)
+			
+			except OSError as socketErr:
+				print("ERROR CONNECTING TO SERVER:", socketErr, file=sys.stderr)
+				self.closeSockets()
+				sys.exit(2)
+			
+			# Send server dataPort via controlSocket (0 for a local server, which passes the data socket instead).
+			dataPortMessage = "DATA_PORT: " + str(0 if self.localPath != None else self.dataPort)
+			clientServerMessaging.sendMessage(self.controlSocket, dataPortMessage, self)
 
-		# Receive initial response from server, validating that it is
-		# expected response of "FTSERVER CONNECTION ESTABLISHED"
-		serverResponse = clientServerMessaging.recvMessage(self.controlSocket, self)
+			# Receive initial response from server. If it is not a busy message, stop trying.
+			serverResponse = clientServerMessaging.recvMessage(self.controlSocket, self)
+			if not serverResponse.startswith(BUSY_PREFIX) or attempt == MAX_CONNECT_ATTEMPTS - 1:
+				break
+			
+			# Otherwise, compute delay: the server's suggested delay doubled for every earlier busy
+			# response (up to MAX_RETRY_DELAY_MS), scaled by a random factor between 0.5 and 1.5.
+			retryAfterMs = int(serverResponse[len(BUSY_PREFIX):].split()[0])
+			delayMs = min(retryAfterMs * (2 ** attempt), MAX_RETRY_DELAY_MS)
+			delayMs *= random.uniform(0.5, 1.5)
+			print("Server busy. Retrying in", int(delayMs), "ms...", file=sys.stderr)
+			
+			# Close control socket and wait before retrying with a new one.
+			self.controlSocket.close()
+			time.sleep(delayMs / 1000)
+			self.controlSocket = self._newControlSocket()
+
+		# Validate that response is expected response of "FTSERVER CONNECTION ESTABLISHED"
 		expectedResponse = "FTSERVER CONNECTION ESTABLISHED"
 		if serverResponse != expectedResponse:
 			print("SERVER VALIDATION ERROR:", file=sys.stderr)
@@ -305,7 +445,8 @@ class FTInfo:
 	
 	#######################################################################################################
 	# Function Name:	makeRequest
-	# Description:		Sends the command and filename (if applicable) to the server.
+	# Description:		Sends the command and filename (if applicable) to the server. A file to be put
+	#			on the server is named without its directory and followed by its size.
 	# Receives: 		A self-reference.
 	# Returns: 		nothing
 	# Pre-Conditions:	The controlSocket has been successfully connected to the server,
@@ -318,7 +459,9 @@ class FTInfo:
 		serverRequest = self.command
 		
 		# If filename is not None, append a space and the filename to serverRequest
-		if self.filename != None:
+		if self.filename != None and self.command == PUT_FILE:
+			serverRequest += " " + os.path.basename(self.filename) + " " + str(self.uploadSize)
+		elif self.filename != None:
 			serverRequest += " " + self.filename
 		
 		# Send the request to the server.
@@ -411,7 +554,52 @@ class FTInfo:
 			self.closeSockets()
 			sys.exit(2)
 		
-		# Now, receive initial message from server on data socket, ensuring it is expected message.
+		# Perform TLS handshake (if connections are encrypted), then exchange validation messages with
+		# server on data socket.
+		self.dataSocket = self._startTls(self.dataSocket)
+		self._exchangeValidationMessages()
+	
+	#######################################################################################################
+	# Function Name:	_receivePassedDataSocket
+	# Description:		Internal function which receives the data socket a local server passes over
+	#			the control connection in place of connecting to DATA_PORT, and exchanges
+	#			validation messages with the server on it. If the server sends an error message
+	#			instead, prints it and exits.
+	# Receives: 		A self-reference.
+	# Returns: 		nothing
+	# Pre-Conditions:	The control socket is connected to a local server, and the request has been sent.
+	# Post-Conditions: 	Unless process exits, dataSocket is ready to receive the data requested.
+	######################################################################################################
+	
+	def _receivePassedDataSocket(self):
+		# Receive next control message with any descriptor attached.
+		message, descriptors = clientServerMessaging.recvMessageAndDescriptors(self.controlSocket, self)
+		
+		# If it is not the data socket, it is an error message. Print it, close any descriptors received, and exit.
+		if message != DATA_SOCKET_MESSAGE or len(descriptors) != 1:
+			for descriptor in descriptors:
+				os.close(descriptor)
+			print(self.serverNickname + ":" + str(self.serverPort), "says:", file=sys.stderr)
+			print(message, file=sys.stderr)
+			self.closeSockets()
+			sys.exit(2)
+		
+		# Otherwise, wrap descriptor as data socket and validate it.
+		self.dataSocket = socket.socket(fileno=descriptors[0])
+		self._exchangeValidationMessages()
+	
+	#######################################################################################################
+	# Function Name:	_exchangeValidationMessages
+	# Description:		Internal function which receives and validates the initial data socket
+	#			message from the server and sends acknowledgement message to server.
+	# Receives: 		A self-reference.
+	# Returns: 		nothing
+	# Pre-Conditions:	dataSocket is connected to the server.
+	# Post-Conditions: 	Unless process exits, dataSocket is ready to receive the data requested.
+	######################################################################################################
+	
+	def _exchangeValidationMessages(self):
+		# Receive initial message from server on data socket, ensuring it is expected message.
 		serverMessage = clientServerMessaging.recvMessage(self.dataSocket, self)
 		expectedMessage = "FTSERVER DATA CONNECTION INITIALIZATION"
 
@@ -455,11 +643,13 @@ class FTInfo:
 	# Description:		Polls the messagingPoll object until controlSocket and/or dataSocket has
 	#			data ready to receive. Once poll call returns, receives data from whichever
 	#			socket(s) have data available.
-	# Receives: 		A self-reference and a flag indicating whether to decode dataMessage to string
-	#			(if set) or leave dataMessage as bytes object (if cleared).
+	# Receives: 		A self-reference, a flag indicating whether to decode dataMessage to string
+	#			(if set) or not (if cleared), and the FrameReceiver through which to receive
+	#			data frames that are not decoded.
 	# Returns: 		A 2-tuple containing (controlMessage, dataMessage). Control message
 	#			(if present) is already decoded to string. Data message is decoded to
-	#			string if decodeDataMessage flag is set; otherwise, is left encoded as bytes.
+	#			string if decodeDataMessage flag is set; otherwise, its payload is passed to
+	#			frameReceiver, and dataMessage is the length of the payload.
 	# Pre-Conditions:	messagingPoll has been initialized and registered for polling controlSocket
 	#			and dataSocket for data available to receive. Data socket and control socket
 	#			have been connected to server.
@@ -467,14 +657,21 @@ class FTInfo:
 	#			indicating that a message was not available on that socket.
 	######################################################################################################
 	
-	def _pollMessagingSockets(self, decodeDataMessage):
+	def _pollMessagingSockets(self, decodeDataMessage, frameReceiver=None):
 		# Initialize controlMessage and dataMessage to None.
 		controlMessage = None
 		dataMessage = None
 		
 		# Poll messagingPoll and process results. Call will block until at least 1
-		# socket has data ready (or error occurs with a socket).
-		pollResults = self.messagingPoll.poll()
+		# socket has data ready (or error occurs with a socket). Data TLS has already decrypted, or
+		# frameReceiver has already received, cannot be seen by poll, so sockets holding some are treated
+		# as ready without polling.
+		pollResults = [(tlsSocket.fileno(), select.POLLIN) for tlsSocket in (self.controlSocket, self.dataSocket)
+			if isinstance(tlsSocket, ssl.SSLSocket) and tlsSocket.pending() > 0]
+		if frameReceiver != None and frameReceiver.pending() and len(pollResults) == 0:
+			pollResults = [(self.dataSocket.fileno(), select.POLLIN)]
+		if len(pollResults) == 0:
+			pollResults = self.messagingPoll.poll()
 		
 		# Loop through results list of 2-tuples containing file descriptors and events.
 		for fd, event in pollResults:
@@ -487,9 +684,9 @@ class FTInfo:
 			elif decodeDataMessage == True:
 				dataMessage = clientServerMessaging.recvMessage(self.dataSocket, self)
 
-			# Otherwise, receive dataMessage as bytes since decodeDataMessage flag not set.
+			# Otherwise, receive data frame through frameReceiver since decodeDataMessage flag not set.
 			else:
-				dataMessage = clientServerMessaging.recvBytes(self.dataSocket, self)
+				dataMessage = frameReceiver.recvFrame()
 			
 		# Return controlMessage and dataMessage in 2-tuple to calling function.
 		return (controlMessage, dataMessage)
@@ -576,7 +773,8 @@ class FTInfo:
 	# Function Name:	_openOutputFile
 	# Description:		Opens an output file in binary mode into which to write data received from
 	#			server in response to GET_FILE request. Ensures that the output file has a
-	#			unique name so as to not overwrite an existing file with the same name.
+	#			unique name so as to not overwrite an existing file with the same name, unless
+	#			outputPath is set, in which case the file at outputPath is replaced.
 	# Receives: 		A self-reference.
 	# Returns: 		A 2-tuple containing the file object of the newly opened output file and the
 	#			name of that file.
@@ -590,6 +788,15 @@ class FTInfo:
 	######################################################################################################
 	
 	def _openOutputFile(self):
+		# If the caller chose where to write the file, open it there, reporting error and exiting on failure.
+		if self.outputPath != None:
+			try:
+				return (open(self.outputPath, "wb"), self.outputPath)
+			except OSError as openErr:
+				print("FILE ERROR:", openErr, file=sys.stderr)
+				self.closeSockets()
+				sys.exit(2)
+		
 		# Initialize outputFile to None as a placeholder and outputFilename to self.filename.
 		outputFile = None
 		outputFilename = self.filename
@@ -662,13 +869,14 @@ class FTInfo:
 		# placeholder for when value is received from server.
 		dataLength = None
 		
-		# Initialize variable bytesReceived to keep count of total bytes of data
-		# actually received from the data socket.
-		bytesReceived = 0
+		# Data frames are received through a FrameReceiver, which counts the bytes of data actually received
+		# from the data socket and writes them in large blocks to an output file with a unique name, opening
+		# it once the first block is written.
+		frameReceiver = clientServerMessaging.FrameReceiver(self.dataSocket, self._openOutputFile, self)
 
 		# Get next message(s) sent by server over data connection and/or control connection
 		# to check for any errors in finding file to send.
-		controlMessage, dataMessage = self._pollMessagingSockets(False)
+		controlMessage, dataMessage = self._pollMessagingSockets(False, frameReceiver)
 		
 		# If there is a controlMessage, process it, storing its return value (length of data in bytes)
 		# for reference below. (If final control message is an error message,
@@ -677,38 +885,159 @@ class FTInfo:
 			dataLength = self._handleFinalControlMessage(controlMessage)
 		
 		# Inform user that file is now being received from server.
-		print("Receiving \"" + self.filename + "\" from " + self.serverNickname + ":" + str(self.dataPort))
-		
-		# Open file and put first set of bytes read in into file (if a dataMessage has already
-		# been received). 
-		outputFile, outputFilename = self._openOutputFile()
-		if dataMessage != None:
-			outputFile.write(dataMessage)
-			bytesReceived += len(dataMessage)
+		if not self.quiet:
+			print("Receiving \"" + self.filename + "\" from " + self.serverNickname + ":" + str(self.dataPort))
 		
 		# Loop until full file is received, continuing as long dataLength = None (the success
 		# message has not been received over the control socket with total number of bytes sent)
 		# or the number of bytes received is less than dataLength.
-		while dataLength == None or bytesReceived < dataLength:
+		while dataLength == None or frameReceiver.bytesReceived < dataLength:
 			# Get next message(s) sent by server over data connection and/or control connection.
-			controlMessage, dataMessage = self._pollMessagingSockets(False)
+			controlMessage, dataMessage = self._pollMessagingSockets(False, frameReceiver)
 			
 			# If there is a controlMessage, process it, storing its return value in dataLength
 			# (program will print controlMessage and exit if it is not the success message
 			# with total length of data sent).
 			if controlMessage != None:			
 				dataLength = self._handleFinalControlMessage(controlMessage)
+		
+		# Now that full file has been received, write the rest of it and close it, print that transfer is
+		# finished and indicate output filename, and exit.
+		frameReceiver.flush()
+		frameReceiver.outputFile.close()
+		if not self.quiet:
+			print("File transfer complete. Results can be found in \"" + frameReceiver.outputFilename + "\"")
+	
+	#######################################################################################################
+	# Function Name:	_recvPassedFile
+	# Description:		Internal function which receives the descriptor of the requested file that
+	#			a local server passes over the data socket and the success message giving the
+	#			number of bytes to copy from it, then copies the file into a new file with a
+	#			unique name. If the server sends an error message instead, prints it and exits.
+	# Receives: 		A self-reference.
+	# Returns: 		nothing
+	# Pre-Conditions:	The data socket has been passed by a local server and validated, and
+	#			messagingPoll has been registered.
+	# Post-Conditions: 	Unless process exits, the file printed to the console holds the requested file.
+	######################################################################################################
+	
+	def _recvPassedFile(self):
+		# Wait for both the descriptor and the success message (or an error message, upon which the process exits).
+		dataLength = None
+		passedFile = None
+		while dataLength == None or passedFile == None:
+			for fd, event in self.messagingPoll.poll():
+				if fd == self.controlSocket.fileno():
+					controlMessage = clientServerMessaging.recvMessage(self.controlSocket, self)
+					dataLength = self._handleFinalControlMessage(controlMessage)
+				elif passedFile == None:
+					message, descriptors = clientServerMessaging.recvMessageAndDescriptors(self.dataSocket, self)
+					if message != FILE_DESCRIPTOR_MESSAGE or len(descriptors) != 1:
+						print("INVALID FILE DESCRIPTOR MESSAGE:", message, file=sys.stderr)
+						self.closeSockets()
+						sys.exit(2)
+					passedFile = descriptors[0]
+					self.messagingPoll.unregister(self.dataSocket.fileno())
+		
+		# Copy file into output file, then close both.
+		if not self.quiet:
+			print("Receiving \"" + self.filename + "\" from " + self.serverNickname)
+		outputFile, outputFilename = self._openOutputFile()
+		try:
+			self._copyPassedFile(passedFile, outputFile.fileno(), dataLength)
+		except OSError as copyErr:
+			print("FILE COPY ERROR:", copyErr, file=sys.stderr)
+			self.closeSockets()
+			sys.exit(2)
+		finally:
+			os.close(passedFile)
+			outputFile.close()
+		if not self.quiet:
+			print("File transfer complete. Results can be found in \"" + outputFilename + "\"")
+	
+	#######################################################################################################
+	# Function Name:	_copyPassedFile
+	# Description:		Internal function which copies the first dataLength bytes of a file passed by
+	#			a local server into the output file, as cheaply as the filesystems allow: by
+	#			cloning its extents (reflink) if the whole file is wanted and both files are on a
+	#			filesystem that supports it, otherwise with copy_file_range (copied inside the
+	#			kernel), and otherwise with sendfile.
+	# Receives: 		A self-reference, the passed file's descriptor, the output file's descriptor, and
+	#			the number of bytes to copy.
+	# Returns: 		nothing (raises OSError if copying fails)
+	# Pre-Conditions:	outputDescriptor refers to a new, empty file open for writing.
+	# Post-Conditions: 	The output file holds the first dataLength bytes of the passed file.
+	######################################################################################################
+	
+	def _copyPassedFile(self, passedDescriptor, outputDescriptor, dataLength):
+		# Clone whole file if it has not grown since the server measured it.
+		if os.fstat(passedDescriptor).st_size == dataLength:
+			try:
+				fcntl.ioctl(outputDescriptor, FICLONE, passedDescriptor)
+				return
+			except OSError:
+				pass
+		
+		# Otherwise, copy it in the kernel. Offsets are passed explicitly, since the server shares the
+		# passed descriptor's file offset.
+		offset = 0
+		useCopyFileRange = hasattr(os, "copy_file_range")
+		while offset < dataLength:
+			if useCopyFileRange:
+				try:
+					bytesCopied = os.copy_file_range(passedDescriptor, outputDescriptor, dataLength - offset, offset, offset)
+				except OSError:
+					useCopyFileRange = False
+					continue
+			else:
+				os.lseek(outputDescriptor, offset, os.SEEK_SET)
+				bytesCopied = os.sendfile(outputDescriptor, passedDescriptor, offset, dataLength - offset)
 			
-			# If there is a data message, write it into the outputFile and add its length to
-			# bytesReceived.
-			if dataMessage != None:
-				outputFile.write(dataMessage)
-				bytesReceived += len(dataMessage)
+			# Stop if the file was truncated since the server measured it.
+			if bytesCopied == 0:
+				raise OSError("file ended after " + str(offset) + " of " + str(dataLength) + " bytes")
+			offset += bytesCopied
+	
+	#######################################################################################################
+	# Function Name:	_sendFileToServer
+	# Description:		Internal function which streams the file to be put on the server over the data
+	#			connection, then receives the server's final control message. The file is sent with
+	#			sendfile, so its data is never copied through the process. If the server hits an
+	#			error, it closes the data connection (so sending stops with an error, which is
+	#			ignored here) and reports the error on the control connection, which is printed
+	#			before the process exits.
+	# Receives: 		A self-reference.
+	# Returns: 		nothing
+	# Pre-Conditions:	dataSocket has been connected to the server and validated, and the server has
+	#			been sent PUT_FILE command, filename, and uploadSize over the control connection.
+	# Post-Conditions: 	Unless process exits, the server has stored the file.
+	######################################################################################################
+	
+	def _sendFileToServer(self):
+		# Inform user that file is now being sent to server.
+		print("Sending \"" + self.filename + "\" to " + self.serverNickname + ":" + str(self.dataPort))
 		
-		# Now that full file has been received, close it, print that transfer is finished
-		# and indicate output filename, and exit.
-		outputFile.close()
-		print("File transfer complete. Results can be found in \"" + outputFilename + "\"")
+		# Open file, reporting error and exiting if one occurs.
+		try:
+			uploadFile = open(self.filename, "rb")
+		except OSError as openErr:
+			print("FILE ERROR:", openErr, file=sys.stderr)
+			self.closeSockets()
+			sys.exit(2)
+		
+		# Send the announced number of bytes of the file. An error means the server has closed the data
+		# connection, which it explains on the control connection.
+		try:
+			self.dataSocket.sendfile(uploadFile, 0, self.uploadSize)
+		except OSError:
+			pass
+		uploadFile.close()
+		
+		# Receive and process the final control message (the process exits if it is an error message),
+		# then print that the transfer is finished.
+		controlMessage = clientServerMessaging.recvMessage(self.controlSocket, self)
+		bytesSent = self._handleFinalControlMessage(controlMessage)
+		print("File transfer complete. " + str(bytesSent) + " bytes stored as \"" + os.path.basename(self.filename) + "\"")
 	
 	#######################################################################################################
 	# Function Name:	_recvListingFromServer
@@ -722,7 +1051,8 @@ class FTInfo:
 	# Pre-Conditions:	The dataSocket and controlSocket have already been connected to the server,
 	#			and the command has been sent to the server.
 	# Post-Conditions: 	Unless error occurs (in which case error message is printed),
-	#			requested listing is received from server and printed to the console.
+	#			requested listing is received from server, stored in self.listing, and printed to
+	#			the console (unless self.quiet is set).
 	######################################################################################################
 
 	def _recvListingFromServer(self):
@@ -748,7 +1078,8 @@ class FTInfo:
 			aboutToRecvMessage = "Receiving directory structure from "
 
 		# Print message informing user what is about to be received.
-		print(aboutToRecvMessage + self.serverNickname + ":" + str(self.dataPort))
+		if not self.quiet:
+			print(aboutToRecvMessage + self.serverNickname + ":" + str(self.dataPort))
 		
 		# Loop until full listing is received, continuing as long dataLength = None (the success
 		# message has not been received over the control socket with total number of bytes sent)
@@ -770,13 +1101,16 @@ class FTInfo:
 			# string since listing received from server will already have newline characters
 			# after each filename.
 			if dataMessage != None:
-				print(dataMessage, end="")
+				self.listing.append(dataMessage)
+				if not self.quiet:
+					print(dataMessage, end="")
 				bytesReceived += len(dataMessage)	
 	
 	#######################################################################################################
 	# Function Name:	receiveData
 	# Description:		Accepts data connection from server and then calls helper functions to either
-	#			receive file from server (if command is GET_FILE) or receive directory
+	#			receive file from server (if command is GET_FILE), send file to server
+	#			(if command is PUT_FILE), or receive directory
 	#			listing from server (if command is LIST_FILES or LIST_TXT_FILES). If the
 	#			server sends an error message through the control connection instead of 
 	#			opening data connection, prints error message before exiting.
@@ -791,9 +1125,13 @@ class FTInfo:
 	######################################################################################################
 	
 	def receiveData(self):
-		# If a new connection is ready to be accepted (and no new data is ready to be read from
+		# If the server is local, receive the data socket it passes.
+		if self.localPath != None:
+			self._receivePassedDataSocket()
+		
+		# Otherwise, if a new connection is ready to be accepted (and no new data is ready to be read from
 		# controlSocket, which would indicate an error message), establish and validate dataConnection.
-		if self._connectionReadyToAccept() == True:
+		elif self._connectionReadyToAccept() == True:
 			self._validateDataConnection()
 
 		# Otherwise, get and print error message from server, then exit.
@@ -810,8 +1148,13 @@ class FTInfo:
 		# data is ready to receive from controlSocket or dataSocket.
 		self._registerMessagingPoll()
 		
-		# If command is GET_FILE, call _recvFileFromServer()
-		if self.command == GET_FILE:
+		# If command is GET_FILE, call _recvPassedFile() if the server is local or _recvFileFromServer() otherwise.
+		# If command is PUT_FILE, call _sendFileToServer().
+		if self.command == PUT_FILE:
+			self._sendFileToServer()
+		elif self.command == GET_FILE and self.localPath != None:
+			self._recvPassedFile()
+		elif self.command == GET_FILE:
 			self._recvFileFromServer()
 		
 		# Otherwise, since command is validated to be one of the other two options (-l or -ltxt),
@@ -0,0 +1,520 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		accessLog.c
+ * File Description: 	Implementation of the access log. See accessLog.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "accessLog.h"
+#include "FTInfo.h"
+#include "serverConfig.h"
+
+/* Definition of struct holding one thread's records. Only the owning thread writes records and
+ * advances head; only the log thread reads records and advances tail, so neither needs a lock. */
+struct LogRing
+{
+	struct AccessLogRecord records[LOG_RING_SIZE];
+	unsigned long long head;	/* Count of records ever written (owning thread). */
+	unsigned long long tail;	/* Count of records ever formatted (log thread). */
+	unsigned long long dropped;	/* Count of records dropped because ring was full. */
+	unsigned long long droppedReported;	/* Value of dropped when last reported (log thread). */
+	struct LogRing* next;		/* Next ring in list of all rings. */
+};
+
+/* Names of events as written in the log, indexed by enum AccessLogEvent. */
+static const char* eventNames[] =
+{
+	"connection", "busy_rejected", "invalid_message", "invalid_request", "invalid_data_response",
+	"file_requested", "file_sending", "file_receiving", "listing_requested", "listing_sending",
+	"error_sent", "transfer_complete", "tcp_sample", "tcp_summary", "transfer_failed",
+	"client_timeout", "stream_failed"
+};
+
+/* Names of the key under which each event's text is written, indexed by enum AccessLogEvent. */
+static const char* textKeys[] =
+{
+	"", "", "error", "error", "received", "file", "file", "file", "command", "command", "error",
+	"command", "file", "file", "error", "phase", "error"
+};
+
+/* Static variables. Each thread's ring is allocated and pushed onto the list of rings the first time
+ * it logs; ringListLock is only taken then, by threads pushing rings. logLock is held by the log
+ * thread while it writes and by setAccessLogFile while it changes logFile, and is never taken by
+ * threads handling requests. */
+static __thread struct LogRing* threadRing = NULL;
+static struct LogRing* ringList = NULL;
+static pthread_mutex_t ringListLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t logLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* logFile = NULL;			/* Access log, or NULL for standard output. */
+static char logFilename[MAX_CONFIG_LINE];	/* Name of access log, or empty for standard output. */
+static pthread_t logThread;
+static int logThreadStarted = 0;
+static volatile int stopRequested = 0;
+
+/* Function prototypes for functions used only in this file. */
+static struct AccessLogRecord* claimRecord(enum AccessLogEvent event, struct FTInfo* myFT);
+static void publishRecord();
+static void* logWriter(void* arg);
+static int drainRings(FILE* out);
+static void writeRecord(FILE* out, struct AccessLogRecord* record);
+static void writeTcpFields(FILE* out, struct AccessLogRecord* record);
+static void writeQuoted(FILE* out, const char* text);
+
+
+/***********************************************************************************************
+ * Function Name:	claimRecord
+ * Description:		Finds the next free record in the calling thread's ring and fills in
+ * 			the fields every event has. Never blocks, prints, or takes a lock (except
+ * 			once per thread, to register its ring).
+ * Receives: 		The event and the session it concerns (or NULL).
+ * Returns: 		The record, or NULL if the ring is full (the record is then counted as
+ * 			dropped).
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	If a record is returned, the caller fills in any other fields and
+ * 			then calls publishRecord.
+**********************************************************************************************/
+
+static struct AccessLogRecord* claimRecord(enum AccessLogEvent event, struct FTInfo* myFT)
+{
+	/* Register ring for this thread the first time it logs. */
+	struct LogRing* ring = threadRing;
+	if (ring == NULL)
+	{
+		ring = calloc(1, sizeof(struct LogRing));
+		if (ring == NULL)
+		{
+			return NULL;
+		}
+		pthread_mutex_lock(&ringListLock);
+		ring->next = ringList;
+		__atomic_store_n(&ringList, ring, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&ringListLock);
+		threadRing = ring;
+	}
+
+	/* Drop record if ring is full. */
+	if (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == LOG_RING_SIZE)
+	{
+		__atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	/* Fill in fields of next free record. */
+	struct AccessLogRecord* record = &ring->records[ring->head & (LOG_RING_SIZE - 1)];
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	record->timeNs = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+	record->event = event;
+	snprintf(record->client, sizeof(record->client), "%s",
+		(myFT != NULL && myFT->clientNickname != NULL) ? myFT->clientNickname : "");
+	snprintf(record->dataPort, sizeof(record->dataPort), "%s",
+		(myFT != NULL && myFT->dataPort != NULL) ? myFT->dataPort : "");
+	return record;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	publishRecord
+ * Description:		Makes the record last returned by claimRecord visible to the log thread.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	claimRecord has just returned a record on this thread.
+ * Post-Conditions: 	The record will be written to the access log.
+**********************************************************************************************/
+
+static void publishRecord()
+{
+	__atomic_store_n(&threadRing->head, threadRing->head + 1, __ATOMIC_RELEASE);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	logEvent
+ * Description:		Records an event in the calling thread's ring without blocking (see
+ * 			claimRecord).
+ * Receives: 		The event, the session it concerns (or NULL), the event's text (or NULL),
+ * 			and the event's value.
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	The record will be written to the access log by the log thread
+ * 			(unless it was dropped).
+**********************************************************************************************/
+
+void logEvent(enum AccessLogEvent event, struct FTInfo* myFT, const char* text, unsigned long long value)
+{
+	struct AccessLogRecord* record = claimRecord(event, myFT);
+	if (record == NULL)
+	{
+		return;
+	}
+	record->value = value;
+	snprintf(record->text, sizeof(record->text), "%s", (text != NULL) ? text : "");
+	publishRecord();
+}
+
+
+/***********************************************************************************************
+ * Function Name:	logTcpEvent
+ * Description:		Records a TCP sample or summary of a session's file transfer in the
+ * 			calling thread's ring without blocking (see claimRecord).
+ * Receives: 		The event (LOG_TCP_SAMPLE or LOG_TCP_SUMMARY), the session, the sample
+ * 			or summary, and the transfer's bottleneck (summaries only).
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	The record will be written to the access log by the log thread
+ * 			(unless it was dropped).
+**********************************************************************************************/
+
+void logTcpEvent(enum AccessLogEvent event, struct FTInfo* myFT, const struct TcpSample* sample, int bottleneck)
+{
+	struct AccessLogRecord* record = claimRecord(event, myFT);
+	if (record == NULL)
+	{
+		return;
+	}
+	record->value = bottleneck;
+	snprintf(record->text, sizeof(record->text), "%s", (myFT->filename != NULL) ? myFT->filename : "");
+	record->tcp = *sample;
+	publishRecord();
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startAccessLog
+ * Description:		Starts the log thread, which writes records to the access log.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	The log thread has not been started.
+ * Post-Conditions: 	Records logged are written to the access log (records logged before
+ * 			this call are written once it is made).
+**********************************************************************************************/
+
+void startAccessLog()
+{
+	int createStatus = pthread_create(&logThread, NULL, logWriter, NULL);
+	if (createStatus != 0)
+	{
+		fprintf(stderr, "THREAD ERROR: could not start access log thread: %s\n", strerror(createStatus));
+		exit(1);
+	}
+	logThreadStarted = 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	stopAccessLog
+ * Description:		Stops the log thread once it has written every record logged, and
+ * 			flushes the access log.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	Not called on the log thread (which blocks every signal).
+ * Post-Conditions: 	Every record logged before this call has been written.
+**********************************************************************************************/
+
+void stopAccessLog()
+{
+	if (logThreadStarted)
+	{
+		stopRequested = 1;
+		pthread_join(logThread, NULL);
+		logThreadStarted = 0;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	setAccessLogFile
+ * Description:		Makes the log thread write to the named file (appending to it), or to
+ * 			standard output if filename is empty. Does nothing if filename names the
+ * 			log already being written, so that reloading an unchanged configuration
+ * 			does not reopen it (a changed name reopens it, e.g. after rotation).
+ * Receives: 		The name of the access log, or an empty string.
+ * Returns: 		0 on success; -1 if the file could not be opened (standard output is then used).
+ * Pre-Conditions: 	filename is shorter than MAX_CONFIG_LINE.
+ * Post-Conditions: 	Records written from now on are written to filename (or standard output).
+**********************************************************************************************/
+
+int setAccessLogFile(char* filename)
+{
+	pthread_mutex_lock(&logLock);
+	if (strcmp(filename, logFilename) == 0)
+	{
+		pthread_mutex_unlock(&logLock);
+		return 0;
+	}
+
+	/* Close any log file open. */
+	if (logFile != NULL)
+	{
+		fclose(logFile);
+		logFile = NULL;
+	}
+	logFilename[0] = '\0';
+	int result = 0;
+
+	/* Open new log file. */
+	if (filename[0] != '\0')
+	{
+		logFile = fopen(filename, "a");
+		if (logFile == NULL)
+		{
+			fprintf(stderr, "ACCESS LOG ERROR: could not open %s: %s\n", filename, strerror(errno));
+			result = -1;
+		}
+		else
+		{
+			strcpy(logFilename, filename);
+		}
+	}
+	pthread_mutex_unlock(&logLock);
+	return result;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	logWriter
+ * Description:		Thread function for the log thread. Repeatedly writes every record in
+ * 			every ring to the access log, flushing it and sleeping for
+ * 			LOG_IDLE_SLEEP_MS whenever no records are waiting, until stopAccessLog
+ * 			is called.
+ * Receives: 		Unused argument.
+ * Returns: 		NULL
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	Every record logged before stopAccessLog was called has been written.
+**********************************************************************************************/
+
+static void* logWriter(void* arg)
+{
+	/* Block every signal, so that signal handlers (which may call stopAccessLog) never run on this thread. */
+	sigset_t allSignals;
+	sigfillset(&allSignals);
+	pthread_sigmask(SIG_BLOCK, &allSignals, NULL);
+
+	struct timespec idleSleep = { 0, LOG_IDLE_SLEEP_MS * 1000000L };
+	while (1)
+	{
+		/* Read stop flag before draining, so that records logged before stop was requested are written. */
+		int stopping = stopRequested;
+		pthread_mutex_lock(&logLock);
+		FILE* out = (logFile != NULL) ? logFile : stdout;
+		int written = drainRings(out);
+		if (written == 0 || stopping)
+		{
+			fflush(out);
+		}
+		pthread_mutex_unlock(&logLock);
+		if (stopping)
+		{
+			break;
+		}
+		if (written == 0)
+		{
+			nanosleep(&idleSleep, NULL);
+		}
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	drainRings
+ * Description:		Writes every record waiting in every ring, in order of time across
+ * 			rings, followed by a line for any ring that has dropped records since
+ * 			last reported.
+ * Receives: 		The stream to write to.
+ * Returns: 		The number of records written.
+ * Pre-Conditions: 	Called only by the log thread, holding logLock.
+ * Post-Conditions: 	Every ring is empty, unless records were logged meanwhile.
+**********************************************************************************************/
+
+static int drainRings(FILE* out)
+{
+	int written = 0;
+	struct LogRing* rings = __atomic_load_n(&ringList, __ATOMIC_ACQUIRE);
+	while (1)
+	{
+		/* Find ring whose oldest waiting record is earliest. */
+		struct LogRing* earliest = NULL;
+		for (struct LogRing* ring = rings; ring != NULL; ring = ring->next)
+		{
+			if (ring->tail != __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) && (earliest == NULL
+				|| ring->records[ring->tail & (LOG_RING_SIZE - 1)].timeNs
+					< earliest->records[earliest->tail & (LOG_RING_SIZE - 1)].timeNs))
+			{
+				earliest = ring;
+			}
+		}
+		if (earliest == NULL)
+		{
+			break;
+		}
+
+		/* Write that record, then free its slot by advancing tail. */
+		writeRecord(out, &earliest->records[earliest->tail & (LOG_RING_SIZE - 1)]);
+		__atomic_store_n(&earliest->tail, earliest->tail + 1, __ATOMIC_RELEASE);
+		written++;
+	}
+
+	/* Report records dropped. */
+	for (struct LogRing* ring = rings; ring != NULL; ring = ring->next)
+	{
+		unsigned long long dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+		if (dropped != ring->droppedReported)
+		{
+			fprintf(out, "log_dropped records=%llu\n", dropped - ring->droppedReported);
+			ring->droppedReported = dropped;
+		}
+	}
+	return written;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	writeRecord
+ * Description:		Writes one record as a line of the access log: the time (UTC, to the
+ * 			microsecond), the event name, and key=value fields for those of the
+ * 			client, data port, text, and value the event has.
+ * Receives: 		The stream to write to and the record.
+ * Returns: 		nothing
+ * Pre-Conditions: 	record->event is a valid enum AccessLogEvent.
+ * Post-Conditions: 	The line has been written to out.
+**********************************************************************************************/
+
+static void writeRecord(FILE* out, struct AccessLogRecord* record)
+{
+	/* Write time and event name. */
+	time_t seconds = record->timeNs / 1000000000ULL;
+	struct tm utc;
+	gmtime_r(&seconds, &utc);
+	char timeString[32];
+	strftime(timeString, sizeof(timeString), "%Y-%m-%dT%H:%M:%S", &utc);
+	fprintf(out, "%s.%06lluZ %s", timeString, (unsigned long long)(record->timeNs % 1000000000ULL) / 1000,
+		eventNames[record->event]);
+
+	/* Write fields. */
+	if (record->client[0] != '\0')
+	{
+		fprintf(out, " client=%s", record->client);
+	}
+	if (record->dataPort[0] != '\0')
+	{
+		fprintf(out, " data_port=%s", record->dataPort);
+	}
+	if (textKeys[record->event][0] != '\0')
+	{
+		fprintf(out, " %s=", textKeys[record->event]);
+		writeQuoted(out, record->text);
+	}
+	if (record->event == LOG_TRANSFER_COMPLETE || record->event == LOG_FILE_RECEIVING)
+	{
+		fprintf(out, " bytes=%llu", (unsigned long long)record->value);
+	}
+	else if (record->event == LOG_TCP_SAMPLE || record->event == LOG_TCP_SUMMARY)
+	{
+		writeTcpFields(out, record);
+	}
+	fputc('\n', out);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	writeTcpFields
+ * Description:		Writes the fields of a TCP sample or summary. A summary's elapsed time,
+ * 			times, bytes, and segments cover the whole transfer, and it also names
+ * 			the bottleneck and gives the time the socket sat idle waiting on the
+ * 			server and the largest round-trip time sampled.
+ * Receives: 		The stream to write to and the record.
+ * Returns: 		nothing
+ * Pre-Conditions: 	record->event is LOG_TCP_SAMPLE or LOG_TCP_SUMMARY.
+ * Post-Conditions: 	The fields have been written to out.
+**********************************************************************************************/
+
+static void writeTcpFields(FILE* out, struct AccessLogRecord* record)
+{
+	struct TcpSample* tcp = &record->tcp;
+	if (record->event == LOG_TCP_SUMMARY)
+	{
+		fprintf(out, " bottleneck=%s", tcpBottleneckName((int)record->value));
+	}
+	fprintf(out, " elapsed_ms=%.1f rtt_us=%u rttvar_us=%u min_rtt_us=%u", tcp->elapsedUs / 1000.0,
+		tcp->rttUs, tcp->rttVarUs, tcp->minRttUs);
+	if (record->event == LOG_TCP_SUMMARY)
+	{
+		fprintf(out, " max_rtt_us=%u", tcp->maxRttUs);
+	}
+	fprintf(out, " cwnd=%u mss=%u delivery_rate_kbps=%llu", tcp->cwnd, tcp->mss,
+		(unsigned long long)tcp->deliveryRate * 8 / 1000);
+	if (record->event == LOG_TCP_SUMMARY)
+	{
+		uint64_t idleUs = (tcp->elapsedUs > tcp->busyUs) ? tcp->elapsedUs - tcp->busyUs : 0;
+		fprintf(out, " idle_ms=%.1f", idleUs / 1000.0);
+	}
+	fprintf(out, " rwnd_limited_ms=%.1f sndbuf_limited_ms=%.1f bytes_sent=%llu retrans_segs=%u bytes_retrans=%llu",
+		tcp->rwndLimitedUs / 1000.0, tcp->sndbufLimitedUs / 1000.0, (unsigned long long)tcp->bytesSent,
+		tcp->retransSegs, (unsigned long long)tcp->bytesRetrans);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	writeQuoted
+ * Description:		Writes text in double quotes, escaping quotes, backslashes, and
+ * 			non-printing characters, so that each record stays on one line and can
+ * 			be parsed unambiguously.
+ * Receives: 		The stream to write to and the text.
+ * Returns: 		nothing
+ * Pre-Conditions: 	text is null-terminated.
+ * Post-Conditions: 	The quoted text has been written to out.
+**********************************************************************************************/
+
+static void writeQuoted(FILE* out, const char* text)
+{
+	fputc('"', out);
+	for (const unsigned char* c = (const unsigned char*)text; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			fprintf(out, "\\%c", *c);
+		}
+		else if (*c < 0x20 || *c >= 0x7f)
+		{
+			fprintf(out, "\\x%02x", *c);
+		}
+		else
+		{
+			fputc(*c, out);
+		}
+	}
+	fputc('"', out);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		accessLog.h
+ * File Description: 	Header file for the access log. Threads handling requests never
+ * 			print: each writes fixed-size records describing what it did into a ring
+ * 			buffer of its own, and a background thread formats the records into the
+ * 			access log (standard output unless access_log is set in the configuration
+ * 			file), one line per record. If a ring is full because the log cannot be
+ * 			written fast enough, records are dropped and counted rather than waited on.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef ACCESS_LOG
+#define ACCESS_LOG
+
+#include <stdint.h>
+#include "tcpSampler.h"
+
+/* Global constants representing the number of records each thread's ring holds (a power of 2),
+ * the max lengths of the fields copied into a record (longer values are truncated), and how long
+ * the log thread sleeps after finding every ring empty. */
+#define LOG_RING_SIZE 512
+#define LOG_CLIENT_LEN 48
+#define LOG_PORT_LEN 8
+#define LOG_TEXT_LEN 120
+#define LOG_IDLE_SLEEP_MS 5
+
+/* Events recorded in the access log. */
+enum AccessLogEvent
+{
+	LOG_CONNECTION,			/* Connection accepted. */
+	LOG_BUSY_REJECTED,		/* Connection turned away because server was busy. */
+	LOG_INVALID_MESSAGE,		/* Initial message invalid; text is error sent. */
+	LOG_INVALID_REQUEST,		/* Request invalid; text is error sent. */
+	LOG_INVALID_DATA_RESPONSE,	/* Client's reply on data connection invalid; text is reply. */
+	LOG_FILE_REQUESTED,		/* File requested; text is filename. */
+	LOG_FILE_SENDING,		/* File opened and about to be sent; text is filename. */
+	LOG_FILE_RECEIVING,		/* Upload created and about to be received; text is filename,
+					 * value is size announced. */
+	LOG_LISTING_REQUESTED,		/* Listing requested; text is command. */
+	LOG_LISTING_SENDING,		/* Directory opened and listing about to be sent; text is command. */
+	LOG_ERROR_SENT,			/* Error sent in reply to request; text is error. */
+	LOG_TRANSFER_COMPLETE,		/* Request fulfilled; text is command, value is bytes transferred. */
+	LOG_TCP_SAMPLE,			/* Periodic TCP sample of file transfer; text is filename. */
+	LOG_TCP_SUMMARY,		/* TCP summary of file transfer; text is filename, value is
+					 * bottleneck (enum TcpBottleneck). */
+	LOG_TRANSFER_FAILED,		/* File transfer dropped after the data connection failed; text
+					 * is error. */
+	LOG_CLIENT_TIMEOUT,		/* Client did not send the message awaited in time; text is the
+					 * phase ("handshake" or "command"). */
+	LOG_STREAM_FAILED		/* Shared stream could not be started, so file is sent alone;
+					 * text is error. */
+};
+
+/* Definition of struct recording one event. */
+struct AccessLogRecord
+{
+	uint64_t timeNs;		/* Wall-clock time of event, in nanoseconds since the epoch. */
+	uint32_t event;			/* enum AccessLogEvent. */
+	uint32_t reserved;		/* Padding, always 0. */
+	uint64_t value;			/* Number associated with event, if any. */
+	char client[LOG_CLIENT_LEN];	/* Client nickname, or empty. */
+	char dataPort[LOG_PORT_LEN];	/* Client's data port, or empty. */
+	char text[LOG_TEXT_LEN];	/* Text associated with event, or empty. */
+	struct TcpSample tcp;		/* TCP sample or summary (TCP events only). */
+};
+
+/* Forward declaration of struct describing a session (see FTInfo.h). */
+struct FTInfo;
+
+/* Function prototypes. */
+void startAccessLog();
+void stopAccessLog();
+int setAccessLogFile(char* filename);
+void logEvent(enum AccessLogEvent event, struct FTInfo* myFT, const char* text, unsigned long long value);
+void logTcpEvent(enum AccessLogEvent event, struct FTInfo* myFT, const struct TcpSample* sample, int bottleneck);
+
+#endif
@@ -0,0 +1,276 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		bandwidthShaper.c
+ * File Description: 	Implementation of token bucket rate limiting of data transfers. The total
+ * 			server bandwidth is split evenly across all active transfers, and limits
+ * 			may be changed at any time by calling setShaperLimits.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include "bandwidthShaper.h"
+#include "serverConfig.h"
+
+/* Variables shared by all transfers. All are protected by shaperLock. Rates are in bytes per second,
+ * with 0 meaning unlimited. */
+static pthread_mutex_t shaperLock = PTHREAD_MUTEX_INITIALIZER;
+static struct ClientShare* clientShares = NULL;	/* List of client hosts with active transfers. */
+static int activeTransfers = 0;				/* Number of transfers in progress. */
+static double totalRateLimit = 0;			/* Bandwidth split across all active transfers. */
+static double clientRateLimit = 0;			/* Bandwidth shared by transfers to one host. */
+static double transferRateLimit = 0;			/* Bandwidth of any single transfer. */
+static double rateBurst = DEFAULT_RATE_BURST;		/* Maximum tokens any bucket may hold. */
+
+
+/***********************************************************************************************
+ * Function Name:	setShaperLimits
+ * Description:		Sets the rate limits and burst size applied to transfers. New limits take
+ * 			effect for transfers already in progress starting with their next send.
+ * Receives: 		Total, per-client, and per-transfer rates in bytes per second (0 for
+ * 			unlimited) and the bucket depth in bytes.
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	All subsequent calls to shapeTransfer use the new limits.
+**********************************************************************************************/
+
+void setShaperLimits(unsigned long long totalRate, unsigned long long clientRate,
+		unsigned long long transferRate, unsigned long long burst)
+{
+	pthread_mutex_lock(&shaperLock);
+	totalRateLimit = totalRate;
+	clientRateLimit = clientRate;
+	transferRateLimit = transferRate;
+	rateBurst = burst;
+	pthread_mutex_unlock(&shaperLock);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	initBucket
+ * Description:		Initializes a token bucket as full.
+ * Receives: 		A pointer to the bucket to initialize.
+ * Returns: 		nothing
+ * Pre-Conditions: 	shaperLock is held by the caller.
+ * Post-Conditions: 	The bucket holds rateBurst tokens and was last refilled now.
+**********************************************************************************************/
+
+static void initBucket(struct TokenBucket* bucket)
+{
+	bucket->tokens = rateBurst;
+	clock_gettime(CLOCK_MONOTONIC, &bucket->lastRefill);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	chargeBucket
+ * Description:		Adds the tokens earned at the given rate since the bucket was last
+ * 			refilled (up to rateBurst), then removes the tokens for bytes about to be
+ * 			sent. If the bucket is left in debt, computes how long the sender must
+ * 			wait for the debt to be repaid.
+ * Receives: 		A pointer to a bucket, the rate at which it refills, the current time,
+ * 			and the number of bytes about to be sent.
+ * Returns: 		The number of seconds the sender must wait before sending (0 if none).
+ * Pre-Conditions: 	shaperLock is held by the caller, and rate is positive.
+ * Post-Conditions: 	The bucket has been refilled up to now and charged for bytes.
+**********************************************************************************************/
+
+static double chargeBucket(struct TokenBucket* bucket, double rate, struct timespec* now, unsigned long long bytes)
+{
+	/* Refill bucket for time elapsed since last refill, capping it at rateBurst. */
+	double elapsed = (now->tv_sec - bucket->lastRefill.tv_sec) + (now->tv_nsec - bucket->lastRefill.tv_nsec) / 1e9;
+	bucket->tokens += elapsed * rate;
+	if (bucket->tokens > rateBurst)
+	{
+		bucket->tokens = rateBurst;
+	}
+	bucket->lastRefill = *now;
+
+	/* Charge bucket for bytes, returning time until any resulting debt is repaid. */
+	bucket->tokens -= bytes;
+	if (bucket->tokens < 0)
+	{
+		return -bucket->tokens / rate;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	beginShapedTransfer
+ * Description:		Registers a new transfer to the client host passed in, creating that
+ * 			host's shared entry if it has no other transfers in progress.
+ * Receives: 		The IPv4 address of the client host receiving the transfer.
+ * Returns: 		A newly-allocated struct TransferShaper pointer.
+ * Pre-Conditions: 	clientHost is a non-null string.
+ * Post-Conditions: 	The transfer is counted as active and shares bandwidth with all
+ * 			other active transfers until endShapedTransfer is called.
+**********************************************************************************************/
+
+struct TransferShaper* beginShapedTransfer(char* clientHost)
+{
+	/* Allocate memory for new struct TransferShaper. */
+	struct TransferShaper* shaper = (struct TransferShaper*)malloc(sizeof(struct TransferShaper));
+
+	pthread_mutex_lock(&shaperLock);
+
+	/* Find the entry for clientHost in list of active client hosts. */
+	struct ClientShare* client = clientShares;
+	while (client != NULL && strcmp(client->clientHost, clientHost) != 0)
+	{
+		client = client->next;
+	}
+
+	/* If client host has no transfers in progress, create an entry for it at the front of the list. */
+	if (client == NULL)
+	{
+		client = (struct ClientShare*)malloc(sizeof(struct ClientShare));
+		memset(client, 0, sizeof(struct ClientShare));
+		strncpy(client->clientHost, clientHost, INET_ADDRSTRLEN - 1);
+		initBucket(&client->bucket);
+		client->next = clientShares;
+		clientShares = client;
+	}
+
+	/* Count transfer as active for both its client host and the server as a whole. */
+	client->activeTransfers++;
+	activeTransfers++;
+	shaper->client = client;
+	initBucket(&shaper->bucket);
+
+	pthread_mutex_unlock(&shaperLock);
+
+	/* Return pointer to newly-allocated struct to calling function. */
+	return shaper;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	shapeTransfer
+ * Description:		Charges the transfer's own bucket and its client host's bucket for bytes
+ * 			about to be sent, then sleeps until both buckets are out of debt. The
+ * 			transfer's own bucket refills at the lesser of the per-transfer limit and
+ * 			its fair share (the total limit divided by the number of active transfers).
+ * Receives: 		A pointer to a struct TransferShaper and the number of bytes about to
+ * 			be sent.
+ * Returns: 		nothing
+ * Pre-Conditions: 	shaper was returned by beginShapedTransfer and has not been ended.
+ * Post-Conditions: 	Sending bytes now keeps the transfer within all limits in effect.
+**********************************************************************************************/
+
+void shapeTransfer(struct TransferShaper* shaper, unsigned long long bytes)
+{
+	/* Get the current time once for refilling both buckets. */
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	pthread_mutex_lock(&shaperLock);
+
+	/* Determine rate of this transfer's own bucket: the smaller of its own limit and its fair share
+	 * of the total limit, ignoring whichever of those is unlimited. */
+	double transferRate = transferRateLimit;
+	if (totalRateLimit > 0)
+	{
+		double fairShare = totalRateLimit / activeTransfers;
+		if (transferRate == 0 || fairShare < transferRate)
+		{
+			transferRate = fairShare;
+		}
+	}
+
+	/* Charge each limited bucket, keeping the longer of the two waits. Unlimited buckets are simply
+	 * marked as refilled now so that a limit set later does not credit time spent unlimited. */
+	double waitSeconds = 0;
+	if (transferRate > 0)
+	{
+		waitSeconds = chargeBucket(&shaper->bucket, transferRate, &now, bytes);
+	}
+	else
+	{
+		shaper->bucket.lastRefill = now;
+	}
+	if (clientRateLimit > 0)
+	{
+		double clientWait = chargeBucket(&shaper->client->bucket, clientRateLimit, &now, bytes);
+		if (clientWait > waitSeconds)
+		{
+			waitSeconds = clientWait;
+		}
+	}
+	else
+	{
+		shaper->client->bucket.lastRefill = now;
+	}
+
+	pthread_mutex_unlock(&shaperLock);
+
+	/* Sleep until the buckets are out of debt, if necessary. */
+	if (waitSeconds > 0)
+	{
+		struct timespec sleepTime;
+		sleepTime.tv_sec = (time_t)waitSeconds;
+		sleepTime.tv_nsec = (long)((waitSeconds - sleepTime.tv_sec) * 1e9);
+		nanosleep(&sleepTime, NULL);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	endShapedTransfer
+ * Description:		Unregisters a transfer, freeing its client host's entry if it was the
+ * 			host's last transfer in progress, and frees the struct TransferShaper.
+ * Receives: 		A pointer to a struct TransferShaper.
+ * Returns: 		nothing
+ * Pre-Conditions: 	shaper was returned by beginShapedTransfer and has not been ended.
+ * Post-Conditions: 	The transfer no longer counts against any limit, and shaper has been freed.
+**********************************************************************************************/
+
+void endShapedTransfer(struct TransferShaper* shaper)
+{
+	pthread_mutex_lock(&shaperLock);
+
+	/* Count transfer as no longer active. */
+	activeTransfers--;
+	struct ClientShare* client = shaper->client;
+	client->activeTransfers--;
+
+	/* If that was the client host's last active transfer, unlink its entry from the list and free it. */
+	if (client->activeTransfers == 0)
+	{
+		struct ClientShare** link = &clientShares;
+		while (*link != client)
+		{
+			link = &(*link)->next;
+		}
+		*link = client->next;
+		free(client);
+	}
+
+	pthread_mutex_unlock(&shaperLock);
+
+	/* Free shaper itself. */
+	free(shaper);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		bandwidthShaper.h
+ * File Description: 	Header file for token bucket rate limiting of data transfers. Each transfer
+ * 			is limited by its own bucket, by a bucket shared with every other transfer
+ * 			to the same client host, and by a fair share of the total server bandwidth.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef BANDWIDTH_SHAPER
+#define BANDWIDTH_SHAPER
+
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Definition of struct representing a token bucket. Tokens are bytes that may be sent; the bucket
+ * refills at the current rate up to a depth of burst bytes. tokens may go negative when a send larger
+ * than the available tokens is admitted, in which case the sender waits until the debt is repaid. */
+struct TokenBucket
+{
+	double tokens;			/* Bytes currently available to send. */
+	struct timespec lastRefill;	/* Time at which tokens was last brought up to date. */
+};
+
+/* Definition of struct tracking bandwidth used by all transfers to a single client host. */
+struct ClientShare
+{
+	char clientHost[INET_ADDRSTRLEN];	/* IPv4 address of client host. */
+	int activeTransfers;			/* Number of transfers to this host in progress. */
+	struct TokenBucket bucket;		/* Bucket limiting all transfers to this host together. */
+	struct ClientShare* next;		/* Next entry in list of active client hosts. */
+};
+
+/* Definition of struct tracking bandwidth used by a single transfer. */
+struct TransferShaper
+{
+	struct ClientShare* client;		/* Share of the client host this transfer is sent to. */
+	struct TokenBucket bucket;		/* Bucket limiting this transfer alone. */
+};
+
+/* Function prototypes. */
+void setShaperLimits(unsigned long long totalRate, unsigned long long clientRate,
+		unsigned long long transferRate, unsigned long long burst);
+struct TransferShaper* beginShapedTransfer(char* clientHost);
+void shapeTransfer(struct TransferShaper* shaper, unsigned long long bytes);
+void endShapedTransfer(struct TransferShaper* shaper);
+
+#endif
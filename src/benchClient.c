@@ -0,0 +1,743 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		benchClient.c
+ * File Description: 	Implementation of the protocol client used by ftbench. See benchClient.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include "benchClient.h"
+
+/* Messages exchanged with ftserver (see manageConnections.c). */
+#define CONNECTION_ESTABLISHED "FTSERVER CONNECTION ESTABLISHED"
+#define DATA_CONNECTION_INITIALIZATION "FTSERVER DATA CONNECTION INITIALIZATION"
+#define DATA_CONNECTION_ACCEPTED "FTSERVER DATA CONNECTION ACCEPTED"
+#define SUCCESS_PREFIX "SUCCESS! "
+#define BUSY_PREFIX "SERVER BUSY, retry after "
+
+/* Static function prototypes. */
+static int sendFrame(struct FrameReader* reader, char* message);
+static int sendAll(struct FrameReader* reader, char* data, int dataLen);
+static void initReader(struct FrameReader* reader, int socketFD);
+static int startReaderTls(struct BenchClient* client, struct FrameReader* reader);
+static int readerPending(struct FrameReader* reader);
+static int fillReader(struct FrameReader* reader);
+static long recvFrameLength(struct FrameReader* reader);
+static long recvFrame(struct FrameReader* reader, char* dest, int destSize);
+static int waitReadable(int socketFD);
+static enum BenchResult failRequest(struct BenchClient* client, int dataSocketFD, char* what);
+
+
+/***********************************************************************************************
+ * Function Name:	initBenchClient
+ * Description:		Resolves the server's address and opens the listening socket on which
+ * 			the server will connect for data. The socket is bound to a port chosen
+ * 			by the kernel and reused for every request made by this client. Also
+ * 			ignores SIGPIPE, so that sending to a server that has closed the
+ * 			connection fails the request instead of killing the process.
+ * Receives: 		The client to initialize and the server's host and port.
+ * Returns: 		0 on success; -1 on failure (with an error message printed).
+ * Pre-Conditions: 	client has been allocated.
+ * Post-Conditions: 	If 0 is returned, client is ready for runBenchRequest.
+**********************************************************************************************/
+
+int initBenchClient(struct BenchClient* client, char* serverHost, char* serverPort)
+{
+	memset(client, 0, sizeof(struct BenchClient));
+	client->listeningSocketFD = -1;
+	signal(SIGPIPE, SIG_IGN);
+
+	/* Resolve server address. */
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	struct addrinfo* addrList = NULL;
+	int status = getaddrinfo(serverHost, serverPort, &hints, &addrList);
+	if (status != 0)
+	{
+		fprintf(stderr, "ADDRESS ERROR: %s\n", gai_strerror(status));
+		return -1;
+	}
+	memcpy(&client->serverAddr, addrList->ai_addr, addrList->ai_addrlen);
+	client->serverAddrLen = addrList->ai_addrlen;
+	freeaddrinfo(addrList);
+
+	/* Open listening socket on a kernel-chosen port, and record port to send to server. */
+	struct sockaddr_in listenAddr;
+	memset(&listenAddr, 0, sizeof(listenAddr));
+	listenAddr.sin_family = AF_INET;
+	listenAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+	listenAddr.sin_port = 0;
+	socklen_t addrLen = sizeof(listenAddr);
+	client->listeningSocketFD = socket(AF_INET, SOCK_STREAM, 0);
+	if (client->listeningSocketFD < 0
+		|| bind(client->listeningSocketFD, (struct sockaddr*)&listenAddr, sizeof(listenAddr)) < 0
+		|| listen(client->listeningSocketFD, 4) < 0
+		|| getsockname(client->listeningSocketFD, (struct sockaddr*)&listenAddr, &addrLen) < 0)
+	{
+		perror("LISTEN ERROR");
+		closeBenchClient(client);
+		return -1;
+	}
+	snprintf(client->dataPort, sizeof(client->dataPort), "%d", ntohs(listenAddr.sin_port));
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	enableBenchTls
+ * Description:		Makes the client encrypt every connection of its requests with TLS,
+ * 			trusting the certificates in caFile and requiring the server's certificate
+ * 			to match serverHost.
+ * Receives: 		A client initialized by initBenchClient, the server's host, and the file
+ * 			of trusted certificates.
+ * Returns: 		0 on success; -1 on failure (with an error message printed), including
+ * 			when ftbench was built without TLS support.
+ * Pre-Conditions: 	No request is in progress.
+ * Post-Conditions: 	If 0 is returned, runBenchRequest performs a TLS handshake on each
+ * 			connection before using it.
+**********************************************************************************************/
+
+int enableBenchTls(struct BenchClient* client, char* serverHost, char* caFile)
+{
+#ifdef FT_TLS
+	client->tlsContext = SSL_CTX_new(TLS_client_method());
+	if (client->tlsContext == NULL || SSL_CTX_load_verify_locations(client->tlsContext, caFile, NULL) != 1)
+	{
+		fprintf(stderr, "TLS ERROR: could not load trusted certificates from %s\n", caFile);
+		return -1;
+	}
+	SSL_CTX_set_verify(client->tlsContext, SSL_VERIFY_PEER, NULL);
+	SSL_CTX_set_options(client->tlsContext, SSL_OP_IGNORE_UNEXPECTED_EOF);
+	snprintf(client->tlsHost, sizeof(client->tlsHost), "%s", serverHost);
+	return 0;
+#else
+	fprintf(stderr, "TLS ERROR: built without TLS support (make TLS=1)\n");
+	return -1;
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	closeBenchClient
+ * Description:		Closes the client's listening socket and frees its TLS sessions and
+ * 			context, if any.
+ * Receives: 		A client initialized by initBenchClient.
+ * Returns: 		nothing
+ * Pre-Conditions: 	No request is in progress.
+ * Post-Conditions: 	The listening socket has been closed.
+**********************************************************************************************/
+
+void closeBenchClient(struct BenchClient* client)
+{
+	if (client->listeningSocketFD >= 0)
+	{
+		close(client->listeningSocketFD);
+		client->listeningSocketFD = -1;
+	}
+#ifdef FT_TLS
+	initReader(&client->controlReader, -1);
+	initReader(&client->dataReader, -1);
+	SSL_CTX_free(client->tlsContext);
+	client->tlsContext = NULL;
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	runBenchRequest
+ * Description:		Performs one complete request the way ftclient.py does: connects to the
+ * 			server, sends DATA_PORT, sends the request, accepts and validates the
+ * 			data connection, and receives data until the server's success message
+ * 			has arrived along with every byte it reports. Data is counted but not
+ * 			stored. An upload ("-p <filename> <size>") instead sends size bytes of
+ * 			filler on the data connection and then receives the success message.
+ * 			If the server is busy, retries after the delay it suggests, doubling the
+ * 			delay on each retry.
+ * Receives: 		The client and the request to send (e.g. "-g file.txt").
+ * Returns: 		The outcome of the request. client->bytesReceived, client->bytesSent,
+ * 			and client->busyRetries describe the request; client->lastError
+ * 			describes any failure.
+ * Pre-Conditions: 	client was initialized by initBenchClient.
+ * Post-Conditions: 	All sockets opened for the request have been closed.
+**********************************************************************************************/
+
+enum BenchResult runBenchRequest(struct BenchClient* client, char* request)
+{
+	client->bytesReceived = 0;
+	client->bytesSent = 0;
+	client->busyRetries = 0;
+	client->lastError[0] = '\0';
+	char controlMessage[BENCH_MAX_CONTROL_MESSAGE];
+	long long uploadSize = -1;
+	if (sscanf(request, "-p %*s %lld", &uploadSize) != 1)
+	{
+		uploadSize = -1;
+	}
+
+	/* Connect and send DATA_PORT, retrying while the server reports it is busy. */
+	int controlSocketFD = -1;
+	while (1)
+	{
+		controlSocketFD = socket(AF_INET, SOCK_STREAM, 0);
+		if (controlSocketFD < 0
+			|| connect(controlSocketFD, (struct sockaddr*)&client->serverAddr, client->serverAddrLen) < 0)
+		{
+			snprintf(client->lastError, sizeof(client->lastError), "connect: %s", strerror(errno));
+			if (controlSocketFD >= 0)
+			{
+				close(controlSocketFD);
+			}
+			return BENCH_FAILED;
+		}
+		initReader(&client->controlReader, controlSocketFD);
+
+		/* Perform TLS handshake (if enabled), send data port, and receive greeting (or busy message). */
+		char dataPortMessage[32];
+		snprintf(dataPortMessage, sizeof(dataPortMessage), "DATA_PORT: %s", client->dataPort);
+		if (startReaderTls(client, &client->controlReader) < 0
+			|| sendFrame(&client->controlReader, dataPortMessage) < 0
+			|| recvFrame(&client->controlReader, controlMessage, sizeof(controlMessage)) < 0)
+		{
+			close(controlSocketFD);
+			return failRequest(client, -1, "handshake");
+		}
+
+		/* If server is busy, close connection and wait before retrying, giving up after
+		 * BENCH_MAX_BUSY_RETRIES retries. */
+		if (strncmp(controlMessage, BUSY_PREFIX, strlen(BUSY_PREFIX)) == 0)
+		{
+			close(controlSocketFD);
+			if (client->busyRetries == BENCH_MAX_BUSY_RETRIES)
+			{
+				snprintf(client->lastError, sizeof(client->lastError), "%s", controlMessage);
+				return BENCH_BUSY;
+			}
+			long retryMs = atol(controlMessage + strlen(BUSY_PREFIX)) << (client->busyRetries < 6 ? client->busyRetries : 6);
+			struct timespec delay = { retryMs / 1000, (retryMs % 1000) * 1000000 };
+			nanosleep(&delay, NULL);
+			client->busyRetries++;
+			continue;
+		}
+		break;
+	}
+
+	/* Check greeting, then send request. */
+	if (strcmp(controlMessage, CONNECTION_ESTABLISHED) != 0)
+	{
+		snprintf(client->lastError, sizeof(client->lastError), "unexpected greeting: %.400s", controlMessage);
+		close(controlSocketFD);
+		return BENCH_FAILED;
+	}
+	if (sendFrame(&client->controlReader, request) < 0)
+	{
+		close(controlSocketFD);
+		return failRequest(client, -1, "send request");
+	}
+
+	/* Wait for either the data connection or an error message on the control connection. */
+	struct pollfd pollInfo[2];
+	pollInfo[0].fd = controlSocketFD;
+	pollInfo[0].events = POLLIN;
+	pollInfo[1].fd = client->listeningSocketFD;
+	pollInfo[1].events = POLLIN;
+	if (poll(pollInfo, 2, BENCH_IO_TIMEOUT_MS) <= 0)
+	{
+		close(controlSocketFD);
+		return failRequest(client, -1, "waiting for data connection");
+	}
+	if (!(pollInfo[1].revents & POLLIN))
+	{
+		enum BenchResult result = BENCH_SERVER_ERROR;
+		if (recvFrame(&client->controlReader, client->lastError, sizeof(client->lastError)) < 0)
+		{
+			result = failRequest(client, -1, "receiving error message");
+		}
+		close(controlSocketFD);
+		return result;
+	}
+
+	/* Accept and validate data connection. */
+	int dataSocketFD = accept(client->listeningSocketFD, NULL, NULL);
+	if (dataSocketFD < 0)
+	{
+		close(controlSocketFD);
+		return failRequest(client, -1, "accept");
+	}
+	initReader(&client->dataReader, dataSocketFD);
+	char validationMessage[BENCH_MAX_CONTROL_MESSAGE];
+	if (startReaderTls(client, &client->dataReader) < 0
+		|| recvFrame(&client->dataReader, validationMessage, sizeof(validationMessage)) < 0
+		|| strcmp(validationMessage, DATA_CONNECTION_INITIALIZATION) != 0
+		|| sendFrame(&client->dataReader, DATA_CONNECTION_ACCEPTED) < 0)
+	{
+		close(controlSocketFD);
+		return failRequest(client, dataSocketFD, "data connection validation");
+	}
+
+	/* If request is an upload, send the size announced (giving up on a server that stops reading for
+	 * BENCH_IO_TIMEOUT_MS), then receive the success message, or the error message that ended the upload
+	 * (in which case the server may have closed the data connection before every byte was sent). */
+	if (uploadSize >= 0)
+	{
+		struct timeval sendTimeout = { BENCH_IO_TIMEOUT_MS / 1000, (BENCH_IO_TIMEOUT_MS % 1000) * 1000 };
+		setsockopt(dataSocketFD, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+		char filler[BENCH_READ_BUFFER];
+		memset(filler, 'u', sizeof(filler));
+		while ((long long)client->bytesSent < uploadSize)
+		{
+			int chunk = (uploadSize - client->bytesSent < sizeof(filler)) ? (int)(uploadSize - client->bytesSent) : (int)sizeof(filler);
+			if (sendAll(&client->dataReader, filler, chunk) < 0)
+			{
+				break;
+			}
+			client->bytesSent += chunk;
+		}
+		enum BenchResult result = BENCH_OK;
+		if (recvFrame(&client->controlReader, controlMessage, sizeof(controlMessage)) < 0)
+		{
+			result = failRequest(client, -1, ((long long)client->bytesSent < uploadSize) ? "sending data"
+				: "receiving completion message");
+		}
+		else if (strncmp(controlMessage, SUCCESS_PREFIX, strlen(SUCCESS_PREFIX)) != 0)
+		{
+			snprintf(client->lastError, sizeof(client->lastError), "%s", controlMessage);
+			result = BENCH_SERVER_ERROR;
+		}
+		close(controlSocketFD);
+		close(dataSocketFD);
+		return result;
+	}
+
+	/* Receive data until the success message has arrived and every byte it reports has been
+	 * received. Data already buffered (or already decrypted by TLS) is consumed before polling again. */
+	long long bytesExpected = -1;
+	pollInfo[1].fd = dataSocketFD;
+	while (bytesExpected < 0 || (long long)client->bytesReceived < bytesExpected)
+	{
+		if (client->dataReader.end == client->dataReader.start && readerPending(&client->dataReader)
+			&& fillReader(&client->dataReader) <= 0)
+		{
+			close(controlSocketFD);
+			return failRequest(client, dataSocketFD, "receiving data");
+		}
+		if (client->dataReader.end > client->dataReader.start)
+		{
+			long dataLen = recvFrame(&client->dataReader, NULL, 0);
+			if (dataLen < 0)
+			{
+				close(controlSocketFD);
+				return failRequest(client, dataSocketFD, "receiving data");
+			}
+			client->bytesReceived += dataLen;
+			continue;
+		}
+
+		if (poll(pollInfo, 2, BENCH_IO_TIMEOUT_MS) <= 0)
+		{
+			close(controlSocketFD);
+			return failRequest(client, dataSocketFD, "waiting for data");
+		}
+
+		/* A control message is either the success message or an error. */
+		if (pollInfo[0].revents & (POLLIN | POLLHUP | POLLERR))
+		{
+			if (recvFrame(&client->controlReader, controlMessage, sizeof(controlMessage)) < 0)
+			{
+				close(controlSocketFD);
+				return failRequest(client, dataSocketFD, "receiving completion message");
+			}
+			if (strncmp(controlMessage, SUCCESS_PREFIX, strlen(SUCCESS_PREFIX)) != 0)
+			{
+				snprintf(client->lastError, sizeof(client->lastError), "%s", controlMessage);
+				close(controlSocketFD);
+				close(dataSocketFD);
+				return BENCH_SERVER_ERROR;
+			}
+			bytesExpected = atoll(controlMessage + strlen(SUCCESS_PREFIX));
+			pollInfo[0].fd = -1;
+		}
+		if ((pollInfo[1].revents & (POLLIN | POLLHUP | POLLERR)) && fillReader(&client->dataReader) <= 0)
+		{
+			close(controlSocketFD);
+			return failRequest(client, dataSocketFD, "receiving data");
+		}
+	}
+
+	/* Close control connection first, which tells the server the client is done; then close data. */
+	close(controlSocketFD);
+	close(dataSocketFD);
+	return BENCH_OK;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	failRequest
+ * Description:		Records why a request failed and closes its data socket (if open).
+ * Receives: 		The client, the data socket (or -1), and the step that failed.
+ * Returns: 		BENCH_FAILED
+ * Pre-Conditions: 	errno describes the failure, or is 0 if the server closed the connection.
+ * Post-Conditions: 	client->lastError describes the failure.
+**********************************************************************************************/
+
+static enum BenchResult failRequest(struct BenchClient* client, int dataSocketFD, char* what)
+{
+	snprintf(client->lastError, sizeof(client->lastError), "%s: %s", what,
+		errno != 0 ? strerror(errno) : "connection closed by server");
+	if (dataSocketFD >= 0)
+	{
+		close(dataSocketFD);
+	}
+	return BENCH_FAILED;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendFrame
+ * Description:		Sends a message prefixed with its length and '@', as ftserver expects,
+ * 			in a single send so that the prefix is never held back waiting for an
+ * 			acknowledgement.
+ * Receives: 		The reader of a connected socket and the message.
+ * Returns: 		0 on success; -1 on failure.
+ * Pre-Conditions: 	message is shorter than BENCH_MAX_CONTROL_MESSAGE.
+ * Post-Conditions: 	The whole frame has been sent.
+**********************************************************************************************/
+
+static int sendFrame(struct FrameReader* reader, char* message)
+{
+	char frame[BENCH_MAX_CONTROL_MESSAGE + 16];
+	int frameLen = snprintf(frame, sizeof(frame), "%d@%s", (int)strlen(message), message);
+	return sendAll(reader, frame, frameLen);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendAll
+ * Description:		Sends every byte of a buffer on a reader's socket, through its TLS session
+ * 			if it has one.
+ * Receives: 		The reader of a connected socket, the data, and its length.
+ * Returns: 		0 on success; -1 on failure.
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	Unless -1 is returned, all dataLen bytes have been sent.
+**********************************************************************************************/
+
+static int sendAll(struct FrameReader* reader, char* data, int dataLen)
+{
+#ifdef FT_TLS
+	if (reader->ssl != NULL)
+	{
+		size_t written = 0;
+		return (SSL_write_ex(reader->ssl, data, dataLen, &written) == 1) ? 0 : -1;
+	}
+#endif
+	int sent = 0;
+	while (sent < dataLen)
+	{
+		ssize_t charsSent = send(reader->socketFD, data + sent, dataLen - sent, MSG_NOSIGNAL);
+		if (charsSent < 0)
+		{
+			return -1;
+		}
+		sent += charsSent;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	initReader
+ * Description:		Empties a reader and attaches it to a socket, freeing the TLS session of
+ * 			the socket it was last attached to (which has already been closed).
+ * Receives: 		A reader and the socket to read from.
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected socket.
+ * Post-Conditions: 	reader holds no bytes and reads from socketFD, without TLS.
+**********************************************************************************************/
+
+static void initReader(struct FrameReader* reader, int socketFD)
+{
+	reader->socketFD = socketFD;
+	reader->start = 0;
+	reader->end = 0;
+#ifdef FT_TLS
+	SSL_free(reader->ssl);
+	reader->ssl = NULL;
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startReaderTls
+ * Description:		If the client has TLS enabled, performs the client side of a TLS handshake
+ * 			on a reader's socket, verifying the server's certificate.
+ * Receives: 		The client and a reader just attached to a connected socket.
+ * Returns: 		0 on success (or if TLS is off); -1 on failure (errno EPROTO).
+ * Pre-Conditions: 	Nothing has been sent or received on the reader's socket.
+ * Post-Conditions: 	If 0 is returned, the reader's socket is ready for frames.
+**********************************************************************************************/
+
+static int startReaderTls(struct BenchClient* client, struct FrameReader* reader)
+{
+#ifdef FT_TLS
+	if (client->tlsContext == NULL)
+	{
+		return 0;
+	}
+	reader->ssl = SSL_new(client->tlsContext);
+	if (reader->ssl == NULL || SSL_set_fd(reader->ssl, reader->socketFD) != 1
+		|| SSL_set1_host(reader->ssl, client->tlsHost) != 1 || SSL_connect(reader->ssl) != 1)
+	{
+		errno = EPROTO;
+		return -1;
+	}
+#endif
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	readerPending
+ * Description:		Reports whether a reader's TLS session holds data already decrypted, which
+ * 			poll cannot see.
+ * Receives: 		A reader.
+ * Returns: 		True if fillReader can receive without waiting.
+**********************************************************************************************/
+
+static int readerPending(struct FrameReader* reader)
+{
+#ifdef FT_TLS
+	return reader->ssl != NULL && SSL_pending(reader->ssl) > 0;
+#else
+	return 0;
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	fillReader
+ * Description:		Waits for a reader's socket to become readable and receives as many
+ * 			bytes as fit after those not yet consumed.
+ * Receives: 		A reader.
+ * Returns: 		The number of bytes received, 0 if the connection was closed, or -1 on
+ * 			error or timeout (with errno set).
+ * Pre-Conditions: 	reader has room for at least one more byte.
+ * Post-Conditions: 	Bytes received follow those not yet consumed.
+**********************************************************************************************/
+
+static int fillReader(struct FrameReader* reader)
+{
+	/* Move unconsumed bytes to front of buffer to make room. */
+	if (reader->start > 0)
+	{
+		memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+		reader->end -= reader->start;
+		reader->start = 0;
+	}
+
+	if (!readerPending(reader) && waitReadable(reader->socketFD) < 0)
+	{
+		return -1;
+	}
+	errno = 0;
+#ifdef FT_TLS
+	if (reader->ssl != NULL)
+	{
+		size_t charsRead = 0;
+		int result = SSL_read_ex(reader->ssl, reader->buffer + reader->end, BENCH_READ_BUFFER - reader->end, &charsRead);
+		if (result != 1)
+		{
+			int error = SSL_get_error(reader->ssl, result);
+			if (error == SSL_ERROR_ZERO_RETURN)
+			{
+				return 0;
+			}
+			errno = (error == SSL_ERROR_SYSCALL && errno != 0) ? errno : EPROTO;
+			return -1;
+		}
+		reader->end += charsRead;
+		return (int)charsRead;
+	}
+#endif
+	ssize_t charsRead = recv(reader->socketFD, reader->buffer + reader->end, BENCH_READ_BUFFER - reader->end, 0);
+	if (charsRead > 0)
+	{
+		reader->end += charsRead;
+	}
+	return (int)charsRead;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvFrameLength
+ * Description:		Reads the "<length>@" prefix of the next message.
+ * Receives: 		A reader.
+ * Returns: 		The length of the message, or -1 on error.
+ * Pre-Conditions: 	reader is attached to a connected socket.
+ * Post-Conditions: 	The prefix has been consumed from reader.
+**********************************************************************************************/
+
+static long recvFrameLength(struct FrameReader* reader)
+{
+	long length = 0;
+	int digits = 0;
+	while (1)
+	{
+		if (reader->start == reader->end && fillReader(reader) <= 0)
+		{
+			return -1;
+		}
+		char c = reader->buffer[reader->start++];
+		if (c == '@' && digits > 0)
+		{
+			return length;
+		}
+		if (c < '0' || c > '9' || ++digits > 10)
+		{
+			errno = EPROTO;
+			return -1;
+		}
+		length = length * 10 + (c - '0');
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvFrame
+ * Description:		Reads a whole message, copying it (null-terminated and truncated to
+ * 			fit) into dest, or discarding it if dest is NULL.
+ * Receives: 		A reader, a destination buffer (or NULL), and the buffer's size.
+ * Returns: 		The length of the message, or -1 on error.
+ * Pre-Conditions: 	reader is attached to a connected socket.
+ * Post-Conditions: 	The message has been consumed from reader.
+**********************************************************************************************/
+
+static long recvFrame(struct FrameReader* reader, char* dest, int destSize)
+{
+	long length = recvFrameLength(reader);
+	if (length < 0)
+	{
+		return -1;
+	}
+
+	/* Consume payload from buffer, refilling as needed, copying what fits into dest. */
+	long remaining = length;
+	long copied = 0;
+	while (remaining > 0)
+	{
+		if (reader->start == reader->end && fillReader(reader) <= 0)
+		{
+			return -1;
+		}
+		long available = reader->end - reader->start;
+		long chunk = (available < remaining) ? available : remaining;
+		if (dest != NULL && copied < destSize - 1)
+		{
+			long toCopy = (chunk < destSize - 1 - copied) ? chunk : destSize - 1 - copied;
+			memcpy(dest + copied, reader->buffer + reader->start, toCopy);
+			copied += toCopy;
+		}
+		reader->start += chunk;
+		remaining -= chunk;
+	}
+	if (dest != NULL)
+	{
+		dest[copied] = '\0';
+	}
+	return length;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	waitReadable
+ * Description:		Waits up to BENCH_IO_TIMEOUT_MS for a socket to become readable.
+ * Receives: 		A socket file descriptor.
+ * Returns: 		0 if readable; -1 on timeout (errno ETIMEDOUT) or error.
+ * Pre-Conditions: 	socketFD is open.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+static int waitReadable(int socketFD)
+{
+	struct pollfd pollInfo;
+	pollInfo.fd = socketFD;
+	pollInfo.events = POLLIN;
+	int pollResult = poll(&pollInfo, 1, BENCH_IO_TIMEOUT_MS);
+	if (pollResult == 0)
+	{
+		errno = ETIMEDOUT;
+	}
+	return (pollResult > 0) ? 0 : -1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	nowNs
+ * Description:		Reads the monotonic clock.
+ * Receives: 		nothing
+ * Returns: 		The current CLOCK_MONOTONIC time in nanoseconds.
+**********************************************************************************************/
+
+unsigned long long nowNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	compareLatencies
+ * Description:		qsort comparison function ordering latencies from least to greatest.
+ * Receives: 		Pointers to two unsigned long long latencies.
+ * Returns: 		Negative, zero, or positive as a is less than, equal to, or greater than b.
+**********************************************************************************************/
+
+int compareLatencies(const void* a, const void* b)
+{
+	unsigned long long first = *(const unsigned long long*)a;
+	unsigned long long second = *(const unsigned long long*)b;
+	return (first > second) - (first < second);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	percentileOf
+ * Description:		Finds the value at or below which a given percentage of sorted values fall.
+ * Receives: 		Sorted latencies, their count, and a percentile (0 to 100).
+ * Returns: 		The percentile, or 0 if count is 0.
+**********************************************************************************************/
+
+unsigned long long percentileOf(unsigned long long* sorted, unsigned long long count, double percentile)
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+	unsigned long long rank = (unsigned long long)(percentile / 100.0 * count + 0.999999);
+	return sorted[(rank > 0 ? rank : 1) - 1];
+}
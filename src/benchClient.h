@@ -0,0 +1,125 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		benchClient.h
+ * File Description: 	Header file for the protocol client used by ftbench. A struct BenchClient
+ * 			plays the part of ftclient.py for one virtual client: it keeps a listening
+ * 			socket for data connections and performs complete requests (DATA_PORT
+ * 			handshake, request, data connection validation, and receipt of all data,
+ * 			or sending of all data for an upload).
+ * 			If TLS is enabled (built with make TLS=1), both connections are encrypted,
+ * 			with the client as the TLS client on each. Also declares the timing and
+ * 			percentile helpers shared by ftbench and ftreplay.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef BENCH_CLIENT
+#define BENCH_CLIENT
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef FT_TLS
+#include <openssl/ssl.h>
+#endif
+
+/* Global constant representing size of the buffer each socket is read through. */
+#define BENCH_READ_BUFFER 65536
+
+/* Global constant representing max length of a control message kept by the client. */
+#define BENCH_MAX_CONTROL_MESSAGE 512
+
+/* Global constant representing milliseconds the client waits for the server at any step
+ * before counting the request as failed. */
+#define BENCH_IO_TIMEOUT_MS 30000
+
+/* Global constant representing most times a request is retried after the server reports
+ * that it is busy. */
+#define BENCH_MAX_BUSY_RETRIES 20
+
+/* Possible outcomes of a request. */
+enum BenchResult
+{
+	BENCH_OK,		/* All data received and server reported success. */
+	BENCH_SERVER_ERROR,	/* Server sent an error message instead of the data. */
+	BENCH_BUSY,		/* Server was still busy after BENCH_MAX_BUSY_RETRIES retries. */
+	BENCH_FAILED		/* Connection, protocol, or timeout error. */
+};
+
+/* Definition of struct buffering reads from one socket, so that message lengths (sent one
+ * digit at a time in front of each message) do not cost a recv call per byte. */
+struct FrameReader
+{
+	int socketFD;				/* Socket read from. */
+	int start;				/* Index of first unread byte in buffer. */
+	int end;				/* Index after last byte read into buffer. */
+#ifdef FT_TLS
+	SSL* ssl;				/* TLS session of socket, or NULL. */
+#endif
+	char buffer[BENCH_READ_BUFFER];		/* Bytes received but not yet consumed. */
+};
+
+/* Definition of struct describing one virtual client. See below for variable descriptions. */
+struct BenchClient
+{
+	struct sockaddr_storage serverAddr;	/* Address of ftserver. */
+	socklen_t serverAddrLen;		/* Length of serverAddr. */
+	int listeningSocketFD;			/* Socket on which server connects for data. */
+	char dataPort[8];			/* Port of listeningSocketFD, as sent to server. */
+	struct FrameReader controlReader;	/* Reader for control connection of current request. */
+	struct FrameReader dataReader;		/* Reader for data connection of current request. */
+	unsigned long long bytesReceived;	/* Data bytes received by the most recent request. */
+	unsigned long long bytesSent;		/* Data bytes sent (uploaded) by the most recent request. */
+	int busyRetries;			/* Busy replies received by the most recent request. */
+	char lastError[BENCH_MAX_CONTROL_MESSAGE];	/* Description of most recent failure. */
+#ifdef FT_TLS
+	SSL_CTX* tlsContext;			/* Context of TLS sessions, or NULL if TLS is off. */
+	char tlsHost[256];			/* Name the server's certificate must match. */
+#endif
+};
+
+/* Function prototypes. */
+int initBenchClient(struct BenchClient* client, char* serverHost, char* serverPort);
+int enableBenchTls(struct BenchClient* client, char* serverHost, char* caFile);
+void closeBenchClient(struct BenchClient* client);
+enum BenchResult runBenchRequest(struct BenchClient* client, char* request);
+unsigned long long nowNs();
+int compareLatencies(const void* a, const void* b);
+unsigned long long percentileOf(unsigned long long* sorted, unsigned long long count, double percentile);
+
+#endif
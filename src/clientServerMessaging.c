@@ -28,7 +28,7 @@
  * File Description: 	Implementation file for functions related to the establishment, binding and connecting
  * 			of sockets as well as sending and receiving messages using sockets.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #include "clientServerMessaging.h"
@@ -39,7 +39,9 @@
  * Description:		Establishes a socket for listening for incoming connections at the
  * 			desired port passed in through the command line.
  * Receives: 		The desired port number at which the socket should listen, represented
- * 			as a string.
+ * 			as a string, the maximum number of connections awaiting acceptance, and
+ * 			whether other sockets may be bound to the same port with SO_REUSEPORT
+ * 			(the kernel then spreads incoming connections across them).
  * Returns: 		The file descriptor of the newly-established and enabled listening
  * 			socket upon success.
  * Pre-Conditions: 	The serverPort passed in is a valid nonnegative integer.
@@ -51,7 +53,7 @@
  * 			Retrieved 02/08/2020 from http://beej.us/guide/bgnet
 ***********************************************************************************************/
 
-int establishListeningSocket(char* serverPort)
+int establishListeningSocket(char* serverPort, int backlog, int reusePort)
 {
 	/* Declare addrinfo structs for establishing connection. */
 	struct addrinfo hints;		/* Contains info about desired connection. */
@@ -83,6 +85,11 @@ int establishListeningSocket(char* serverPort)
 		/* If a socket was established successfully, attempt to bind the socket to serverPort. */
 		if (listeningSocketFD != -1)
 		{
+			if (reusePort)
+			{
+				setsockopt(listeningSocketFD, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort));
+			}
+
 			/* If binding socket is successful, set flag to true. */
 			if (bind(listeningSocketFD, currentNode->ai_addr, currentNode->ai_addrlen) != -1)
 			{
@@ -115,7 +122,7 @@ int establishListeningSocket(char* serverPort)
 
 	/* Activate listening socket so it will listen for incoming connections, reporting error and exiting
 	 * upon failure. */
-	if(listen(listeningSocketFD, MAX_BACKLOG) == -1)
+	if(listen(listeningSocketFD, backlog) == -1)
 	{
 		perror("ERROR ENABLING SOCKET FOR LISTENING");
 		exit(2);
@@ -158,10 +165,14 @@ struct FTInfo* acceptClientConnection(int listeningSocketFD)
 	sizeOfClientInfo = sizeof(clientInfo); 
 	controlSocketFD = accept(listeningSocketFD, (struct sockaddr *)&clientInfo, &sizeOfClientInfo);
 	
-	/* If the accept call failed, print error message and return NULL to calling function. */
+	/* If the accept call failed, print error message and return NULL to calling function.
+	 * No message is printed if accept was merely interrupted by a signal. */
 	if (controlSocketFD < 0)
 	{
-		perror("ACCEPT CONNECTION ERROR");
+		if (errno != EINTR)
+		{
+			perror("ACCEPT CONNECTION ERROR");
+		}
 		return NULL;
 	}
 	
@@ -172,7 +183,9 @@ struct FTInfo* acceptClientConnection(int listeningSocketFD)
 	inet_ntop(AF_INET, &(clientInfo.sin_addr), clientHost, INET_ADDRSTRLEN);
 	
 	/* Allocate and return a new struct FTInfo pointer initialized with controlSocketFD and clientHost. */
-	return newFTInfo(controlSocketFD, clientHost);
+	struct FTInfo* myFT = newFTInfo(controlSocketFD, clientHost);
+	FT_PROBE(accept, myFT->sessionId, controlSocketFD, clientHost);
+	return myFT;
 }
 
 
@@ -180,10 +193,14 @@ struct FTInfo* acceptClientConnection(int listeningSocketFD)
  * Function Name:  	establishDataSocket
  * Description:		Creates a new socket for data transfer, connecting to the client at the
  * 			requested port.
+ * 			Each connection attempt is made without blocking and abandoned if it
+ * 			has not completed within timeoutMs milliseconds, so a client that never
+ * 			answers cannot hold the calling thread for the kernel's connect timeout.
  * Receives: 		Strings representing the client's host address and desired port number
- * 			for the new data port.
+ * 			for the new data port, and the connection timeout in milliseconds
+ * 			(0 for no timeout).
  * Returns: 		The file descriptor of the newly-established socket upon success
- * 			or -1 upon failure.
+ * 			or -1 upon failure (with errno set to ETIMEDOUT if the attempt timed out).
  * Pre-Conditions: 	clientHost represents the address of the client with which this process
  * 			has already connected, and dataPort represents the port number requested
  * 			by the client.
@@ -198,7 +215,7 @@ struct FTInfo* acceptClientConnection(int listeningSocketFD)
  * 			  Programming Assignment 1.
 **********************************************************************************************/
 
-int establishDataSocket(char* clientHost, char* dataPort)
+int establishDataSocket(char* clientHost, char* dataPort, int timeoutMs)
 {
 	/* Declare addrinfo structs for establishing connection. */
 	struct addrinfo hints;		/* Contains info about desired connection. */
@@ -217,6 +234,10 @@ int establishDataSocket(char* clientHost, char* dataPort)
 		return -1;
 	}
 
+	/* Compute the time by which the connection must be established. */
+	struct timespec deadline;
+	setDeadline(&deadline, timeoutMs);
+
 	/* Loop through addrList, connecting to the first process which will accept the connection. */
 	int dataSocketFD = -5;				/* Will store connected socket to return to caller. */
 	int socketConnected = 0;			/* Flag to track if socket connected. */
@@ -230,16 +251,39 @@ int establishDataSocket(char* clientHost, char* dataPort)
 		 * using current node's info. */
 		if (dataSocketFD != -1)
 		{
-			/* If connecting socket is successful, set flag to true. */
-			if (connect(dataSocketFD, currentNode->ai_addr, currentNode->ai_addrlen) != -1)
+			/* Make socket non-blocking so that connect returns immediately, saving its flags to restore. */
+			int socketFlags = fcntl(dataSocketFD, F_GETFL);
+			fcntl(dataSocketFD, F_SETFL, socketFlags | O_NONBLOCK);
+
+			/* Start connecting. If connection is still in progress, wait until it completes or
+			 * deadline passes, then get result of connection attempt. */
+			int connectResult = connect(dataSocketFD, currentNode->ai_addr, currentNode->ai_addrlen);
+			if (connectResult == -1 && errno == EINPROGRESS)
 			{
+				int connectError = 0;
+				socklen_t errorLen = sizeof(connectError);
+				if (waitForSocket(dataSocketFD, POLLOUT, timeoutMs > 0 ? &deadline : NULL) == 1
+					&& getsockopt(dataSocketFD, SOL_SOCKET, SO_ERROR, &connectError, &errorLen) == 0)
+				{
+					connectResult = (connectError == 0) ? 0 : -1;
+					errno = connectError;
+				}
+			}
+
+			/* If connecting socket is successful, restore blocking mode and set flag to true. */
+			if (connectResult == 0)
+			{
+				fcntl(dataSocketFD, F_SETFL, socketFlags);
 				socketConnected = 1;
 			}
 
-			/* Otherwise, close socket in preparation for next iteration. */
+			/* Otherwise, close socket in preparation for next iteration (preserving errno for
+			 * error message below). */
 			else
 			{
+				int connectErrno = errno;
 				close(dataSocketFD);
+				errno = connectErrno;
 			}
 		}
 		
@@ -255,8 +299,11 @@ int establishDataSocket(char* clientHost, char* dataPort)
 	/* If the socket is not connected, print error message, and return -1 to calling function. */
 	if (!socketConnected)
 	{
-		fprintf(stderr, "CONNECTION ERROR: could not connect to client at %s:%s: ", clientHost, dataPort);
-		perror("");
+		int connectErrno = errno;
+		STAT_ERRNO(connectErrno);
+		fprintf(stderr, "CONNECTION ERROR: could not connect to client at %s:%s: %s\n",
+			clientHost, dataPort, strerror(connectErrno));
+		errno = connectErrno;
 		return -1;
 	}
 
@@ -286,6 +333,26 @@ int establishDataSocket(char* clientHost, char* dataPort)
 **********************************************************************************************/
 
 int sendMessage(int socketFD, char* message)
+{
+	return sendFrame(socketFD, message, strlen(message));
+}
+
+
+/***********************************************************************************************
+ * Function Name:  	sendFrame
+ * Description:		Sends the length of a buffer to the client followed by the buffer itself,
+ * 			framed exactly as sendMessage frames a string, but without requiring the
+ * 			data to be a null-terminated string (so it may hold any bytes).
+ * Receives: 		The file descriptor of a socket connected to the client, the data,
+ * 			and its length.
+ * Returns: 		0 on success; -1 on failure.
+ * Pre-Conditions: 	socketFD refers to a socket which has successfully been connected
+ * 			to the client, and data holds at least dataLen bytes.
+ * Post-Conditions: 	If 0 is returned to indicate success, all bytes of the frame have
+ * 			succesfully been sent out to the transport layer.
+**********************************************************************************************/
+
+int sendFrame(int socketFD, char* data, int dataLen)
 {
 	/* Send client message length so it knows how many characters to expect to receive.
 	 * Declare buffer to hold message length + terminating '@' character
@@ -294,16 +361,18 @@ int sendMessage(int socketFD, char* message)
 	memset(messageLenStr, '\0', sizeof(messageLenStr));
 	 
 	/* Store message length + terminating '@' character in messageLenStr. */
-	sprintf(messageLenStr, "%d@", (int)strlen(message));
+	sprintf(messageLenStr, "%d@", dataLen);
 
-	/* Send messageLenStr to server, returning -1 to calling function if error. */
-	if (sendCompleteString(socketFD, messageLenStr) == -1)
+	/* Send messageLenStr to server, returning -1 to calling function if error. If frames are sent
+	 * with MSG_MORE, the kernel holds messageLenStr until the message follows it, so both leave in
+	 * one segment instead of the message waiting for messageLenStr to be acknowledged. */
+	if (sendCompleteString(socketFD, messageLenStr, socketTuning.frameMore ? MSG_MORE : 0) == -1)
 	{
 		return -1;
 	}
 
 	/* Send message to server, returning -1 to calling function if error. */
-	if (sendCompleteString(socketFD, message) == -1)
+	if (sendCompleteBuffer(socketFD, data, dataLen, 0) == -1)
 	{
 		return -1;
 	}
@@ -317,32 +386,58 @@ int sendMessage(int socketFD, char* message)
  * Function Name:  	sendCompleteString
  * Description:		Sends string passed in to client, looping until full message has been
  * 			sent out on transport layer or send error has occurred.
- * Receives: 		The file descriptor of a messaging socket connected to the client
- * 			and the message to be sent.
+ * Receives: 		The file descriptor of a messaging socket connected to the client,
+ * 			the message to be sent, and flags to pass to send.
  * Returns: 		0 on success, -1 on send error.
  * Pre-Conditions: 	socketFD refers to a socket which has successfully been connected
  * 			to the client, and the message is a non-null string.
  * Post-Conditions: 	If 0 is returned to indicate success, all bytes of the message have
- * 			succesfully been sent out to the transport layer.
+ * 			succesfully been sent out to the transport layer. If -1 is returned
+ * 			because a send stalled past the socket's send timeout, errno is ETIMEDOUT.
  * ** CITATIONS **:	Function adapted from my implementation of a function with an
  * 			identical purpose in the Block 4 Project in CS 344-400 Fall 2019
  * 			and from my implementation of a function with identical purpose
  * 			in CS 372 Programming Assignment 1.
 **********************************************************************************************/
 
-int sendCompleteString(int messagingSocket, char* message)
+int sendCompleteString(int messagingSocket, char* message, int flags)
+{
+	return sendCompleteBuffer(messagingSocket, message, strlen(message), flags);
+}
+
+
+/***********************************************************************************************
+ * Function Name:  	sendCompleteBuffer
+ * Description:		Sends bufferLen bytes of buffer to client, looping until all of them have
+ * 			been sent out on transport layer or send error has occurred.
+ * Receives: 		The file descriptor of a messaging socket connected to the client,
+ * 			the buffer to be sent, its length, and flags to pass to send.
+ * Returns: 		0 on success, -1 on send error.
+ * Pre-Conditions: 	socketFD refers to a socket which has successfully been connected
+ * 			to the client, and buffer holds at least bufferLen bytes.
+ * Post-Conditions: 	Same as sendCompleteString.
+**********************************************************************************************/
+
+int sendCompleteBuffer(int messagingSocket, char* buffer, int bufferLen, int flags)
 {
-	/* Loop until full message is sent. */
-	int charsRemaining = strlen(message);		/* Number of chars remaining to be sent. */
-	char* posInMessage = message;			/* Position of next character to send. */
+	/* Loop until full buffer is sent. */
+	int charsRemaining = bufferLen;			/* Number of chars remaining to be sent. */
+	char* posInMessage = buffer;			/* Position of next character to send. */
 	while (charsRemaining > 0)
 	{
 		/* Attempt to send up to charsRemaining bytes of message. */
-		int charsSent = send(messagingSocket, posInMessage, charsRemaining, 0);
+		int charsSent = tlsSend(messagingSocket, posInMessage, charsRemaining, flags);
 				
-		/* If an error occurred, print error message and return -1 to calling function. */
+		/* If an error occurred, print error message and return -1 to calling function. If the send
+		 * timeout set by setSendTimeout expired, count the stall and report it as a timeout. */
 		if (charsSent < 0)
 		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				STAT_ADD(sendStallTimeouts, 1);
+				errno = ETIMEDOUT;
+			}
+			STAT_ERRNO(errno);
 			perror("SEND ERROR");
 			fprintf(stderr, "Disconnecting from client.\n");
 			return -1;
@@ -362,22 +457,33 @@ int sendCompleteString(int messagingSocket, char* message)
 /***********************************************************************************************
  * Function Name:  	recvMessage
  * Description:		Receives and returns a message from the client, ensuring that all bytes
- * 			of full message are read from transport layer.
- * Receives:		The file descriptor of a socket connected to the client.
+ * 			of full message are read from transport layer. The whole message must
+ * 			arrive within timeoutMs milliseconds, so a client that sends nothing (or
+ * 			sends one byte at a time) cannot hold the calling thread indefinitely.
+ * 			Length prefixes that are too long, not a number, or larger than
+ * 			MAX_MESSAGE_LEN are rejected before any memory is allocated.
+ * Receives:		The file descriptor of a socket connected to the client and the
+ * 			timeout in milliseconds (0 for no timeout).
  * Returns: 		The message received from the client as a string
  * 			(or NULL if error occurs).
  * Pre-Conditions: 	socketFD represents a socket previously successfully connected
  * 			to the client.
  * Post-Conditions: 	Unless an error occurs while calling recv and NULL is returned,
  * 			the full message has been read from the transport layer and returned.
+ * 			If NULL is returned because the timeout expired, errno is ETIMEDOUT.
  * ** CITATIONS **:	Function adapted from my implementation of functions with similar
  * 			purpose in the Block 4 Project in CS 344-400 Fall 2019 and from
  * 			my implementation of function with similar purpose in CS 372
  * 			Programming Assignment 1.
 **********************************************************************************************/
 
-char* recvMessage(int socketFD)
+char* recvMessage(int socketFD, int timeoutMs)
 {
+	/* Compute the time by which the full message must be received. */
+	struct timespec deadline;
+	setDeadline(&deadline, timeoutMs);
+	struct timespec* deadlinePtr = (timeoutMs > 0) ? &deadline : NULL;
+
 	/* Receive message length. Declare buffer of 12 characters to hold length of message. */
 	char messageLenStr[12];
 	memset(messageLenStr, '\0', sizeof(messageLenStr));
@@ -387,8 +493,22 @@ char* recvMessage(int socketFD)
 	char endingChar = '\0';			/* Current ending char of message. */
 	while(endingChar != '@')
 	{
+		/* If buffer is full and '@' has not been received, length is invalid. Report error and return NULL. */
+		if (posInStr - messageLenStr >= (int)sizeof(messageLenStr) - 1)
+		{
+			fprintf(stderr, "RECV ERROR: Invalid message length received\n");
+			errno = EPROTO;
+			return NULL;
+		}
+
+		/* Wait until a character is available or deadline passes, returning NULL upon timeout. */
+		if (waitForSocket(socketFD, POLLIN, deadlinePtr) != 1)
+		{
+			return NULL;
+		}
+
 		/* Read up to 1 character from the socket. */
-		int charsRead = recv(socketFD, posInStr, 1, 0); 
+		int charsRead = tlsRecv(socketFD, posInStr, 1, 0); 
 
 		/* If an error occurred, return NULL to calling function. */
 		if (recvError(charsRead))
@@ -402,9 +522,17 @@ char* recvMessage(int socketFD)
 		posInStr += charsRead;
 	}
 
-	/* Strip the terminating '@' character off of the message and convert it to an int. */
+	/* Strip the terminating '@' character off of the message and convert it to an int,
+	 * returning NULL if it is not a number in the accepted range. */
 	messageLenStr[(int)strlen(messageLenStr) - 1] = '\0';
-	int messageLen = atoi(messageLenStr);
+	char* lenEnd = NULL;
+	long messageLen = strtol(messageLenStr, &lenEnd, 10);
+	if (lenEnd == messageLenStr || *lenEnd != '\0' || messageLen < 0 || messageLen > MAX_MESSAGE_LEN)
+	{
+		fprintf(stderr, "RECV ERROR: Invalid message length received\n");
+		errno = EPROTO;
+		return NULL;
+	}
 
 	/* Allocate a buffer for the message. */
 	int messageBufferLen = messageLen + 1;
@@ -416,8 +544,17 @@ char* recvMessage(int socketFD)
 	int charsRemaining = messageLen;	/* Max number of chars remaining to be read. */
 	while(charsRemaining > 0)
 	{
+		/* Wait until characters are available or deadline passes, freeing message and returning
+		 * NULL upon timeout. */
+		if (waitForSocket(socketFD, POLLIN, deadlinePtr) != 1)
+		{
+			free(message);
+			message = NULL;
+			return NULL;
+		}
+
 		/* Read up to charsRemaining characters from the socket. */
-		int charsRead = recv(socketFD, posInMessage, charsRemaining, 0); 
+		int charsRead = tlsRecv(socketFD, posInMessage, charsRemaining, 0); 
 		
 		/* Check for receive error, freeing message and returning NULL if one occurred. */
 		if (recvError(charsRead))
@@ -459,6 +596,7 @@ int recvError(int charsRead)
 		/* If charsRead is -1, report error in errno. */
 		if (charsRead == -1)
 		{
+			STAT_ERRNO(errno);
 			perror("RECV ERROR");
 		}
 
@@ -477,3 +615,123 @@ int recvError(int charsRead)
 		return 0;
 	}
 }
+
+
+/***********************************************************************************************
+ * Function Name:  	setDeadline
+ * Description:		Computes the time a given number of milliseconds from now.
+ * Receives: 		A pointer to a struct timespec in which to store the deadline and the
+ * 			number of milliseconds from now.
+ * Returns: 		nothing
+ * Pre-Conditions: 	deadline is non-null.
+ * Post-Conditions: 	deadline holds the current CLOCK_MONOTONIC time plus timeoutMs.
+**********************************************************************************************/
+
+void setDeadline(struct timespec* deadline, int timeoutMs)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeoutMs / 1000;
+	deadline->tv_nsec += (long)(timeoutMs % 1000) * 1000000;
+	if (deadline->tv_nsec >= 1000000000)
+	{
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:  	waitForSocket
+ * Description:		Waits until a socket is ready for the requested events or the deadline
+ * 			passes, reporting an error if the deadline passes first.
+ * Receives: 		A socket file descriptor, the poll events to wait for (POLLIN or POLLOUT),
+ * 			and a pointer to the deadline (NULL to wait indefinitely).
+ * Returns: 		1 if the socket is ready (or has an error or hang-up pending, which the
+ * 			next recv or send will report); 0 if the deadline passed; -1 on poll error.
+ * Pre-Conditions: 	socketFD is an open socket.
+ * Post-Conditions: 	If 0 is returned, a timeout has been reported and errno is ETIMEDOUT.
+**********************************************************************************************/
+
+int waitForSocket(int socketFD, short events, struct timespec* deadline)
+{
+	/* Without a deadline, there is nothing to wait for here; the caller's recv or send will block. Nor is
+	 * there if TLS has already decrypted data poll cannot see. */
+	if (deadline == NULL || ((events & POLLIN) && tlsPending(socketFD)))
+	{
+		return 1;
+	}
+
+	struct pollfd pollInfo;
+	pollInfo.fd = socketFD;
+	pollInfo.events = events;
+	while (1)
+	{
+		/* Compute milliseconds remaining until deadline (rounded up), treating a past deadline as 0. */
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		long long remainingMs = (deadline->tv_sec - now.tv_sec) * 1000LL
+			+ (deadline->tv_nsec - now.tv_nsec + 999999) / 1000000;
+		if (remainingMs < 0)
+		{
+			remainingMs = 0;
+		}
+
+		/* Wait for socket, retrying if interrupted by a signal. */
+		int pollResult = poll(&pollInfo, 1, (int)remainingMs);
+		if (pollResult > 0)
+		{
+			return 1;
+		}
+		else if (pollResult == 0)
+		{
+			fprintf(stderr, "TIMEOUT ERROR: Client did not respond in time\n");
+			errno = ETIMEDOUT;
+			STAT_ERRNO(ETIMEDOUT);
+			return 0;
+		}
+		else if (errno != EINTR)
+		{
+			perror("POLL ERROR");
+			return -1;
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:  	setSendTimeout
+ * Description:		Sets the longest time a single send on a socket may block waiting for
+ * 			the client to make room in the socket buffer before failing.
+ * Receives: 		A socket file descriptor and the timeout in milliseconds (0 for none).
+ * Returns: 		0 on success; -1 on failure.
+ * Pre-Conditions: 	socketFD is an open socket.
+ * Post-Conditions: 	Sends on socketFD that stall longer than timeoutMs fail with EAGAIN,
+ * 			which sendCompleteString reports as a timeout.
+**********************************************************************************************/
+
+int setSendTimeout(int socketFD, int timeoutMs)
+{
+	struct timeval timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_usec = (timeoutMs % 1000) * 1000;
+	return setsockopt(socketFD, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+
+/***********************************************************************************************
+ * Function Name:  	setRecvTimeout
+ * Description:		Sets the longest time a single recv on a socket may block waiting for
+ * 			the client to send more data before failing.
+ * Receives: 		A socket file descriptor and the timeout in milliseconds (0 for none).
+ * Returns: 		0 on success; -1 on failure.
+ * Pre-Conditions: 	socketFD is an open socket.
+ * Post-Conditions: 	Receives on socketFD that wait longer than timeoutMs fail with EAGAIN.
+**********************************************************************************************/
+
+int setRecvTimeout(int socketFD, int timeoutMs)
+{
+	struct timeval timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_usec = (timeoutMs % 1000) * 1000;
+	return setsockopt(socketFD, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
@@ -28,7 +28,7 @@
  * File Description: 	Header file for functions related to the establishment, binding and connecting
  * 			of sockets as well as sending and receiving messages using sockets.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #ifndef CLIENT_SERVER_MESSAGING
@@ -36,22 +36,36 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <netdb.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
 #include "FTInfo.h"
+#include "serverStats.h"
+#include "socketTuning.h"
+#include "tlsTransport.h"
 
-/* Constant representing max number of connections awaiting acceptance. */
-#define MAX_BACKLOG 10
+/* Constant representing max length of a message accepted by recvMessage. Messages received are
+ * control and validation messages, so anything longer indicates a misbehaving client. */
+#define MAX_MESSAGE_LEN 65536
 
 /* Function prototypes. */
-int establishListeningSocket(char* serverPort);
+int establishListeningSocket(char* serverPort, int backlog, int reusePort);
 struct FTInfo* acceptClientConnection(int listeningSocketFD);
-int establishDataSocket(char* clientHost, char* dataPort);
+int establishDataSocket(char* clientHost, char* dataPort, int timeoutMs);
 int sendMessage(int socketFD, char* message);
-int sendCompleteString(int socketFD, char* message);
-char* recvMessage(int socketFD);
+int sendFrame(int socketFD, char* data, int dataLen);
+int sendCompleteString(int socketFD, char* message, int flags);
+int sendCompleteBuffer(int socketFD, char* buffer, int bufferLen, int flags);
+char* recvMessage(int socketFD, int timeoutMs);
 int recvError(int charsRead);
+void setDeadline(struct timespec* deadline, int timeoutMs);
+int waitForSocket(int socketFD, short events, struct timespec* deadline);
+int setSendTimeout(int socketFD, int timeoutMs);
+int setRecvTimeout(int socketFD, int timeoutMs);
 
 #endif
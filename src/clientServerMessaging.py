@@ -18,10 +18,11 @@
 # File Description: 	File containing functions for sending and receiving data between client
 #			and server. Invoked by various methods of FTInfo class.
 # Course Name: 		CS 372-400: Introduction to Computer Networks
-# Last Modified:	03/09/2020
+# Last Modified:	10/18/2026
 ######################################################################################################
 
 
+import array
 import socket
 import sys
 import FTInfo
@@ -107,8 +108,9 @@ def sendMessage(messagingSocket, message, myFT):
 # Function Name:  	recvMessage
 # Description:		Receives and returns a message from the server, ensuring that all bytes of full
 #  			message are read from transport layer.
-# Receives:		A socket connected to the server and an FTInfo object to be used
-#			for closing open sockets if error occurs before exiting.
+# Receives:		A socket connected to the server, an FTInfo object to be used
+#			for closing open sockets if error occurs before exiting, and optionally
+#			the beginning of the message length already received.
 #			Note that, although messagingSocket represents one of the sockets
 #			stored in FTInfo, this parameter clarifies which of those sockets
 #			to use for sending this message.
@@ -130,11 +132,12 @@ def sendMessage(messagingSocket, message, myFT):
 #			  CS-372 Programming Assignment 1.
 #######################################################################################################
 
-def recvMessage(messagingSocket, myFT):
-	# Receive message length. Declare string to hold length of message.
-	messageLenStr = ""
+def recvMessage(messagingSocket, myFT, messageLenStr=""):
+	# Receive message length, continuing from any part of it already received.
 
-	# Receive length 1 byte at a time, stopping after '@' character is received.
+	# Receive length 1 byte at a time, stopping after '@' character is received. (Messages are short and
+	# may be followed by others on the same socket, so nothing is read past the message; file data is
+	# received through a FrameReceiver instead.)
 	while not messageLenStr.endswith("@"):
 		# Read up to 1 character from the socket and check for error.
 		try:
@@ -160,28 +163,27 @@ def recvMessage(messagingSocket, myFT):
 	messageLenStr = messageLenStr.strip("@")
 	messageLenReported = int(messageLenStr)
 	
-	# Allocate an empty string into which to store message. */
-	message = ""
+	# Allocate a buffer of the reported length into which to receive message, so that chunks are received
+	# in place instead of being concatenated. */
+	messageBuffer = bytearray(messageLenReported)
+	messageView = memoryview(messageBuffer)
 	
 	# Loop until full messageLenReported has been read or error occurs. */
-	charsRemaining = messageLenReported
+	charsReceived = 0
 	
-	while charsRemaining > 0:
-		# Read up to charsRemaining characters from the socket and check for recv error. */
+	while charsReceived < messageLenReported:
+		# Read up to the number of characters remaining from the socket and check for recv error. */
 		try:
-			chunkAsBytes = messagingSocket.recv(charsRemaining)
-			chunkAsStr = chunkAsBytes.decode()
+			chunkLen = messagingSocket.recv_into(messageView[charsReceived:])
 			
 			# If 0 bytes were received, report error to user and exit.
-			if len(chunkAsStr) == 0:
+			if chunkLen == 0:
 				print("RECV ERROR: Connection closed by server.", file=sys.stderr)
 				myFT.closeSockets()
 				sys.exit(2)
 			
-			# Update the number of chars remaining for the next iteration, and concatenate
-			# messageChunkStr to end of message.
-			charsRemaining -= len(chunkAsStr)
-			message += chunkAsStr
+			# Update the number of chars received for the next iteration.
+			charsReceived += chunkLen
 		
 		# If an OSError was raised during the recv call, catch and report it before exiting.
 		except OSError as socketError:
@@ -189,95 +191,232 @@ def recvMessage(messagingSocket, myFT):
 			myFT.closeSockets()
 			sys.exit(2)
 	
+	# Decode whole message at once, so that no character is split between chunks.
+	message = messageBuffer.decode()
+	
 	# Return message to calling function now that full message has been received.
 	return message
 
 #######################################################################################################
-# Function Name:  	recvBytes
-# Description:		Receives and returns a chunk of bytes from the server, ensuring that complete
-#			chunk of data sent by the server with length reported by the server is
-#			received before returning it.
-# Receives:		A socket connected to the server and an FTInfo object to be used
+# Function Name:  	recvMessageAndDescriptors
+# Description:		Receives a message from the server over a Unix-domain socket along with any
+#			file descriptors the server attached to it (SCM_RIGHTS). The server attaches
+#			descriptors to the first byte of a message, so that byte is read with recvmsg
+#			and the rest of the message is read by recvMessage.
+# Receives:		A Unix-domain socket connected to the server and an FTInfo object to be used
 #			for closing open sockets if error occurs before exiting.
-#			Note that, although messagingSocket represents one of the sockets
-#			stored in FTInfo, this parameter clarifies which of those sockets
-#			to use for sending this message.
-# Returns: 		A chunk of bytes received from the server as a bytes object.
-# Pre-Conditions: 	The messagingSocket is connected to the server and myFT represents
-#			an instantiated FTInfo object.
-# Post-Conditions: 	Unless an error occurs while calling recv and the connection is closed,
-# 			the full chunk of bytes with length reported by the server has
-#			been read from the transport layer and returned.
-# ** CITATIONS **:	- recv() calls based off example recv() call in Lecture 15, Slide 9.
-#			- Use of bytes.decode() learned from Python 3 documentation:
-#			  https://docs.python.org/3.6/library/stdtypes.html#bytes.decode
-#			- Concept of looping until full message is received based on information
-#			  provided in the following article: 
-#			  McMillan, G. Socket Programming HOWTO. Accessed 02/09/2020 from:
-#			  https://docs.python.org/3.6/howto/sockets.html
-#			- Function adapted from my C implementation of functions with similar
-# 			  purpose in the Block 4 Project in CS 344-400 Fall 2019.
-#			- Function adapted from my Python implementation of similar function in
-#			  CS-372 Programming Assignment 1.
+# Returns: 		A 2-tuple containing the message, decoded as a string, and a list of the
+#			descriptors received (empty if none were attached).
+# Pre-Conditions: 	The messagingSocket is a Unix-domain socket connected to the server.
+# Post-Conditions: 	The full message has been read, and the caller owns the descriptors returned.
 #######################################################################################################
 
-def recvBytes(messagingSocket, myFT):
-	# Receive message length. Declare string to hold length of message.
-	messageLenStr = ""
+def recvMessageAndDescriptors(messagingSocket, myFT):
+	# Receive first byte of message with room for one descriptor of ancillary data.
+	try:
+		firstByte, ancillaryData, flags, address = messagingSocket.recvmsg(1, socket.CMSG_SPACE(array.array("i").itemsize))
+	except OSError as socketError:
+		print("RECV ERROR:", socketError, file=sys.stderr)
+		myFT.closeSockets()
+		sys.exit(2)
+	if len(firstByte) == 0:
+		print("RECV ERROR: Connection closed by server.", file=sys.stderr)
+		myFT.closeSockets()
+		sys.exit(2)
+	
+	# Collect descriptors from any SCM_RIGHTS ancillary data received.
+	descriptors = array.array("i")
+	for level, dataType, data in ancillaryData:
+		if level == socket.SOL_SOCKET and dataType == socket.SCM_RIGHTS:
+			descriptors.frombytes(data[:len(data) - (len(data) % descriptors.itemsize)])
+	
+	# Receive remainder of message.
+	message = recvMessage(messagingSocket, myFT, firstByte.decode())
+	return (message, list(descriptors))
 
-	# Receive length 1 byte at a time, stopping after '@' character is received.
-	while not messageLenStr.endswith("@"):
-		# Read up to 1 character from the socket and check for error.
+#######################################################################################################
+# Class Name:		FrameReceiver
+# Class Description:	Receives the frames of a file sent by the server over the data socket and writes
+#			their contents to the output file, which is opened the first time the buffer is
+#			written (so none is created if the server reports an error first). Payloads are received with recv_into straight
+#			into a preallocated write buffer, which is written to the file only when full (or
+#			flushed), so no memory is allocated per frame and the file is written in large
+#			blocks. Length prefixes are received PREFIX_READ_SIZE bytes at a time instead of
+#			1 byte at a time; any payload bytes received with a prefix are copied into the
+#			write buffer, so only the data socket may be read through a FrameReceiver once
+#			it has been created.
+# Data Members:		messagingSocket (data socket connected to the server)
+#			openOutputFile (function opening the output file, returning it and its name)
+#			outputFile, outputFilename (output file, opened in binary mode, and its name, or None)
+#			myFT (FTInfo object used for closing open sockets if error occurs before exiting)
+#			prefixBuffer, prefixView (bytes received while looking for a length prefix)
+#			prefixStart, prefixEnd (range of prefixBuffer received but not yet consumed)
+#			writeBuffer, writeView (payload bytes not yet written to outputFile)
+#			writeLen (number of bytes of writeBuffer in use)
+#			bytesReceived (total payload bytes received)
+# Member Functions:	(see below for definitions and descriptions)
+#######################################################################################################
+
+# Number of bytes to receive at a time while looking for a length prefix, and size of the buffer holding
+# payload bytes until they are written to the output file.
+PREFIX_READ_SIZE = 32
+WRITE_BUFFER_SIZE = 4194304
+
+class FrameReceiver:
+	
+	#######################################################################################################
+	# Function Name:	__init__
+	# Description:		Allocates the buffers of a FrameReceiver for a data socket and output file.
+	# Receives: 		A self-reference, a data socket connected to the server, a function that opens
+	#			the output file in binary mode and returns a 2-tuple of it and its name, and an
+	#			FTInfo object to be used for closing open sockets if error occurs before exiting.
+	# Returns: 		nothing
+	# Pre-Conditions:	The data connection has been validated.
+	# Post-Conditions: 	The FrameReceiver is ready to receive frames.
+	######################################################################################################
+	
+	def __init__(self, messagingSocket, openOutputFile, myFT):
+		self.messagingSocket = messagingSocket
+		self.openOutputFile = openOutputFile
+		self.outputFile = None
+		self.outputFilename = None
+		self.myFT = myFT
+		self.prefixBuffer = bytearray(PREFIX_READ_SIZE)
+		self.prefixView = memoryview(self.prefixBuffer)
+		self.prefixStart = 0
+		self.prefixEnd = 0
+		self.writeBuffer = bytearray(WRITE_BUFFER_SIZE)
+		self.writeView = memoryview(self.writeBuffer)
+		self.writeLen = 0
+		self.bytesReceived = 0
+	
+	#######################################################################################################
+	# Function Name:	pending
+	# Description:		Reports whether bytes of the next frame have already been received, which
+	#			poll cannot see.
+	# Receives: 		A self-reference.
+	# Returns: 		True if received bytes are waiting to be consumed; False otherwise.
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	None.
+	######################################################################################################
+	
+	def pending(self):
+		return self.prefixEnd > self.prefixStart
+	
+	#######################################################################################################
+	# Function Name:	_recvInto
+	# Description:		Receives bytes from the data socket into the buffer passed in, reporting any
+	#			error and exiting as recvMessage does.
+	# Receives: 		A self-reference and a memoryview of the part of a buffer to receive into.
+	# Returns: 		The number of bytes received (at least 1).
+	# Pre-Conditions:	view is not empty.
+	# Post-Conditions: 	Unless the process exits, the bytes received are at the start of view.
+	######################################################################################################
+	
+	def _recvInto(self, view):
+		# Receive bytes, reporting error and exiting if an OSError is raised or connection has closed.
 		try:
-			messageByte = messagingSocket.recv(1)
-			byteAsStr = messageByte.decode()
-			
-			# If 0 bytes were received, report error to user and exit.
-			if len(byteAsStr) == 0:
-				print("RECV ERROR: Connection closed by server.", file=sys.stderr)
-				myFT.closeSockets()
-				sys.exit(2)
-			
-			# Otherwise, add byteAsStr to end of messageLenStr.
-			messageLenStr += byteAsStr
-		
-		# If an OSError was raised during the recv call, catch and report it before exiting.
+			chunkLen = self.messagingSocket.recv_into(view)
 		except OSError as socketError:
 			print("RECV ERROR:", socketError, file=sys.stderr)
-			myFT.closeSockets()
+			self.myFT.closeSockets()
+			sys.exit(2)
+		if chunkLen == 0:
+			print("RECV ERROR: Connection closed by server.", file=sys.stderr)
+			self.myFT.closeSockets()
 			sys.exit(2)
+		return chunkLen
 	
-	# Strip the terminating '@' character off of the message and convert it to an int. */
-	messageLenStr = messageLenStr.strip("@")
-	messageLenReported = int(messageLenStr)
+	#######################################################################################################
+	# Function Name:	_recvLength
+	# Description:		Receives the length prefix of the next frame, consuming it (and its terminating
+	#			'@' character) from prefixBuffer.
+	# Receives: 		A self-reference.
+	# Returns: 		The length of the frame's payload (as int).
+	# Pre-Conditions:	The previous frame (if any) has been received in full.
+	# Post-Conditions: 	Unless the process exits because the prefix is invalid, prefixBuffer holds any
+	#			payload bytes received with the prefix.
+	######################################################################################################
 	
-	# Allocate an empty bytes object into which to store message. */
-	data = b""
+	def _recvLength(self):
+		# Receive until the '@' character ending the prefix is found, moving any part of the prefix already
+		# received to the start of prefixBuffer to make room for the rest.
+		atIndex = self.prefixBuffer.find(b"@", self.prefixStart, self.prefixEnd)
+		while atIndex == -1:
+			charsLeft = self.prefixEnd - self.prefixStart
+			if charsLeft == PREFIX_READ_SIZE:
+				break
+			self.prefixView[:charsLeft] = self.prefixView[self.prefixStart:self.prefixEnd]
+			self.prefixStart = 0
+			self.prefixEnd = charsLeft + self._recvInto(self.prefixView[charsLeft:])
+			atIndex = self.prefixBuffer.find(b"@", charsLeft, self.prefixEnd)
+		
+		# Convert prefix to an int, reporting error and exiting if it is not a valid length.
+		try:
+			if atIndex == -1:
+				raise ValueError("no '@' in first " + str(PREFIX_READ_SIZE) + " bytes")
+			messageLenReported = int(self.prefixView[self.prefixStart:atIndex])
+		except ValueError as lengthError:
+			print("RECV ERROR: Invalid message length received from server:", lengthError, file=sys.stderr)
+			self.myFT.closeSockets()
+			sys.exit(2)
+		self.prefixStart = atIndex + 1
+		return messageLenReported
 	
-	# Loop until full messageLenReported has been read or error occurs. */
-	bytesRemaining = messageLenReported
+	#######################################################################################################
+	# Function Name:	recvFrame
+	# Description:		Receives the next frame from the server in full, adding its payload to the
+	#			write buffer and writing the buffer to the output file each time it fills.
+	#			Payload bytes that arrived with the length prefix are copied; the rest are
+	#			received straight into the write buffer.
+	# Receives: 		A self-reference.
+	# Returns: 		The length of the frame's payload.
+	# Pre-Conditions:	The data socket (or prefixBuffer) has bytes of the next frame ready.
+	# Post-Conditions: 	Unless the process exits, the whole frame has been consumed and its payload
+	#			is in the write buffer or the output file.
+	######################################################################################################
 	
-	while bytesRemaining > 0:
-		# Read up to charsRemaining characters from the socket and check for recv error. */
-		try:
-			chunkOfBytes = messagingSocket.recv(bytesRemaining)
-			
-			# If 0 bytes were received, report error to user and exit.
-			if len(chunkOfBytes) == 0:
-				print("RECV ERROR: Connection closed by server.", file=sys.stderr)
-				myFT.closeSockets()
-				sys.exit(2)
+	def recvFrame(self):
+		messageLenReported = self._recvLength()
+		bytesRemaining = messageLenReported
+		while bytesRemaining > 0:
+			# Make room in write buffer if it is full.
+			if self.writeLen == WRITE_BUFFER_SIZE:
+				self.flush()
+			chunkLimit = min(bytesRemaining, WRITE_BUFFER_SIZE - self.writeLen)
 			
-			# Update the number of bytes remaining for the next iteration, and concatenate
-			# chunkOfBytes to end of data.
-			bytesRemaining -= len(chunkOfBytes)
-			data += chunkOfBytes
+			# Copy any payload bytes received with the prefix, or otherwise receive straight into write buffer.
+			if self.pending():
+				chunkLen = min(chunkLimit, self.prefixEnd - self.prefixStart)
+				self.writeView[self.writeLen:self.writeLen + chunkLen] = self.prefixView[self.prefixStart:self.prefixStart + chunkLen]
+				self.prefixStart += chunkLen
+			else:
+				chunkLen = self._recvInto(self.writeView[self.writeLen:self.writeLen + chunkLimit])
+			self.writeLen += chunkLen
+			bytesRemaining -= chunkLen
 		
-		# If an OSError was raised during the recv call, catch and report it before exiting.
-		except OSError as socketError:
-			print("RECV ERROR:", socketError, file=sys.stderr)
-			myFT.closeSockets()
-			sys.exit(2)
+		# Count payload, and return its length to calling function.
+		self.bytesReceived += messageLenReported
+		return messageLenReported
+	
+	#######################################################################################################
+	# Function Name:	flush
+	# Description:		Writes the contents of the write buffer to the output file (opening it first,
+	#			if it has not been opened yet), reporting any error and exiting.
+	# Receives: 		A self-reference.
+	# Returns: 		nothing
+	# Pre-Conditions:	None.
+	# Post-Conditions: 	Unless the process exits, the output file is open, every payload byte received
+	#			is in it, and the write buffer is empty.
+	######################################################################################################
 	
-	# Return data to calling function now that full message has been received.
-	return data
+	def flush(self):
+		if self.outputFile == None:
+			self.outputFile, self.outputFilename = self.openOutputFile()
+		try:
+			self.outputFile.write(self.writeView[:self.writeLen])
+		except OSError as writeError:
+			print("WRITE ERROR:", writeError, file=sys.stderr)
+			self.myFT.closeSockets()
+			sys.exit(2)
+		self.writeLen = 0
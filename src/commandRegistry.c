@@ -0,0 +1,255 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		commandRegistry.c
+ * File Description: 	Implementation of the command registry and in-place request parser.
+ * 			To add a new command, write its handler and append an entry to commandList
+ * 			below; the parser and dispatch code do not need to change.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include "commandRegistry.h"
+#include "manageConnections.h"
+#include "serverStats.h"
+
+/* Registry of commands accepted by ftserver. Each entry maps a command's syntax to the function
+ * that fulfills it, the number of arguments it requires, and the error messages sent to the client
+ * when it is received with too few or too many arguments. */
+static const struct CommandHandler commandList[] =
+{
+	{ GET_FILE, 1, sendFileToClient,
+	  "BAD REQUEST: <filename> required after -g command.",
+	  "BAD REQUEST: only <filename> should come after -g command." },
+	{ LIST_FILES, 0, sendListingToClient,
+	  NULL,
+	  "BAD REQUEST: no arguments should appear after -l command." },
+	{ LIST_TXT_FILES, 0, sendListingToClient,
+	  NULL,
+	  "BAD REQUEST: no arguments should appear after -ltxt command." },
+	{ PUT_FILE, 2, receiveFileFromClient,
+	  "BAD REQUEST: <filename> and <size> required after -p command.",
+	  "BAD REQUEST: only <filename> and <size> should come after -p command." }
+};
+
+/* Open-addressed hash table of pointers into commandList, filled in by initCommandRegistry
+ * so that looking up a command costs one hash and (almost always) one comparison. */
+static const struct CommandHandler* commandTable[COMMAND_TABLE_SIZE];
+
+/* FNV-1a hash constants. */
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+
+/***********************************************************************************************
+ * Function Name:	initCommandRegistry
+ * Description:		Inserts every entry of commandList into commandTable, hashing each
+ * 			command's syntax and placing it in the first free slot at or after
+ * 			its hash position. Also names each command's request counter in
+ * 			serverStats.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	commandList contains fewer than COMMAND_TABLE_SIZE entries and no more
+ * 			than STATS_MAX_COMMANDS entries.
+ * Post-Conditions: 	Every registered command can be found with lookupCommand.
+**********************************************************************************************/
+
+void initCommandRegistry()
+{
+	/* Determine number of registered commands. */
+	int numCommands = sizeof(commandList) / sizeof(commandList[0]);
+
+	/* Insert each command into the table. */
+	for (int i = 0; i < numCommands; i++)
+	{
+		/* Hash the command's syntax. */
+		unsigned int hash = FNV_OFFSET_BASIS;
+		for (char* pos = commandList[i].syntax; *pos != '\0'; pos++)
+		{
+			hash = (hash ^ (unsigned char)*pos) * FNV_PRIME;
+		}
+
+		/* Probe forward from the hash position until a free slot is found, then store the command. */
+		unsigned int slot = hash & (COMMAND_TABLE_SIZE - 1);
+		while (commandTable[slot] != NULL)
+		{
+			slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+		}
+		commandTable[slot] = &commandList[i];
+
+		/* Name the counter of requests for this command. */
+		setStatsCommandName(i, commandList[i].syntax);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	lookupCommand
+ * Description:		Finds the registered command matching the syntax passed in.
+ * Receives: 		A pointer to the command token, its length, and its FNV-1a hash
+ * 			(computed by the caller while scanning the token).
+ * Returns: 		A pointer to the matching registry entry, or NULL if no registered
+ * 			command has that syntax.
+ * Pre-Conditions: 	initCommandRegistry has been called, and syntax is null-terminated
+ * 			at syntaxLen.
+ * Post-Conditions: 	The registry is unchanged.
+**********************************************************************************************/
+
+const struct CommandHandler* lookupCommand(char* syntax, int syntaxLen, unsigned int hash)
+{
+	/* Probe forward from the hash position until the command or an empty slot is found. */
+	unsigned int slot = hash & (COMMAND_TABLE_SIZE - 1);
+	while (commandTable[slot] != NULL)
+	{
+		/* If the entry in this slot has the same syntax, return it. */
+		const struct CommandHandler* entry = commandTable[slot];
+		if (memcmp(entry->syntax, syntax, syntaxLen) == 0 && entry->syntax[syntaxLen] == '\0')
+		{
+			return entry;
+		}
+		slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+	}
+
+	/* An empty slot was reached, so the command is not registered. */
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	parseRequest
+ * Description:		Splits the request received from the client into space-separated tokens
+ * 			by writing null terminators into the request buffer itself, looks up the
+ * 			first token in the registry, and checks that the number of tokens that
+ * 			follow it matches the command's arity. No memory is allocated; the
+ * 			pointers stored in parsed refer to positions within request.
+ * Receives: 		The request buffer received from the client and a pointer to a struct
+ * 			ParsedRequest to fill in.
+ * Returns: 		NULL if the request is valid; otherwise, the error message to send
+ * 			to the client.
+ * Pre-Conditions: 	request is a modifiable, null-terminated string, and initCommandRegistry
+ * 			has been called.
+ * Post-Conditions: 	If NULL is returned, parsed contains the command token, its registry
+ * 			entry, and exactly arity argument tokens. request has been modified in
+ * 			place and must outlive any use of the pointers in parsed.
+**********************************************************************************************/
+
+char* parseRequest(char* request, struct ParsedRequest* parsed)
+{
+	/* Initialize parsed as if no tokens have been found. */
+	parsed->command = NULL;
+	parsed->handler = NULL;
+	parsed->argCount = 0;
+
+	/* Scan the request one token at a time. Scanning stops early once more arguments than
+	 * the command accepts have been seen, since the request is invalid at that point. */
+	char* pos = request;		/* Position of next char to examine. */
+	while (*pos != '\0')
+	{
+		/* Skip spaces before the next token, stopping if the end of the request is reached. */
+		while (*pos == ' ')
+		{
+			pos++;
+		}
+		if (*pos == '\0')
+		{
+			break;
+		}
+
+		/* Advance to the end of the token, hashing it as it is scanned. */
+		char* tokenStart = pos;
+		unsigned int hash = FNV_OFFSET_BASIS;
+		while (*pos != ' ' && *pos != '\0')
+		{
+			hash = (hash ^ (unsigned char)*pos) * FNV_PRIME;
+			pos++;
+		}
+		int tokenLen = pos - tokenStart;
+
+		/* Null-terminate the token in place, stepping past the terminator if it replaced a space. */
+		if (*pos != '\0')
+		{
+			*pos = '\0';
+			pos++;
+		}
+
+		/* If this is the first token, it is the command. Look it up, returning error message
+		 * if it is not registered. */
+		if (parsed->command == NULL)
+		{
+			parsed->command = tokenStart;
+			parsed->handler = lookupCommand(tokenStart, tokenLen, hash);
+			if (parsed->handler == NULL)
+			{
+				return UNRECOGNIZED_COMMAND_MESSAGE;
+			}
+		}
+
+		/* Otherwise, it is an argument. If the command does not accept another argument,
+		 * return its error message for extra arguments. */
+		else if (parsed->argCount == parsed->handler->arity)
+		{
+			return parsed->handler->extraArgMessage;
+		}
+
+		/* Otherwise, store the argument. */
+		else
+		{
+			parsed->args[parsed->argCount] = tokenStart;
+			parsed->argCount++;
+		}
+	}
+
+	/* If no tokens were found (request is empty or contains only spaces), return error message. */
+	if (parsed->command == NULL)
+	{
+		return NO_COMMAND_MESSAGE;
+	}
+
+	/* If fewer arguments than the command requires were received, return its error message. */
+	if (parsed->argCount < parsed->handler->arity)
+	{
+		return parsed->handler->missingArgMessage;
+	}
+
+	/* Otherwise, request is valid. */
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	commandIndex
+ * Description:		Finds the position of a registry entry in commandList, which is also the
+ * 			index of its request counter in serverStats.
+ * Receives: 		A pointer to a registry entry returned by lookupCommand.
+ * Returns: 		The index of the entry.
+ * Pre-Conditions: 	handler points into commandList.
+ * Post-Conditions: 	The registry is unchanged.
+**********************************************************************************************/
+
+int commandIndex(const struct CommandHandler* handler)
+{
+	return handler - commandList;
+}
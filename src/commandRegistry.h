@@ -0,0 +1,82 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		commandRegistry.h
+ * File Description: 	Header file for the table-driven registry of commands accepted by ftserver
+ * 			and for the in-place request parser that validates a client request against
+ * 			that registry without allocating memory.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef COMMAND_REGISTRY
+#define COMMAND_REGISTRY
+
+#include "FTInfo.h"
+
+/* Global constant representing the maximum number of arguments any registered command accepts
+ * after the command itself. */
+#define MAX_COMMAND_ARGS 2
+
+/* Global constant representing the number of slots in the command lookup table. Must be a power of 2
+ * and larger than the number of registered commands so that every lookup finds an empty slot. */
+#define COMMAND_TABLE_SIZE 16
+
+/* Error messages sent to the client when a request does not name a registered command. */
+#define NO_COMMAND_MESSAGE "NO COMMAND RECEIVED"
+#define UNRECOGNIZED_COMMAND_MESSAGE "UNRECOGNIZED COMMAND: Accepted commands are -l, -ltxt, -g <filename>, and -p <filename> <size>."
+
+/* Error message sent to the client when the size following -p is not a number of bytes. */
+#define BAD_SIZE_MESSAGE "BAD REQUEST: <size> after -p command must be a number of bytes."
+
+/* Definition of struct describing a command accepted by ftserver. Each registered command
+ * is one entry in the registry defined in commandRegistry.c. See below for variable descriptions. */
+struct CommandHandler
+{
+	char* syntax;				/* Command as sent by the client (e.g. "-g"). */
+	int arity;				/* Number of arguments required after the command. */
+	void (*handle)(struct FTInfo* myFT);	/* Function that fulfills the request over the data connection. */
+	char* missingArgMessage;		/* Error sent if fewer than arity arguments received (NULL if arity is 0). */
+	char* extraArgMessage;			/* Error sent if more than arity arguments received. */
+};
+
+/* Definition of struct filled in by parseRequest. All pointers refer to positions within the
+ * request buffer that was parsed, so they remain valid only as long as that buffer. */
+struct ParsedRequest
+{
+	char* command;					/* Command token of the request. */
+	const struct CommandHandler* handler;		/* Registry entry matching command. */
+	char* args[MAX_COMMAND_ARGS];			/* Argument tokens following command. */
+	int argCount;					/* Number of argument tokens stored in args. */
+};
+
+/* Function prototypes. */
+void initCommandRegistry();
+const struct CommandHandler* lookupCommand(char* syntax, int syntaxLen, unsigned int hash);
+char* parseRequest(char* request, struct ParsedRequest* parsed);
+int commandIndex(const struct CommandHandler* handler);
+
+#endif
@@ -0,0 +1,438 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		directRead.c
+ * File Description: 	Implementation of the direct I/O read path and its buffer pool. See
+ * 			directRead.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+/* Needed for O_DIRECT. */
+#define _GNU_SOURCE
+
+#include <linux/aio_abi.h>
+#include <sys/syscall.h>
+#include "directRead.h"
+#include "manageConnections.h"
+
+/* Definition of struct holding the reads of one direct I/O transfer. Slot i of each array describes
+ * the read into buffers[i]; slots are filled and sent in turn, so blocks are sent in file order. */
+struct DirectTransfer
+{
+	int fileFD;					/* File being sent. */
+	int depth;					/* Number of slots (buffers) in use. */
+	int async;					/* True if reads are submitted to context. */
+	aio_context_t context;				/* Asynchronous I/O context of transfer. */
+	char* buffers[MAX_DIRECT_IO_DEPTH];		/* Buffers taken from the pool. */
+	struct iocb reads[MAX_DIRECT_IO_DEPTH];		/* Read submitted for each slot. */
+	unsigned long long offsets[MAX_DIRECT_IO_DEPTH];	/* File offset each slot was read from. */
+	long long results[MAX_DIRECT_IO_DEPTH];		/* Bytes read into each slot, or -errno. */
+	int pending[MAX_DIRECT_IO_DEPTH];		/* True while a slot's read is in flight. */
+	int active[MAX_DIRECT_IO_DEPTH];		/* True if a slot holds a read not yet sent. */
+};
+
+/* Static variables. */
+static struct DirectBufferPool directPool =	/* Buffers shared by all direct I/O transfers. */
+{
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.available = PTHREAD_COND_INITIALIZER
+};
+
+/* Function prototypes of static functions. */
+static void startDirectRead(struct DirectTransfer* transfer, int slot, unsigned long long offset, int readLen);
+static void waitDirectRead(struct DirectTransfer* transfer, int slot);
+
+
+/***********************************************************************************************
+ * Function Name:	initDirectBufferPool
+ * Description:		Allocates the pool of direct_io_buffers aligned buffers of direct_io_block
+ * 			bytes (rounded up to a multiple of DIRECT_IO_ALIGNMENT). If the setting is 0,
+ * 			or no buffer can be allocated, direct I/O is disabled.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	The configuration file has been loaded, and no transfers are in progress.
+ * Post-Conditions: 	directPool holds every buffer allocated, all free.
+**********************************************************************************************/
+
+void initDirectBufferPool()
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Determine buffer size. */
+	unsigned long long blockSize = config->directIoBlock;
+	if (blockSize > MAX_DIRECT_IO_BLOCK)
+	{
+		blockSize = MAX_DIRECT_IO_BLOCK;
+	}
+	blockSize = (blockSize + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+	if (blockSize == 0)
+	{
+		blockSize = DIRECT_IO_ALIGNMENT;
+	}
+	directPool.blockSize = (int)blockSize;
+
+	/* Allocate buffers, stopping (with a warning) at the first that cannot be allocated. */
+	if (config->directIoBuffers == 0)
+	{
+		return;
+	}
+	directPool.freeBuffers = (char**)malloc(config->directIoBuffers * sizeof(char*));
+	if (directPool.freeBuffers == NULL)
+	{
+		perror("DIRECT I/O BUFFER POOL ERROR");
+		return;
+	}
+	for (unsigned long long i = 0; i < config->directIoBuffers; i++)
+	{
+		int allocResult = posix_memalign((void**)&directPool.freeBuffers[i], DIRECT_IO_ALIGNMENT, blockSize);
+		if (allocResult != 0)
+		{
+			fprintf(stderr, "DIRECT I/O BUFFER POOL ERROR: %s (%d of %llu buffers allocated)\n",
+				strerror(allocResult), directPool.numBuffers, config->directIoBuffers);
+			break;
+		}
+		directPool.numBuffers++;
+	}
+	directPool.numFree = directPool.numBuffers;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	acquireDirectBuffers
+ * Description:		Takes up to wanted buffers from the pool, waiting until at least one is
+ * 			free. A transfer that gets fewer than it wanted keeps fewer reads in flight
+ * 			rather than waiting for more.
+ * Receives: 		An array in which to store the buffers and the number wanted.
+ * Returns: 		The number of buffers taken (at least 1).
+ * Pre-Conditions: 	The pool holds at least one buffer, and wanted is at least 1.
+ * Post-Conditions: 	The buffers returned belong to the caller until released.
+**********************************************************************************************/
+
+int acquireDirectBuffers(char** buffers, int wanted)
+{
+	pthread_mutex_lock(&directPool.lock);
+	while (directPool.numFree == 0)
+	{
+		pthread_cond_wait(&directPool.available, &directPool.lock);
+	}
+	int taken = 0;
+	while (taken < wanted && directPool.numFree > 0)
+	{
+		directPool.numFree--;
+		buffers[taken] = directPool.freeBuffers[directPool.numFree];
+		taken++;
+	}
+	pthread_mutex_unlock(&directPool.lock);
+	return taken;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	releaseDirectBuffers
+ * Description:		Returns buffers to the pool and wakes any transfers waiting for them.
+ * Receives: 		The buffers and their number.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The buffers were taken by acquireDirectBuffers, and no read into them is
+ * 			in flight.
+ * Post-Conditions: 	The buffers are free.
+**********************************************************************************************/
+
+void releaseDirectBuffers(char** buffers, int count)
+{
+	pthread_mutex_lock(&directPool.lock);
+	for (int i = 0; i < count; i++)
+	{
+		directPool.freeBuffers[directPool.numFree] = buffers[i];
+		directPool.numFree++;
+	}
+	pthread_cond_broadcast(&directPool.available);
+	pthread_mutex_unlock(&directPool.lock);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	enableDirectRead
+ * Description:		Decides whether an open file should be sent with direct I/O: the pool must
+ * 			hold buffers, direct_io_min_size must be set, and the file must be at least
+ * 			that large. If so, turns on O_DIRECT for the file's descriptor, which fails
+ * 			on filesystems that do not support direct I/O (the file is then sent through
+ * 			the page cache as usual).
+ * Receives: 		The file's descriptor and a pointer at which to store its size.
+ * Returns: 		True if the file should be sent with sendFileDirect; false otherwise.
+ * Pre-Conditions: 	fileFD is open for reading.
+ * Post-Conditions: 	If true is returned, fileFD reads bypass the page cache and *fileSize
+ * 			holds the file's size.
+**********************************************************************************************/
+
+int enableDirectRead(int fileFD, unsigned long long* fileSize)
+{
+	/* Check that direct I/O is enabled and the file is large enough. */
+	unsigned long long minSize = getServerConfig()->directIoMinSize;
+	struct stat fileInfo;
+	if (directPool.numBuffers == 0 || minSize == 0 || fstat(fileFD, &fileInfo) == -1
+		|| !S_ISREG(fileInfo.st_mode) || (unsigned long long)fileInfo.st_size < minSize)
+	{
+		return 0;
+	}
+
+	/* Turn on O_DIRECT. */
+	int flags = fcntl(fileFD, F_GETFL);
+	if (flags == -1 || fcntl(fileFD, F_SETFL, flags | O_DIRECT) == -1)
+	{
+		return 0;
+	}
+	*fileSize = fileInfo.st_size;
+	return 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendFileDirect
+ * Description:		Sends a file opened for direct I/O to the client, one pool buffer per
+ * 			frame. Takes up to direct_io_depth buffers and starts a read into each; then,
+ * 			in file order, waits for each read, sends the block, and reuses its buffer for
+ * 			the next block not yet read. If the kernel does not provide asynchronous I/O,
+ * 			blocks are read one at a time instead. The file is sent as it was when
+ * 			opened: data appended after that is not sent, and if the file shrinks, the
+ * 			transfer ends at its new end. Finally, sends the success message (or an error
+ * 			message if a read failed) over the control socket.
+ * Receives: 		A struct FTInfo pointer, the file (of which it takes ownership), and the
+ * 			file's size.
+ * Returns: 		nothing
+ * Pre-Conditions: 	enableDirectRead has returned true for fileToSend, and the data
+ * 			connection has been validated.
+ * Post-Conditions: 	The file has been closed and its buffers returned to the pool, and the
+ * 			file and a success message, or an error message, have been sent unless
+ * 			sending failed.
+**********************************************************************************************/
+
+void sendFileDirect(struct FTInfo* myFT, int fileToSend, unsigned long long fileSize)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Take buffers for as many reads in flight as configured, but no more than the file has blocks. */
+	struct DirectTransfer transfer;
+	memset(&transfer, 0, sizeof(transfer));
+	transfer.fileFD = fileToSend;
+	unsigned long long blockSize = directPool.blockSize;
+	unsigned long long numBlocks = (fileSize + blockSize - 1) / blockSize;
+	unsigned long long wanted = config->directIoDepth;
+	if (wanted > MAX_DIRECT_IO_DEPTH)
+	{
+		wanted = MAX_DIRECT_IO_DEPTH;
+	}
+	if (wanted > numBlocks)
+	{
+		wanted = numBlocks;
+	}
+	transfer.depth = acquireDirectBuffers(transfer.buffers, wanted > 0 ? (int)wanted : 1);
+
+	/* Set up asynchronous I/O if more than one read is to be in flight. Without it, only one
+	 * buffer is of use, so the rest are returned. */
+	transfer.async = transfer.depth > 1 && syscall(SYS_io_setup, transfer.depth, &transfer.context) == 0;
+	if (!transfer.async)
+	{
+		releaseDirectBuffers(transfer.buffers + 1, transfer.depth - 1);
+		transfer.depth = 1;
+	}
+
+	/* Take the first TCP sample of the transfer, and cork data socket until file has been sent. */
+	startTcpSampling(&myFT->tcp, myFT->dataSocketFD, config->tcpSampleIntervalMs);
+	corkSocket(myFT->dataSocketFD, 1);
+
+	/* Start a read into each slot. */
+	unsigned long long nextOffset = 0;	/* Offset of next block to read. */
+	for (int slot = 0; slot < transfer.depth && nextOffset < fileSize; slot++)
+	{
+		startDirectRead(&transfer, slot, nextOffset, (int)blockSize);
+		nextOffset += blockSize;
+	}
+
+	/* Send blocks in file order until every slot is idle. */
+	unsigned long long totalSent = 0;
+	int readFailed = 0;
+	int sendFailed = 0;
+	int slot = 0;
+	while (transfer.active[slot])
+	{
+		/* Wait for slot's read, stopping upon error. */
+		waitDirectRead(&transfer, slot);
+		transfer.active[slot] = 0;
+		long long charsRead = transfer.results[slot];
+		if (charsRead < 0)
+		{
+			errno = (int)-charsRead;
+			readFailed = 1;
+			break;
+		}
+
+		/* Send what was read up to the file's size when opened, stopping upon error. */
+		unsigned long long remaining = fileSize - transfer.offsets[slot];
+		int charsToSend = ((unsigned long long)charsRead < remaining) ? (int)charsRead : (int)remaining;
+		if (charsToSend > 0)
+		{
+			shapeTransfer(myFT->shaper, charsToSend);
+			if (sendFrame(myFT->dataSocketFD, transfer.buffers[slot], charsToSend) == -1)
+			{
+				sendFailed = 1;
+				break;
+			}
+			countDataSent(myFT, charsToSend);
+			totalSent += charsToSend;
+
+			/* Log a periodic TCP sample of the transfer if one is due, resizing the send buffer
+			 * for the rate and round-trip time sampled. */
+			if (sampleTcpIfDue(&myFT->tcp, config->tcpSampleIntervalMs))
+			{
+				logTcpEvent(LOG_TCP_SAMPLE, myFT, &myFT->tcp.latest, 0);
+				resizeDataBuffer(myFT->dataSocketFD, myFT->tcp.latest.rttUs, myFT->tcp.latest.deliveryRate);
+			}
+		}
+
+		/* A short read means the file has shrunk, so read no further. Otherwise, reuse the slot
+		 * for the next block, and move on to the slot holding the block after this one. */
+		if ((unsigned long long)charsRead < blockSize && (unsigned long long)charsRead < remaining)
+		{
+			nextOffset = fileSize;
+		}
+		if (nextOffset < fileSize)
+		{
+			startDirectRead(&transfer, slot, nextOffset, (int)blockSize);
+			nextOffset += blockSize;
+		}
+		slot = (slot + 1) % transfer.depth;
+	}
+
+	/* Wait for any reads still in flight (io_destroy does) before returning buffers to the pool. */
+	int transferErrno = errno;
+	if (transfer.async)
+	{
+		syscall(SYS_io_destroy, transfer.context);
+	}
+	releaseDirectBuffers(transfer.buffers, transfer.depth);
+	close(fileToSend);
+	errno = transferErrno;
+
+	/* If sending failed, summarize transfer as TCP saw it and return. */
+	if (sendFailed)
+	{
+		reportTcpTransfer(myFT);
+		return;
+	}
+
+	/* Otherwise, uncork data socket, summarize transfer, and send success or error message. */
+	corkSocket(myFT->dataSocketFD, 0);
+	reportTcpTransfer(myFT);
+	if (readFailed)
+	{
+		sendErrorMessage(myFT);
+		return;
+	}
+	STAT_ADD(filesReadDirect, 1);
+	STAT_ADD(bytesReadDirect, totalSent);
+	sendSuccessMessage(myFT, totalSent);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startDirectRead
+ * Description:		Starts a read of readLen bytes at offset into a slot's buffer. For an
+ * 			asynchronous transfer the read is submitted and completes later; otherwise
+ * 			it is made now. A read that cannot be submitted is recorded as failed.
+ * Receives: 		The transfer, the slot, the offset, and the length to read (both
+ * 			multiples of DIRECT_IO_ALIGNMENT).
+ * Returns: 		nothing
+ * Pre-Conditions: 	The slot is idle.
+ * Post-Conditions: 	The slot is active, and its result is set or its read is pending.
+**********************************************************************************************/
+
+static void startDirectRead(struct DirectTransfer* transfer, int slot, unsigned long long offset, int readLen)
+{
+	transfer->offsets[slot] = offset;
+	transfer->active[slot] = 1;
+
+	/* Without asynchronous I/O, read now. */
+	if (!transfer->async)
+	{
+		ssize_t charsRead;
+		do
+		{
+			charsRead = pread(transfer->fileFD, transfer->buffers[slot], readLen, (off_t)offset);
+		} while (charsRead == -1 && errno == EINTR);
+		transfer->results[slot] = (charsRead == -1) ? -errno : charsRead;
+		return;
+	}
+
+	/* Otherwise, describe the read, tagged with its slot, and submit it. */
+	struct iocb* read = &transfer->reads[slot];
+	memset(read, 0, sizeof(*read));
+	read->aio_data = slot;
+	read->aio_lio_opcode = IOCB_CMD_PREAD;
+	read->aio_fildes = transfer->fileFD;
+	read->aio_buf = (unsigned long long)(uintptr_t)transfer->buffers[slot];
+	read->aio_nbytes = readLen;
+	read->aio_offset = offset;
+	struct iocb* readList[1] = { read };
+	if (syscall(SYS_io_submit, transfer->context, 1, readList) != 1)
+	{
+		transfer->results[slot] = -errno;
+		return;
+	}
+	transfer->pending[slot] = 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	waitDirectRead
+ * Description:		Waits for a slot's read to complete, recording the results of any other
+ * 			reads that complete meanwhile.
+ * Receives: 		The transfer and the slot.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The slot is active.
+ * Post-Conditions: 	The slot's result is set.
+**********************************************************************************************/
+
+static void waitDirectRead(struct DirectTransfer* transfer, int slot)
+{
+	while (transfer->pending[slot])
+	{
+		struct io_event events[MAX_DIRECT_IO_DEPTH];
+		long numEvents = syscall(SYS_io_getevents, transfer->context, 1, transfer->depth, events, NULL);
+		if (numEvents == -1 && errno != EINTR)
+		{
+			transfer->results[slot] = -errno;
+			transfer->pending[slot] = 0;
+			return;
+		}
+		for (long i = 0; i < numEvents; i++)
+		{
+			int completed = (int)events[i].data;
+			transfer->results[completed] = events[i].res;
+			transfer->pending[completed] = 0;
+		}
+	}
+}
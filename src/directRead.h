@@ -0,0 +1,74 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		directRead.h
+ * File Description: 	Header file for the direct I/O read path used to send files of at least
+ * 			direct_io_min_size bytes. Such files are read with O_DIRECT, bypassing the
+ * 			page cache, so that sending a huge file once does not push the hot working
+ * 			set of small files out of memory. Reads are made into page-aligned buffers
+ * 			taken from a pool allocated once at startup (direct_io_buffers buffers of
+ * 			direct_io_block bytes each), and up to direct_io_depth reads per transfer are
+ * 			kept in flight with Linux native asynchronous I/O while earlier blocks are
+ * 			sent, so the disk is never idle while the socket drains.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef DIRECT_READ
+#define DIRECT_READ
+
+#include <pthread.h>
+#include "FTInfo.h"
+
+/* Global constant representing the alignment (in bytes) that direct I/O requires of buffer
+ * addresses, file offsets, and read lengths. */
+#define DIRECT_IO_ALIGNMENT 4096
+
+/* Global constants representing the largest buffer in the pool and the most reads one transfer
+ * may keep in flight. */
+#define MAX_DIRECT_IO_BLOCK 67108864
+#define MAX_DIRECT_IO_DEPTH 64
+
+/* Definition of struct describing the pool of aligned buffers shared by all direct I/O transfers.
+ * See below for variable descriptions. */
+struct DirectBufferPool
+{
+	pthread_mutex_t lock;		/* Protects the fields below. */
+	pthread_cond_t available;	/* Signaled when buffers are returned to the pool. */
+	char** freeBuffers;		/* Stack of buffers not in use. */
+	int numFree;			/* Number of buffers in freeBuffers. */
+	int numBuffers;			/* Number of buffers allocated (0 if direct I/O is disabled). */
+	int blockSize;			/* Size of each buffer, a multiple of DIRECT_IO_ALIGNMENT. */
+};
+
+/* Function prototypes. */
+void initDirectBufferPool();
+int acquireDirectBuffers(char** buffers, int wanted);
+void releaseDirectBuffers(char** buffers, int count);
+int enableDirectRead(int fileFD, unsigned long long* fileSize);
+void sendFileDirect(struct FTInfo* myFT, int fileToSend, unsigned long long fileSize);
+
+#endif
@@ -0,0 +1,383 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		fileUpload.c
+ * File Description: 	Implementation of the handler of the put command and the functions it uses
+ * 			to preallocate, write, and commit an upload. See fileUpload.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+/* Needed for fallocate and sync_file_range. */
+#define _GNU_SOURCE
+
+#include "fileUpload.h"
+#include "manageConnections.h"
+
+/* Global constant representing the largest block in which an upload is received and written. */
+#define MAX_UPLOAD_BLOCK 67108864
+
+
+/***********************************************************************************************
+ * Function Name:	receiveFileFromClient
+ * Description:		Receives the file named in a put request over the data connection,
+ * 			writing it into a temporary file preallocated to the size announced in
+ * 			the request, one aligned block of upload_write_block bytes at a time
+ * 			(writing each behind if upload_write_behind is set). Once the announced
+ * 			number of bytes has been received, commits the upload by renaming the
+ * 			temporary file over the file named and sends the client a success message
+ * 			with the number of bytes received. Upon any error, the temporary file is
+ * 			removed and the client is sent an error message instead.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The controlSocketFD and dataSocketFD refer to connections already
+ * 			established with the client, and myFT->requestSize holds the size
+ * 			announced in the request.
+ * Post-Conditions: 	Either the file has been replaced by the complete upload and a success
+ * 			message has been sent, or the file is unchanged and an error message has
+ * 			been sent, through the control socket.
+**********************************************************************************************/
+
+void receiveFileFromClient(struct FTInfo* myFT)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Log request. */
+	logEvent(LOG_FILE_REQUESTED, myFT, myFT->filename, 0);
+	unsigned long long size = myFT->requestSize;
+
+	/* Refuse to write anywhere but a file in the server's directory. */
+	if (!validUploadName(myFT->filename))
+	{
+		errno = EINVAL;
+		abortUpload(myFT, -1, NULL);
+		return;
+	}
+
+	/* Create the temporary file, preallocated to the size announced. */
+	char tempName[strlen(myFT->filename) + sizeof(UPLOAD_TEMP_FORMAT)];
+	int uploadFile = createUploadFile(myFT->filename, size, tempName, sizeof(tempName));
+	if (uploadFile == -1)
+	{
+		abortUpload(myFT, -1, NULL);
+		return;
+	}
+
+	/* Allocate a block buffer aligned to UPLOAD_ALIGNMENT, rounding the block size up to a
+	 * multiple of it. */
+	unsigned long long blockSize = config->uploadWriteBlock;
+	if (blockSize > MAX_UPLOAD_BLOCK)
+	{
+		blockSize = MAX_UPLOAD_BLOCK;
+	}
+	blockSize = (blockSize + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+	if (blockSize == 0)
+	{
+		blockSize = UPLOAD_ALIGNMENT;
+	}
+	char* block = NULL;
+	int allocResult = posix_memalign((void**)&block, UPLOAD_ALIGNMENT, blockSize);
+	if (allocResult != 0)
+	{
+		errno = allocResult;
+		abortUpload(myFT, uploadFile, tempName);
+		return;
+	}
+
+	/* Limit how long each receive may wait on a client that stops sending, and log that the upload
+	 * is being received. */
+	setRecvTimeout(myFT->dataSocketFD, (int)config->sendStallTimeoutMs);
+	logEvent(LOG_FILE_RECEIVING, myFT, myFT->filename, size);
+
+	/* Receive and write one block at a time until the announced number of bytes has been written. */
+	int writeBehindOn = config->uploadWriteBehind != 0;
+	unsigned long long bytesWritten = 0;
+	int previousLen = 0;		/* Length of block written before the current one. */
+	while (bytesWritten < size)
+	{
+		/* Receive the next block (shorter than blockSize only at the end of the file). */
+		int blockLen = (size - bytesWritten < blockSize) ? (int)(size - bytesWritten) : (int)blockSize;
+		if (recvUploadBlock(myFT->dataSocketFD, block, blockLen) == -1)
+		{
+			free(block);
+			abortUpload(myFT, uploadFile, tempName);
+			return;
+		}
+		if (bytesWritten == 0)
+		{
+			markPhase(myFT, PHASE_FIRST_BYTE);
+		}
+		shapeTransfer(myFT->shaper, blockLen);
+
+		/* Write block at its offset in the file. */
+		int blockWritten = 0;
+		while (blockWritten < blockLen)
+		{
+			ssize_t charsWritten = pwrite(uploadFile, block + blockWritten, blockLen - blockWritten,
+				(off_t)(bytesWritten + blockWritten));
+			if (charsWritten == -1 && errno != EINTR)
+			{
+				free(block);
+				abortUpload(myFT, uploadFile, tempName);
+				return;
+			}
+			if (charsWritten > 0)
+			{
+				blockWritten += charsWritten;
+			}
+		}
+		STAT_ADD(bytesReceived, blockLen);
+
+		/* Write block behind if enabled, and move on to the next. */
+		if (writeBehindOn)
+		{
+			writeBehind(uploadFile, bytesWritten, blockLen, previousLen);
+		}
+		bytesWritten += blockLen;
+		previousLen = blockLen;
+	}
+	free(block);
+
+	/* Commit the upload, sending error message upon failure. */
+	if (commitUpload(uploadFile, tempName, myFT->filename) == -1)
+	{
+		abortUpload(myFT, uploadFile, tempName);
+		return;
+	}
+	close(uploadFile);
+	STAT_ADD(filesReceived, 1);
+	sendSuccessMessage(myFT, size);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	validUploadName
+ * Description:		Checks that the name of a file to be uploaded names a file in the server's
+ * 			directory: it must not be empty, contain a '/', or be "." or "..".
+ * Receives: 		The filename from the request.
+ * Returns: 		True if the file may be uploaded; false otherwise.
+ * Pre-Conditions: 	filename is a non-null string.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+int validUploadName(char* filename)
+{
+	return filename[0] != '\0' && strchr(filename, '/') == NULL
+		&& strcmp(filename, ".") != 0 && strcmp(filename, "..") != 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	createUploadFile
+ * Description:		Creates a uniquely-named hidden temporary file in the server's directory
+ * 			to hold an upload and allocates size bytes of disk space to it, so that
+ * 			the filesystem can allocate the upload in as few extents as possible and
+ * 			an upload too large for the disk fails before any of it is received.
+ * 			Filesystems that cannot preallocate leave the file to grow as it is
+ * 			written.
+ * Receives: 		The name of the file being uploaded, the size announced, and a buffer of
+ * 			tempNameSize bytes in which to store the temporary file's name.
+ * Returns: 		The temporary file's descriptor, or -1 (with errno set) upon error.
+ * Pre-Conditions: 	tempName can hold filename formatted with UPLOAD_TEMP_FORMAT.
+ * Post-Conditions: 	If a descriptor is returned, tempName holds the name of the file it refers
+ * 			to. Otherwise, no temporary file exists.
+**********************************************************************************************/
+
+int createUploadFile(char* filename, unsigned long long size, char* tempName, int tempNameSize)
+{
+	/* Create temporary file, returning upon error. */
+	snprintf(tempName, tempNameSize, UPLOAD_TEMP_FORMAT, filename);
+	int fileFD = mkstemp(tempName);
+	if (fileFD == -1)
+	{
+		return -1;
+	}
+
+	/* Preallocate it, removing it upon any error other than the filesystem not supporting it. */
+	if (size > 0 && fallocate(fileFD, 0, 0, (off_t)size) == -1 && errno != EOPNOTSUPP)
+	{
+		int allocErrno = errno;
+		close(fileFD);
+		unlink(tempName);
+		errno = allocErrno;
+		return -1;
+	}
+	return fileFD;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvUploadBlock
+ * Description:		Receives exactly blockLen bytes of an upload from the data socket.
+ * Receives: 		The data socket, the buffer to fill, and the number of bytes to receive.
+ * Returns: 		0 once blockLen bytes have been received; -1 (with errno set) if the
+ * 			client closes the connection first, stalls longer than the socket's receive
+ * 			timeout (ETIMEDOUT, counted as a send stall timeout), or an error occurs.
+ * Pre-Conditions: 	block holds at least blockLen bytes.
+ * Post-Conditions: 	If 0 is returned, block holds the next blockLen bytes of the upload.
+**********************************************************************************************/
+
+int recvUploadBlock(int socketFD, char* block, int blockLen)
+{
+	int blockReceived = 0;
+	while (blockReceived < blockLen)
+	{
+		/* MSG_WAITALL lets a single call fill the rest of the block. */
+		ssize_t charsRead = tlsRecv(socketFD, block + blockReceived, blockLen - blockReceived, MSG_WAITALL);
+		if (charsRead > 0)
+		{
+			blockReceived += charsRead;
+		}
+		else if (charsRead == 0)
+		{
+			errno = ECONNRESET;
+			return -1;
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			STAT_ADD(sendStallTimeouts, 1);
+			errno = ETIMEDOUT;
+			return -1;
+		}
+		else if (errno != EINTR)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	writeBehind
+ * Description:		Starts writing the block just written to disk without waiting for it,
+ * 			then waits for the previous block (whose writing began one block ago, so
+ * 			is usually finished) and drops it from the page cache. An upload thus
+ * 			keeps the disk busy while the next block is received, yet never holds more
+ * 			than two blocks of dirty pages or pushes other files out of the page cache.
+ * 			Errors are ignored, since the data stays in the page cache to be written
+ * 			later (and synced, if upload_fsync is set) regardless.
+ * Receives: 		The upload file, the offset and length of the block just written, and the
+ * 			length of the block before it (0 if none).
+ * Returns: 		nothing
+ * Pre-Conditions: 	The block has just been written at offset.
+ * Post-Conditions: 	The block is being written to disk, and the previous block has been.
+**********************************************************************************************/
+
+void writeBehind(int fileFD, unsigned long long offset, int blockLen, int previousLen)
+{
+	sync_file_range(fileFD, (off_t)offset, blockLen, SYNC_FILE_RANGE_WRITE);
+	if (previousLen > 0)
+	{
+		off_t previousOffset = (off_t)offset - previousLen;
+		sync_file_range(fileFD, previousOffset, previousLen,
+			SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+		posix_fadvise(fileFD, previousOffset, previousLen, POSIX_FADV_DONTNEED);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	commitUpload
+ * Description:		Makes a complete upload visible under the name the client gave: syncs
+ * 			its data (unless upload_fsync is UPLOAD_FSYNC_NONE), gives it the usual
+ * 			permissions of a new file (mkstemp creates it readable only by the server),
+ * 			and renames it over filename, replacing any file of that name at once.
+ * 			With UPLOAD_FSYNC_DIRECTORY, also syncs the directory so that the rename
+ * 			is on disk before the client is told the upload succeeded.
+ * Receives: 		The temporary file's descriptor and name, and the name to commit it as.
+ * Returns: 		0 on success; -1 (with errno set) on failure.
+ * Pre-Conditions: 	Every byte of the upload has been written to the temporary file.
+ * Post-Conditions: 	If 0 is returned, filename holds the upload. The descriptor stays open.
+**********************************************************************************************/
+
+int commitUpload(int fileFD, char* tempName, char* filename)
+{
+	/* Read policy once so that a reload part way through cannot mix policies. */
+	unsigned long long fsyncPolicy = getServerConfig()->uploadFsync;
+
+	/* Sync file's data if required, set its permissions, and rename it. */
+	if (fsyncPolicy >= UPLOAD_FSYNC_FILE && fdatasync(fileFD) == -1)
+	{
+		return -1;
+	}
+	if (fchmod(fileFD, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == -1 || rename(tempName, filename) == -1)
+	{
+		return -1;
+	}
+
+	/* Sync directory if required. */
+	if (fsyncPolicy >= UPLOAD_FSYNC_DIRECTORY)
+	{
+		int directoryFD = open(".", O_RDONLY | O_DIRECTORY);
+		if (directoryFD == -1)
+		{
+			return -1;
+		}
+		int result = fsync(directoryFD);
+		int syncErrno = errno;
+		close(directoryFD);
+		errno = syncErrno;
+		return result;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	abortUpload
+ * Description:		Abandons an upload: closes and removes its temporary file (if created),
+ * 			closes the data socket so that a client still sending fails at once rather
+ * 			than filling the socket buffer, and sends the client an error message
+ * 			describing errno on the control socket.
+ * Receives: 		A struct FTInfo pointer, the temporary file's descriptor (or -1), and its
+ * 			name (or NULL).
+ * Returns: 		nothing
+ * Pre-Conditions: 	errno describes the error that ended the upload.
+ * Post-Conditions: 	The temporary file no longer exists, the data socket is closed, and an
+ * 			error message has been sent unless sending failed.
+**********************************************************************************************/
+
+void abortUpload(struct FTInfo* myFT, int fileFD, char* tempName)
+{
+	int uploadErrno = errno;
+	if (fileFD >= 0)
+	{
+		close(fileFD);
+	}
+	if (tempName != NULL)
+	{
+		unlink(tempName);
+	}
+	if (myFT->dataSocketFD >= 0)
+	{
+		endTls(myFT->dataSocketFD);
+		close(myFT->dataSocketFD);
+		myFT->dataSocketFD = -5;
+	}
+	errno = uploadErrno;
+	sendErrorMessage(myFT);
+}
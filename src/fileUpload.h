@@ -0,0 +1,70 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		fileUpload.h
+ * File Description: 	Header file for the handler of the put command (-p FILENAME SIZE), which
+ * 			receives a file of SIZE bytes that the client streams over the data
+ * 			connection. The upload is written into a hidden temporary file in the
+ * 			server's directory, preallocated to SIZE bytes so that the filesystem can
+ * 			lay it out contiguously, in blocks of upload_write_block bytes aligned to
+ * 			the page size. With upload_write_behind set, each block is handed to the
+ * 			disk as soon as it is written and dropped from the page cache once the
+ * 			disk has it, so an upload never builds up more than two blocks of dirty
+ * 			pages. Once every byte has arrived, the file is synced as upload_fsync
+ * 			directs and renamed over FILENAME, so other clients see either the old
+ * 			file or the complete new one, never a partial upload.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef FILE_UPLOAD
+#define FILE_UPLOAD
+
+#include "FTInfo.h"
+
+/* Global constant representing the alignment (in bytes) of upload blocks in memory and in the file. */
+#define UPLOAD_ALIGNMENT 4096
+
+/* Global constant representing the format of the name of the temporary file holding an upload
+ * (formatted with the name of the file uploaded, as mkstemp requires). */
+#define UPLOAD_TEMP_FORMAT ".%s.XXXXXX"
+
+/* Values of upload_fsync: commit without syncing, sync the file's data before renaming it, or also
+ * sync the directory after renaming so that the rename itself survives a crash. */
+#define UPLOAD_FSYNC_NONE 0
+#define UPLOAD_FSYNC_FILE 1
+#define UPLOAD_FSYNC_DIRECTORY 2
+
+/* Function prototypes. */
+void receiveFileFromClient(struct FTInfo* myFT);
+int validUploadName(char* filename);
+int createUploadFile(char* filename, unsigned long long size, char* tempName, int tempNameSize);
+int recvUploadBlock(int socketFD, char* block, int blockLen);
+void writeBehind(int fileFD, unsigned long long offset, int blockLen, int previousLen);
+int commitUpload(int fileFD, char* tempName, char* filename);
+void abortUpload(struct FTInfo* myFT, int fileFD, char* tempName);
+
+#endif
@@ -0,0 +1,539 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		framingBench.c
+ * File Description: 	Implementation file for framebench, a microbenchmark of the framing layer
+ * 			in clientServerMessaging.c. Usage: framebench [-t] [-i IMPL[,IMPL]...] [-j]
+ * 			Each framing implementation (a sender and a receiver) moves frames of
+ * 			16 B to 1 MB over a socketpair (or, with -t, a loopback TCP connection)
+ * 			between two threads. For every frame size, ns per frame, send and
+ * 			receive syscalls per frame, and GB/s are reported as text or (with -j)
+ * 			as one JSON object per line. The "current" implementation calls
+ * 			sendMessage and recvMessage themselves; the others are candidates for
+ * 			replacing them, so that any change to framing has numbers behind it.
+ * 			Syscalls are counted by wrapping send, recv, writev, and poll at link
+ * 			time (see the framebench target in the makefile).
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include "clientServerMessaging.h"
+#include "serverConfig.h"
+
+/* Global constants representing smallest and largest frame sizes measured (each size is 4 times
+ * the previous), bytes moved per measurement, frame count limits per measurement, and the
+ * timeout passed to recvMessage (the server always passes one, so the current receiver polls). */
+#define MIN_FRAME_SIZE 16
+#define MAX_FRAME_SIZE 1048576
+#define BYTES_PER_RUN 33554432
+#define MIN_FRAMES_PER_RUN 64
+#define MAX_FRAMES_PER_RUN 50000
+#define RECV_TIMEOUT_MS 5000
+
+/* Definition of struct describing a framing implementation. See below for variable descriptions. */
+struct FramingImpl
+{
+	char* name;					/* Name given with -i. */
+	int (*sendFrame)(int socketFD, char* message, int length);	/* Sends one frame. */
+	char* (*recvFrame)(int socketFD);		/* Receives one frame into a malloc'd string. */
+	int maxFrame;					/* Largest frame recvFrame accepts. */
+};
+
+/* Definition of struct passed to the receiving thread. */
+struct ReceiverArgs
+{
+	int socketFD;				/* Socket to receive from. */
+	int frames;				/* Number of frames to receive. */
+	int frameSize;				/* Expected length of every frame. */
+	const struct FramingImpl* impl;		/* Implementation whose receiver is measured. */
+	unsigned long long syscalls;		/* Syscalls made by receiver, set by thread. */
+	int errors;				/* Frames missing or of the wrong length, set by thread. */
+};
+
+/* Syscalls made by the calling thread, counted by the wrappers below. */
+static __thread unsigned long long syscallCount = 0;
+
+/* Definitions of syscall wrappers. The linker directs every call to send, recv, writev, and
+ * poll (including those in clientServerMessaging.c) to __wrap_<name>, which counts the call and
+ * makes it through __real_<name>. */
+ssize_t __real_send(int socketFD, const void* buffer, size_t length, int flags);
+ssize_t __real_recv(int socketFD, void* buffer, size_t length, int flags);
+ssize_t __real_writev(int fd, const struct iovec* iov, int iovcnt);
+int __real_poll(struct pollfd* fds, nfds_t nfds, int timeout);
+
+ssize_t __wrap_send(int socketFD, const void* buffer, size_t length, int flags)
+{
+	syscallCount++;
+	return __real_send(socketFD, buffer, length, flags);
+}
+
+ssize_t __wrap_recv(int socketFD, void* buffer, size_t length, int flags)
+{
+	syscallCount++;
+	return __real_recv(socketFD, buffer, length, flags);
+}
+
+ssize_t __wrap_writev(int fd, const struct iovec* iov, int iovcnt)
+{
+	syscallCount++;
+	return __real_writev(fd, iov, iovcnt);
+}
+
+int __wrap_poll(struct pollfd* fds, nfds_t nfds, int timeout)
+{
+	syscallCount++;
+	return __real_poll(fds, nfds, timeout);
+}
+
+/* Definitions required by clientServerMessaging.c, which counts errors in serverStats, and by
+ * tlsTransport.c, which reads the server configuration (leaving TLS off). */
+static struct ServerStats benchStats;
+struct ServerStats* serverStats = &benchStats;
+static struct ServerConfig benchConfig;
+struct ServerConfig* getServerConfig()
+{
+	return &benchConfig;
+}
+
+/* Function prototypes. */
+int sendCurrent(int socketFD, char* message, int length);
+int sendWritev(int socketFD, char* message, int length);
+char* recvCurrent(int socketFD);
+char* recvPeek(int socketFD);
+char* recvBuffered(int socketFD);
+int connectedPair(int useTCP, int* sendFD, int* recvFD);
+void* receiver(void* arg);
+unsigned long long nowNs();
+
+/* Implementations measured, in the order reported. */
+static const struct FramingImpl impls[] =
+{
+	{ "current", sendCurrent, recvCurrent, MAX_MESSAGE_LEN },	/* sendMessage / recvMessage. */
+	{ "writev", sendWritev, recvCurrent, MAX_MESSAGE_LEN },		/* One writev per frame. */
+	{ "writev-peek", sendWritev, recvPeek, MAX_FRAME_SIZE },	/* Length read with one MSG_PEEK. */
+	{ "writev-buffered", sendWritev, recvBuffered, MAX_FRAME_SIZE }	/* Receiver reads in 64 KB chunks. */
+};
+
+
+/***********************************************************************************************
+ * Function Name:	main
+ * Description:		Entry point for framebench execution. Measures each selected
+ * 			implementation at each frame size and prints the results.
+ * Receives: 		An array of strings representing command line arguments.
+ * Returns: 		0 on success; 1 upon usage error; 2 if any frame was corrupted.
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	Results have been printed to stdout.
+***********************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	/* Parse options. */
+	int useTCP = 0, json = 0;
+	char* selected = NULL;
+	int option;
+	while ((option = getopt(argc, argv, "ti:j")) != -1)
+	{
+		switch (option)
+		{
+			case 't':
+				useTCP = 1;
+				break;
+			case 'i':
+				selected = optarg;
+				break;
+			case 'j':
+				json = 1;
+				break;
+			default:
+				fprintf(stderr, "USAGE: %s [-t] [-i IMPL[,IMPL]...] [-j]\n", argv[0]);
+				exit(1);
+		}
+	}
+
+	/* Build a frame of the largest size; smaller frames are its tail (so each is null-terminated). */
+	char* frameBuffer = malloc(MAX_FRAME_SIZE + 1);
+	memset(frameBuffer, 'x', MAX_FRAME_SIZE);
+	frameBuffer[MAX_FRAME_SIZE] = '\0';
+
+	if (!json)
+	{
+		printf("%-16s %8s %8s %10s %10s %10s %8s\n", "impl", "size", "frames", "ns/frame",
+			"send sys", "recv sys", "GB/s");
+	}
+	int corrupted = 0;
+	int numImpls = sizeof(impls) / sizeof(impls[0]);
+	for (int i = 0; i < numImpls; i++)
+	{
+		/* Skip implementations not selected with -i. */
+		const struct FramingImpl* impl = &impls[i];
+		if (selected != NULL)
+		{
+			char* match = strstr(selected, impl->name);
+			int nameLen = strlen(impl->name);
+			if (match == NULL || (match != selected && match[-1] != ',')
+				|| (match[nameLen] != '\0' && match[nameLen] != ','))
+			{
+				continue;
+			}
+		}
+
+		for (int size = MIN_FRAME_SIZE; size <= MAX_FRAME_SIZE; size *= 4)
+		{
+			/* Report sizes receiver does not accept. */
+			if (size > impl->maxFrame)
+			{
+				if (!json)
+				{
+					printf("%-16s %8d %8s   (larger than receiver accepts)\n", impl->name, size, "-");
+				}
+				continue;
+			}
+
+			/* Move enough frames to make timing stable, within limits. */
+			int frames = BYTES_PER_RUN / size;
+			frames = (frames < MIN_FRAMES_PER_RUN) ? MIN_FRAMES_PER_RUN : frames;
+			frames = (frames > MAX_FRAMES_PER_RUN) ? MAX_FRAMES_PER_RUN : frames;
+
+			int sendFD, recvFD;
+			if (connectedPair(useTCP, &sendFD, &recvFD) == -1)
+			{
+				exit(1);
+			}
+			struct ReceiverArgs args = { recvFD, frames, size, impl, 0, 0 };
+			char* frame = frameBuffer + MAX_FRAME_SIZE - size;
+
+			/* Time from first send until receiver has received the last frame. */
+			pthread_t receiverThread;
+			unsigned long long startNs = nowNs();
+			pthread_create(&receiverThread, NULL, receiver, &args);
+			syscallCount = 0;
+			for (int f = 0; f < frames; f++)
+			{
+				if (impl->sendFrame(sendFD, frame, size) == -1)
+				{
+					break;
+				}
+			}
+			unsigned long long sendSyscalls = syscallCount;
+			pthread_join(receiverThread, NULL);
+			double elapsedNs = nowNs() - startNs;
+			close(sendFD);
+			close(recvFD);
+			corrupted |= (args.errors > 0);
+
+			/* Print result. */
+			double nsPerFrame = elapsedNs / frames;
+			double gbPerSec = (double)size * frames / elapsedNs;
+			if (json)
+			{
+				printf("{\"impl\": \"%s\", \"transport\": \"%s\", \"size\": %d, \"frames\": %d, "
+					"\"ns_per_frame\": %.1f, \"send_syscalls_per_frame\": %.2f, "
+					"\"recv_syscalls_per_frame\": %.2f, \"gb_per_sec\": %.3f, \"errors\": %d}\n",
+					impl->name, useTCP ? "tcp" : "unix", size, frames, nsPerFrame,
+					(double)sendSyscalls / frames, (double)args.syscalls / frames, gbPerSec, args.errors);
+			}
+			else
+			{
+				printf("%-16s %8d %8d %10.1f %10.2f %10.2f %8.3f%s\n", impl->name, size, frames, nsPerFrame,
+					(double)sendSyscalls / frames, (double)args.syscalls / frames, gbPerSec,
+					args.errors > 0 ? "  CORRUPTED" : "");
+			}
+			fflush(stdout);
+		}
+	}
+	free(frameBuffer);
+	return corrupted ? 2 : 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	receiver
+ * Description:		Thread function that receives the expected number of frames with the
+ * 			implementation's receiver, checking each frame's length.
+ * Receives: 		A pointer to a struct ReceiverArgs.
+ * Returns: 		NULL
+ * Pre-Conditions: 	The sending end of args->socketFD is sending args->frames frames.
+ * Post-Conditions: 	args->syscalls and args->errors have been set.
+**********************************************************************************************/
+
+void* receiver(void* arg)
+{
+	struct ReceiverArgs* args = (struct ReceiverArgs*)arg;
+	syscallCount = 0;
+	for (int f = 0; f < args->frames; f++)
+	{
+		char* message = args->impl->recvFrame(args->socketFD);
+		if (message == NULL)
+		{
+			args->errors += args->frames - f;
+			break;
+		}
+		if ((int)strlen(message) != args->frameSize)
+		{
+			args->errors++;
+		}
+		free(message);
+	}
+	args->syscalls = syscallCount;
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendCurrent
+ * Description:		Sends a frame with sendMessage, as ftserver does.
+ * Receives: 		A connected socket, the message, and its length (unused).
+ * Returns: 		0 on success; -1 on failure.
+**********************************************************************************************/
+
+int sendCurrent(int socketFD, char* message, int length)
+{
+	return sendMessage(socketFD, message);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendWritev
+ * Description:		Sends the length prefix and message together with writev, so each
+ * 			frame normally costs one syscall and the prefix is never sent alone.
+ * Receives: 		A connected socket, the message, and its length.
+ * Returns: 		0 on success; -1 on failure.
+**********************************************************************************************/
+
+int sendWritev(int socketFD, char* message, int length)
+{
+	char prefix[16];
+	int prefixLen = sprintf(prefix, "%d@", length);
+	struct iovec parts[2] = { { prefix, prefixLen }, { message, length } };
+	struct iovec* next = parts;
+	int partsLeft = 2;
+	while (partsLeft > 0)
+	{
+		ssize_t charsSent = writev(socketFD, next, partsLeft);
+		if (charsSent < 0)
+		{
+			perror("SEND ERROR");
+			return -1;
+		}
+
+		/* Skip parts sent completely, then advance within a partly sent part. */
+		while (partsLeft > 0 && (size_t)charsSent >= next->iov_len)
+		{
+			charsSent -= next->iov_len;
+			next++;
+			partsLeft--;
+		}
+		if (partsLeft > 0)
+		{
+			next->iov_base = (char*)next->iov_base + charsSent;
+			next->iov_len -= charsSent;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvCurrent
+ * Description:		Receives a frame with recvMessage, as ftserver does.
+ * Receives: 		A connected socket.
+ * Returns: 		The message (malloc'd), or NULL on error.
+**********************************************************************************************/
+
+char* recvCurrent(int socketFD)
+{
+	return recvMessage(socketFD, RECV_TIMEOUT_MS);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvPeek
+ * Description:		Receives a frame by peeking at up to 12 bytes to find the length
+ * 			prefix, consuming exactly the prefix, and then receiving the message
+ * 			with MSG_WAITALL.
+ * Receives: 		A connected socket.
+ * Returns: 		The message (malloc'd), or NULL on error.
+**********************************************************************************************/
+
+char* recvPeek(int socketFD)
+{
+	/* Peek until the '@' ending the prefix is visible. */
+	char prefix[12];
+	char* at = NULL;
+	ssize_t peeked = 0;
+	while (at == NULL)
+	{
+		peeked = recv(socketFD, prefix, sizeof(prefix), MSG_PEEK);
+		if (peeked <= 0)
+		{
+			return NULL;
+		}
+		at = memchr(prefix, '@', peeked);
+		if (at == NULL && peeked == sizeof(prefix))
+		{
+			return NULL;
+		}
+	}
+
+	/* Consume prefix, then receive message. */
+	int prefixLen = at - prefix + 1;
+	if (recv(socketFD, prefix, prefixLen, 0) != prefixLen)
+	{
+		return NULL;
+	}
+	int length = atoi(prefix);
+	char* message = malloc(length + 1);
+	if (length > 0 && recv(socketFD, message, length, MSG_WAITALL) != length)
+	{
+		free(message);
+		return NULL;
+	}
+	message[length] = '\0';
+	return message;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recvBuffered
+ * Description:		Receives a frame through a 64 KB buffer owned by the calling thread,
+ * 			so that prefixes and small frames are parsed from memory and large
+ * 			frames take a few large recv calls.
+ * Receives: 		A connected socket (the same one on every call from a thread until
+ * 			the previous one is closed).
+ * Returns: 		The message (malloc'd), or NULL on error.
+**********************************************************************************************/
+
+char* recvBuffered(int socketFD)
+{
+	/* Buffer and its unconsumed range, reset whenever a different socket is read. */
+	static __thread char buffer[65536];
+	static __thread int start = 0, end = 0, bufferedFD = -1;
+	if (socketFD != bufferedFD)
+	{
+		start = end = 0;
+		bufferedFD = socketFD;
+	}
+
+	/* Parse prefix, refilling buffer as needed. */
+	int length = 0;
+	while (1)
+	{
+		if (start == end)
+		{
+			start = 0;
+			end = recv(socketFD, buffer, sizeof(buffer), 0);
+			if (end <= 0)
+			{
+				end = 0;
+				return NULL;
+			}
+		}
+		char c = buffer[start++];
+		if (c == '@')
+		{
+			break;
+		}
+		length = length * 10 + (c - '0');
+	}
+
+	/* Copy buffered part of message, then receive remainder directly into message. */
+	char* message = malloc(length + 1);
+	int copied = (end - start < length) ? end - start : length;
+	memcpy(message, buffer + start, copied);
+	start += copied;
+	if (copied < length && recv(socketFD, message + copied, length - copied, MSG_WAITALL) != length - copied)
+	{
+		free(message);
+		return NULL;
+	}
+	message[length] = '\0';
+	return message;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	connectedPair
+ * Description:		Creates a pair of connected stream sockets: a socketpair, or a loopback
+ * 			TCP connection if useTCP is set.
+ * Receives: 		Whether to use TCP, and pointers in which to store the sending and
+ * 			receiving sockets.
+ * Returns: 		0 on success; -1 on failure (with an error message printed).
+**********************************************************************************************/
+
+int connectedPair(int useTCP, int* sendFD, int* recvFD)
+{
+	if (!useTCP)
+	{
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0)
+		{
+			perror("SOCKETPAIR ERROR");
+			return -1;
+		}
+		*sendFD = pair[0];
+		*recvFD = pair[1];
+		return 0;
+	}
+
+	/* Listen on a kernel-chosen loopback port, connect to it, and accept the connection. */
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addrLen = sizeof(addr);
+	int listenFD = socket(AF_INET, SOCK_STREAM, 0);
+	*sendFD = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenFD < 0 || *sendFD < 0
+		|| bind(listenFD, (struct sockaddr*)&addr, sizeof(addr)) < 0
+		|| listen(listenFD, 1) < 0
+		|| getsockname(listenFD, (struct sockaddr*)&addr, &addrLen) < 0
+		|| connect(*sendFD, (struct sockaddr*)&addr, sizeof(addr)) < 0
+		|| (*recvFD = accept(listenFD, NULL, NULL)) < 0)
+	{
+		perror("LOOPBACK ERROR");
+		return -1;
+	}
+	close(listenFD);
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	nowNs
+ * Description:		Reads the monotonic clock.
+ * Receives: 		nothing
+ * Returns: 		The current CLOCK_MONOTONIC time in nanoseconds.
+**********************************************************************************************/
+
+unsigned long long nowNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
@@ -0,0 +1,422 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		ftbench.c
+ * File Description: 	Implementation file for ftbench, a load generator for ftserver.
+ * 			Usage: ftbench [-h SERVER_HOST] [-c CLIENTS] [-n REQUESTS | -d SECONDS]
+ * 			[-r REQUEST[:WEIGHT]]... [-t CA_FILE] [-m MS] [-j] SERVER_PORT
+ * 			Runs CLIENTS virtual clients at once, each making requests back to back
+ * 			(REQUESTS requests each, or as many as fit in SECONDS). Each request is
+ * 			chosen at random from the -r options in proportion to their weights
+ * 			(default: "-l"). Reports requests per second, MB per second, and latency
+ * 			percentiles overall and per request, as text or (with -j) as JSON. With
+ * 			-t, connections are encrypted with TLS, trusting the certificates in
+ * 			CA_FILE (requires make TLS=1). With -m, fails if the median latency of any
+ * 			request in the mix is above MS milliseconds.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <pthread.h>
+#include "benchClient.h"
+
+/* Global constants representing default number of clients and of requests per client, and the
+ * max number of distinct requests in a mix. */
+#define DEFAULT_BENCH_CLIENTS 8
+#define DEFAULT_BENCH_REQUESTS 100
+#define MAX_BENCH_MIX 16
+
+/* Definition of struct describing one request in the mix and the results gathered for it. */
+struct BenchMixEntry
+{
+	char* request;			/* Request sent to server (e.g. "-g file.txt"). */
+	int weight;			/* Relative frequency of request. */
+	unsigned long long* latencies;	/* Latencies (ns) of successful requests, filled in by report. */
+	unsigned long long completed;	/* Successful requests. */
+	unsigned long long failed;	/* Requests that did not succeed. */
+	unsigned long long bytes;	/* Data bytes received (or sent, for uploads). */
+};
+
+/* Definition of struct holding one successful or failed request made by a virtual client. */
+struct BenchSample
+{
+	unsigned long long latencyNs;	/* Time from connect until all data received. */
+	unsigned long long bytes;	/* Data bytes received (or sent, for uploads). */
+	int mixIndex;			/* Index of request in mix. */
+	enum BenchResult result;	/* Outcome of request. */
+};
+
+/* Definition of struct describing one virtual client thread and its samples. */
+struct BenchWorker
+{
+	pthread_t thread;		/* Thread running the client. */
+	struct BenchClient* client;	/* Protocol client. */
+	unsigned int seed;		/* Seed for choosing requests. */
+	struct BenchSample* samples;	/* Requests made so far. */
+	int numSamples;			/* Number of samples stored. */
+	int capacity;			/* Number of samples samples can hold. */
+	unsigned long long busyRetries;	/* Busy replies received. */
+};
+
+/* Global variables describing the run, set by main before the workers start. */
+static struct BenchMixEntry mix[MAX_BENCH_MIX];	/* Requests to choose from. */
+static int mixSize = 0;				/* Number of entries in mix. */
+static int totalWeight = 0;			/* Sum of weights in mix. */
+static int requestsPerClient = DEFAULT_BENCH_REQUESTS;	/* Requests per client, if not timed. */
+static unsigned long long stopAtNs = 0;		/* Time to stop making requests, if timed (else 0). */
+static pthread_barrier_t startBarrier;		/* Released once every worker is ready. */
+
+/* Function prototypes. */
+void usage(char* programName);
+int addMixEntry(char* spec);
+void* benchWorker(void* arg);
+void printReport(int numClients, double seconds, struct BenchWorker* workers, int json);
+
+
+/***********************************************************************************************
+ * Function Name:	main
+ * Description:		Entry point for ftbench execution. Parses options, starts one thread
+ * 			per virtual client, waits for all of them to finish, and prints results.
+ * Receives: 		An array of strings representing command line arguments.
+ * Returns: 		0 if every request succeeded; 2 if any failed; 3 if every request succeeded
+ * 			but a median latency was above the -m limit; 1 upon usage or setup error.
+ * Pre-Conditions: 	An ftserver is listening on SERVER_PORT at SERVER_HOST.
+ * Post-Conditions: 	Results have been printed to stdout.
+***********************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	/* Parse options. */
+	char* serverHost = "localhost";
+	int numClients = DEFAULT_BENCH_CLIENTS;
+	double duration = 0;
+	int json = 0;
+	char* caFile = NULL;
+	double medianLimitMs = 0;
+	int option;
+	while ((option = getopt(argc, argv, "h:c:n:d:r:t:m:j")) != -1)
+	{
+		switch (option)
+		{
+			case 'h':
+				serverHost = optarg;
+				break;
+			case 'c':
+				numClients = atoi(optarg);
+				break;
+			case 'n':
+				requestsPerClient = atoi(optarg);
+				break;
+			case 'd':
+				duration = atof(optarg);
+				break;
+			case 'r':
+				if (addMixEntry(optarg) == -1)
+				{
+					usage(argv[0]);
+				}
+				break;
+			case 't':
+				caFile = optarg;
+				break;
+			case 'm':
+				medianLimitMs = atof(optarg);
+				break;
+			case 'j':
+				json = 1;
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+	if (optind != argc - 1 || numClients <= 0 || requestsPerClient <= 0 || duration < 0 || medianLimitMs < 0)
+	{
+		usage(argv[0]);
+	}
+	if (mixSize == 0)
+	{
+		addMixEntry("-l");
+	}
+
+	/* Set up one protocol client per worker, exiting if any cannot be set up. */
+	struct BenchWorker* workers = calloc(numClients, sizeof(struct BenchWorker));
+	for (int i = 0; i < numClients; i++)
+	{
+		workers[i].client = malloc(sizeof(struct BenchClient));
+		workers[i].seed = i + 1;
+		if (initBenchClient(workers[i].client, serverHost, argv[optind]) == -1
+			|| (caFile != NULL && enableBenchTls(workers[i].client, serverHost, caFile) == -1))
+		{
+			exit(1);
+		}
+	}
+
+	/* Start workers, releasing them all at once, and time the run from release until the last
+	 * worker finishes. */
+	pthread_barrier_init(&startBarrier, NULL, numClients + 1);
+	for (int i = 0; i < numClients; i++)
+	{
+		pthread_create(&workers[i].thread, NULL, benchWorker, &workers[i]);
+	}
+	unsigned long long startNs = nowNs();
+	if (duration > 0)
+	{
+		stopAtNs = startNs + (unsigned long long)(duration * 1e9);
+	}
+	pthread_barrier_wait(&startBarrier);
+	for (int i = 0; i < numClients; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		closeBenchClient(workers[i].client);
+	}
+	double seconds = (nowNs() - startNs) / 1e9;
+
+	/* Print results, returning 2 if any request failed, or 3 if any request's median latency is above
+	 * the limit given. */
+	printReport(numClients, seconds, workers, json);
+	for (int i = 0; i < mixSize; i++)
+	{
+		if (mix[i].failed > 0)
+		{
+			return 2;
+		}
+	}
+	int status = 0;
+	for (int i = 0; i < mixSize && medianLimitMs > 0; i++)
+	{
+		double medianMs = percentileOf(mix[i].latencies, mix[i].completed, 50) / 1e6;
+		if (medianMs > medianLimitMs)
+		{
+			fprintf(stderr, "LATENCY CHECK FAILED: median latency of %s is %.3f ms (limit %.3f ms)\n",
+				mix[i].request, medianMs, medianLimitMs);
+			status = 3;
+		}
+	}
+	return status;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	usage
+ * Description:		Prints usage message and exits with status 1.
+ * Receives: 		The program name.
+ * Returns: 		Does not return.
+**********************************************************************************************/
+
+void usage(char* programName)
+{
+	fprintf(stderr, "USAGE: %s [-h SERVER_HOST] [-c CLIENTS] [-n REQUESTS | -d SECONDS] "
+		"[-r REQUEST[:WEIGHT]]... [-t CA_FILE] [-m MS] [-j] SERVER_PORT\n", programName);
+	exit(1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	addMixEntry
+ * Description:		Adds a request to the mix. The weight follows the last ':' in spec; if
+ * 			there is none (or it is not a positive number), the weight is 1.
+ * Receives: 		A request specification, e.g. "-g small.txt:8".
+ * Returns: 		0 on success; -1 if the mix is full.
+ * Pre-Conditions: 	spec remains valid for the whole run.
+ * Post-Conditions: 	The request has been added to mix and totalWeight.
+**********************************************************************************************/
+
+int addMixEntry(char* spec)
+{
+	if (mixSize == MAX_BENCH_MIX)
+	{
+		fprintf(stderr, "At most %d requests may be given with -r.\n", MAX_BENCH_MIX);
+		return -1;
+	}
+	struct BenchMixEntry* entry = &mix[mixSize];
+	memset(entry, 0, sizeof(struct BenchMixEntry));
+	entry->request = spec;
+	entry->weight = 1;
+	char* separator = strrchr(spec, ':');
+	if (separator != NULL && atoi(separator + 1) > 0)
+	{
+		entry->weight = atoi(separator + 1);
+		*separator = '\0';
+	}
+	totalWeight += entry->weight;
+	mixSize++;
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	benchWorker
+ * Description:		Thread function for one virtual client. Waits at the start barrier, then
+ * 			makes requests back to back, choosing each at random from the mix, until
+ * 			requestsPerClient have been made or stopAtNs has passed.
+ * Receives: 		A pointer to the worker's struct BenchWorker.
+ * Returns: 		NULL
+ * Pre-Conditions: 	The worker's client has been initialized.
+ * Post-Conditions: 	The worker's samples hold every request made.
+**********************************************************************************************/
+
+void* benchWorker(void* arg)
+{
+	struct BenchWorker* worker = (struct BenchWorker*)arg;
+	pthread_barrier_wait(&startBarrier);
+	for (int made = 0; (stopAtNs > 0) ? nowNs() < stopAtNs : made < requestsPerClient; made++)
+	{
+		/* Choose request in proportion to weights. */
+		int pick = rand_r(&worker->seed) % totalWeight;
+		int mixIndex = 0;
+		while (pick >= mix[mixIndex].weight)
+		{
+			pick -= mix[mixIndex].weight;
+			mixIndex++;
+		}
+
+		/* Make room for sample, then make and time request. */
+		if (worker->numSamples == worker->capacity)
+		{
+			worker->capacity = (worker->capacity > 0) ? worker->capacity * 2 : 256;
+			worker->samples = realloc(worker->samples, worker->capacity * sizeof(struct BenchSample));
+		}
+		struct BenchSample* sample = &worker->samples[worker->numSamples++];
+		unsigned long long startNs = nowNs();
+		sample->result = runBenchRequest(worker->client, mix[mixIndex].request);
+		sample->latencyNs = nowNs() - startNs;
+		sample->bytes = worker->client->bytesReceived + worker->client->bytesSent;
+		sample->mixIndex = mixIndex;
+		worker->busyRetries += worker->client->busyRetries;
+		if (sample->result != BENCH_OK)
+		{
+			fprintf(stderr, "%s failed: %s\n", mix[mixIndex].request, worker->client->lastError);
+		}
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	printReport
+ * Description:		Combines every worker's samples and prints throughput and latency
+ * 			percentiles for the whole run and for each request in the mix, as text
+ * 			or as a single JSON object.
+ * Receives: 		The number of clients, the length of the run in seconds, the workers,
+ * 			and whether to print JSON.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Every worker has finished.
+ * Post-Conditions: 	Results have been printed to stdout, and mix holds per-request totals.
+**********************************************************************************************/
+
+void printReport(int numClients, double seconds, struct BenchWorker* workers, int json)
+{
+	/* Gather latencies of successful requests, overall and per mix entry, along with totals. */
+	unsigned long long totalSamples = 0, busyRetries = 0;
+	for (int i = 0; i < numClients; i++)
+	{
+		totalSamples += workers[i].numSamples;
+		busyRetries += workers[i].busyRetries;
+	}
+	unsigned long long* all = malloc((totalSamples + 1) * sizeof(unsigned long long));
+	unsigned long long completed = 0, failed = 0, bytes = 0;
+	for (int m = 0; m < mixSize; m++)
+	{
+		mix[m].latencies = malloc((totalSamples + 1) * sizeof(unsigned long long));
+	}
+	for (int i = 0; i < numClients; i++)
+	{
+		for (int s = 0; s < workers[i].numSamples; s++)
+		{
+			struct BenchSample* sample = &workers[i].samples[s];
+			struct BenchMixEntry* entry = &mix[sample->mixIndex];
+			if (sample->result == BENCH_OK)
+			{
+				all[completed++] = sample->latencyNs;
+				entry->latencies[entry->completed++] = sample->latencyNs;
+				entry->bytes += sample->bytes;
+				bytes += sample->bytes;
+			}
+			else
+			{
+				entry->failed++;
+				failed++;
+			}
+		}
+	}
+	qsort(all, completed, sizeof(unsigned long long), compareLatencies);
+	for (int m = 0; m < mixSize; m++)
+	{
+		qsort(mix[m].latencies, mix[m].completed, sizeof(unsigned long long), compareLatencies);
+	}
+
+	/* Print results in requested format, with latencies in milliseconds. */
+	static const double percentiles[] = { 50, 90, 99, 99.9 };
+	static const char* percentileKeys[] = { "p50", "p90", "p99", "p999" };
+	int numPercentiles = sizeof(percentiles) / sizeof(percentiles[0]);
+	if (json)
+	{
+		printf("{\"clients\": %d, \"seconds\": %.3f, \"requests\": %llu, \"failed\": %llu, "
+			"\"busy_retries\": %llu, \"requests_per_sec\": %.1f, \"mb_per_sec\": %.2f, \"latency_ms\": {",
+			numClients, seconds, completed, failed, busyRetries, completed / seconds, bytes / 1e6 / seconds);
+		for (int p = 0; p < numPercentiles; p++)
+		{
+			printf("\"%s\": %.3f, ", percentileKeys[p], percentileOf(all, completed, percentiles[p]) / 1e6);
+		}
+		printf("\"max\": %.3f}, \"mix\": [", percentileOf(all, completed, 100) / 1e6);
+		for (int m = 0; m < mixSize; m++)
+		{
+			printf("%s{\"request\": \"%s\", \"weight\": %d, \"requests\": %llu, \"failed\": %llu, "
+				"\"bytes\": %llu, \"latency_ms\": {", (m > 0) ? ", " : "", mix[m].request, mix[m].weight,
+				mix[m].completed, mix[m].failed, mix[m].bytes);
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				printf("\"%s\": %.3f, ", percentileKeys[p],
+					percentileOf(mix[m].latencies, mix[m].completed, percentiles[p]) / 1e6);
+			}
+			printf("\"max\": %.3f}}", percentileOf(mix[m].latencies, mix[m].completed, 100) / 1e6);
+		}
+		printf("]}\n");
+	}
+	else
+	{
+		printf("%d clients made %llu requests (%llu failed, %llu busy retries) in %.2f s\n",
+			numClients, completed + failed, failed, busyRetries, seconds);
+		printf("Throughput: %.1f requests/s, %.2f MB/s\n", completed / seconds, bytes / 1e6 / seconds);
+		printf("%-24s %8s %9s %9s %9s %9s %9s\n", "latency (ms)", "count", "p50", "p90", "p99", "p99.9", "max");
+		printf("%-24s %8llu", "all", completed);
+		for (int p = 0; p < numPercentiles; p++)
+		{
+			printf(" %9.3f", percentileOf(all, completed, percentiles[p]) / 1e6);
+		}
+		printf(" %9.3f\n", percentileOf(all, completed, 100) / 1e6);
+		for (int m = 0; m < mixSize; m++)
+		{
+			printf("%-24s %8llu", mix[m].request, mix[m].completed);
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				printf(" %9.3f", percentileOf(mix[m].latencies, mix[m].completed, percentiles[p]) / 1e6);
+			}
+			printf(" %9.3f\n", percentileOf(mix[m].latencies, mix[m].completed, 100) / 1e6);
+		}
+	}
+	free(all);
+}
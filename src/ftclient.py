@@ -21,20 +21,26 @@
 #			instantiating FTInfo object to faciliate communications between ftclient
 #			and ftserver.
 # Course Name: 		CS 372-400: Introduction to Computer Networks
-# Last Modified:	03/09/2020
+# Last Modified:	10/18/2026
 ######################################################################################################
 
 import sys
+import FTBatch
 import FTInfo
 
 # If "-h" was entered on command line, display usage instructions + list of available commands to stdout
 # and exit with exit code 0 to indicate no error.
 if len(sys.argv) == 2 and sys.argv[1] == "-h":
 	print(FTInfo.USAGE_MESSAGE)
+	print(FTBatch.BATCH_USAGE_MESSAGE)
 	print("Accepted Commands:\n")
 	print(FTInfo.ACCEPTED_COMMANDS)
 	sys.exit(0)
 
+# If batch mode was selected, fetch the batch of files and exit with its status.
+if len(sys.argv) > 1 and sys.argv[1] == FTBatch.BATCH_FLAG:
+	sys.exit(FTBatch.FTBatch(sys.argv).run())
+
 # If an invalid number of command-line arguments were entered, print usage message and exit.
 if len(sys.argv) < FTInfo.MIN_ARGS or len(sys.argv) > FTInfo.MAX_ARGS:
 	print(FTInfo.USAGE_MESSAGE, file=sys.stderr)
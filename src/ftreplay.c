@@ -0,0 +1,548 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		ftreplay.c
+ * File Description: 	Implementation file for ftreplay, which replays a session trace recorded by
+ * 			ftserver (see trace_file in ftserver.conf) against a test server.
+ * 			Usage: ftreplay [-h SERVER_HOST] [-s SPEED] [-m DIRECTORY] [-j] TRACE_FILE SERVER_PORT
+ * 			Each recorded request is sent at the same offset from the start of the
+ * 			trace (divided by SPEED, so -s 2 replays twice as fast) by a pool of
+ * 			virtual clients as large as the most sessions the trace shows in
+ * 			progress at once. Latency percentiles of the replay are then compared
+ * 			with those recorded, per command. Uploads are replayed by sending the
+ * 			size recorded (so they write files on the test server). With -m, a
+ * 			stand-in for every file requested is first created in DIRECTORY with the
+ * 			size recorded, so the test server can serve the same transfers.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "benchClient.h"
+#include "sessionTrace.h"
+
+/* Global constant representing number of groups results are reported in: one per command
+ * (-g, -l, -ltxt, -p) and one for requests the server rejected when recorded. */
+#define NUM_REPLAY_GROUPS 5
+
+/* Global constant representing the group of uploads, which can only be replayed if their size
+ * was recorded. */
+#define UPLOAD_GROUP 3
+
+/* Definition of struct describing one replayed session. */
+struct ReplaySession
+{
+	struct TraceRecord* record;	/* Session as recorded. */
+	unsigned long long startAt;	/* Nanoseconds after replay start to send request. */
+	unsigned long long latencyNs;	/* Replayed latency, set by worker. */
+	unsigned long long lateNs;	/* How long after startAt request was actually sent. */
+	enum BenchResult result;	/* Outcome of replayed request. */
+};
+
+/* Global variables describing the replay, set by main before the workers start. */
+static struct ReplaySession* sessions = NULL;	/* Sessions to replay, in order of startAt. */
+static int numSessions = 0;			/* Number of entries in sessions. */
+static int nextSession = 0;			/* Index of next session to be taken by a worker. */
+static unsigned long long replayStartNs = 0;	/* Monotonic time at which replay starts. */
+static const char* groupNames[NUM_REPLAY_GROUPS] = { "-g", "-l", "-ltxt", "-p", "rejected" };
+
+/* Function prototypes. */
+void usage(char* programName);
+struct TraceRecord* readTrace(char* filename, int* numRecords);
+int replayGroup(struct TraceRecord* record);
+int compareSessions(const void* a, const void* b);
+int maxConcurrency(struct TraceRecord* records, int numRecords);
+void createStandIns(struct TraceRecord* records, int numRecords, char* directory);
+void* replayWorker(void* arg);
+void printComparison(double seconds, int json);
+
+
+/***********************************************************************************************
+ * Function Name:	main
+ * Description:		Entry point for ftreplay execution. Reads the trace, optionally creates
+ * 			stand-in files, replays every recorded request, and prints a comparison
+ * 			of replayed and recorded latencies.
+ * Receives: 		An array of strings representing command line arguments.
+ * Returns: 		0 if every request got the same kind of reply as when recorded; 2 if not;
+ * 			1 upon usage or setup error.
+ * Pre-Conditions: 	An ftserver is listening on SERVER_PORT at SERVER_HOST.
+ * Post-Conditions: 	Results have been printed to stdout.
+***********************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	/* Parse options. */
+	char* serverHost = "localhost";
+	char* standInDirectory = NULL;
+	double speed = 1;
+	int json = 0;
+	int option;
+	while ((option = getopt(argc, argv, "h:s:m:j")) != -1)
+	{
+		switch (option)
+		{
+			case 'h':
+				serverHost = optarg;
+				break;
+			case 's':
+				speed = atof(optarg);
+				break;
+			case 'm':
+				standInDirectory = optarg;
+				break;
+			case 'j':
+				json = 1;
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+	if (optind != argc - 2 || speed <= 0)
+	{
+		usage(argv[0]);
+	}
+
+	/* Read trace, and create stand-in files if requested. */
+	int numRecords = 0;
+	struct TraceRecord* records = readTrace(argv[optind], &numRecords);
+	if (records == NULL)
+	{
+		exit(1);
+	}
+	if (standInDirectory != NULL)
+	{
+		createStandIns(records, numRecords, standInDirectory);
+	}
+
+	/* Schedule every session in which a request was received, relative to the first one accepted, except
+	 * uploads recorded without their size (by an older server, or cut off by a long filename), which are
+	 * counted and skipped. Records are written as sessions finish, so sessions are then sorted into the
+	 * order they were accepted. */
+	sessions = calloc(numRecords + 1, sizeof(struct ReplaySession));
+	unsigned long long firstAccepted = ULLONG_MAX;
+	int uploadsSkipped = 0;
+	long long uploadSize;
+	for (int i = 0; i < numRecords; i++)
+	{
+		if (records[i].request[0] == '\0')
+		{
+			continue;
+		}
+		if (replayGroup(&records[i]) == UPLOAD_GROUP && sscanf(records[i].request, "-p %*s %lld", &uploadSize) != 1)
+		{
+			uploadsSkipped++;
+			continue;
+		}
+		firstAccepted = (records[i].acceptedAt < firstAccepted) ? records[i].acceptedAt : firstAccepted;
+		sessions[numSessions].record = &records[i];
+		numSessions++;
+	}
+	for (int i = 0; i < numSessions; i++)
+	{
+		sessions[i].startAt = (sessions[i].record->acceptedAt - firstAccepted) / speed;
+	}
+	qsort(sessions, numSessions, sizeof(struct ReplaySession), compareSessions);
+	if (uploadsSkipped > 0)
+	{
+		fprintf(stderr, "Skipped %d uploads recorded without their size.\n", uploadsSkipped);
+	}
+	if (numSessions == 0)
+	{
+		fprintf(stderr, "%s contains no requests to replay.\n", argv[optind]);
+		exit(1);
+	}
+
+	/* Start one virtual client per session recorded in progress at once, and wait for all
+	 * sessions to be replayed. */
+	int numWorkers = maxConcurrency(records, numRecords);
+	pthread_t* workers = malloc(numWorkers * sizeof(pthread_t));
+	struct BenchClient* clients = malloc(numWorkers * sizeof(struct BenchClient));
+	for (int i = 0; i < numWorkers; i++)
+	{
+		if (initBenchClient(&clients[i], serverHost, argv[optind + 1]) == -1)
+		{
+			exit(1);
+		}
+	}
+	replayStartNs = nowNs();
+	for (int i = 0; i < numWorkers; i++)
+	{
+		pthread_create(&workers[i], NULL, replayWorker, &clients[i]);
+	}
+	for (int i = 0; i < numWorkers; i++)
+	{
+		pthread_join(workers[i], NULL);
+		closeBenchClient(&clients[i]);
+	}
+	double seconds = (nowNs() - replayStartNs) / 1e9;
+	if (!json)
+	{
+		printf("Replayed %d sessions from %s at %gx with %d concurrent clients in %.2f s\n",
+			numSessions, argv[optind], speed, numWorkers, seconds);
+	}
+	printComparison(seconds, json);
+
+	/* Return 2 if any request got a different kind of reply than when it was recorded. */
+	for (int i = 0; i < numSessions; i++)
+	{
+		int recordedOk = (sessions[i].record->phasesMarked & (1u << PHASE_STREAMING)) != 0;
+		if (recordedOk != (sessions[i].result == BENCH_OK))
+		{
+			return 2;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	usage
+ * Description:		Prints usage message and exits with status 1.
+ * Receives: 		The program name.
+ * Returns: 		Does not return.
+**********************************************************************************************/
+
+void usage(char* programName)
+{
+	fprintf(stderr, "USAGE: %s [-h SERVER_HOST] [-s SPEED] [-m DIRECTORY] [-j] TRACE_FILE SERVER_PORT\n",
+		programName);
+	exit(1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	readTrace
+ * Description:		Reads every complete record from a trace file, checking its header.
+ * Receives: 		The trace's filename and a pointer in which to store the record count.
+ * Returns: 		The records (malloc'd), or NULL upon error (with an error message printed).
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	*numRecords holds the number of records returned.
+**********************************************************************************************/
+
+struct TraceRecord* readTrace(char* filename, int* numRecords)
+{
+	FILE* traceFile = fopen(filename, "rb");
+	if (traceFile == NULL)
+	{
+		fprintf(stderr, "TRACE ERROR: could not open %s: %s\n", filename, strerror(errno));
+		return NULL;
+	}
+
+	/* Check header. */
+	struct TraceHeader header;
+	if (fread(&header, sizeof(header), 1, traceFile) != 1 || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0
+		|| header.version != TRACE_VERSION || header.recordSize != sizeof(struct TraceRecord))
+	{
+		fprintf(stderr, "TRACE ERROR: %s is not a trace written by a compatible ftserver.\n", filename);
+		fclose(traceFile);
+		return NULL;
+	}
+
+	/* Read records, growing array as needed, and ignoring a partial record at end of file. */
+	int capacity = 1024;
+	struct TraceRecord* records = malloc(capacity * sizeof(struct TraceRecord));
+	*numRecords = 0;
+	while (fread(&records[*numRecords], sizeof(struct TraceRecord), 1, traceFile) == 1)
+	{
+		records[*numRecords].request[TRACE_MAX_REQUEST - 1] = '\0';
+		if (++*numRecords == capacity)
+		{
+			capacity *= 2;
+			records = realloc(records, capacity * sizeof(struct TraceRecord));
+		}
+	}
+	fclose(traceFile);
+	return records;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	replayGroup
+ * Description:		Finds the group a recorded session is reported in: its command if the
+ * 			server accepted the request, or "rejected" otherwise.
+ * Receives: 		A trace record.
+ * Returns: 		An index into groupNames.
+**********************************************************************************************/
+
+int replayGroup(struct TraceRecord* record)
+{
+	if (record->command != STATS_MAX_COMMANDS)
+	{
+		for (int group = 0; group < NUM_REPLAY_GROUPS - 1; group++)
+		{
+			int nameLen = strlen(groupNames[group]);
+			if (strncmp(record->request, groupNames[group], nameLen) == 0
+				&& (record->request[nameLen] == ' ' || record->request[nameLen] == '\0'))
+			{
+				return group;
+			}
+		}
+	}
+	return NUM_REPLAY_GROUPS - 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	compareSessions
+ * Description:		qsort comparison function ordering sessions by the time they are to start.
+ * Receives: 		Pointers to two struct ReplaySession.
+ * Returns: 		Negative, zero, or positive as a starts before, with, or after b.
+**********************************************************************************************/
+
+int compareSessions(const void* a, const void* b)
+{
+	unsigned long long first = ((const struct ReplaySession*)a)->startAt;
+	unsigned long long second = ((const struct ReplaySession*)b)->startAt;
+	return (first > second) - (first < second);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	maxConcurrency
+ * Description:		Finds the most sessions the trace shows in progress at the same time,
+ * 			treating each session as lasting from acceptance for its total time.
+ * Receives: 		The records and their count.
+ * Returns: 		The most sessions in progress at once (at least 1).
+**********************************************************************************************/
+
+int maxConcurrency(struct TraceRecord* records, int numRecords)
+{
+	/* Sort start and end times (ends encoded as odd values so an end sorts before a start at the
+	 * same time), then sweep through them counting sessions in progress. */
+	unsigned long long* events = malloc(2 * numRecords * sizeof(unsigned long long) + 1);
+	for (int i = 0; i < numRecords; i++)
+	{
+		events[2 * i] = (records[i].acceptedAt << 1) | 1;
+		events[2 * i + 1] = ((records[i].acceptedAt + records[i].phaseNs[PHASE_TOTAL]) << 1);
+	}
+	qsort(events, 2 * numRecords, sizeof(unsigned long long), compareLatencies);
+	int inProgress = 0, most = 1;
+	for (int i = 0; i < 2 * numRecords; i++)
+	{
+		inProgress += (events[i] & 1) ? 1 : -1;
+		most = (inProgress > most) ? inProgress : most;
+	}
+	free(events);
+	return most;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	createStandIns
+ * Description:		Creates, in directory, a file of the recorded size for every file
+ * 			requested with -g (skipping names containing '/' and files that already
+ * 			have the right size). Contents are text, which ftserver can send.
+ * Receives: 		The records, their count, and the directory to create files in.
+ * Returns: 		nothing
+ * Pre-Conditions: 	directory exists.
+ * Post-Conditions: 	Every file requested in the trace exists in directory.
+**********************************************************************************************/
+
+void createStandIns(struct TraceRecord* records, int numRecords, char* directory)
+{
+	char chunk[65536];
+	memset(chunk, 'r', sizeof(chunk));
+	for (int i = 0; i < numRecords; i++)
+	{
+		/* Skip records not requesting a file of known size. */
+		char* filename = records[i].request + 3;
+		if (strncmp(records[i].request, "-g ", 3) != 0 || records[i].requestSize < 0 || strchr(filename, '/') != NULL)
+		{
+			continue;
+		}
+
+		/* Skip files already of recorded size. */
+		char path[PATH_MAX];
+		snprintf(path, sizeof(path), "%s/%s", directory, filename);
+		struct stat fileInfo;
+		if (stat(path, &fileInfo) == 0 && fileInfo.st_size == records[i].requestSize)
+		{
+			continue;
+		}
+
+		/* Write file of recorded size. */
+		FILE* standIn = fopen(path, "wb");
+		if (standIn == NULL)
+		{
+			fprintf(stderr, "Could not create %s: %s\n", path, strerror(errno));
+			continue;
+		}
+		for (long long remaining = records[i].requestSize; remaining > 0; remaining -= sizeof(chunk))
+		{
+			fwrite(chunk, 1, (remaining < (long long)sizeof(chunk)) ? remaining : (long long)sizeof(chunk), standIn);
+		}
+		fclose(standIn);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	replayWorker
+ * Description:		Thread function for one virtual client. Repeatedly takes the next
+ * 			session in schedule order, waits until its start time, and replays it.
+ * Receives: 		A pointer to the worker's struct BenchClient.
+ * Returns: 		NULL
+ * Pre-Conditions: 	sessions is sorted by startAt and replayStartNs has been set.
+ * Post-Conditions: 	Every session taken has its results set.
+**********************************************************************************************/
+
+void* replayWorker(void* arg)
+{
+	struct BenchClient* client = (struct BenchClient*)arg;
+	while (1)
+	{
+		int index = __atomic_fetch_add(&nextSession, 1, __ATOMIC_RELAXED);
+		if (index >= numSessions)
+		{
+			break;
+		}
+		struct ReplaySession* session = &sessions[index];
+
+		/* Sleep until session's start time, then replay and time it. */
+		unsigned long long startAt = replayStartNs + session->startAt;
+		struct timespec wakeAt = { startAt / 1000000000ULL, startAt % 1000000000ULL };
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeAt, NULL);
+		unsigned long long startNs = nowNs();
+		session->lateNs = (startNs > startAt) ? startNs - startAt : 0;
+		session->result = runBenchRequest(client, session->record->request);
+		session->latencyNs = nowNs() - startNs;
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	printComparison
+ * Description:		Prints, for every group with sessions, the recorded and replayed latency
+ * 			percentiles and their ratio, as text or as one JSON object. Recorded
+ * 			latency is the server's total session time; replayed latency is the
+ * 			client's time from connecting until all data was received.
+ * Receives: 		The length of the replay in seconds and whether to print JSON.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Every session has been replayed.
+ * Post-Conditions: 	Comparison has been printed to stdout.
+**********************************************************************************************/
+
+void printComparison(double seconds, int json)
+{
+	static const double percentiles[] = { 50, 90, 99, 100 };
+	static const char* percentileKeys[] = { "p50", "p90", "p99", "max" };
+	int numPercentiles = sizeof(percentiles) / sizeof(percentiles[0]);
+	unsigned long long* recorded = malloc(numSessions * sizeof(unsigned long long));
+	unsigned long long* replayed = malloc(numSessions * sizeof(unsigned long long));
+
+	/* Find mean lateness of replayed requests. */
+	unsigned long long totalLate = 0;
+	for (int i = 0; i < numSessions; i++)
+	{
+		totalLate += sessions[i].lateNs;
+	}
+	if (json)
+	{
+		printf("{\"sessions\": %d, \"seconds\": %.3f, \"mean_late_ms\": %.3f, \"groups\": [",
+			numSessions, seconds, totalLate / 1e6 / numSessions);
+	}
+	else
+	{
+		printf("Mean lateness of requests: %.3f ms\n", totalLate / 1e6 / numSessions);
+		printf("%-9s %6s %6s %-9s", "group", "count", "failed", "(ms)");
+		for (int p = 0; p < numPercentiles; p++)
+		{
+			printf(" %9s", percentileKeys[p]);
+		}
+		printf("\n");
+	}
+
+	int groupsPrinted = 0;
+	for (int group = 0; group < NUM_REPLAY_GROUPS; group++)
+	{
+		/* Gather latencies of sessions in group, counting those whose outcome differs from recording. */
+		unsigned long long count = 0, changed = 0;
+		for (int i = 0; i < numSessions; i++)
+		{
+			if (replayGroup(sessions[i].record) != group)
+			{
+				continue;
+			}
+			recorded[count] = sessions[i].record->phaseNs[PHASE_TOTAL];
+			replayed[count] = sessions[i].latencyNs;
+			int recordedOk = (sessions[i].record->phasesMarked & (1u << PHASE_STREAMING)) != 0;
+			changed += (recordedOk != (sessions[i].result == BENCH_OK));
+			count++;
+		}
+		if (count == 0)
+		{
+			continue;
+		}
+		qsort(recorded, count, sizeof(unsigned long long), compareLatencies);
+		qsort(replayed, count, sizeof(unsigned long long), compareLatencies);
+
+		/* Print group. */
+		if (json)
+		{
+			printf("%s{\"group\": \"%s\", \"count\": %llu, \"changed\": %llu", (groupsPrinted > 0) ? ", " : "",
+				groupNames[group], count, changed);
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				printf(", \"%s_recorded_ms\": %.3f, \"%s_replayed_ms\": %.3f", percentileKeys[p],
+					percentileOf(recorded, count, percentiles[p]) / 1e6, percentileKeys[p],
+					percentileOf(replayed, count, percentiles[p]) / 1e6);
+			}
+			printf("}");
+		}
+		else
+		{
+			printf("%-9s %6llu %6llu %-9s", groupNames[group], count, changed, "recorded");
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				printf(" %9.3f", percentileOf(recorded, count, percentiles[p]) / 1e6);
+			}
+			printf("\n%-9s %6s %6s %-9s", "", "", "", "replayed");
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				printf(" %9.3f", percentileOf(replayed, count, percentiles[p]) / 1e6);
+			}
+			printf("\n%-9s %6s %6s %-9s", "", "", "", "ratio");
+			for (int p = 0; p < numPercentiles; p++)
+			{
+				unsigned long long recordedValue = percentileOf(recorded, count, percentiles[p]);
+				printf(" %9.2f", recordedValue > 0
+					? (double)percentileOf(replayed, count, percentiles[p]) / recordedValue : 0.0);
+			}
+			printf("\n");
+		}
+		groupsPrinted++;
+	}
+	if (json)
+	{
+		printf("]}\n");
+	}
+	free(recorded);
+	free(replayed);
+}
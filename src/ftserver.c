@@ -27,7 +27,7 @@
  * File Name:		ftserver.c
  * File Description: 	Implementation file for main function (see below for function description).
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #include "manageConnections.h"
@@ -37,29 +37,31 @@
  * Function Name:	main
  * Description:		Entry point for ftserver execution. Receives command line arguments.
  * 			Validates that only 1 argument was entered after the program name on the
- * 			command line and that that argument is a non-negative integer for
- * 			representing a port number. Upon validation of command line arguments,
+ * 			command line (optionally followed by the name of a configuration file)
+ * 			and that that argument is a non-negative integer for
+ * 			representing a port number. Upon validation of command line arguments
+ * 			and loading of the configuration file (if any),
  * 			calls startup(), from which other functions handling communication are called.
  * 			When startup() returns after SIGINT is received, main() returns.
  * Receives: 		An array of strings representing command line arguments.
  * Returns: 		Error code 3 upon unexpected return (calls startup function which, in turn,
- * 			calls a function which enters an endless loop. Signal handler registered
- * 			to SIGINT should cause process to exit with status code 0).
- * Pre-Conditions: 	The command line arguments consist only of the program name and a
- * 			port number on which to establish a listening socket.
+ * 			calls a function which loops until SIGINT is received and then exits the
+ * 			process with status code 0).
+ * Pre-Conditions: 	The command line arguments consist only of the program name, a
+ * 			port number on which to establish a listening socket, and
+ * 			optionally the name of a configuration file.
  * Post-Conditions: 	Unless the process has exited due to an error establishing a listening
- * 			socket, the listening socket has been shut down by a signal handler
- * 			once a SIGINT is received, and that signal handler has exited the 
- * 			process with status code 0. Status code 3 indicates unxpected
- * 			return from main.
+ * 			socket, the listening socket has been shut down once a SIGINT is
+ * 			received, and the main server loop has exited the process with status
+ * 			code 0. Status code 3 indicates unxpected return from main.
 ***********************************************************************************************/
 
 int main(int argc, char** argv)
 {
 	/* If the incorrect number of arguments were entered, print error message and exit. */
-	if (argc != 2)
+	if (argc != 2 && argc != 3)
 	{
-		fprintf(stderr, "USAGE: %s SERVER_PORT\n", argv[0]);
+		fprintf(stderr, "USAGE: %s SERVER_PORT [CONFIG_FILE]\n", argv[0]);
 		exit(1);
 	}
 
@@ -67,11 +69,22 @@ int main(int argc, char** argv)
 	char* portnum = argv[1];
 	if (!validatePortnum(portnum))
 	{
-		fprintf(stderr, "USAGE: %s SERVER_PORT\n", argv[0]);
+		fprintf(stderr, "USAGE: %s SERVER_PORT [CONFIG_FILE]\n", argv[0]);
 		fprintf(stderr, "The SERVER_PORT entered is not a valid non-negative integer.\n");
 		exit(1);
 	}
 	
+	/* If a configuration file was named, load it, exiting if it cannot be read. The filename is kept
+	 * so that the file can be reloaded upon SIGHUP. */
+	if (argc == 3)
+	{
+		configFilename = argv[2];
+		if (loadServerConfig(configFilename) == -1)
+		{
+			exit(1);
+		}
+	}
+
 	/* Call startup function, which will call functions necessary for communication with clients. */
 	startup(portnum);
 	
@@ -0,0 +1,352 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		ftstat.c
+ * File Description: 	Implementation file for ftstat, which prints the counters a running ftserver
+ * 			publishes in shared memory. Usage: ftstat SERVER_PORT [INTERVAL_SECONDS].
+ * 			With no interval, counters are printed once; otherwise they are printed
+ * 			every INTERVAL_SECONDS along with send throughput and request rate since
+ * 			the previous sample, until a SIGINT is received. Latency percentiles of
+ * 			each phase of a request are printed after the counters. The counters of
+ * 			a sharded server are summed over its shards. Reading the
+ * 			segment takes no locks, so ftstat never slows the server down.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "serverShards.h"
+#include "serverStats.h"
+
+/* Global variable definitions. */
+struct ServerStats* serverStats = NULL;		/* Server's counters, mapped read-only by openServerStats. */
+static struct ServerStats* shardStats[MAX_SHARDS];	/* Each shard's counters, if server is sharded. */
+static int numShardStats = 0;			/* Number of shards mapped (0 if server is not sharded). */
+static struct ServerStats shardTotals;		/* Sum of shards' counters, if server is sharded. */
+
+/* Function prototypes. */
+int openServerStats(char* serverPort);
+struct ServerStats* mapStatsSegment(char* name);
+void collectServerStats();
+void printServerStats(struct ServerStats* previous, double elapsedSeconds);
+
+
+/***********************************************************************************************
+ * Function Name:	main
+ * Description:		Entry point for ftstat execution. Maps the statistics segment of the
+ * 			server listening on SERVER_PORT and prints its counters once, or every
+ * 			INTERVAL_SECONDS if an interval is given.
+ * Receives: 		An array of strings representing command line arguments.
+ * Returns: 		0 after printing counters once; 1 upon error.
+ * Pre-Conditions: 	An ftserver is running on SERVER_PORT on this machine.
+ * Post-Conditions: 	Counters have been printed to stdout.
+***********************************************************************************************/
+
+int main(int argc, char** argv)
+{
+	/* If the incorrect number of arguments were entered, print error message and exit. */
+	if (argc != 2 && argc != 3)
+	{
+		fprintf(stderr, "USAGE: %s SERVER_PORT [INTERVAL_SECONDS]\n", argv[0]);
+		exit(1);
+	}
+
+	/* Validate interval, if any. */
+	double interval = 0;
+	if (argc == 3)
+	{
+		char* end = NULL;
+		interval = strtod(argv[2], &end);
+		if (end == argv[2] || *end != '\0' || interval <= 0)
+		{
+			fprintf(stderr, "USAGE: %s SERVER_PORT [INTERVAL_SECONDS]\n", argv[0]);
+			fprintf(stderr, "The INTERVAL_SECONDS entered is not a positive number.\n");
+			exit(1);
+		}
+	}
+
+	/* Map server's counters, exiting upon error. */
+	if (openServerStats(argv[1]) == -1)
+	{
+		exit(1);
+	}
+
+	/* Print counters once if no interval was given. */
+	if (interval == 0)
+	{
+		printServerStats(NULL, 0);
+		return 0;
+	}
+
+	/* Otherwise, print counters every interval along with rates since previous sample. */
+	struct ServerStats previous;
+	memcpy(&previous, serverStats, sizeof(previous));
+	struct timespec previousTime, now;
+	clock_gettime(CLOCK_MONOTONIC, &previousTime);
+	struct timespec sleepTime;
+	sleepTime.tv_sec = (time_t)interval;
+	sleepTime.tv_nsec = (long)((interval - sleepTime.tv_sec) * 1000000000);
+	while (1)
+	{
+		nanosleep(&sleepTime, NULL);
+		collectServerStats();
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		double elapsed = (now.tv_sec - previousTime.tv_sec) + (now.tv_nsec - previousTime.tv_nsec) / 1e9;
+		printServerStats(&previous, elapsed);
+		memcpy(&previous, serverStats, sizeof(previous));
+		previousTime = now;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	openServerStats
+ * Description:		Maps the statistics segment of the server listening on serverPort
+ * 			read-only, or, if the server is sharded, the segment of every shard.
+ * Receives: 		The server's port, as a string.
+ * Returns: 		0 on success; -1 on failure (with an error message printed).
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	If 0 is returned, serverStats points to the server's counters (summed
+ * 			over shards by collectServerStats, if sharded).
+**********************************************************************************************/
+
+int openServerStats(char* serverPort)
+{
+	/* Map server's segment. If there is none, map the segment of each shard in turn until one is
+	 * not found. */
+	char name[STATS_SEGMENT_NAME_LEN];
+	snprintf(name, sizeof(name), STATS_SEGMENT_FORMAT, serverPort);
+	serverStats = mapStatsSegment(name);
+	if (serverStats == NULL && errno == ENOENT)
+	{
+		char shard[STATS_SEGMENT_NAME_LEN / 2];
+		while (numShardStats < MAX_SHARDS)
+		{
+			snprintf(shard, sizeof(shard), SHARD_NAME_FORMAT, serverPort, numShardStats);
+			snprintf(name, sizeof(name), STATS_SEGMENT_FORMAT, shard);
+			struct ServerStats* stats = mapStatsSegment(name);
+			if (stats == NULL)
+			{
+				break;
+			}
+			shardStats[numShardStats] = stats;
+			numShardStats++;
+		}
+		if (numShardStats > 0)
+		{
+			errno = 0;
+			collectServerStats();
+		}
+	}
+
+	/* Report a server that is not running if no segment exists. */
+	if (serverStats == NULL)
+	{
+		if (errno == ENOENT)
+		{
+			fprintf(stderr, "No ftserver statistics found for port %s. Is the server running?\n", serverPort);
+		}
+		return -1;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	mapStatsSegment
+ * Description:		Maps a statistics segment read-only, checking that it was initialized
+ * 			with the expected layout.
+ * Receives: 		The name of the segment.
+ * Returns: 		The counters in the segment; NULL on failure (with an error message printed
+ * 			unless errno is ENOENT because the segment does not exist).
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+struct ServerStats* mapStatsSegment(char* name)
+{
+	/* Open segment, leaving errno set to ENOENT if it does not exist. */
+	int segmentFD = shm_open(name, O_RDONLY, 0);
+	if (segmentFD < 0)
+	{
+		if (errno != ENOENT)
+		{
+			perror("STATS SEGMENT ERROR");
+		}
+		return NULL;
+	}
+
+	/* Map segment, closing descriptor since the mapping keeps the segment alive. */
+	struct ServerStats* stats = mmap(NULL, sizeof(struct ServerStats), PROT_READ, MAP_SHARED, segmentFD, 0);
+	close(segmentFD);
+	if (stats == MAP_FAILED)
+	{
+		perror("STATS SEGMENT ERROR");
+		return NULL;
+	}
+
+	/* Check that segment was written by a compatible server. */
+	if (__atomic_load_n(&stats->magic, __ATOMIC_ACQUIRE) != STATS_MAGIC
+		|| stats->version != STATS_VERSION)
+	{
+		fprintf(stderr, "STATS SEGMENT ERROR: %s was not written by a compatible ftserver.\n", name);
+		errno = EINVAL;
+		return NULL;
+	}
+	return stats;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	collectServerStats
+ * Description:		If the server is sharded, sums every shard's counters into
+ * 			shardTotals. Every field after the header except the command names
+ * 			is a counter, so the counters are summed as an array.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	openServerStats has returned 0.
+ * Post-Conditions: 	serverStats holds the server's current counters.
+**********************************************************************************************/
+
+void collectServerStats()
+{
+	if (numShardStats == 0)
+	{
+		return;
+	}
+
+	/* Take header and command names from the first shard. */
+	memcpy(&shardTotals, shardStats[0], offsetof(struct ServerStats, sessionsAccepted));
+	memcpy(shardTotals.commandNames, shardStats[0]->commandNames, sizeof(shardTotals.commandNames));
+
+	/* Sum counters before and after the command names. */
+	size_t namesStart = offsetof(struct ServerStats, commandNames) / sizeof(unsigned long long);
+	size_t namesEnd = offsetof(struct ServerStats, commandCounts) / sizeof(unsigned long long);
+	size_t first = offsetof(struct ServerStats, sessionsAccepted) / sizeof(unsigned long long);
+	size_t last = sizeof(struct ServerStats) / sizeof(unsigned long long);
+	unsigned long long* totals = (unsigned long long*)&shardTotals;
+	for (size_t i = first; i < last; i++)
+	{
+		if (i == namesStart)
+		{
+			i = namesEnd - 1;
+			continue;
+		}
+		totals[i] = 0;
+		for (int shard = 0; shard < numShardStats; shard++)
+		{
+			totals[i] += __atomic_load_n((unsigned long long*)shardStats[shard] + i, __ATOMIC_RELAXED);
+		}
+	}
+	serverStats = &shardTotals;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	printServerStats
+ * Description:		Prints every counter in serverStats. If a previous sample is given,
+ * 			also prints send throughput and request rate since that sample.
+ * Receives: 		A copy of the counters taken elapsedSeconds ago, or NULL.
+ * Returns: 		nothing
+ * Pre-Conditions: 	openServerStats has returned 0.
+ * Post-Conditions: 	Counters have been printed to stdout.
+**********************************************************************************************/
+
+void printServerStats(struct ServerStats* previous, double elapsedSeconds)
+{
+	/* Print header identifying server and when sample was taken. */
+	time_t now = time(NULL);
+	if (numShardStats > 0)
+	{
+		printf("=== ftserver, %d shards, up %lld s ===\n", numShardStats, (long long)now - serverStats->startTime);
+	}
+	else
+	{
+		printf("=== ftserver pid %lld, up %lld s ===\n", serverStats->serverPid,
+			(long long)now - serverStats->startTime);
+	}
+	printf("Sessions: %llu accepted, %llu rejected (busy), %llu active\n",
+		STAT_GET(sessionsAccepted), STAT_GET(sessionsRejected), STAT_GET(activeSessions));
+	printf("Transfers: %llu active, %llu completed, %llu bytes sent\n",
+		STAT_GET(activeTransfers), STAT_GET(completedTransfers), STAT_GET(bytesSent));
+	printf("Files passed to local clients: %llu, %llu bytes\n", STAT_GET(filesPassed), STAT_GET(bytesPassed));
+	printf("Files received from clients: %llu, %llu bytes\n", STAT_GET(filesReceived), STAT_GET(bytesReceived));
+	printf("Files sent with direct I/O: %llu, %llu bytes\n", STAT_GET(filesReadDirect), STAT_GET(bytesReadDirect));
+	printf("TLS handshakes: %llu completed (%llu with kernel encryption), %llu failed\n",
+		STAT_GET(tlsHandshakes), STAT_GET(tlsKernelSends), STAT_GET(tlsHandshakeFailures));
+	printf("Zero-copy sends: %llu, %llu bytes (%llu completed by copying); %llu transfers failed waiting\n",
+		STAT_GET(zeroCopySends), STAT_GET(zeroCopyBytes), STAT_GET(zeroCopyCopied), STAT_GET(zeroCopyFailures));
+	printf("Shared streams: %llu started, %llu transfers joined; chunks %llu from ring, %llu read privately\n",
+		STAT_GET(sharedStreams), STAT_GET(coalescedTransfers), STAT_GET(sharedChunks), STAT_GET(privateChunks));
+
+	/* Print rates since previous sample, if any. */
+	if (previous != NULL && elapsedSeconds > 0)
+	{
+		unsigned long long requests = 0, previousRequests = 0;
+		for (int i = 0; i < STATS_MAX_COMMANDS; i++)
+		{
+			requests += STAT_GET(commandCounts[i]);
+			previousRequests += previous->commandCounts[i];
+		}
+		printf("Rates: %.1f KB/s sent, %.1f requests/s\n",
+			(STAT_GET(bytesSent) - previous->bytesSent) / 1024.0 / elapsedSeconds,
+			(requests - previousRequests) / elapsedSeconds);
+	}
+
+	/* Print request count of each command. */
+	printf("Requests:");
+	for (int i = 0; i < STATS_MAX_COMMANDS && serverStats->commandNames[i][0] != '\0'; i++)
+	{
+		printf(" %s %llu", serverStats->commandNames[i], STAT_GET(commandCounts[i]));
+	}
+	printf("\n");
+
+	/* Print failures, timeouts, and count of each error seen. */
+	printf("Failures: handshake %llu, invalid request %llu, data connection %llu\n",
+		STAT_GET(handshakeFailures), STAT_GET(invalidRequests), STAT_GET(validationFailures));
+	printf("Timeouts: handshake %llu, command %llu, data connect %llu, send stall %llu, final ack %llu\n",
+		STAT_GET(handshakeTimeouts), STAT_GET(commandTimeouts), STAT_GET(dataConnectTimeouts),
+		STAT_GET(sendStallTimeouts), STAT_GET(finalAckTimeouts));
+	for (int i = 0; i < STATS_MAX_ERRNO; i++)
+	{
+		unsigned long long errorCount = STAT_GET(errorsByErrno[i]);
+		if (errorCount > 0)
+		{
+			printf("Errors (%s): %llu\n", (i == 0) ? "other" : strerror(i), errorCount);
+		}
+	}
+	printTcpStats(stdout, serverStats);
+	printLatencyPercentiles(stdout, serverStats);
+	fflush(stdout);
+}
@@ -0,0 +1,215 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		latencyHistogram.c
+ * File Description: 	Implementation of functions for recording request latencies in
+ * 			histograms and reporting their percentiles. Used by both ftserver and ftstat.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include "latencyHistogram.h"
+#include "serverStats.h"
+
+/* Name of each phase of a session, indexed by enum SessionPhase. */
+static const char* phaseNames[NUM_PHASES] =
+{
+	"intake queue",		/* Accepted until DATA_PORT starts to arrive and an intake thread takes it. */
+	"handshake",		/* Receiving DATA_PORT and sending the greeting. */
+	"command",		/* Greeting sent until the request has been received and parsed. */
+	"lane queue",		/* Parsed until a lane thread takes the request. */
+	"data connect",		/* Connecting the data socket to the client. */
+	"data validation",	/* Exchanging validation messages on the data connection. */
+	"first byte",		/* Validated until the first data has been sent. */
+	"streaming",		/* First data sent until the completion message has been sent. */
+	"final ack",		/* Waiting for the client to close its end. */
+	"total"			/* Accepted until the session finishes. */
+};
+
+/* Percentiles reported by printLatencyPercentiles. */
+static const double reportedPercentiles[] = { 50, 90, 99, 99.9 };
+
+
+/***********************************************************************************************
+ * Function Name:	phaseName
+ * Description:		Gets the name of a phase.
+ * Receives: 		A value of enum SessionPhase.
+ * Returns: 		The phase's name.
+ * Pre-Conditions: 	phase is less than NUM_PHASES.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+const char* phaseName(int phase)
+{
+	return phaseNames[phase];
+}
+
+
+/***********************************************************************************************
+ * Function Name:	latencyBucketLimit
+ * Description:		Gets the largest value counted by a histogram bucket.
+ * Receives: 		The index of a bucket.
+ * Returns: 		The largest latency, in nanoseconds, that latencyBucket places in bucket.
+ * Pre-Conditions: 	bucket is less than LATENCY_BUCKETS.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+unsigned long long latencyBucketLimit(int bucket)
+{
+	/* Buckets below LATENCY_SUB_BUCKETS hold a single value each. */
+	if (bucket < LATENCY_SUB_BUCKETS)
+	{
+		return bucket;
+	}
+
+	/* Otherwise, invert latencyBucket: recover the shift and the sub-bucket's leading bits, and
+	 * return the largest value with those leading bits. */
+	int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	unsigned long long leadingBits = LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS;
+	return ((leadingBits + 1) << shift) - 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	latencyPercentile
+ * Description:		Finds the value at or below which a given percentage of the recorded
+ * 			values fall.
+ * Receives: 		A histogram of LATENCY_BUCKETS counts and a percentile (0 to 100).
+ * Returns: 		The upper limit of the bucket holding the percentile, in nanoseconds,
+ * 			or 0 if the histogram is empty.
+ * Pre-Conditions: 	buckets holds LATENCY_BUCKETS counts.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+unsigned long long latencyPercentile(const unsigned long long* buckets, double percentile)
+{
+	/* Count values recorded. */
+	unsigned long long total = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; i++)
+	{
+		total += __atomic_load_n(&buckets[i], __ATOMIC_RELAXED);
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	/* Find rank of percentile (at least 1), then walk buckets until that many values are counted. */
+	unsigned long long rank = (unsigned long long)(percentile / 100.0 * total + 0.999999);
+	if (rank == 0)
+	{
+		rank = 1;
+	}
+	unsigned long long seen = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; i++)
+	{
+		seen += __atomic_load_n(&buckets[i], __ATOMIC_RELAXED);
+		if (seen >= rank)
+		{
+			return latencyBucketLimit(i);
+		}
+	}
+	return latencyBucketLimit(LATENCY_BUCKETS - 1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	recordLatency
+ * Description:		Counts one latency in the histogram for a phase and command.
+ * Receives: 		The phase, the command's index in the command registry (or
+ * 			STATS_MAX_COMMANDS if no valid command was received), and the time spent
+ * 			in the phase in nanoseconds.
+ * Returns: 		nothing
+ * Pre-Conditions: 	phase is less than NUM_PHASES and command at most STATS_MAX_COMMANDS.
+ * Post-Conditions: 	The matching bucket has been incremented with one atomic add.
+**********************************************************************************************/
+
+void recordLatency(int phase, int command, unsigned long long nanoseconds)
+{
+	STAT_ADD(latencyCounts[phase][command][latencyBucket(nanoseconds)], 1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	printLatencyPercentiles
+ * Description:		Prints count, percentiles, and maximum of every non-empty histogram,
+ * 			grouped by command, in microseconds.
+ * Receives: 		The stream to print to and the statistics holding the histograms.
+ * Returns: 		nothing
+ * Pre-Conditions: 	stats is initialized.
+ * Post-Conditions: 	Percentiles have been printed to out.
+**********************************************************************************************/
+
+void printLatencyPercentiles(FILE* out, struct ServerStats* stats)
+{
+	int numPercentiles = sizeof(reportedPercentiles) / sizeof(reportedPercentiles[0]);
+	for (int command = 0; command <= STATS_MAX_COMMANDS; command++)
+	{
+		/* Skip commands with no sessions recorded. */
+		const unsigned long long* totals = stats->latencyCounts[PHASE_TOTAL][command];
+		if (latencyPercentile(totals, 100) == 0)
+		{
+			continue;
+		}
+
+		/* Print heading naming command (or lack of one), then one line per non-empty phase. */
+		if (command == STATS_MAX_COMMANDS)
+		{
+			fprintf(out, "Latency (us), sessions without a valid command:\n");
+		}
+		else
+		{
+			fprintf(out, "Latency (us), %s requests:\n", stats->commandNames[command]);
+		}
+		fprintf(out, "  %-16s %8s", "phase", "count");
+		for (int i = 0; i < numPercentiles; i++)
+		{
+			char heading[16];
+			snprintf(heading, sizeof(heading), "p%g", reportedPercentiles[i]);
+			fprintf(out, " %10s", heading);
+		}
+		fprintf(out, " %10s\n", "max");
+		for (int phase = 0; phase < NUM_PHASES; phase++)
+		{
+			const unsigned long long* buckets = stats->latencyCounts[phase][command];
+			unsigned long long count = 0;
+			for (int i = 0; i < LATENCY_BUCKETS; i++)
+			{
+				count += __atomic_load_n(&buckets[i], __ATOMIC_RELAXED);
+			}
+			if (count == 0)
+			{
+				continue;
+			}
+			fprintf(out, "  %-16s %8llu", phaseNames[phase], count);
+			for (int i = 0; i < numPercentiles; i++)
+			{
+				fprintf(out, " %10.1f", latencyPercentile(buckets, reportedPercentiles[i]) / 1000.0);
+			}
+			fprintf(out, " %10.1f\n", latencyPercentile(buckets, 100) / 1000.0);
+		}
+	}
+}
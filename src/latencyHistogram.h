@@ -0,0 +1,117 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		latencyHistogram.h
+ * File Description: 	Header file for per-phase request latency histograms. Each session records
+ * 			the time spent in every phase it passes through, and when the session
+ * 			finishes those times are added to log-linear histograms (one per phase
+ * 			and command) in the statistics segment. Bucket boundaries follow the
+ * 			HdrHistogram layout: LATENCY_SUB_BUCKETS linear buckets per power of
+ * 			two, so every recorded value is within about 6% of its bucket's bounds.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef LATENCY_HISTOGRAM
+#define LATENCY_HISTOGRAM
+
+#include <stdio.h>
+#include <time.h>
+
+/* Phases of a session, in the order they occur. PHASE_TOTAL spans from accept until the
+ * session finishes. See phaseNames in latencyHistogram.c for descriptions. */
+enum SessionPhase
+{
+	PHASE_INTAKE_QUEUE,
+	PHASE_HANDSHAKE,
+	PHASE_COMMAND,
+	PHASE_LANE_QUEUE,
+	PHASE_DATA_CONNECT,
+	PHASE_DATA_VALIDATION,
+	PHASE_FIRST_BYTE,
+	PHASE_STREAMING,
+	PHASE_FINAL_ACK,
+	PHASE_TOTAL,
+	NUM_PHASES
+};
+
+/* Global constants describing histogram layout: 2^LATENCY_SUB_BUCKET_BITS linear buckets per
+ * power of two, up to values of 2^(LATENCY_MAX_EXPONENT + 1) nanoseconds (about 36 minutes);
+ * longer values are counted in the last bucket. */
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_EXPONENT 40
+#define LATENCY_BUCKETS ((LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS + 2) * LATENCY_SUB_BUCKETS)
+
+/* Forward declaration of struct holding the histograms (see serverStats.h). */
+struct ServerStats;
+
+/***********************************************************************************************
+ * Function Name:	monotonicNs
+ * Description:		Reads the monotonic clock.
+ * Receives: 		nothing
+ * Returns: 		The current CLOCK_MONOTONIC time in nanoseconds.
+**********************************************************************************************/
+
+static inline unsigned long long monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/***********************************************************************************************
+ * Function Name:	latencyBucket
+ * Description:		Finds the histogram bucket counting a value. Values below
+ * 			LATENCY_SUB_BUCKETS have a bucket each; larger values are placed by
+ * 			their highest set bit and the LATENCY_SUB_BUCKET_BITS bits after it.
+ * Receives: 		A latency in nanoseconds.
+ * Returns: 		The index of the bucket counting value.
+**********************************************************************************************/
+
+static inline int latencyBucket(unsigned long long value)
+{
+	if (value < LATENCY_SUB_BUCKETS)
+	{
+		return (int)value;
+	}
+	int exponent = 63 - __builtin_clzll(value);
+	if (exponent > LATENCY_MAX_EXPONENT)
+	{
+		return LATENCY_BUCKETS - 1;
+	}
+	int shift = exponent - LATENCY_SUB_BUCKET_BITS;
+	return (shift + 1) * LATENCY_SUB_BUCKETS + (int)((value >> shift) - LATENCY_SUB_BUCKETS);
+}
+
+/* Function prototypes. */
+const char* phaseName(int phase);
+unsigned long long latencyBucketLimit(int bucket);
+unsigned long long latencyPercentile(const unsigned long long* buckets, double percentile);
+void recordLatency(int phase, int command, unsigned long long nanoseconds);
+void printLatencyPercentiles(FILE* out, struct ServerStats* stats);
+
+#endif
@@ -0,0 +1,254 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		localTransport.c
+ * File Description: 	Implementation of functions for the Unix-domain socket transport. See
+ * 			localTransport.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "clientServerMessaging.h"
+#include "localTransport.h"
+
+/* Static variables. */
+static char boundPath[sizeof(((struct sockaddr_un*)0)->sun_path)];	/* Path the socket was bound to, or "". */
+static dev_t boundDevice;						/* Device and inode of the socket file */
+static ino_t boundInode;						/* created at boundPath. */
+
+
+/***********************************************************************************************
+ * Function Name:	establishLocalListeningSocket
+ * Description:		Creates a Unix-domain socket listening at path, replacing any socket
+ * 			left there by a server that did not shut down cleanly. The socket is
+ * 			non-blocking, since it is only accepted from once poll reports a
+ * 			connection waiting (and shards share it, so another may accept first).
+ * Receives: 		The path at which to listen, and the maximum number of connections awaiting
+ * 			acceptance.
+ * Returns: 		The file descriptor of the listening socket.
+ * Pre-Conditions: 	path is a non-empty string.
+ * Post-Conditions: 	Unless an error occurs (in which case the process exits), the socket is
+ * 			listening at path.
+**********************************************************************************************/
+
+int establishLocalListeningSocket(char* path, int backlog)
+{
+	/* Build address, exiting if the path does not fit. */
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "UNIX SOCKET ERROR: path %s is longer than %d characters\n", path,
+			(int)sizeof(address.sun_path) - 1);
+		exit(2);
+	}
+	strcpy(address.sun_path, path);
+
+	/* Remove a socket left at path (but nothing else, so a mistyped path cannot delete a file). */
+	struct stat pathInfo;
+	if (lstat(path, &pathInfo) == 0 && S_ISSOCK(pathInfo.st_mode))
+	{
+		unlink(path);
+	}
+
+	/* Create, bind, and activate socket, reporting error and exiting upon failure. */
+	int listeningSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (listeningSocketFD == -1
+		|| bind(listeningSocketFD, (struct sockaddr*)&address, sizeof(address)) == -1
+		|| listen(listeningSocketFD, backlog) == -1)
+	{
+		fprintf(stderr, "UNIX SOCKET ERROR: could not listen at %s: ", path);
+		perror("");
+		exit(2);
+	}
+
+	/* Remember the socket file created, so that removeLocalListeningSocket removes this file even
+	 * if the unix_socket setting is later changed, and never a file that has since replaced it. */
+	if (lstat(path, &pathInfo) == 0)
+	{
+		strcpy(boundPath, path);
+		boundDevice = pathInfo.st_dev;
+		boundInode = pathInfo.st_ino;
+	}
+	return listeningSocketFD;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	removeLocalListeningSocket
+ * Description:		Removes the socket file created by establishLocalListeningSocket, if it
+ * 			is still at the path it was bound to. Anything else now at that path
+ * 			(another server's socket, or a file) is left alone.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	The socket file this process created no longer exists.
+**********************************************************************************************/
+
+void removeLocalListeningSocket()
+{
+	struct stat pathInfo;
+	if (boundPath[0] != '\0' && lstat(boundPath, &pathInfo) == 0 && S_ISSOCK(pathInfo.st_mode)
+		&& pathInfo.st_dev == boundDevice && pathInfo.st_ino == boundInode)
+	{
+		unlink(boundPath);
+	}
+	boundPath[0] = '\0';
+}
+
+
+/***********************************************************************************************
+ * Function Name:	acceptLocalConnection
+ * Description:		Accepts a connection waiting on the Unix-domain listening socket and
+ * 			creates a struct FTInfo for it, marked as local, with LOCAL_CLIENT_HOST
+ * 			as its client host.
+ * Receives: 		The file descriptor of the Unix-domain listening socket.
+ * Returns: 		A newly-allocated struct FTInfo pointer on success, or NULL if no
+ * 			connection was waiting or an error occurred (which is printed).
+ * Pre-Conditions: 	listeningSocketFD was returned by establishLocalListeningSocket.
+ * Post-Conditions: 	Unless NULL is returned, the struct holds the control connection.
+**********************************************************************************************/
+
+struct FTInfo* acceptLocalConnection(int listeningSocketFD)
+{
+	/* Accept connection. The accepted socket blocks (it does not inherit O_NONBLOCK), like those
+	 * accepted over TCP. */
+	int controlSocketFD = accept(listeningSocketFD, NULL, NULL);
+	if (controlSocketFD < 0)
+	{
+		if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			perror("ACCEPT LOCAL CONNECTION ERROR");
+		}
+		return NULL;
+	}
+
+	/* Allocate and return a new struct FTInfo pointer for the local client. */
+	char* clientHost = (char*)malloc(sizeof(LOCAL_CLIENT_HOST));
+	strcpy(clientHost, LOCAL_CLIENT_HOST);
+	struct FTInfo* myFT = newFTInfo(controlSocketFD, clientHost);
+	myFT->local = 1;
+	FT_PROBE(accept, myFT->sessionId, controlSocketFD, clientHost);
+	return myFT;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	passDataSocket
+ * Description:		Creates a connected pair of Unix-domain sockets and passes one of them to
+ * 			a local client over its control connection, attached to
+ * 			DATA_SOCKET_MESSAGE, to serve as the data connection.
+ * Receives: 		The control socket of a local client.
+ * Returns: 		The server's end of the data connection, or -1 upon error.
+ * Pre-Conditions: 	The client has sent a valid request.
+ * Post-Conditions: 	Unless -1 is returned, the client holds the other end of the data connection.
+**********************************************************************************************/
+
+int passDataSocket(int controlSocketFD)
+{
+	int socketPair[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, socketPair) == -1)
+	{
+		STAT_ERRNO(errno);
+		perror("DATA SOCKET ERROR");
+		return -1;
+	}
+
+	/* Pass client's end, closing it here whether or not passing it succeeded. */
+	int result = sendDescriptor(controlSocketFD, DATA_SOCKET_MESSAGE, socketPair[1]);
+	close(socketPair[1]);
+	if (result == -1)
+	{
+		close(socketPair[0]);
+		return -1;
+	}
+	return socketPair[0];
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendDescriptor
+ * Description:		Sends a message framed as sendMessage frames it, with a file descriptor
+ * 			attached (SCM_RIGHTS) to its first byte, so that the receiver gets the
+ * 			descriptor by reading that byte with recvmsg.
+ * Receives: 		A Unix-domain socket connected to the client, the message, and the
+ * 			descriptor to pass.
+ * Returns: 		0 on success; -1 upon error (which is printed).
+ * Pre-Conditions: 	socketFD is a connected Unix-domain stream socket.
+ * Post-Conditions: 	Unless -1 is returned, the whole message has been sent and the client
+ * 			holds a duplicate of descriptor. The caller still owns descriptor.
+**********************************************************************************************/
+
+int sendDescriptor(int socketFD, char* message, int descriptor)
+{
+	/* Frame message in one buffer, so that the descriptor is attached to a complete frame. */
+	char frame[64];
+	int frameLen = snprintf(frame, sizeof(frame), "%d@%s", (int)strlen(message), message);
+
+	/* Attach descriptor as ancillary data. */
+	struct iovec frameVector;
+	frameVector.iov_base = frame;
+	frameVector.iov_len = frameLen;
+	union
+	{
+		char buffer[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} control;
+	memset(&control, 0, sizeof(control));
+	struct msghdr header;
+	memset(&header, 0, sizeof(header));
+	header.msg_iov = &frameVector;
+	header.msg_iovlen = 1;
+	header.msg_control = control.buffer;
+	header.msg_controllen = sizeof(control.buffer);
+	struct cmsghdr* rights = CMSG_FIRSTHDR(&header);
+	rights->cmsg_level = SOL_SOCKET;
+	rights->cmsg_type = SCM_RIGHTS;
+	rights->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(rights), &descriptor, sizeof(int));
+
+	/* Send frame with descriptor, then any part of the frame not sent. */
+	int charsSent = sendmsg(socketFD, &header, MSG_NOSIGNAL);
+	if (charsSent < 0)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			STAT_ADD(sendStallTimeouts, 1);
+			errno = ETIMEDOUT;
+		}
+		STAT_ERRNO(errno);
+		perror("SEND DESCRIPTOR ERROR");
+		return -1;
+	}
+	if (charsSent < frameLen)
+	{
+		return sendCompleteString(socketFD, frame + charsSent, 0);
+	}
+	return 0;
+}
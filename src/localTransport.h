@@ -0,0 +1,60 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		localTransport.h
+ * File Description: 	Header file for the Unix-domain socket transport used by clients on the
+ * 			same host as the server. A local client connects to the socket named by
+ * 			the unix_socket setting and sends "DATA_PORT: 0"; instead of connecting
+ * 			back to the client, the server makes a socket pair and passes one end to
+ * 			the client over the control connection (SCM_RIGHTS) as the data socket.
+ * 			A requested file is then not streamed: the server passes the client an
+ * 			open read-only descriptor of it over the data socket, and the success
+ * 			message gives the number of bytes the client should copy from it.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef LOCAL_TRANSPORT
+#define LOCAL_TRANSPORT
+
+#include "FTInfo.h"
+
+/* Global constant representing the client host recorded for connections on the Unix-domain socket. */
+#define LOCAL_CLIENT_HOST "local"
+
+/* Global constants representing the messages to which the data socket and a file's descriptor are
+ * attached when passed to a client. */
+#define DATA_SOCKET_MESSAGE "FTSERVER DATA SOCKET"
+#define FILE_DESCRIPTOR_MESSAGE "FTSERVER FILE DESCRIPTOR"
+
+/* Function prototypes. */
+int establishLocalListeningSocket(char* path, int backlog);
+void removeLocalListeningSocket();
+struct FTInfo* acceptLocalConnection(int listeningSocketFD);
+int passDataSocket(int controlSocketFD);
+int sendDescriptor(int socketFD, char* message, int descriptor);
+
+#endif
@@ -29,14 +29,31 @@
  * 			establishing a listening socket at that port, and then entering an endless loop 
  * 			awaiting new connections.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
+/* Needed for ppoll. */
+#define _GNU_SOURCE
+
 #include "manageConnections.h"
 
 /* Global variable definitions. */
-int listeningSocketFD = -5;			/* Listening socket file descriptor closed by SIGINT handler. */
+int listeningSocketFD = -5;			/* Listening socket file descriptor closed upon SIGINT. */
+int localListeningSocketFD = -1;		/* Unix-domain listening socket, or -1 if none. */
 char* serverPort = NULL;			/* Server port number; used when printing error messages. */
+volatile sig_atomic_t reloadRequested = 0;	/* Set by SIGHUP handler to request configuration reload. */
+volatile sig_atomic_t statsRequested = 0;	/* Set by SIGUSR1 handler to request statistics be printed. */
+volatile sig_atomic_t shutdownRequested = 0;	/* Set by SIGINT handler to request the server shut down. */
+
+/* Connections turned away because the server was busy whose sockets have not been closed yet.
+ * Used only by the thread accepting connections. */
+static struct RejectedConnection rejectedConnections[MAX_REJECTED_CONNECTIONS];
+static int numRejected = 0;
+
+/* Signal mask of the thread accepting connections while it waits for one. SIGINT, SIGHUP and SIGUSR1
+ * are blocked at all other times, so that a signal received while the thread is busy is acted upon
+ * as soon as it waits instead of after the next connection. */
+static sigset_t acceptMask;
 
 /***********************************************************************************************
  * Function Name:	validatePortnum
@@ -70,7 +87,8 @@ int validatePortnum(char* portnum)
  * Function Name:	startup
  * Description:		Creates listening socket, registers signal handler to close listening
  * 			socket upon SIGINT, and calls acceptConnection to enter main
- * 			server loop.
+ * 			server loop. If the configuration sets shards, this is done in each
+ * 			shard, while the process started from the command line supervises them.
  * Receives: 		The desired portnum at which to bind the listening socket,
  * 			represented as a string.
  * Returns: 		nothing (Listening socket file descriptor stored in global variable
@@ -85,18 +103,69 @@ int validatePortnum(char* portnum)
 
 void startup(char* portnumIn)
 {
+	struct ServerConfig* config = getServerConfig();
+
 	/* Store SERVER_PORT received on command line in global variable
 	 * (for reference when referring to control connections in error messages). */
 	serverPort = portnumIn;
+
+	/* Build the command lookup table used when parsing client requests. */
+	initCommandRegistry();
+
+	/* Create Unix-domain listening socket for local clients, if configured. Shards share it. */
+	if (config->unixSocket[0] != '\0')
+	{
+		localListeningSocketFD = establishLocalListeningSocket(config->unixSocket, config->listenBacklog);
+	}
 	
 	/* Create listening socket and print message to indicate server is now listening for connections
-	 * on portnum. */
-	listeningSocketFD = establishListeningSocket(serverPort);
-	printf("Server listening on port %s.\n", serverPort);
+	 * on portnum. If the server is sharded, only the shards return from startShards, each with its
+	 * own listening socket. */
+	if (config->shards > 0)
+	{
+		listeningSocketFD = startShards(serverPort, (int)config->shards, config->listenBacklog);
+	}
+	else
+	{
+		listeningSocketFD = establishListeningSocket(serverPort, config->listenBacklog, 0);
+		printf("Server listening on port %s.\n", serverPort);
+	}
+	if (localListeningSocketFD >= 0 && shardIndex <= 0)
+	{
+		printf("Server listening for local clients at %s.\n", config->unixSocket);
+	}
 
-	/* Register signal handler to close listening socket upon sigint. */
+	/* Publish server counters for ftstat (in a segment of this shard's own, if sharded). */
+	char statsName[STATS_SEGMENT_NAME_LEN];
+	shardName(serverPort, statsName, sizeof(statsName));
+	openStatsSegment(statsName);
+
+	/* Register signal handler to shut down upon sigint. */
 	setSIGINThandler();
 
+	/* Put configuration loaded by main into effect, and register signal handlers
+	 * to reload it upon SIGHUP and print statistics upon SIGUSR1. */
+	applyServerConfig();
+	setFlagSignalHandlers();
+
+	/* Block those signals except while waiting for a connection (see acceptNextConnection). Threads
+	 * started from now on block every signal anyway. */
+	sigset_t serverSignals;
+	sigemptyset(&serverSignals);
+	sigaddset(&serverSignals, SIGINT);
+	sigaddset(&serverSignals, SIGHUP);
+	sigaddset(&serverSignals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &serverSignals, &acceptMask);
+
+	/* Start the thread writing the access log, so that threads handling requests never print. */
+	startAccessLog();
+
+	/* Load the TLS certificate (if connections are encrypted) and allocate the buffers used to read files
+	 * with direct I/O, then start the scheduler's worker threads, which will handle accepted connections. */
+	initTls();
+	initDirectBufferPool();
+	startScheduler();
+
 	/* Call acceptConnection to enter main server loop of listening for
 	 * and then accepting client connections. */
 	acceptConnection();
@@ -105,8 +174,7 @@ void startup(char* portnumIn)
 
 /***********************************************************************************************
  * Function Name:	setSIGINThandler
- * Description:		Registers a signal handler to SIGINT for closing the listening socket
- * 			before exiting.
+ * Description:		Registers a signal handler to SIGINT for shutting the server down.
  * Receives: 		nothing
  * Returns: 		nothing
  * Pre-Conditions: 	listeningSocketFD represents a listening socket that has already
@@ -135,73 +203,343 @@ void setSIGINThandler()
 
 /***********************************************************************************************
  * Function Name:	catchSIGINT
- * Description:		Handles a SIGINT when one is raised. Closes the listening socket
- * 			and exits with status code 0 to indicate successful server shutdown.
+ * Description:		Handles a SIGINT when one is raised by setting shutdownRequested, so that
+ * 			the main server loop shuts the server down (joining the access log thread and
+ * 			exiting are not safe within a signal handler).
  * Receives: 		The signal number of the signal raised.
  * Returns: 		nothing
- * Pre-Conditions: 	listeningSocketFD represents a listening socket that has previously
- * 			been bound to the desired port number and activated for listening.
- * Post-Conditions: 	The listening socket has been closed and the process has exited.
+ * Pre-Conditions: 	SIGINT has been received.
+ * Post-Conditions: 	shutdownRequested is set.
 **********************************************************************************************/
 
 void catchSIGINT(int signo)
 {
-	close(listeningSocketFD);
-	exit(0);
+	shutdownRequested = 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	setFlagSignalHandlers
+ * Description:		Registers catchFlagSignal as the signal handler for SIGHUP and SIGUSR1.
+ * 			Either signal interrupts the wait for a connection, so the request is
+ * 			acted upon promptly even while the server is idle.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	When SIGHUP or SIGUSR1 is received, catchFlagSignal is called.
+**********************************************************************************************/
+
+void setFlagSignalHandlers()
+{
+	/* Declare sigaction struct for SIGHUP and SIGUSR1 signals, initializing as empty. */
+	struct sigaction flag_action;
+	memset(&flag_action, 0, sizeof(struct sigaction));
+
+	/* Set data members of flag_action struct so that signal handler is catchFlagSignal,
+	 * all other incoming signals are blocked until the signal handler returns, and no flags are set. */
+	flag_action.sa_handler = catchFlagSignal;
+	sigfillset(&flag_action.sa_mask);
+	flag_action.sa_flags = 0;
+
+	/* Call sigaction function to set signal actions for when SIGHUP or SIGUSR1 is received. */
+	sigaction(SIGHUP, &flag_action, NULL);
+	sigaction(SIGUSR1, &flag_action, NULL);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	catchFlagSignal
+ * Description:		Signal handler for SIGHUP and SIGUSR1. Sets reloadRequested (upon SIGHUP)
+ * 			or statsRequested (upon SIGUSR1) so that the main server loop reloads the
+ * 			configuration file or prints server statistics (reading files and
+ * 			printing are not safe within a signal handler).
+ * Receives: 		The number of the signal received.
+ * Returns: 		nothing
+ * Pre-Conditions: 	SIGHUP or SIGUSR1 has been received.
+ * Post-Conditions: 	The flag corresponding to signo is set.
+**********************************************************************************************/
+
+void catchFlagSignal(int signo)
+{
+	if (signo == SIGHUP)
+	{
+		reloadRequested = 1;
+	}
+	else
+	{
+		statsRequested = 1;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	applyServerConfig
+ * Description:		Puts the settings returned by getServerConfig into effect in every
+ * 			module that keeps its own copy of them.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	The settings to apply have been loaded.
+ * Post-Conditions: 	All subsequent requests are handled with the settings loaded.
+**********************************************************************************************/
+
+void applyServerConfig()
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Calling listen again on a listening socket changes its backlog without dropping connections
+	 * already awaiting accept. */
+	if (listeningSocketFD >= 0)
+	{
+		listen(listeningSocketFD, config->listenBacklog);
+	}
+
+	setShaperLimits(config->totalRateLimit, config->clientRateLimit,
+			config->transferRateLimit, config->rateBurst);
+
+	struct SocketTuning tuning;
+	memset(&tuning, 0, sizeof(tuning));
+	tuning.noDelay = (config->socketNodelay != 0);
+	tuning.frameMore = (config->socketFrameMore != 0);
+	tuning.cork = (config->socketCork != 0);
+	tuning.notsentLowat = config->socketNotsentLowat;
+	tuning.bdpBuffers = (config->socketBdpBuffers != 0);
+	setSocketTuning(&tuning, config->socketCongestion, listeningSocketFD);
+
+	/* Each shard writes its own trace and access log, named after the shard. */
+	char filename[MAX_CONFIG_LINE + MAX_ULLINT_DIGITS];
+	shardName(config->traceFile, filename, sizeof(filename));
+	openSessionTrace(filename);
+	shardName(config->accessLog, filename, sizeof(filename));
+	setAccessLogFile(filename);
 }
 
 
 /***********************************************************************************************
  * Function Name:	acceptConnection
- * Description:		Loops between accepting and handling incoming client connections
- * 			on the listening socket until SIGINT is received.
+ * Description:		Loops accepting incoming client connections on the listening socket
+ * 			and submitting them to the request scheduler, whose worker threads
+ * 			handle them, until SIGINT is received. Then closes the listening socket,
+ * 			removes the Unix-domain socket (if any), writes any access log records
+ * 			still waiting, removes the statistics segment, and exits with status code
+ * 			0 to indicate successful server shutdown.
  * Receives: 		nothing (listeningSocketFD is stored in global variable)
- * Returns: 		nothing
+ * Returns: 		Never returns.
  * Pre-Conditions: 	listeningSocketFD represents a socket that has been bound to the 
  * 			desired port and activated for listening. SIGINT handler has been
- * 			registered to catch SIGINTs.
- * Post-Conditions: 	Once SIGINT is received, signal handler closes listening socket
- * 			and exits process with status code 0.
+ * 			registered to catch SIGINTs, and SIGINT, SIGHUP and SIGUSR1 are blocked.
+ * Post-Conditions: 	The process has exited.
 **********************************************************************************************/
 
 void acceptConnection()
 {
-	/* Enter endless loop to accept and then handle client connections
+	/* Enter loop to accept and then handle client connections
 	 * until SIGINT is received. */
-	while (1)
+	while (!shutdownRequested)
 	{
-		/* Print message indicating that server is awaiting new connection. */
-		printf("Awaiting new connection...\n");
-		
+		/* If a SIGHUP has been received since the last iteration, reload the configuration file,
+		 * keeping the settings currently in effect if it cannot be read. */
+		if (reloadRequested)
+		{
+			reloadRequested = 0;
+			if (configFilename != NULL && loadServerConfig(configFilename) == 0)
+			{
+				applyServerConfig();
+				printf("Configuration reloaded from %s.\n", configFilename);
+			}
+		}
+
+		/* If a SIGUSR1 has been received since the last iteration, print server statistics. */
+		if (statsRequested)
+		{
+			statsRequested = 0;
+			dumpServerStats(stdout, listeningSocketFD);
+		}
+
+		/* Close any rejected connections that are finished. */
+		reapRejectedConnections();
+
 		/* Accept connection, receiving new FTInfo returned (or NULL on error). If
 		 * error occurs, continue to next iteration. */
-		struct FTInfo* myFT = acceptClientConnection(listeningSocketFD);
+		struct FTInfo* myFT = acceptNextConnection();
 		if (myFT == NULL)
 		{
 			continue;
 		}
+		if (!myFT->local)
+		{
+			tuneControlSocket(myFT->controlSocketFD);
+		}
 		
-		/* Print that connection received from myFT->clientNickname (which will be
-		 * flip server or IP address). */
-		printf("Connection from %s\n", myFT->clientNickname);
-		
-		/* Receive and validate initial message with data port
-		 * from client. If invalid conection, free FTInfo and continue
-		 * to next iteration. */
-		if (!validateControlConnection(myFT))
+		/* If the maximum number of sessions are already active, turn the client away with a message
+		 * telling it when to retry, and continue to next iteration. */
+		if (!admitConnection())
 		{
+			logEvent(LOG_BUSY_REJECTED, myFT, NULL, 0);
+			rejectConnection(myFT);
 			deleteFTInfo(myFT);
 			myFT = NULL;
 			continue;
 		}
 
-		/* Handle request. */
-		handleRequest(myFT);
-
-		/* Delete FTInfo (which will also close its data socket if ever created). */
-		deleteFTInfo(myFT);
+		/* Log that connection received from myFT->clientNickname (which will be
+		 * flip server or IP address). */
+		logEvent(LOG_CONNECTION, myFT, NULL, 0);
+		
+		/* Submit connection to the scheduler, which will validate it, receive the request,
+		 * fulfill the request, and delete FTInfo on a worker thread. */
+		submitConnection(myFT);
 		myFT = NULL;
 	}
+
+	/* Shut down. */
+	close(listeningSocketFD);
+	removeLocalListeningSocket();
+	stopAccessLog();
+	closeStatsSegment();
+	exit(0);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	acceptNextConnection
+ * Description:		Accepts the next client connection. Waits until a listening socket has a
+ * 			connection waiting, with acceptMask in effect so that SIGINT, SIGHUP and
+ * 			SIGUSR1 interrupt only the wait, and accepts from it. If there is also a
+ * 			Unix-domain listening socket, takes turns between the two when both have
+ * 			connections waiting so that neither kind of client can starve the other.
+ * Receives: 		nothing
+ * Returns: 		A newly-allocated struct FTInfo pointer on success, or NULL if the wait
+ * 			was interrupted by a signal or an error occurred.
+ * Pre-Conditions: 	listeningSocketFD (and localListeningSocketFD, if not -1) are listening.
+ * Post-Conditions: 	Unless NULL is returned, the connection has been accepted.
+**********************************************************************************************/
+
+struct FTInfo* acceptNextConnection()
+{
+	static int preferLocal = 0;	/* True if the local socket is accepted from first when both are ready. */
+
+	/* Wait for a connection on either socket, returning if interrupted by a signal. */
+	struct pollfd listeners[2];
+	listeners[0].fd = listeningSocketFD;
+	listeners[0].events = POLLIN;
+	listeners[0].revents = 0;
+	listeners[1].fd = localListeningSocketFD;
+	listeners[1].events = POLLIN;
+	listeners[1].revents = 0;
+	if (ppoll(listeners, (localListeningSocketFD >= 0) ? 2 : 1, NULL, &acceptMask) <= 0)
+	{
+		return NULL;
+	}
+
+	/* Accept from the socket whose turn it is if it is ready, and otherwise from the other one. */
+	int localReady = (listeners[1].revents & POLLIN) != 0;
+	int tcpReady = (listeners[0].revents & POLLIN) != 0;
+	if (localReady && (preferLocal || !tcpReady))
+	{
+		preferLocal = 0;
+		return acceptLocalConnection(localListeningSocketFD);
+	}
+	preferLocal = 1;
+	return tcpReady ? acceptClientConnection(listeningSocketFD) : NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	rejectConnection
+ * Description:		Tells a client that the server is too busy to serve it and when to retry,
+ * 			without waiting on the client at any point: the socket is made non-blocking,
+ * 			the busy message is sent, and the sending side of the connection is shut
+ * 			down. The socket is not closed yet, since closing it before the client's
+ * 			initial message arrives would reset the connection and could discard the
+ * 			busy message; instead it is handed to reapRejectedConnections.
+ * Receives: 		A struct FTInfo pointer for a newly-accepted connection.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Nothing has been received from or sent to the client yet.
+ * Post-Conditions: 	The busy message has been sent (unless the socket buffer was full),
+ * 			the rejection has been counted, and myFT no longer owns its control
+ * 			socket. The caller still deletes myFT.
+**********************************************************************************************/
+
+void rejectConnection(struct FTInfo* myFT)
+{
+	/* Make control socket non-blocking so that a client that never reads cannot stall the accept loop. */
+	fcntl(myFT->controlSocketFD, F_SETFL, fcntl(myFT->controlSocketFD, F_GETFL) | O_NONBLOCK);
+
+	/* Build and send busy message containing the number of milliseconds after which to retry. If
+	 * connections are encrypted, the client expects a TLS handshake that this thread cannot wait for,
+	 * so the connection is only shut down. */
+	if (!tlsEnabled() || myFT->local)
+	{
+		char busyMessage[sizeof(BUSY_MESSAGE_PREFIX) + MAX_ULLINT_DIGITS + 4];
+		sprintf(busyMessage, "%s%llu ms", BUSY_MESSAGE_PREFIX, getServerConfig()->busyRetryMs);
+		sendMessage(myFT->controlSocketFD, busyMessage);
+	}
+
+	/* Signal that nothing more will be sent. */
+	shutdown(myFT->controlSocketFD, SHUT_WR);
+
+	/* If the list of rejected connections awaiting close is full, close the oldest one to make room. */
+	if (numRejected == MAX_REJECTED_CONNECTIONS)
+	{
+		close(rejectedConnections[0].socketFD);
+		memmove(rejectedConnections, rejectedConnections + 1, (numRejected - 1) * sizeof(struct RejectedConnection));
+		numRejected--;
+	}
+
+	/* Add control socket to the list, transferring ownership from myFT. */
+	rejectedConnections[numRejected].socketFD = myFT->controlSocketFD;
+	clock_gettime(CLOCK_MONOTONIC, &rejectedConnections[numRejected].rejectedAt);
+	numRejected++;
+	myFT->controlSocketFD = -1;
+
+	/* Count rejection. */
+	STAT_ADD(sessionsRejected, 1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	reapRejectedConnections
+ * Description:		Discards anything received on each rejected connection awaiting close,
+ * 			closing the connection once the client has closed its end or
+ * 			REJECTED_LINGER_SECONDS have passed since it was rejected.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	Called only by the thread accepting connections.
+ * Post-Conditions: 	Connections that are finished have been closed and removed from the list.
+**********************************************************************************************/
+
+void reapRejectedConnections()
+{
+	/* Get the current time for comparing with rejection times. */
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	/* Examine each connection, keeping those that are not finished at the front of the list. */
+	int numKept = 0;
+	for (int i = 0; i < numRejected; i++)
+	{
+		/* Discard everything received so far. recv returns 0 once the client has closed its end. */
+		int socketFD = rejectedConnections[i].socketFD;
+		char discardBuffer[256];
+		int charsRead;
+		do
+		{
+			charsRead = recv(socketFD, discardBuffer, sizeof(discardBuffer), 0);
+		} while (charsRead > 0);
+		int clientClosed = (charsRead == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+
+		/* Close connection if client has closed its end or it has lingered long enough. Otherwise, keep it. */
+		if (clientClosed || now.tv_sec - rejectedConnections[i].rejectedAt.tv_sec >= REJECTED_LINGER_SECONDS)
+		{
+			close(socketFD);
+		}
+		else
+		{
+			rejectedConnections[numKept] = rejectedConnections[i];
+			numKept++;
+		}
+	}
+	numRejected = numKept;
 }
 
 
@@ -221,10 +559,31 @@ void acceptConnection()
 
 int validateControlConnection(struct FTInfo* myFT)
 {
-	/* Receive initial message from client, returning false if NULL message received. */
-	char* messageFromClient = recvMessage(myFT->controlSocketFD);
+	struct ServerConfig* config = getServerConfig();
+
+	/* Limit how long any send on control socket may stall waiting for client to read. */
+	setSendTimeout(myFT->controlSocketFD, (int)config->sendStallTimeoutMs);
+
+	/* If connections are encrypted, perform TLS handshake first (local clients are not encrypted),
+	 * returning false upon failure (counting a timeout if client did not answer in time). */
+	if (!myFT->local && startTls(myFT->controlSocketFD, remainingMessageMs(myFT)) == -1)
+	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(handshakeTimeouts, 1);
+		}
+		return 0;
+	}
+
+	/* Receive initial message from client, returning false if NULL message received (counting a timeout
+	 * if client did not send it in time). */
+	char* messageFromClient = recvMessage(myFT->controlSocketFD, remainingMessageMs(myFT));
 	if (messageFromClient == NULL)
 	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(handshakeTimeouts, 1);
+		}
 		return 0;
 	}
 
@@ -275,11 +634,10 @@ int validateControlConnection(struct FTInfo* myFT)
 	{
 		char* errMessage = "MESSAGE FORMAT ERROR: Initial message must be formatted as: \"DATA_PORT: <portnum>\"";
 		
-		/* If there is no error sending error message, print message
-		 * to console explaining invalid message format received. */
+		/* If there is no error sending error message, log that invalid message format was received. */
 		if (sendMessage(myFT->controlSocketFD, errMessage) == 0)
 		{
-			fprintf(stderr, "%s\n", errMessage);
+			logEvent(LOG_INVALID_MESSAGE, myFT, errMessage, 0);
 		}
 		
 		/* Return 0 to calling function to indicate invalid connection. */
@@ -297,6 +655,7 @@ int validateControlConnection(struct FTInfo* myFT)
 		{
 			return 0;
 		}
+		FT_PROBE(handshake, myFT->sessionId, 0, myFT->dataPort);
 
 		/* Otherwise, return 1 since sending message was successful. */
 		return 1;
@@ -306,161 +665,124 @@ int validateControlConnection(struct FTInfo* myFT)
 
 /***********************************************************************************************
  * Function Name:	handleRequest
- * Description:		Receives and interprets client's request. If valid request, calls
- * 			apporpriate function to process it. If invalid request, sends error
- * 			to client.
+ * Description:		Receives and interprets client's request. If invalid request, sends error
+ * 			to client. The request is fulfilled later by fulfillRequest, once the
+ * 			scheduler has chosen a thread for it.
  * Receives: 		struct FTInfo containing information about the connection to
  * 			the client.
- * Returns: 		nothing
+ * Returns: 		True if a valid request was received; false otherwise.
  * Pre-Conditions: 	The struct FTInfo has been allocated and initialized with a controlSocketFD
  * 			connected to the client, information about the client's host, and 
  *			the port on which the client is listening for a data connection.
- * Post-Conditions: 	The client's request has been fulfilled or an error message
- * 			has been sent to the client.
+ * Post-Conditions: 	If true is returned, the command, handler, and filename (if applicable)
+ * 			of the struct FTInfo have been set. Otherwise, an error message
+ * 			has been sent to the client (unless the request could not be received).
 **********************************************************************************************/
 
-void handleRequest(struct FTInfo* myFT)
+int handleRequest(struct FTInfo* myFT)
 {
-	/* Get and validate client request, returning from this function
-	 * if a NULL message is received. */
-	char* clientRequest = recvMessage(myFT->controlSocketFD);
+	/* Get and validate client request, returning false from this function
+	 * if a NULL message is received (counting a timeout if client did not send it in time). */
+	char* clientRequest = recvMessage(myFT->controlSocketFD, remainingMessageMs(myFT));
 	if (clientRequest == NULL)
 	{
-		return;
-	}
-
-	/* Declare variable for use with strtok_r. */
-	int requestError = 0;		/* Flag set if error detected with request. */
-	char* saveptr;			/* Pointer used by strtok_r to save place in string. */
-	char* errMessage = NULL;	/* Error message to send to client, if applicable. */
-
-	/* Get first token of string. */
-	char* token1 = strtok_r(clientRequest, " ", &saveptr);
-
-	/* If first token is NULL (clientRequest is string containing only spaces), set requestError. */
-	if (token1 == NULL)
-	{
-		requestError = 1;
-		errMessage = "NO COMMAND RECEIVED";
-	}
-	
-	/* Otherwise, get second token (which should be NULL unless -g command is received,
-	 * in which case it should be a filename). */
-	else
-	{
-		char* token2 = strtok_r(NULL, " ", &saveptr);
-
-		/* See if token1 is GET_FILE command. */
-		if (strcmp(token1, GET_FILE) == 0)
+		if (errno == ETIMEDOUT)
 		{
-			/* If token2 is null, set requestError flag. */
-			if (token2 == NULL)
-			{
-				requestError = 1;
-				errMessage = "BAD REQUEST: <filename> required after -g command.";
-			}
-
-			/* Otherwise, if there is an unexpected non-null token after token2, set requestError flag. */
-			else if (strtok_r(NULL, " ", &saveptr) != NULL)
-			{
-				requestError = 1;
-				errMessage = "BAD REQUEST: only <filename> should come after -g command.";
-			}
-
-			/* Otherwise, since command syntax appears valid, set command and filename
-			 * of struct FTInfo. */
-			else
-			{
-				myFT->command = copyToken(token1);
-				myFT->filename = copyToken(token2);
-			}
+			STAT_ADD(commandTimeouts, 1);
 		}
+		return 0;
+	}
 
-		/* Otherwise, if token1 is -l, process it. */
-		else if (strcmp(token1, LIST_FILES) == 0)
-		{
-			/* If there is an unexpected second token after -l command,
-			 * set requestError flag. */
-			if (token2 != NULL)
-			{
-				requestError = 1;
-				errMessage = "BAD REQUEST: no arguments should appear after -l command.";
-			}
+	/* Store clientRequest in struct FTInfo, which takes ownership of it. The request is parsed in place,
+	 * so the command and filename stored below point into it and remain valid until myFT is deleted. */
+	myFT->request = clientRequest;
 
-			/* Otherwise, store command in struct FTInfo. */
-			else
-			{
-				myFT->command = copyToken(token1);
-			}
-		}
+	/* Parse request against the command registry. errMessage is NULL if the request is valid. */
+	struct ParsedRequest parsed;
+	char* errMessage = parseRequest(clientRequest, &parsed);
 
-		/* Otherwise, if token1 is -ltxt, process it. */
-		else if (strcmp(token1, LIST_TXT_FILES) == 0)
+	/* If command also takes a size after the filename (as PUT_FILE does), store it as the size of the
+	 * request, rejecting the request if it is not a number of bytes. */
+	if (errMessage == NULL && parsed.argCount > 1)
+	{
+		char* sizeEnd = parsed.args[1];
+		errno = 0;
+		if (isdigit((unsigned char)parsed.args[1][0]))
 		{
-			/* If there is an unexpected second token after -ltxt command,
-			 * set requestError flag. */
-			if (token2 != NULL)
-			{
-				requestError = 1;
-				errMessage = "BAD REQUEST: no arguments should appear after -ltxt command.";
-			}
-
-			/* Otherwise, store command in struct FTInfo. */
-			else
-			{
-				myFT->command = copyToken(token1);
-			}
+			myFT->requestSize = strtoll(parsed.args[1], &sizeEnd, 10);
 		}
-
-		/* Otherwise, command is invalid. Set requestError flag. */
-		else
+		if (sizeEnd == parsed.args[1] || *sizeEnd != '\0' || errno == ERANGE)
 		{
-			requestError = 1;
-			errMessage = "UNRECOGNIZED COMMAND: Accepted commands are -l, -ltxt, and -g <filename>.";
+			myFT->requestSize = -1;
+			errMessage = BAD_SIZE_MESSAGE;
 		}
 	}
 
-	/* Free clientRequest now that it has been tokenized and tokens have either been copied to struct FTInfo
-	 * (if valid) or can be completely discarded (if invalid). */
-	free(clientRequest);
-	clientRequest = NULL;
-
-	/* If there was a request error, send error message to client on control socket, print error message
-	 * upon send success, and return control to calling function. */
-	if (requestError)
+	/* If there was a request error, count it, send error message to client on control socket, log error
+	 * message upon send success, and return false to calling function. */
+	if (errMessage != NULL)
 	{
+		STAT_ADD(invalidRequests, 1);
 		if (sendMessage(myFT->controlSocketFD, errMessage) == 0)
 		{
-			fprintf(stderr, "%s\n", errMessage);
+			logEvent(LOG_INVALID_REQUEST, myFT, errMessage, 0);
 		}
-		return;
+		return 0;
 	}
 
-	/* Otherwise, establish a data connection with the client, sending initial message and receiving response
-	 * to validate connection. Return control to calling function upon validation failure. */
-	else if (!validateDataConnection(myFT))
+	/* Otherwise, since request syntax is valid, count it and set command, handler, and filename (if command
+	 * takes one) of struct FTInfo. */
+	STAT_ADD(commandCounts[commandIndex(parsed.handler)], 1);
+	myFT->command = parsed.command;
+	myFT->handler = parsed.handler;
+	if (parsed.argCount > 0)
 	{
-		return;
+		myFT->filename = parsed.args[0];
 	}
+	return 1;
+}
 
-	/* Now that data connection has been established and validated, call appropriate request handler
-	 * based on command received. If command received is GET_FILE, call sendFileToClient.  */
-	if (strcmp(myFT->command, GET_FILE) == 0)
-	{
-		sendFileToClient(myFT);
-	}
 
-	/* Otherwise, command is -l or -ltxt. Call sendListingToClient. */
-	else
+/***********************************************************************************************
+ * Function Name:	fulfillRequest
+ * Description:		Establishes and validates a data connection with the client and calls
+ * 			the handler registered for the command received to send the requested
+ * 			data.
+ * Receives: 		struct FTInfo containing information about the connection to
+ * 			the client.
+ * Returns: 		nothing
+ * Pre-Conditions: 	handleRequest has returned true for the struct FTInfo.
+ * Post-Conditions: 	The client's request has been fulfilled or an error message
+ * 			has been sent to the client.
+**********************************************************************************************/
+
+void fulfillRequest(struct FTInfo* myFT)
+{
+	/* Establish a data connection with the client, sending initial message and receiving response
+	 * to validate connection. Count failure and return control to calling function upon validation failure. */
+	if (!validateDataConnection(myFT))
 	{
-		sendListingToClient(myFT);
+		STAT_ADD(validationFailures, 1);
+		return;
 	}
+
+	/* Now that data connection has been established and validated, call the request handler
+	 * registered for the command received, limiting the rate at which it sends data to the client
+	 * for as long as it runs. */
+	STAT_ADD(activeTransfers, 1);
+	myFT->shaper = beginShapedTransfer(myFT->clientHost);
+	myFT->handler->handle(myFT);
+	endShapedTransfer(myFT->shaper);
+	myFT->shaper = NULL;
+	STAT_SUB(activeTransfers, 1);
+	STAT_ADD(completedTransfers, 1);
 }
 
 
 /***********************************************************************************************
  * Function Name:	validateDataConnection
- * Description:		Connects data socket of struct FTInfo received to client. Sends initial
+ * Description:		Connects data socket of struct FTInfo received to client (or, for a
+ * 			local client, passes it one end of a socket pair). Sends initial
  * 			validation message to client and receives validation response.
  * Receives: 		A pointer to a struct FTInfo.
  * Returns: 		True if the data socket was connected to the client and validation messages
@@ -474,15 +796,50 @@ void handleRequest(struct FTInfo* myFT)
 
 int validateDataConnection(struct FTInfo* myFT)
 {
-	/* Establish data socket, returning false upon error. */
-	int socketFDReturned = establishDataSocket(myFT->clientHost, myFT->dataPort);
+	struct ServerConfig* config = getServerConfig();
+
+	/* Establish data socket, returning false upon error (counting a timeout if client did not accept
+	 * the connection in time). */
+	int socketFDReturned;
+	if (myFT->local)
+	{
+		socketFDReturned = passDataSocket(myFT->controlSocketFD);
+	}
+	else
+	{
+		socketFDReturned = establishDataSocket(myFT->clientHost, myFT->dataPort,
+			(int)config->dataConnectTimeoutMs);
+	}
+	FT_PROBE(data_connect, myFT->sessionId, socketFDReturned, myFT->dataPort);
 	if (socketFDReturned == -1)
 	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(dataConnectTimeouts, 1);
+		}
 		return 0;
 	}
 	
-	/* Since valid socketFD was returned, store it as data socket in myFT. */
+	/* Since valid socketFD was returned, store it as data socket in myFT, set the socket options in
+	 * effect, and limit how long any send on it may stall waiting for client to read. */
+	markPhase(myFT, PHASE_DATA_CONNECT);
 	myFT->dataSocketFD = socketFDReturned;
+	if (!myFT->local)
+	{
+		tuneDataSocket(myFT->dataSocketFD, myFT->controlSocketFD);
+	}
+	setSendTimeout(myFT->dataSocketFD, (int)config->sendStallTimeoutMs);
+
+	/* If connections are encrypted, perform TLS handshake on data connection too (with the server again
+	 * as the TLS server), returning false upon failure. */
+	if (!myFT->local && startTls(myFT->dataSocketFD, (int)config->dataConnectTimeoutMs) == -1)
+	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(dataConnectTimeouts, 1);
+		}
+		return 0;
+	}
 
 	/* Send initial validation message to client on data connection, returning false if error. */
 	char* validationMessage = "FTSERVER DATA CONNECTION INITIALIZATION";
@@ -491,10 +848,15 @@ int validateDataConnection(struct FTInfo* myFT)
 		return 0;
 	}
 
-	/* Receive initial response from client, returning false if NULL message received. */
-	char* responseReceived = recvMessage(myFT->dataSocketFD);
+	/* Receive initial response from client, returning false if NULL message received (counting a
+	 * timeout if client did not respond in time). */
+	char* responseReceived = recvMessage(myFT->dataSocketFD, (int)config->dataConnectTimeoutMs);
 	if (responseReceived == NULL)
 	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(dataConnectTimeouts, 1);
+		}
 		return 0;
 	}
 
@@ -507,10 +869,8 @@ int validateDataConnection(struct FTInfo* myFT)
 	 * and return false. */
 	if (strcmpResult != 0)
 	{
-		/* Print error message informing user of client response expected and that received. */
-		fprintf(stderr, "DATA CONNECTION VALIDATION ERROR: Invalid response from client.\n");
-		fprintf(stderr, "Response expected on data connection: %s\n", responseExpected);
-		fprintf(stderr, "Response received on data connection: %s\n", responseReceived);
+		/* Log invalid response received. */
+		logEvent(LOG_INVALID_DATA_RESPONSE, myFT, responseReceived, 0);
 
 		/* Free responseReceived and return false to calling function. */
 		free(responseReceived);
@@ -523,6 +883,7 @@ int validateDataConnection(struct FTInfo* myFT)
 	{
 		free(responseReceived);
 		responseReceived = NULL;
+		markPhase(myFT, PHASE_DATA_VALIDATION);
 		return 1;
 	}
 }
@@ -531,9 +892,10 @@ int validateDataConnection(struct FTInfo* myFT)
 /***********************************************************************************************
  * Function Name:	sendFileToCLient
  * Description:		Attempts to send the requested file to the client. If unable to open
- * 			file, sends error message to client on control socket. Otherwise, reads
- * 			up to MAX_SEND_SIZE bytes of file at a time, sending them to client on data
- * 			socket. Finally, sends confirmation message to client over control socket
+ * 			file, sends error message to client on control socket. Otherwise, sends
+ * 			the file to client on data socket through a pipeline whose reader thread
+ * 			fills a ring of buffers while this thread sends them (see sendPipeline.h).
+ * 			Finally, sends confirmation message to client over control socket
  * 			of number of bytes sent over data socket.
  * Receives: 		A struct FTInfo pointer.
  * Returns: 		nothing
@@ -547,8 +909,8 @@ int validateDataConnection(struct FTInfo* myFT)
 
 void sendFileToClient(struct FTInfo* myFT)
 {
-	/* Print info about request. */
-	printf("File \"%s\" requested on port %s.\n", myFT->filename, myFT->dataPort);
+	/* Log request. */
+	logEvent(LOG_FILE_REQUESTED, myFT, myFT->filename, 0);
 	
 	/* Open file with filename requested for reading, sending error message to client
 	 * and returning upon error. */
@@ -559,59 +921,181 @@ void sendFileToClient(struct FTInfo* myFT)
 		return;
 	}
 
-	/* Since file was opened successfully, print message about sending it to client. */
-	printf("Sending \"%s\" to %s:%s\n", myFT->filename, myFT->clientNickname, myFT->dataPort);
-	
-	/* Declare buffer to hold up to MAX_SEND_SIZE bytes read from file per iteration
-	 * in loop below and accumulator to keep track of total number of bytes read. */
-	char readBuffer[MAX_SEND_SIZE + 1];
-	memset(readBuffer, '\0', sizeof(readBuffer));
-	unsigned long long int totalCharsRead = 0;
+	/* Since file was opened successfully, log that it is being sent to client. A local client is passed
+	 * the open file instead. */
+	logEvent(LOG_FILE_SENDING, myFT, myFT->filename, 0);
+	if (myFT->local)
+	{
+		passFileToClient(myFT, fileToSend);
+		return;
+	}
 
-	/* Loop until EOF is reached (read call returns 0) or error occurs (read call returns -1). */
-	int charsRead = -5;	/* Keeps track of chars read each iteration. */
-	do
+	/* Once another download of a file of at least coalesce_min_size bytes is in progress, the file is
+	 * sent through a stream shared with the other downloads, so that it is read once for all of them.
+	 * A download that is the only one of its file is sent on its own. */
+	struct SharedStream* stream = joinSharedStream(myFT, fileToSend);
+	if (stream != NULL)
 	{
-		/* Get up to MAX_SEND_SIZE chars from file, storing them in buffer. */
-		charsRead = read(fileToSend, readBuffer, MAX_SEND_SIZE);
+		sendFileShared(myFT, fileToSend, stream);
+		return;
+	}
 
-		/* If chars were read, send them to client. */
-		if (charsRead > 0)
-		{
-			/* Set the byte after the last byte read into the buffer to null terminator, and update
-			 * totalCharsRead. */
-			readBuffer[charsRead] = '\0';
-			totalCharsRead += charsRead;
-
-			/* Attempt to send bytes just read to client over data connection,
-			 * returning control to calling function upon error. */
-			if (sendMessage(myFT->dataSocketFD, readBuffer) == -1)
-			{
-				return;
-			}
-		}
-	} while (charsRead > 0);
-	
-	/* Close file now that it is no longer in use. */
-	close(fileToSend);
+	/* Files of at least direct_io_min_size bytes are read with direct I/O instead, so that sending them
+	 * does not evict the hot working set from the page cache. */
+	unsigned long long fileSize;
+	if (enableDirectRead(fileToSend, &fileSize))
+	{
+		sendFileDirect(myFT, fileToSend, fileSize);
+		return;
+	}
 
-	/* Now that loop above has exited, send success or error message to client accordingly. If charsRead is 0 
-	 * and function has not returned, all chars have been successfully read from file (since eof has been reached) 
-	 * and sent out through dataSocket. */
-	if (charsRead == 0)
+	/* Take the first TCP sample of the transfer, and send large buffers without copying them where
+	 * possible. Otherwise, cork data socket so frames are packed into full segments until file has been
+	 * sent. (A zero-copy send completes only once its data is acked, so a corked tail would hold up
+	 * reclaiming the buffers it was sent from.) */
+	startTcpSampling(&myFT->tcp, myFT->dataSocketFD, getServerConfig()->tcpSampleIntervalMs);
+	startZeroCopy(&myFT->zeroCopy, myFT->dataSocketFD);
+	if (!myFT->zeroCopy.enabled)
 	{
-		sendSuccessMessage(myFT, totalCharsRead);
+		corkSocket(myFT->dataSocketFD, 1);
 	}
 
-	/* Otherwise, reading error has occurred. Send error message to client
-	 * over control socket*/
+	/* Send file through a pipeline whose reader reads ahead of the data socket (and reuses a buffer only
+	 * once the kernel is done sending it), returning control to calling function if sending fails. */
+	unsigned long long startBytes = myFT->bytesSent;
+	struct PipelineStage stages[] = {{sendPipelineBuffer, awaitPipelineBuffer, myFT}};
+	int result = runSendPipeline(fileToSend, stages, 1);
+	int readErrno = errno;
+	close(fileToSend);
+	if (result == PIPELINE_STAGE_ERROR)
+	{
+		reportTcpTransfer(myFT);
+		return;
+	}
+
+	/* Uncork data socket to send any partial segment left, and summarize transfer as TCP saw it. */
+	corkSocket(myFT->dataSocketFD, 0);
+	reportTcpTransfer(myFT);
+
+	/* If the whole file was read and sent, send success message to client. Otherwise, reading error
+	 * has occurred. Send error message to client over control socket. */
+	if (result == PIPELINE_DONE)
+	{
+		sendSuccessMessage(myFT, myFT->bytesSent - startBytes);
+	}
 	else
 	{
+		errno = readErrno;
 		sendErrorMessage(myFT);
 	}
 }
 
 
+/***********************************************************************************************
+ * Function Name:	sendPipelineBuffer
+ * Description:		The sender stage of the pipeline of sendFileToClient: once sending is
+ * 			within rate limits, sends a buffer read from the file to the client as one
+ * 			frame on the data socket, then logs a periodic TCP sample of the transfer if
+ * 			one is due, resizing the send buffer for the rate and round-trip time sampled.
+ * Receives: 		The buffer and the struct FTInfo pointer of the transfer.
+ * Returns: 		0 if the buffer was sent; -1 otherwise.
+ * Pre-Conditions: 	The data connection has been validated.
+ * Post-Conditions: 	The buffer has been sent and counted, or sending has failed.
+**********************************************************************************************/
+
+int sendPipelineBuffer(struct PipelineBuffer* buffer, void* arg)
+{
+	struct FTInfo* myFT = (struct FTInfo*)arg;
+	shapeTransfer(myFT->shaper, buffer->len);
+	if (sendZeroCopyFrame(&myFT->zeroCopy, buffer->data, buffer->len, &buffer->ticket) == -1)
+	{
+		return -1;
+	}
+	countDataSent(myFT, buffer->len);
+	if (sampleTcpIfDue(&myFT->tcp, getServerConfig()->tcpSampleIntervalMs))
+	{
+		logTcpEvent(LOG_TCP_SAMPLE, myFT, &myFT->tcp.latest, 0);
+		resizeDataBuffer(myFT->dataSocketFD, myFT->tcp.latest.rttUs, myFT->tcp.latest.deliveryRate);
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	awaitPipelineBuffer
+ * Description:		Reclaims a buffer of the pipeline of sendFileToClient for the reader,
+ * 			waiting (up to send_stall_timeout_ms) until every zero-copy send of it is
+ * 			complete. If that fails, or a send has already failed, the transfer is over,
+ * 			so the sends still queued are dropped instead (see abortZeroCopy).
+ * Receives: 		The buffer and the struct FTInfo pointer of the transfer.
+ * Returns: 		0 once the kernel no longer reads from the buffer; -1 if the data connection
+ * 			failed while waiting. Once a send has failed (or this function has returned
+ * 			-1), returns 0 once the sends queued have been dropped, or -1 if they could
+ * 			not be within send_stall_timeout_ms.
+ * Pre-Conditions: 	startZeroCopy has been called for the data socket.
+ * Post-Conditions: 	If 0 is returned, the kernel no longer reads from the buffer.
+**********************************************************************************************/
+
+int awaitPipelineBuffer(struct PipelineBuffer* buffer, void* arg)
+{
+	struct FTInfo* myFT = (struct FTInfo*)arg;
+	int timeoutMs = (int)getServerConfig()->sendStallTimeoutMs;
+	if (__atomic_load_n(&myFT->zeroCopy.failed, __ATOMIC_RELAXED))
+	{
+		return abortZeroCopy(&myFT->zeroCopy, buffer->ticket, timeoutMs);
+	}
+	if (awaitZeroCopy(&myFT->zeroCopy, buffer->ticket, timeoutMs) == -1)
+	{
+		STAT_ADD(zeroCopyFailures, 1);
+		logEvent(LOG_TRANSFER_FAILED, myFT, strerror(errno), 0);
+		abortZeroCopy(&myFT->zeroCopy, buffer->ticket, timeoutMs);
+		return -1;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	passFileToClient
+ * Description:		Passes a local client the open descriptor of the file it requested over
+ * 			the data socket instead of sending the file's contents, then sends the
+ * 			success message with the file's size, which is the number of bytes the
+ * 			client copies from the descriptor. Rate limits do not apply, since no data
+ * 			is sent.
+ * Receives: 		A struct FTInfo pointer for a local client and the open file.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT->local is set, and the data connection has been validated.
+ * Post-Conditions: 	The file has been closed, and either the descriptor and success message
+ * 			or an error message have been sent to the client.
+**********************************************************************************************/
+
+void passFileToClient(struct FTInfo* myFT, int fileToSend)
+{
+	/* Get file's size, sending error message upon failure. */
+	struct stat fileInfo;
+	if (fstat(fileToSend, &fileInfo) == -1)
+	{
+		int statErrno = errno;
+		close(fileToSend);
+		errno = statErrno;
+		sendErrorMessage(myFT);
+		return;
+	}
+
+	/* Pass descriptor, returning upon error. */
+	int result = sendDescriptor(myFT->dataSocketFD, FILE_DESCRIPTOR_MESSAGE, fileToSend);
+	close(fileToSend);
+	if (result == -1)
+	{
+		return;
+	}
+	STAT_ADD(filesPassed, 1);
+	STAT_ADD(bytesPassed, fileInfo.st_size);
+	markPhase(myFT, PHASE_FIRST_BYTE);
+	sendSuccessMessage(myFT, fileInfo.st_size);
+}
+
+
 /***********************************************************************************************
  * Function Name:	sendListingToClient
  * Description:		Sends either listing of all files in current directory to client
@@ -633,23 +1117,13 @@ void sendListingToClient(struct FTInfo* myFT)
 	/* Declare flag that keeps track of whether or not to include all files or just .txt files.
 	 * Initialize it to being set, clearing it if command is -ltxt. */
 	int includeAllFiles = 1;
-
-	/* Declare request messages for printing what client has requested, initializing them as if client
-	 * has requested all files and updating them if client has requested only .txt files. */
-	char* requestMessage1 = "List directory requested on port ";
-	char* requestMessage2 = "Sending directory contents to ";
-	
-	/* If the command is LIST_TXT_FILES, clear includeAllFiles flag and update
-	 * request messages. */
 	if (strcmp(myFT->command, LIST_TXT_FILES) == 0)
 	{
 		includeAllFiles = 0;
-		requestMessage1 = "List directory .txt files requested on port ";
-		requestMessage2 = "Sending directory .txt filenames to ";
 	}
 
-	/* Print requestMessage1 to console indicating what was requested. */
-	printf("%s%s.\n", requestMessage1, myFT->dataPort);
+	/* Log what was requested. */
+	logEvent(LOG_LISTING_REQUESTED, myFT, myFT->command, 0);
 
 	/* Attempt to open current directory, sending error message to client upon failure before returning
 	 * control to calling function. */
@@ -660,8 +1134,10 @@ void sendListingToClient(struct FTInfo* myFT)
 		return;
 	}
 
-	/* Print requestMessage2 to indicate that directory is open and listing about to be sent to client. */
-	printf("%s%s:%s\n", requestMessage2, myFT->clientNickname, myFT->dataPort);
+	/* Log that directory is open and listing about to be sent to client, and cork data socket so frames
+	 * are packed into full segments until listing has been sent. */
+	logEvent(LOG_LISTING_SENDING, myFT, myFT->command, 0);
+	corkSocket(myFT->dataSocketFD, 1);
 
 	/* Since readdir call returns NULL both on error (in which case errno is set) and on reaching end of directory
 	 * (in which case errno remains unchanged), reset errno to 0 in case it was set to a non-zero value previously. */
@@ -703,12 +1179,14 @@ void sendListingToClient(struct FTInfo* myFT)
 			 * posInSendBuffer and charsInSendBuffer before adding this new filename. */
 			if (charsInSendBuffer + entryLen > MAX_SEND_SIZE)
 			{
-				/* Send current contents of sendBuffer to client over data socket,
-				 * returning control to calling function upon failure. */
+				/* Send current contents of sendBuffer to client over data socket once within
+				 * rate limits, returning control to calling function upon failure. */
+				shapeTransfer(myFT->shaper, charsInSendBuffer);
 				if (sendMessage(myFT->dataSocketFD, sendBuffer) == -1)
 				{
 					return;
 				}
+				countDataSent(myFT, charsInSendBuffer);
 
 				/* Update totalCharsSent, empty out the sendBuffer, 
 				 * and reset charsInSendBuffer and posInSendBuffer. */
@@ -733,9 +1211,12 @@ void sendListingToClient(struct FTInfo* myFT)
 	/* Close directory now that loop above has finished processing it. */
 	closedir(currentDir);
 
-	/* If errno is a non-zero value, send error message to client. */
+	/* If errno is a non-zero value, uncork data socket to send what was listed, and send error message to client. */
 	if (errno != 0)
 	{
+		int readdirErrno = errno;
+		corkSocket(myFT->dataSocketFD, 0);
+		errno = readdirErrno;
 		sendErrorMessage(myFT);
 	}
 
@@ -765,15 +1246,21 @@ void sendListingToClient(struct FTInfo* myFT)
 		/* If there are any bytes remaining in sendBuffer, send them. */
 		if (charsInSendBuffer > 0)
 		{
-			/* Attempt to send chars, returning control to calling function upon send error. */
+			/* Attempt to send chars once within rate limits, returning control to calling function
+			 * upon send error. */
+			shapeTransfer(myFT->shaper, charsInSendBuffer);
 			if (sendMessage(myFT->dataSocketFD, sendBuffer) == -1)
 			{
 				return;
 			}
+			countDataSent(myFT, charsInSendBuffer);
 
 			/* Update totalCharsSent with the number of bytes just sent. */
 			totalCharsSent += charsInSendBuffer;
 		}
+
+		/* Uncork data socket to send any partial segment left. */
+		corkSocket(myFT->dataSocketFD, 0);
 		
 		/* Send success message with total number of chars sent to client. */
 		sendSuccessMessage(myFT, totalCharsSent);
@@ -869,9 +1356,10 @@ int sendSuccessMessage(struct FTInfo* myFT, unsigned long long int bytesSent)
 	}
 
 	/* Otherwise, no error detected sending message. Wait for client to close
-	 * data connection to be sure client has received all data sent through control and data connection
-	 * before returning 0 to indicate success. */
+	 * data connection to be sure client has received all data sent through control and data connection,
+	 * and log transfer before returning 0 to indicate success. */
 	waitToCloseDataSocket(myFT);
+	logEvent(LOG_TRANSFER_COMPLETE, myFT, myFT->command, bytesSent);
 	return 0;
 }
 
@@ -897,17 +1385,17 @@ int sendSuccessMessage(struct FTInfo* myFT, unsigned long long int bytesSent)
 
 int sendErrorMessage(struct FTInfo* myFT)
 {
-	/* Get error that errno represents as string. */
+	/* Count error, and get error that errno represents as string. */
+	STAT_ERRNO(errno);
 	char* errMessage = strerror(errno);
 
 	/* If sending error message to client succeeds,
-	 * print error message to screen and then wait to close data
+	 * log error message and then wait to close data
 	 * connection until client closes control connection before returning
 	 * 0 to indicate success sending error message. */
 	if (sendMessage(myFT->controlSocketFD, errMessage) == 0)
 	{
-		fprintf(stderr, "%s. Sending error message to %s:%s\n",
-			errMessage, myFT->clientNickname, serverPort);
+		logEvent(LOG_ERROR_SENT, myFT, errMessage, 0);
 		waitToCloseDataSocket(myFT);
 		return 0;
 	}
@@ -950,22 +1438,93 @@ char* copyToken(char* token)
  * Function Name:	waitToCloseDataSocket
  * Description:		Waits for the client to finish reading from the control socket and
  * 			data socket (indicated by the client closing the control socket)
- * 			before returning.
+ * 			before returning. Gives up after final_ack_timeout_ms so that a client
+ * 			which never closes its end cannot hold the calling thread.
  * Receives: 		A struct FTInfo pointer.
  * Returns: 		nothing
  * Pre-Conditions: 	The controlSocket and dataSocket have been successfully connected
  * 			to the client. No more data will be sent to the client,
  * 			and no more messages are expected to be received from the client.
- * Post-Conditions: 	When function returns, it is safe to assume the client has closed the
- * 			control connection and that the data connection can now be closed.
+ * Post-Conditions: 	When function returns, either the client has closed the control
+ * 			connection or the timeout has expired, and the data connection can
+ * 			now be closed.
  * ** CITATIONS **	Function adapted from my implementation of a function with a
  * 			similar purpose in the Block 4 Project in CS 344-400 Fall 2019.
 **********************************************************************************************/
 
 void waitToCloseDataSocket(struct FTInfo* myFT)
 {
+	/* End streaming phase if any data was sent, or otherwise start timing final phase now. */
+	if (myFT->phasesMarked & (1u << PHASE_FIRST_BYTE))
+	{
+		markPhase(myFT, PHASE_STREAMING);
+	}
+	else
+	{
+		myFT->phaseMark = monotonicNs();
+	}
+
+	/* Wait until control socket is readable (client shut it down) or deadline passes, counting a timeout
+	 * if client did not close it in time. */
+	struct timespec deadline;
+	int timeoutMs = (int)getServerConfig()->finalAckTimeoutMs;
+	setDeadline(&deadline, timeoutMs);
+	if (waitForSocket(myFT->controlSocketFD, POLLIN, timeoutMs > 0 ? &deadline : NULL) != 1)
+	{
+		if (errno == ETIMEDOUT)
+		{
+			STAT_ADD(finalAckTimeouts, 1);
+		}
+		markPhase(myFT, PHASE_FINAL_ACK);
+		return;
+	}
+
 	/* Attempt to read 1 character from client on control socket (no more data is expected on control socket),
-	 * which will cause process to block until client shuts down control socket. */
+	 * which will cause thread to block until client shuts down control socket. */
 	char waitBuff[1];
-	recv(myFT->controlSocketFD, waitBuff, sizeof(waitBuff), 0);
+	tlsRecv(myFT->controlSocketFD, waitBuff, sizeof(waitBuff), 0);
+	markPhase(myFT, PHASE_FINAL_ACK);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	countDataSent
+ * Description:		Counts data just sent to the client over the data connection in the
+ * 			server's and session's totals and fires the chunk probe. The first time it is called for a
+ * 			session, also ends the time-to-first-byte phase.
+ * Receives: 		A struct FTInfo pointer and the number of bytes sent.
+ * Returns: 		nothing
+ * Pre-Conditions: 	bytes of data have just been sent to the client over the data connection.
+ * Post-Conditions: 	The bytes have been counted, and the first byte phase has been marked.
+**********************************************************************************************/
+
+void countDataSent(struct FTInfo* myFT, unsigned long long bytes)
+{
+	STAT_ADD(bytesSent, bytes);
+	myFT->bytesSent += bytes;
+	FT_PROBE(chunk, myFT->sessionId, bytes, FT_PROBE_NAME(myFT));
+	if (!(myFT->phasesMarked & (1u << PHASE_FIRST_BYTE)))
+	{
+		markPhase(myFT, PHASE_FIRST_BYTE);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	reportTcpTransfer
+ * Description:		Takes the last TCP sample of a file transfer, and logs the transfer's
+ * 			summary and bottleneck (which finishTcpSampling also counts in the
+ * 			server's statistics).
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	startTcpSampling has been called for myFT's transfer, and the transfer
+ * 			has sent all it will send.
+ * Post-Conditions: 	The transfer's summary has been logged and counted.
+**********************************************************************************************/
+
+void reportTcpTransfer(struct FTInfo* myFT)
+{
+	struct TcpSample summary;
+	int bottleneck = finishTcpSampling(&myFT->tcp, myFT->bytesSent, &summary);
+	logTcpEvent(LOG_TCP_SUMMARY, myFT, &summary, bottleneck);
 }
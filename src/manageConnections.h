@@ -29,7 +29,7 @@
  * 			establishing a listening socket at that port, and then entering an endless loop 
  * 			awaiting new connections.
  * Course Name: 	CS 372-400: Introduction to Computer Networks
- * Last Modified:	03/09/2020
+ * Last Modified:	10/18/2026
 *****************************************************************************************************/
 
 #ifndef MANAGE_CONNECTIONS
@@ -40,18 +40,42 @@
 #include <fcntl.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <time.h>
+#include "accessLog.h"
+#include "bandwidthShaper.h"
 #include "clientServerMessaging.h"
+#include "commandRegistry.h"
+#include "directRead.h"
+#include "fileUpload.h"
 #include "FTInfo.h"
+#include "localTransport.h"
+#include "requestScheduler.h"
+#include "sendPipeline.h"
+#include "serverConfig.h"
+#include "serverShards.h"
+#include "serverStats.h"
+#include "sessionTrace.h"
+#include "sharedStream.h"
 
 /* Global constants representing possible commands. */
 #define GET_FILE "-g"
 #define LIST_FILES "-l"
 #define LIST_TXT_FILES "-ltxt"
+#define PUT_FILE "-p"
 
 /* Global constants representing .txt extension and extension length. */
 #define TXT_EXTENSION ".txt"
 #define TXT_EXTENSION_LEN 4
 
+/* Global constant representing beginning of message sent to clients turned away because the
+ * maximum number of sessions are active. The number of milliseconds after which to retry follows it. */
+#define BUSY_MESSAGE_PREFIX "SERVER BUSY, retry after "
+
+/* Global constants representing maximum number of rejected connections kept open until the client
+ * closes its end, and maximum number of seconds each is kept open. */
+#define MAX_REJECTED_CONNECTIONS 256
+#define REJECTED_LINGER_SECONDS 2
+
 /* Global constant representing maximum number of bytes that can be read from file / sent to 
  * client at one time. */
 #define MAX_SEND_SIZE 10000
@@ -62,25 +86,49 @@
  * on the GNU website: https://www.gnu.org/software/libc/manual/html_node/Range-of-Type.html. */
 #define MAX_ULLINT_DIGITS 20
 
+/* Definition of struct representing a connection turned away because the server was busy, kept open
+ * until the client closes its end so that closing it does not reset the connection. */
+struct RejectedConnection
+{
+	int socketFD;			/* Control socket of rejected connection. */
+	struct timespec rejectedAt;	/* Time at which connection was rejected. */
+};
+
 /* Global variable declarations. */
-extern int listeningSocketFD;			/* Listening socket file descriptor closed by SIGINT handler. */
+extern int listeningSocketFD;			/* Listening socket file descriptor closed upon SIGINT. */
+extern int localListeningSocketFD;		/* Unix-domain listening socket, or -1 if none. */
 extern char* serverPort;			/* SERVER_PORT received on command line; used when printing errors. */
+extern volatile sig_atomic_t reloadRequested;	/* Set by SIGHUP handler to request configuration reload. */
+extern volatile sig_atomic_t statsRequested;	/* Set by SIGUSR1 handler to request statistics be printed. */
+extern volatile sig_atomic_t shutdownRequested;	/* Set by SIGINT handler to request the server shut down. */
 
 /* Function prototypes. */
 int validatePortnum(char* portnum);
 void startup(char* portnum);
 void setSIGINThandler();
 void catchSIGINT(int signo);
+void setFlagSignalHandlers();
+void catchFlagSignal(int signo);
+void applyServerConfig();
 void acceptConnection();
+struct FTInfo* acceptNextConnection();
+void rejectConnection(struct FTInfo* myFT);
+void reapRejectedConnections();
 int validateControlConnection(struct FTInfo* myFT);
-void handleRequest(struct FTInfo* myFT);
+int handleRequest(struct FTInfo* myFT);
+void fulfillRequest(struct FTInfo* myFT);
 int validateDataConnection(struct FTInfo* myFT);
 void sendFileToClient(struct FTInfo* myFT);
+void passFileToClient(struct FTInfo* myFT, int fileToSend);
+int sendPipelineBuffer(struct PipelineBuffer* buffer, void* arg);
+int awaitPipelineBuffer(struct PipelineBuffer* buffer, void* arg);
 void sendListingToClient(struct FTInfo* myFT);
 int isTxtFile(char* filename);
 int sendSuccessMessage(struct FTInfo* myFT, unsigned long long int bytesSent);
 int sendErrorMessage(struct FTInfo* myFT);
 char* copyToken(char* token);
 void waitToCloseDataSocket(struct FTInfo* myFT);
+void countDataSent(struct FTInfo* myFT, unsigned long long bytes);
+void reportTcpTransfer(struct FTInfo* myFT);
 
 #endif
@@ -0,0 +1,71 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		probes.h
+ * File Description: 	Header file defining the server's static tracepoints (USDT probes). When
+ * 			sys/sdt.h (from systemtap's SDT development package) is available, each
+ * 			FT_PROBE compiles to a single nop plus a note in the executable that
+ * 			tools such as bpftrace and perf use to attach to it while the server runs,
+ * 			so probes cost nothing unless traced. Otherwise (or when compiled with
+ * 			-DFT_NO_PROBES) they compile to nothing. See bpftrace/ for scripts.
+ *
+ * 			Every probe is in provider "ftserver" and has three arguments: arg0 is the
+ * 			session ID (sessions are numbered from 1 in order of acceptance), arg1 a
+ * 			number, and arg2 a string (never NULL):
+ *
+ * 			probe        fired when                        arg1              arg2
+ * 			accept       connection accepted               control socket    client address
+ * 			handshake    DATA_PORT received and answered   0                 data port
+ * 			request      valid request received            file size or -1   filename or command
+ * 			data_connect data connection attempt ended     data socket or -1 data port
+ * 			chunk        data sent over data connection    bytes             filename or command
+ * 			session_end  session deleted                   total bytes sent  filename or command
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef PROBES
+#define PROBES
+
+#if !defined(FT_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define FT_PROBES_ENABLED 1
+#endif
+#endif
+
+#ifdef FT_PROBES_ENABLED
+#define FT_PROBE(name, sessionId, number, string) \
+	DTRACE_PROBE3(ftserver, name, (unsigned long long)(sessionId), (long long)(number), (const char*)(string))
+#else
+#define FT_PROBE(name, sessionId, number, string) do { } while (0)
+#endif
+
+/* Returns the name a session's probes report: its filename, or its command if it has none. */
+#define FT_PROBE_NAME(myFT) (((myFT)->filename != NULL) ? (myFT)->filename \
+	: ((myFT)->command != NULL) ? (myFT)->command : "")
+
+#endif
@@ -0,0 +1,179 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		readPolicy.c
+ * File Description: 	Implementation of the I/O policy applied to files sent through the page
+ * 			cache. See readPolicy.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+/* Needed for readahead. */
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "latencyHistogram.h"
+#include "readPolicy.h"
+#include "serverConfig.h"
+
+
+/***********************************************************************************************
+ * Function Name:	beginReadPolicy
+ * Description:		Applies read_policy to a file about to be sent: advises the kernel that
+ * 			it will be read sequentially (unless the policy is READ_POLICY_KERNEL),
+ * 			decides whether its pages will be dropped once sent, and for the adaptive
+ * 			policy starts reading the first readahead_min bytes.
+ * Receives: 		The policy state to initialize and the open file.
+ * Returns: 		nothing
+ * Pre-Conditions: 	fileFD is open for reading at offset 0.
+ * Post-Conditions: 	readPolicy describes the file, and advanceReadPolicy may be called as
+ * 			it is read.
+**********************************************************************************************/
+
+void beginReadPolicy(struct ReadPolicy* readPolicy, int fileFD)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Initialize state, reading settings once so that a reload cannot change policy part way through. */
+	memset(readPolicy, 0, sizeof(*readPolicy));
+	readPolicy->fileFD = fileFD;
+	readPolicy->policy = (int)config->readPolicy;
+	readPolicy->window = config->readaheadMin;
+	readPolicy->startNs = monotonicNs();
+	if (readPolicy->policy == READ_POLICY_KERNEL)
+	{
+		return;
+	}
+
+	/* Advise sequential access, and drop pages behind the cursor if file is large enough. */
+	posix_fadvise(fileFD, 0, 0, POSIX_FADV_SEQUENTIAL);
+	struct stat fileInfo;
+	unsigned long long dropMinSize = config->dropBehindMinSize;
+	readPolicy->dropBehind = dropMinSize > 0 && fstat(fileFD, &fileInfo) == 0
+		&& (unsigned long long)fileInfo.st_size >= dropMinSize;
+
+	/* Start reading the first window. */
+	if (readPolicy->policy == READ_POLICY_ADAPTIVE && readPolicy->window > 0)
+	{
+		readahead(fileFD, 0, readPolicy->window);
+		readPolicy->readaheadEnd = readPolicy->window;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	advanceReadPolicy
+ * Description:		Records a read of the file and applies the policy at the new cursor.
+ * 			Under the adaptive policy, once less than half a window remains read ahead
+ * 			of the cursor, resizes the window and issues readahead up to a full window
+ * 			ahead. If pages are dropped behind, drops them once a window's worth has
+ * 			been sent.
+ * Receives: 		The policy state, the number of bytes just read, and how long the read took.
+ * Returns: 		nothing
+ * Pre-Conditions: 	beginReadPolicy has been called, and the bytes read before this call have
+ * 			been copied out of the file (so that pages behind the cursor are no longer needed).
+ * Post-Conditions: 	Readahead has been issued and pages dropped as the policy directs.
+**********************************************************************************************/
+
+void advanceReadPolicy(struct ReadPolicy* readPolicy, unsigned long long bytesRead, unsigned long long readNs)
+{
+	readPolicy->cursor += bytesRead;
+	readPolicy->readNs += readNs;
+	if (readPolicy->policy == READ_POLICY_KERNEL)
+	{
+		return;
+	}
+
+	/* Keep at least half a window read ahead of the cursor. */
+	if (readPolicy->policy == READ_POLICY_ADAPTIVE
+		&& readPolicy->cursor + readPolicy->window / 2 >= readPolicy->readaheadEnd)
+	{
+		readPolicy->window = readaheadWindow(readPolicy);
+		unsigned long long start = readPolicy->readaheadEnd > readPolicy->cursor ? readPolicy->readaheadEnd : readPolicy->cursor;
+		unsigned long long end = readPolicy->cursor + readPolicy->window;
+		if (end > start)
+		{
+			readahead(readPolicy->fileFD, (off_t)start, end - start);
+			readPolicy->readaheadEnd = end;
+		}
+	}
+
+	/* Drop pages already sent once there are at least a window's worth of them. */
+	if (readPolicy->dropBehind && readPolicy->cursor - readPolicy->droppedEnd >= readPolicy->window)
+	{
+		posix_fadvise(readPolicy->fileFD, (off_t)readPolicy->droppedEnd,
+			(off_t)(readPolicy->cursor - readPolicy->droppedEnd), POSIX_FADV_DONTNEED);
+		readPolicy->droppedEnd = readPolicy->cursor;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	readaheadWindow
+ * Description:		Sizes the adaptive readahead window: enough of the file to keep sending
+ * 			for READAHEAD_LEAD_MS at the rate the transfer has sent so far, scaled up by
+ * 			the ratio of that rate to the rate at which reads have returned data when
+ * 			the disk has been the slower of the two. Each rate is measured over the time
+ * 			the transfer spent in it, so a stall on one does not hide the other. The result is kept between
+ * 			readahead_min and readahead_max.
+ * Receives: 		The policy state.
+ * Returns: 		The window, in bytes.
+ * Pre-Conditions: 	beginReadPolicy has been called.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+unsigned long long readaheadWindow(struct ReadPolicy* readPolicy)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Measure rates (in bytes per second) of reading (over the time spent in reads) and of sending
+	 * (over the rest of the transfer's time). */
+	unsigned long long elapsedNs = monotonicNs() - readPolicy->startNs;
+	unsigned long long sendNs = elapsedNs > readPolicy->readNs ? elapsedNs - readPolicy->readNs : 0;
+	double sendRate = sendNs > 0 ? readPolicy->cursor * 1e9 / sendNs : 0;
+	double readRate = readPolicy->readNs > 0 ? readPolicy->cursor * 1e9 / readPolicy->readNs : sendRate;
+
+	/* Size window, scaling it up if disk is slower than network. */
+	double window = sendRate * READAHEAD_LEAD_MS / 1000;
+	if (readRate > 0 && readRate < sendRate)
+	{
+		window *= sendRate / readRate;
+	}
+
+	/* Keep window within configured bounds. */
+	unsigned long long minWindow = config->readaheadMin;
+	unsigned long long maxWindow = config->readaheadMax > minWindow ? config->readaheadMax : minWindow;
+	if (window < minWindow)
+	{
+		return minWindow;
+	}
+	if (window > maxWindow)
+	{
+		return maxWindow;
+	}
+	return (unsigned long long)window;
+}
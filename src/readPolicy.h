@@ -0,0 +1,75 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		readPolicy.h
+ * File Description: 	Header file for the I/O policy applied to files sent through the page
+ * 			cache, chosen by the read_policy setting. READ_POLICY_KERNEL leaves
+ * 			readahead to the kernel. READ_POLICY_SEQUENTIAL tells the kernel the file
+ * 			will be read sequentially (doubling its readahead window). READ_POLICY_ADAPTIVE
+ * 			also issues readahead explicitly ahead of the send cursor, in a window sized
+ * 			from the rates at which the transfer reads from disk and sends to the client,
+ * 			so that a slow disk keeps reading while the network drains what was read.
+ * 			Under either of the last two policies, the pages of files of at least
+ * 			drop_behind_min_size bytes are dropped from the page cache once sent, so a
+ * 			large file cannot evict the rest of the working set.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef READ_POLICY
+#define READ_POLICY
+
+/* Values of read_policy. */
+#define READ_POLICY_KERNEL 0
+#define READ_POLICY_SEQUENTIAL 1
+#define READ_POLICY_ADAPTIVE 2
+
+/* Global constant representing the time (in milliseconds) of sending the adaptive readahead
+ * window covers when the disk keeps up with the network. The window is scaled up by how much
+ * slower the disk has been than the network. */
+#define READAHEAD_LEAD_MS 100
+
+/* Definition of struct holding the state of the policy for one file being sent. See below for
+ * variable descriptions. */
+struct ReadPolicy
+{
+	int fileFD;				/* File being sent. */
+	int policy;				/* read_policy when the transfer began. */
+	int dropBehind;				/* True if sent pages are dropped from the page cache. */
+	unsigned long long cursor;		/* Offset up to which the file has been read. */
+	unsigned long long readaheadEnd;	/* Offset up to which readahead has been issued. */
+	unsigned long long droppedEnd;		/* Offset up to which pages have been dropped. */
+	unsigned long long window;		/* Current readahead window (bytes). */
+	unsigned long long startNs;		/* Monotonic time at which the transfer began. */
+	unsigned long long readNs;		/* Time spent in reads of the file. */
+};
+
+/* Function prototypes. */
+void beginReadPolicy(struct ReadPolicy* readPolicy, int fileFD);
+void advanceReadPolicy(struct ReadPolicy* readPolicy, unsigned long long bytesRead, unsigned long long readNs);
+unsigned long long readaheadWindow(struct ReadPolicy* readPolicy);
+
+#endif
@@ -0,0 +1,671 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		requestScheduler.c
+ * File Description: 	Implementation of the request scheduler's queues and worker threads.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <limits.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include "requestScheduler.h"
+#include "manageConnections.h"
+#include "serverStats.h"
+#include "sessionTrace.h"
+#include "tlsTransport.h"
+
+/* Queues of connections awaiting a thread. pollQueue holds connections just added to those the intake
+ * poller waits on; intakeQueue holds connections whose client has sent its next message (DATA_PORT or
+ * the request); fastLane, bulkLane and sharedLane hold parsed requests awaiting a data connection. */
+static struct RequestQueue pollQueue = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0 };
+static struct RequestQueue intakeQueue = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0 };
+static struct RequestQueue fastLane = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0 };
+static struct RequestQueue bulkLane = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0 };
+static struct RequestQueue sharedLane = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 1 };
+
+/* Static variables. */
+static int pollWakeFD = -1;		/* eventfd written to wake the intake poller when pollQueue is added to. */
+
+/* Function prototypes of static functions. */
+static void awaitClientMessage(struct FTInfo* myFT);
+static void expireClientMessage(struct FTInfo* myFT);
+static void* intakePoller(void* arg);
+
+
+/***********************************************************************************************
+ * Function Name:	startThreads
+ * Description:		Starts the number of detached threads requested, each running the
+ * 			function passed in with the argument passed in. Exits the process if a
+ * 			thread cannot be started.
+ * Receives: 		The number of threads, the function each should run, its argument, and
+ * 			a description of the threads used in error messages.
+ * Returns: 		nothing
+ * Pre-Conditions: 	count is positive.
+ * Post-Conditions: 	count threads are running function.
+**********************************************************************************************/
+
+static void startThreads(int count, void* (*function)(void*), void* arg, char* description)
+{
+	/* Declare attributes so that threads are detached (never joined). */
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+	pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+	/* Start each thread, reporting error and exiting upon failure. */
+	for (int i = 0; i < count; i++)
+	{
+		pthread_t thread;
+		int createStatus = pthread_create(&thread, &attributes, function, arg);
+		if (createStatus != 0)
+		{
+			fprintf(stderr, "THREAD ERROR: could not start %s thread: %s\n", description, strerror(createStatus));
+			exit(2);
+		}
+	}
+
+	pthread_attr_destroy(&attributes);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startScheduler
+ * Description:		Starts the intake poller, the intake, fast lane, and bulk lane worker
+ * 			threads, with the number of each taken from the configuration, and the first
+ * 			shared lane thread (the shared lane starts more as it needs them). All
+ * 			signals are blocked in the workers so that SIGINT and SIGHUP are always
+ * 			handled by the main thread. Exits the process if the poller cannot be set up.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	The settings have been loaded at startup.
+ * Post-Conditions: 	Worker threads are waiting for connections to be submitted.
+**********************************************************************************************/
+
+void startScheduler()
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Block all signals while starting threads so that threads inherit the blocked mask,
+	 * saving the calling thread's mask to restore afterward. */
+	sigset_t allSignals;
+	sigset_t previousMask;
+	sigfillset(&allSignals);
+	pthread_sigmask(SIG_SETMASK, &allSignals, &previousMask);
+
+	/* Create the eventfd that wakes the intake poller, reporting error and exiting upon failure. */
+	pollWakeFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (pollWakeFD == -1)
+	{
+		perror("INTAKE POLLER ERROR");
+		exit(2);
+	}
+
+	/* Start the intake poller and worker threads for each queue, with at least one thread per queue. */
+	startThreads(1, intakePoller, NULL, "intake poller");
+	startThreads(config->intakeThreads > 0 ? config->intakeThreads : 1, intakeWorker, NULL, "intake");
+	startThreads(config->fastLaneThreads > 0 ? config->fastLaneThreads : 1, laneWorker, &fastLane, "fast lane");
+	startThreads(config->bulkLaneSlots > 0 ? config->bulkLaneSlots : 1, laneWorker, &bulkLane, "bulk lane");
+	startThreads(1, laneWorker, &sharedLane, "shared lane");
+
+	/* Restore the calling thread's signal mask. */
+	pthread_sigmask(SIG_SETMASK, &previousMask, NULL);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	submitConnection
+ * Description:		Hands a newly-accepted connection to the intake poller, which passes it
+ * 			to an intake thread once the client has sent its first message.
+ * Receives: 		A struct FTInfo pointer for the accepted connection.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT was returned by acceptClientConnection.
+ * Post-Conditions: 	The scheduler owns myFT and will delete it once the client is served.
+**********************************************************************************************/
+
+void submitConnection(struct FTInfo* myFT)
+{
+	STAT_ADD(sessionsAccepted, 1);
+	awaitClientMessage(myFT);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	awaitClientMessage
+ * Description:		Adds a connection to those the intake poller waits on, and wakes the
+ * 			poller so that it starts waiting on it.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT is not in any queue, and the next message expected from its client
+ * 			is DATA_PORT (if myFT->dataPort is NULL) or the request.
+ * Post-Conditions: 	myFT will be placed on intakeQueue once the message starts to arrive, or
+ * 			finished if it does not arrive in time.
+**********************************************************************************************/
+
+static void awaitClientMessage(struct FTInfo* myFT)
+{
+	enqueueRequest(&pollQueue, myFT);
+	uint64_t wake = 1;
+	if (write(pollWakeFD, &wake, sizeof(wake)) == -1 && errno != EAGAIN)
+	{
+		perror("INTAKE POLLER ERROR");
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	expireClientMessage
+ * Description:		Ends the session of a connection whose client did not start sending
+ * 			the message awaited before handshake_timeout_ms (for DATA_PORT) or
+ * 			command_timeout_ms (for the request) passed, counting the timeout as the
+ * 			intake thread would have.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT was removed from the intake poller's connections.
+ * Post-Conditions: 	myFT has been finished.
+**********************************************************************************************/
+
+static void expireClientMessage(struct FTInfo* myFT)
+{
+	STAT_ERRNO(ETIMEDOUT);
+	logEvent(LOG_CLIENT_TIMEOUT, myFT, (myFT->dataPort == NULL) ? "handshake" : "command", 0);
+	if (myFT->dataPort == NULL)
+	{
+		STAT_ADD(handshakeTimeouts, 1);
+		STAT_ADD(handshakeFailures, 1);
+		markPhase(myFT, PHASE_INTAKE_QUEUE);
+	}
+	else
+	{
+		STAT_ADD(commandTimeouts, 1);
+		markPhase(myFT, PHASE_COMMAND);
+	}
+	finishSession(myFT);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	intakePoller
+ * Description:		Thread function that endlessly waits, with a single poll, on the control
+ * 			sockets of every connection whose client has yet to send the message
+ * 			the server awaits (DATA_PORT, or the request once DATA_PORT has been
+ * 			answered), and places each connection on intakeQueue as soon as its
+ * 			message starts to arrive. Intake threads are thus never left waiting on a
+ * 			client that has connected but not sent anything, however many such
+ * 			clients there are. Connections whose message does not start in time
+ * 			are finished by expireClientMessage.
+ * Receives: 		An unused argument.
+ * Returns: 		Never returns.
+ * Pre-Conditions: 	Thread was started by startScheduler.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+static void* intakePoller(void* arg)
+{
+	/* Connections waited on, the time (monotonicNs) by which each message must start, and the poll set:
+	 * pollSet[0] watches pollWakeFD, and pollSet[i + 1] watches the control socket of waiting[i]. */
+	struct FTInfo** waiting = NULL;
+	unsigned long long* deadlines = NULL;
+	struct pollfd* pollSet = (struct pollfd*)malloc(sizeof(struct pollfd));
+	int numWaiting = 0;
+	int capacity = 0;
+	if (pollSet == NULL)
+	{
+		perror("INTAKE POLLER ERROR");
+		exit(2);
+	}
+	pollSet[0].fd = pollWakeFD;
+	pollSet[0].events = POLLIN;
+
+	while (1)
+	{
+		/* Take every connection added since the last pass. */
+		pthread_mutex_lock(&pollQueue.lock);
+		struct FTInfo* added = pollQueue.head;
+		pollQueue.head = NULL;
+		pollQueue.tail = NULL;
+		pollQueue.depth = 0;
+		pthread_mutex_unlock(&pollQueue.lock);
+
+		/* Wait on each until the deadline for the message it awaits (timeout 0 meaning none), which is stored
+		 * on the connection so that the intake thread receiving the message waits only for the time left. A
+		 * connection whose message TLS has already decrypted (which poll cannot see), or that cannot be waited
+		 * on for lack of memory, goes straight to an intake thread, which waits on it itself. */
+		struct ServerConfig* config = getServerConfig();
+		unsigned long long now = monotonicNs();
+		while (added != NULL)
+		{
+			struct FTInfo* myFT = added;
+			added = myFT->next;
+			myFT->next = NULL;
+			if (numWaiting == capacity)
+			{
+				int newCapacity = (capacity > 0) ? capacity * 2 : 64;
+				struct FTInfo** newWaiting = (struct FTInfo**)realloc(waiting, newCapacity * sizeof(struct FTInfo*));
+				waiting = (newWaiting != NULL) ? newWaiting : waiting;
+				unsigned long long* newDeadlines = (unsigned long long*)realloc(deadlines,
+					newCapacity * sizeof(unsigned long long));
+				deadlines = (newDeadlines != NULL) ? newDeadlines : deadlines;
+				struct pollfd* newPollSet = (struct pollfd*)realloc(pollSet, (newCapacity + 1) * sizeof(struct pollfd));
+				pollSet = (newPollSet != NULL) ? newPollSet : pollSet;
+				if (newWaiting != NULL && newDeadlines != NULL && newPollSet != NULL)
+				{
+					capacity = newCapacity;
+				}
+			}
+			unsigned long long timeoutMs = (myFT->dataPort == NULL) ? config->handshakeTimeoutMs : config->commandTimeoutMs;
+			myFT->messageDeadline = (timeoutMs > 0) ? now + timeoutMs * 1000000ULL : ULLONG_MAX;
+			if (numWaiting == capacity || tlsPending(myFT->controlSocketFD))
+			{
+				enqueueRequest(&intakeQueue, myFT);
+				continue;
+			}
+			waiting[numWaiting] = myFT;
+			deadlines[numWaiting] = myFT->messageDeadline;
+			pollSet[numWaiting + 1].fd = myFT->controlSocketFD;
+			pollSet[numWaiting + 1].events = POLLIN;
+			numWaiting++;
+		}
+
+		/* Wait until a message starts to arrive, a connection is added, or the earliest deadline passes. */
+		unsigned long long earliest = ULLONG_MAX;
+		for (int i = 0; i < numWaiting; i++)
+		{
+			earliest = (deadlines[i] < earliest) ? deadlines[i] : earliest;
+		}
+		int pollTimeoutMs = -1;
+		if (earliest != ULLONG_MAX)
+		{
+			unsigned long long remainingMs = (earliest > now) ? (earliest - now + 999999) / 1000000 : 0;
+			pollTimeoutMs = (remainingMs > INT_MAX) ? INT_MAX : (int)remainingMs;
+		}
+		if (poll(pollSet, numWaiting + 1, pollTimeoutMs) == -1 && errno != EINTR)
+		{
+			perror("INTAKE POLLER ERROR");
+		}
+
+		/* Clear the wakeup, if any (connections added are taken at the top of the next pass). */
+		uint64_t wakeups;
+		if (pollSet[0].revents != 0 && read(pollWakeFD, &wakeups, sizeof(wakeups)) == -1 && errno != EAGAIN)
+		{
+			perror("INTAKE POLLER ERROR");
+		}
+
+		/* Hand each connection whose message has started (or whose socket has an error or hang-up, which the
+		 * intake thread will report) to an intake thread, finish each whose deadline has passed, and keep
+		 * waiting on the rest. */
+		now = monotonicNs();
+		int numKept = 0;
+		for (int i = 0; i < numWaiting; i++)
+		{
+			if (pollSet[i + 1].revents != 0)
+			{
+				enqueueRequest(&intakeQueue, waiting[i]);
+			}
+			else if (deadlines[i] <= now)
+			{
+				expireClientMessage(waiting[i]);
+			}
+			else
+			{
+				waiting[numKept] = waiting[i];
+				deadlines[numKept] = deadlines[i];
+				pollSet[numKept + 1] = pollSet[i + 1];
+				numKept++;
+			}
+		}
+		numWaiting = numKept;
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	admitConnection
+ * Description:		Decides whether a newly-accepted connection may be served, counting it
+ * 			as an active session if so. A connection is admitted unless
+ * 			max_sessions sessions are already active.
+ * Receives: 		nothing
+ * Returns: 		True if the connection is admitted; false if the server is busy.
+ * Pre-Conditions: 	Called only by the thread accepting connections (so that the active
+ * 			session count cannot be raised past the maximum by another thread).
+ * Post-Conditions: 	If true is returned, the caller must submit the connection, and
+ * 			finishSession will be called for it once it is served.
+**********************************************************************************************/
+
+int admitConnection()
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* If the maximum number of sessions is limited and already reached, do not admit connection. */
+	if (config->maxSessions > 0 && STAT_GET(activeSessions) >= config->maxSessions)
+	{
+		return 0;
+	}
+
+	/* Otherwise, count connection as active and admit it. */
+	STAT_ADD(activeSessions, 1);
+	return 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	finishSession
+ * Description:		Adds the time spent in each phase of an admitted connection's session
+ * 			to the latency histograms and the session trace (if any), stops counting
+ * 			it among the downloads of its file, deletes its FTInfo (closing its
+ * 			sockets), and counts the session as no longer active.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT was admitted by admitConnection and submitted to the scheduler.
+ * Post-Conditions: 	myFT has been deleted and its slot is free for a new session.
+**********************************************************************************************/
+
+void finishSession(struct FTInfo* myFT)
+{
+	/* Time the whole session, then record every phase marked under the command received (or under
+	 * STATS_MAX_COMMANDS if no valid command was received). */
+	myFT->phaseNs[PHASE_TOTAL] = monotonicNs() - myFT->acceptedAt;
+	myFT->phasesMarked |= 1u << PHASE_TOTAL;
+	int command = (myFT->handler != NULL) ? commandIndex(myFT->handler) : STATS_MAX_COMMANDS;
+	for (int phase = 0; phase < NUM_PHASES; phase++)
+	{
+		if (myFT->phasesMarked & (1u << phase))
+		{
+			recordLatency(phase, command, myFT->phaseNs[phase]);
+		}
+	}
+	traceSession(myFT);
+
+	leaveSharedFile(myFT);
+	deleteFTInfo(myFT);
+	STAT_SUB(activeSessions, 1);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	getQueueDepths
+ * Description:		Reports the number of connections waiting in each scheduler queue.
+ * Receives: 		Pointers to ints in which to store the intake, fast lane, bulk lane, and
+ * 			shared lane queue depths.
+ * Returns: 		nothing
+ * Pre-Conditions: 	All pointers are non-null.
+ * Post-Conditions: 	The ints pointed to hold the queue depths.
+**********************************************************************************************/
+
+void getQueueDepths(int* intakeDepth, int* fastDepth, int* bulkDepth, int* sharedDepth)
+{
+	pthread_mutex_lock(&intakeQueue.lock);
+	*intakeDepth = intakeQueue.depth;
+	pthread_mutex_unlock(&intakeQueue.lock);
+	pthread_mutex_lock(&fastLane.lock);
+	*fastDepth = fastLane.depth;
+	pthread_mutex_unlock(&fastLane.lock);
+	pthread_mutex_lock(&bulkLane.lock);
+	*bulkDepth = bulkLane.depth;
+	pthread_mutex_unlock(&bulkLane.lock);
+	pthread_mutex_lock(&sharedLane.lock);
+	*sharedDepth = sharedLane.depth;
+	pthread_mutex_unlock(&sharedLane.lock);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	enqueueRequest
+ * Description:		Adds a connection to the tail of a queue and wakes a thread waiting on it.
+ * 			If the queue is growable and more connections are queued than threads
+ * 			wait for them, starts another thread serving the queue.
+ * Receives: 		A pointer to a queue and a struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT is not in any queue. Called with all signals blocked (as in every
+ * 			worker thread), so that a thread started inherits that mask.
+ * Post-Conditions: 	myFT is the last connection in the queue.
+**********************************************************************************************/
+
+void enqueueRequest(struct RequestQueue* queue, struct FTInfo* myFT)
+{
+	pthread_mutex_lock(&queue->lock);
+
+	/* Link myFT after the current tail (or make it the head if queue is empty). */
+	myFT->next = NULL;
+	if (queue->tail == NULL)
+	{
+		queue->head = myFT;
+	}
+	else
+	{
+		queue->tail->next = myFT;
+	}
+	queue->tail = myFT;
+	queue->depth++;
+
+	/* Wake one thread waiting for a connection, starting one if none is left to wake. If it cannot be
+	 * started, the connection waits for a thread already serving the queue. */
+	pthread_cond_signal(&queue->notEmpty);
+	if (queue->growable && queue->depth > queue->waiting)
+	{
+		pthread_t thread;
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+		int createStatus = pthread_create(&thread, &attributes, laneWorker, queue);
+		if (createStatus != 0)
+		{
+			fprintf(stderr, "THREAD ERROR: could not start lane thread: %s\n", strerror(createStatus));
+		}
+		pthread_attr_destroy(&attributes);
+	}
+	pthread_mutex_unlock(&queue->lock);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	dequeueRequest
+ * Description:		Removes the connection at the head of a queue, blocking until one is
+ * 			available if the queue is empty. A growable queue that is empty and already
+ * 			has GROWABLE_IDLE_THREADS threads waiting needs no more, so the calling
+ * 			thread is told to exit instead.
+ * Receives: 		A pointer to a queue.
+ * Returns: 		The struct FTInfo pointer removed from the queue, or NULL if the calling
+ * 			thread should exit.
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	The returned connection is no longer in the queue.
+**********************************************************************************************/
+
+struct FTInfo* dequeueRequest(struct RequestQueue* queue)
+{
+	pthread_mutex_lock(&queue->lock);
+
+	/* Return NULL if this thread is surplus to a growable queue. Otherwise, wait until queue contains a
+	 * connection. */
+	if (queue->growable && queue->head == NULL && queue->waiting >= GROWABLE_IDLE_THREADS)
+	{
+		pthread_mutex_unlock(&queue->lock);
+		return NULL;
+	}
+	queue->waiting++;
+	while (queue->head == NULL)
+	{
+		pthread_cond_wait(&queue->notEmpty, &queue->lock);
+	}
+	queue->waiting--;
+
+	/* Unlink the head of the queue. */
+	struct FTInfo* myFT = queue->head;
+	queue->head = myFT->next;
+	if (queue->head == NULL)
+	{
+		queue->tail = NULL;
+	}
+	queue->depth--;
+	myFT->next = NULL;
+
+	pthread_mutex_unlock(&queue->lock);
+	return myFT;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	classifyRequest
+ * Description:		Chooses the lane on which a parsed request should wait for a thread.
+ * 			Requests that do not name a file (listings), requests for files that
+ * 			cannot be examined (which will only produce an error message), and
+ * 			files smaller than fast_lane_max_size, and any file requested
+ * 			by a local client, go to the fast lane;
+ * 			all other files (including uploads of at least that size) go to the bulk
+ * 			lane, except downloads of a file another download is already sending (or
+ * 			waiting to send), which go to the shared lane to share its stream. The size
+ * 			of the named file is stored in myFT->requestSize unless the request
+ * 			announced a size, and downloads are counted by enterSharedFile.
+ * Receives: 		A struct FTInfo pointer whose request has been parsed.
+ * Returns: 		A pointer to the queue the request should be placed on.
+ * Pre-Conditions: 	handleRequest has returned true for myFT.
+ * Post-Conditions: 	myFT->requestSize holds the size of the named file, or -1 if none.
+**********************************************************************************************/
+
+struct RequestQueue* classifyRequest(struct FTInfo* myFT)
+{
+	/* If request names a file that can be examined, store its size (unless the request gave the size
+	 * itself, as an upload does). */
+	struct stat fileInfo;
+	int examined = myFT->requestSize < 0 && myFT->filename != NULL && stat(myFT->filename, &fileInfo) == 0;
+	if (examined)
+	{
+		myFT->requestSize = fileInfo.st_size;
+	}
+	FT_PROBE(request, myFT->sessionId, myFT->requestSize, FT_PROBE_NAME(myFT));
+
+	/* Count downloads (other than by local clients) of files that may be coalesced. */
+	int transfers = 0;
+	if (examined && !myFT->local && strcmp(myFT->command, GET_FILE) == 0)
+	{
+		transfers = enterSharedFile(myFT, &fileInfo);
+	}
+
+	/* Send large files to the bulk lane (or, if another download of the file is in progress, to the
+	 * shared lane, whose transfers read the file once between them and so are not limited to
+	 * bulk_lane_slots) and everything else to the fast lane. Files requested by local clients are passed
+	 * as descriptors rather than sent, so they always take the fast lane (but their uploads are
+	 * streamed like any other). */
+	int streamed = !myFT->local || strcmp(myFT->command, PUT_FILE) == 0;
+	if (streamed && myFT->requestSize >= 0 && (unsigned long long)myFT->requestSize >= getServerConfig()->fastLaneMaxSize)
+	{
+		return (transfers > 1) ? &sharedLane : &bulkLane;
+	}
+	return &fastLane;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	intakeWorker
+ * Description:		Thread function that endlessly takes connections from the intake queue
+ * 			(once the intake poller has seen their client's next message arrive)
+ * 			and handles that message: a connection that has not been validated has
+ * 			its DATA_PORT message validated and is handed back to the poller to
+ * 			await the request; otherwise its request is received, and a valid
+ * 			request is placed on the lane chosen by classifyRequest. Invalid
+ * 			connections and requests are deleted once the client has been sent an
+ * 			error message.
+ * Receives: 		An unused argument.
+ * Returns: 		Never returns.
+ * Pre-Conditions: 	Thread was started by startScheduler.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+void* intakeWorker(void* arg)
+{
+	while (1)
+	{
+		/* Wait for a connection whose client is sending its next message. */
+		struct FTInfo* myFT = dequeueRequest(&intakeQueue);
+
+		/* If connection has not been validated (its data port is only stored once it is), receive and
+		 * validate initial message, then wait for the request without holding this thread, deleting the
+		 * connection if the message is invalid. */
+		if (myFT->dataPort == NULL)
+		{
+			markPhase(myFT, PHASE_INTAKE_QUEUE);
+			int validConnection = validateControlConnection(myFT);
+			markPhase(myFT, PHASE_HANDSHAKE);
+			if (!validConnection)
+			{
+				STAT_ADD(handshakeFailures, 1);
+				finishSession(myFT);
+			}
+			else
+			{
+				awaitClientMessage(myFT);
+			}
+		}
+
+		/* Otherwise, receive request, queueing it on its lane if valid and deleting the connection
+		 * otherwise. */
+		else if (handleRequest(myFT))
+		{
+			markPhase(myFT, PHASE_COMMAND);
+			enqueueRequest(classifyRequest(myFT), myFT);
+		}
+		else
+		{
+			markPhase(myFT, PHASE_COMMAND);
+			finishSession(myFT);
+		}
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	laneWorker
+ * Description:		Thread function that takes parsed requests from a lane, fulfills each,
+ * 			and deletes its connection, until the lane has no more need of the thread
+ * 			(only a growable lane ever lets a thread go).
+ * Receives: 		A pointer to the lane (struct RequestQueue) this thread serves.
+ * Returns: 		NULL once the lane has enough idle threads without this one.
+ * Pre-Conditions: 	Thread was started by startScheduler.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+void* laneWorker(void* arg)
+{
+	struct RequestQueue* lane = (struct RequestQueue*)arg;
+	while (1)
+	{
+		/* Wait for a parsed request (exiting if the lane has enough idle threads without this one),
+		 * fulfill it, and delete its connection (which will also close its sockets), freeing its
+		 * session slot. */
+		struct FTInfo* myFT = dequeueRequest(lane);
+		if (myFT == NULL)
+		{
+			break;
+		}
+		markPhase(myFT, PHASE_LANE_QUEUE);
+		fulfillRequest(myFT);
+		finishSession(myFT);
+	}
+	return NULL;
+}
@@ -0,0 +1,80 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		requestScheduler.h
+ * File Description: 	Header file for the request scheduler. Accepted connections are watched by
+ * 			an intake poller until their client sends DATA_PORT, and again until it
+ * 			sends its request, and each message is then received and parsed by a
+ * 			pool of intake threads, which never wait on an idle client. Parsed
+ * 			requests are then classified by size: listings and small files are queued
+ * 			on the fast lane, and large files on the bulk lane, which has a limited
+ * 			number of slots, so small requests never wait behind large transfers.
+ * 			Downloads of a file another download is already sending (or waiting to
+ * 			send) go to the shared lane instead, which starts threads as it needs
+ * 			them, since they share one read of the file (see sharedStream.h).
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef REQUEST_SCHEDULER
+#define REQUEST_SCHEDULER
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include "FTInfo.h"
+
+/* Global constant representing how many idle threads a growable queue keeps. A thread of such a queue
+ * that finds it empty with this many threads already waiting exits instead of waiting too. */
+#define GROWABLE_IDLE_THREADS 2
+
+/* Definition of struct representing a first-in, first-out queue of connections awaiting a thread.
+ * Connections are linked through the next member of struct FTInfo. */
+struct RequestQueue
+{
+	pthread_mutex_t lock;		/* Protects all other members. */
+	pthread_cond_t notEmpty;	/* Signaled when a connection is added. */
+	struct FTInfo* head;		/* Next connection to be removed. */
+	struct FTInfo* tail;		/* Connection most recently added. */
+	int depth;			/* Number of connections in queue. */
+	int waiting;			/* Number of threads waiting for a connection. */
+	int growable;			/* True if a thread is started whenever no thread waits for a connection added
+					 * (and threads beyond GROWABLE_IDLE_THREADS exit once idle). */
+};
+
+/* Function prototypes. */
+void startScheduler();
+void submitConnection(struct FTInfo* myFT);
+int admitConnection();
+void finishSession(struct FTInfo* myFT);
+void getQueueDepths(int* intakeDepth, int* fastDepth, int* bulkDepth, int* sharedDepth);
+void enqueueRequest(struct RequestQueue* queue, struct FTInfo* myFT);
+struct FTInfo* dequeueRequest(struct RequestQueue* queue);
+struct RequestQueue* classifyRequest(struct FTInfo* myFT);
+void* intakeWorker(void* arg);
+void* laneWorker(void* arg);
+
+#endif
@@ -0,0 +1,340 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sendPipeline.c
+ * File Description: 	Implementation of the pipeline through which files are sent from the
+ * 			page cache. See sendPipeline.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "latencyHistogram.h"
+#include "sendPipeline.h"
+#include "serverConfig.h"
+
+
+/***********************************************************************************************
+ * Function Name:	runSendPipeline
+ * Description:		Passes a file through the reader and the stages given, returning once
+ * 			the last stage has processed the end of the file or a stage has failed.
+ * 			The reader and every stage but the last run on threads of their own, with
+ * 			a ring of pipeline_depth buffers of pipeline_buffer bytes between them. A
+ * 			file smaller than one buffer (or a depth below 2) would gain nothing from
+ * 			threads, so it is read into a single buffer of its size and passed through
+ * 			the stages by the calling thread.
+ * Receives: 		The file, the stages to pass it through after the reader (the last of which
+ * 			runs on the calling thread), and their number.
+ * Returns: 		PIPELINE_DONE, PIPELINE_READ_ERROR (with errno set), or PIPELINE_STAGE_ERROR.
+ * Pre-Conditions: 	fileFD is open for reading at offset 0, and numStages is between 1 and
+ * 			MAX_PIPELINE_STAGES.
+ * Post-Conditions: 	Every thread started has exited and every buffer has been freed (unless
+ * 			the kernel might still read it after a failure). The file is left open.
+**********************************************************************************************/
+
+int runSendPipeline(int fileFD, const struct PipelineStage* stages, int numStages)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Initialize pipeline, applying read_policy to the file. */
+	struct SendPipeline pipeline;
+	memset(&pipeline, 0, sizeof(pipeline));
+	pthread_mutex_init(&pipeline.lock, NULL);
+	pthread_cond_init(&pipeline.changed, NULL);
+	pipeline.fileFD = fileFD;
+	pipeline.stages = stages;
+	pipeline.numStages = numStages;
+	beginReadPolicy(&pipeline.readPolicy, fileFD);
+
+	/* Size ring from settings, shrinking it to a single buffer for a file smaller than one buffer. */
+	unsigned long long bufferSize = config->pipelineBuffer;
+	bufferSize = (bufferSize < 1) ? 1 : (bufferSize > MAX_PIPELINE_BUFFER) ? MAX_PIPELINE_BUFFER : bufferSize;
+	unsigned long long depth = config->pipelineDepth;
+	depth = (depth < 1) ? 1 : (depth > MAX_PIPELINE_DEPTH) ? MAX_PIPELINE_DEPTH : depth;
+	struct stat fileInfo;
+	if (fstat(fileFD, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode) && (unsigned long long)fileInfo.st_size < bufferSize)
+	{
+		bufferSize = fileInfo.st_size + 1;
+		depth = 1;
+	}
+	pipeline.depth = (int)depth;
+
+	/* Allocate buffers. */
+	char* memory = (char*)malloc(depth * bufferSize);
+	if (memory == NULL)
+	{
+		errno = ENOMEM;
+		return PIPELINE_READ_ERROR;
+	}
+	for (int i = 0; i < pipeline.depth; i++)
+	{
+		pipeline.ring[i].data = memory + i * bufferSize;
+		pipeline.ring[i].size = (int)bufferSize;
+	}
+
+	/* With a single buffer, pass it through every stage in turn on this thread. */
+	if (pipeline.depth == 1)
+	{
+		struct PipelineBuffer* buffer = &pipeline.ring[0];
+		while (!pipeline.stopped)
+		{
+			if (reclaimPipelineBuffer(&pipeline, buffer) == -1)
+			{
+				pipeline.stopped = 1;
+				break;
+			}
+			fillPipelineBuffer(&pipeline, buffer);
+			for (int stage = 1; stage <= numStages && buffer->len > 0 && !pipeline.stopped; stage++)
+			{
+				pipeline.stopped = stages[stage - 1].process(buffer, stages[stage - 1].arg) == -1;
+			}
+			if (buffer->last)
+			{
+				break;
+			}
+		}
+	}
+
+	/* Otherwise, start a thread for the reader and every stage but the last, run the last, and wait
+	 * for the threads to finish. If a thread cannot be started, stop those already started. */
+	else
+	{
+		int numWorkers = 0;
+		for (int stage = 0; stage < numStages; stage++)
+		{
+			pipeline.workers[stage].pipeline = &pipeline;
+			pipeline.workers[stage].stage = stage;
+			int createResult = pthread_create(&pipeline.workers[stage].thread, NULL, pipelineWorker, &pipeline.workers[stage]);
+			if (createResult != 0)
+			{
+				fprintf(stderr, "PIPELINE THREAD ERROR: %s\n", strerror(createResult));
+				pthread_mutex_lock(&pipeline.lock);
+				pipeline.stopped = 1;
+				pthread_cond_broadcast(&pipeline.changed);
+				pthread_mutex_unlock(&pipeline.lock);
+				break;
+			}
+			numWorkers++;
+		}
+		if (!pipeline.stopped)
+		{
+			runPipelineStage(&pipeline, numStages);
+		}
+		for (int i = 0; i < numWorkers; i++)
+		{
+			pthread_join(pipeline.workers[i].thread, NULL);
+		}
+	}
+
+	/* Wait for the kernel to release every buffer before freeing them. If this is the first failure
+	 * of the transfer, reclaim the buffer again, so that a stage handing buffers to the kernel drops
+	 * the sends still queued rather than waiting for them. If a buffer may still be read by the kernel
+	 * even so, the ring is left allocated rather than freed under it. */
+	int released = 1;
+	for (int i = 0; i < pipeline.depth; i++)
+	{
+		int result = reclaimPipelineBuffer(&pipeline, &pipeline.ring[i]);
+		if (result == -1 && !pipeline.stopped)
+		{
+			pipeline.stopped = 1;
+			result = reclaimPipelineBuffer(&pipeline, &pipeline.ring[i]);
+		}
+		released = released && result == 0;
+	}
+
+	/* Release resources, and report how the transfer ended. */
+	if (released)
+	{
+		free(memory);
+	}
+	else
+	{
+		fprintf(stderr, "PIPELINE WARNING: buffers still held by the kernel were not freed.\n");
+	}
+	pthread_mutex_destroy(&pipeline.lock);
+	pthread_cond_destroy(&pipeline.changed);
+	if (pipeline.stopped)
+	{
+		return PIPELINE_STAGE_ERROR;
+	}
+	if (pipeline.readErrno != 0)
+	{
+		errno = pipeline.readErrno;
+		return PIPELINE_READ_ERROR;
+	}
+	return PIPELINE_DONE;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	fillPipelineBuffer
+ * Description:		The reader stage: fills a buffer from the file, timing each read and
+ * 			applying read_policy as the file is read. Marks the buffer as the last if the
+ * 			end of the file is reached or a read fails (storing the error in the pipeline).
+ * Receives: 		The pipeline and the buffer to fill.
+ * Returns: 		0
+ * Pre-Conditions: 	The buffer belongs to the reader.
+ * Post-Conditions: 	The buffer holds the next len bytes of the file.
+**********************************************************************************************/
+
+int fillPipelineBuffer(struct SendPipeline* pipeline, struct PipelineBuffer* buffer)
+{
+	buffer->len = 0;
+	buffer->last = 0;
+	while (buffer->len < buffer->size)
+	{
+		unsigned long long readStart = monotonicNs();
+		ssize_t charsRead = read(pipeline->fileFD, buffer->data + buffer->len, buffer->size - buffer->len);
+		if (charsRead > 0)
+		{
+			buffer->len += charsRead;
+			advanceReadPolicy(&pipeline->readPolicy, charsRead, monotonicNs() - readStart);
+		}
+		else if (charsRead == 0 || errno != EINTR)
+		{
+			if (charsRead == -1)
+			{
+				pipeline->readErrno = errno;
+			}
+			buffer->last = 1;
+			break;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	reclaimPipelineBuffer
+ * Description:		Calls the reclaim function of every stage that has one for a buffer, so
+ * 			that no send may still be reading it when it is refilled or freed.
+ * Receives: 		The pipeline and the buffer.
+ * Returns: 		0 once the buffer may be reused; -1 if a stage failed.
+ * Pre-Conditions: 	The buffer belongs to the reader.
+ * Post-Conditions: 	If 0 is returned, only the reader refers to the buffer.
+**********************************************************************************************/
+
+int reclaimPipelineBuffer(struct SendPipeline* pipeline, struct PipelineBuffer* buffer)
+{
+	for (int stage = 0; stage < pipeline->numStages; stage++)
+	{
+		if (pipeline->stages[stage].reclaim != NULL
+			&& pipeline->stages[stage].reclaim(buffer, pipeline->stages[stage].arg) == -1)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	runPipelineStage
+ * Description:		Runs one stage of a pipeline: takes each buffer of the ring in turn once
+ * 			the previous stage has passed it on, processes it (filling it, for the
+ * 			reader), and passes it to the next stage (the last stage passes it back to
+ * 			the reader). Returns after processing the last buffer of the file, or once
+ * 			any stage has failed.
+ * Receives: 		The pipeline and the index of the stage (0 = reader).
+ * Returns: 		nothing
+ * Pre-Conditions: 	The pipeline's ring has been allocated.
+ * Post-Conditions: 	The stage has processed every buffer it will.
+**********************************************************************************************/
+
+void runPipelineStage(struct SendPipeline* pipeline, int stage)
+{
+	for (unsigned long long sequence = 0; ; sequence++)
+	{
+		/* Wait until the buffer is passed to this stage, returning if the pipeline stops. */
+		struct PipelineBuffer* buffer = &pipeline->ring[sequence % pipeline->depth];
+		pthread_mutex_lock(&pipeline->lock);
+		while (buffer->stage != stage && !pipeline->stopped)
+		{
+			pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+		}
+		int stopped = pipeline->stopped;
+		pthread_mutex_unlock(&pipeline->lock);
+		if (stopped)
+		{
+			return;
+		}
+
+		/* Process buffer, noting whether it is the last before passing it on. */
+		int result = 0;
+		if (stage == 0)
+		{
+			result = reclaimPipelineBuffer(pipeline, buffer);
+			if (result == 0)
+			{
+				fillPipelineBuffer(pipeline, buffer);
+			}
+		}
+		else if (buffer->len > 0)
+		{
+			result = pipeline->stages[stage - 1].process(buffer, pipeline->stages[stage - 1].arg);
+		}
+		int last = buffer->last;
+
+		/* Pass buffer on, or stop the pipeline if processing failed. */
+		pthread_mutex_lock(&pipeline->lock);
+		if (result == -1)
+		{
+			pipeline->stopped = 1;
+		}
+		else
+		{
+			buffer->stage = (stage == pipeline->numStages) ? 0 : stage + 1;
+		}
+		pthread_cond_broadcast(&pipeline->changed);
+		pthread_mutex_unlock(&pipeline->lock);
+		if (result == -1 || last)
+		{
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	pipelineWorker
+ * Description:		Thread function running one stage of a pipeline.
+ * Receives: 		A pointer to the struct PipelineWorker describing the stage.
+ * Returns: 		NULL
+ * Pre-Conditions: 	Thread was started by runSendPipeline.
+ * Post-Conditions: 	The stage has processed every buffer it will.
+**********************************************************************************************/
+
+void* pipelineWorker(void* arg)
+{
+	struct PipelineWorker* worker = (struct PipelineWorker*)arg;
+	runPipelineStage(worker->pipeline, worker->stage);
+	return NULL;
+}
@@ -0,0 +1,116 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sendPipeline.h
+ * File Description: 	Header file for the pipeline through which files are sent from the page
+ * 			cache. A reader stage fills a ring of pipeline_depth buffers of
+ * 			pipeline_buffer bytes from the file, on a thread of its own, while the
+ * 			last stage (the sender, run by the calling thread) drains them, so the disk
+ * 			reads ahead while the socket drains instead of each waiting on the other.
+ * 			Stages between the two (e.g. compression or hashing) may be passed in before
+ * 			the sender; each runs on its own thread and works on buffers in place, in
+ * 			file order, so no stage copies data. A stage may change a buffer's length
+ * 			(within its size) before passing it on.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SEND_PIPELINE
+#define SEND_PIPELINE
+
+#include <pthread.h>
+#include "readPolicy.h"
+
+/* Global constants representing the most buffers in the ring, the largest buffer, and the most
+ * stages after the reader. */
+#define MAX_PIPELINE_DEPTH 64
+#define MAX_PIPELINE_BUFFER 16777216
+#define MAX_PIPELINE_STAGES 8
+
+/* Values returned by runSendPipeline: every byte of the file passed through every stage, reading
+ * the file failed (errno is set), or a stage failed. */
+#define PIPELINE_DONE 0
+#define PIPELINE_READ_ERROR -1
+#define PIPELINE_STAGE_ERROR -2
+
+/* Definition of struct describing one buffer of the ring. See below for variable descriptions. */
+struct PipelineBuffer
+{
+	char* data;		/* Contents. */
+	int len;		/* Number of bytes of data in use. */
+	int size;		/* Number of bytes data holds. */
+	int stage;		/* Index of next stage to process buffer (0 = reader, once sender is done). */
+	int last;		/* True if buffer holds the end of the file (or reading failed). */
+	unsigned int ticket;	/* Set by a stage whose sends may still read data after it returns. */
+};
+
+/* Definition of struct describing a stage after the reader. process is called with each buffer in
+ * turn and arg, and returns 0 to pass the buffer on or -1 to stop the transfer. reclaim (which may be
+ * NULL) is called by the reader before it refills a buffer, and before the ring is freed, for a stage
+ * that hands buffers to the kernel without copying them; it returns once the kernel is done with the
+ * buffer (0) or has failed (-1, stopping the transfer). Once the transfer has failed, reclaim must
+ * make the kernel let go of the buffer rather than wait for the client (e.g. by resetting the
+ * connection), returning -1 only if it cannot, in which case the ring is never freed. */
+struct PipelineStage
+{
+	int (*process)(struct PipelineBuffer* buffer, void* arg);	/* Function processing a buffer. */
+	int (*reclaim)(struct PipelineBuffer* buffer, void* arg);	/* Function awaiting a buffer's release. */
+	void* arg;							/* Argument passed to both. */
+};
+
+/* Definition of struct identifying the stage run by a thread of a pipeline. */
+struct PipelineWorker
+{
+	struct SendPipeline* pipeline;	/* Pipeline the thread belongs to. */
+	int stage;			/* Stage the thread runs (0 = reader). */
+	pthread_t thread;		/* The thread. */
+};
+
+/* Definition of struct holding the state of one pipeline. See below for variable descriptions. */
+struct SendPipeline
+{
+	pthread_mutex_t lock;			/* Protects stage of each buffer and stopped. */
+	pthread_cond_t changed;			/* Signaled whenever a buffer moves to another stage. */
+	int fileFD;				/* File read by the reader. */
+	struct ReadPolicy readPolicy;		/* read_policy applied by the reader. */
+	int readErrno;				/* Error of failed read, or 0. */
+	int stopped;				/* True once any stage has failed. */
+	const struct PipelineStage* stages;	/* Stages after the reader, the last being the sender. */
+	int numStages;				/* Number of stages after the reader. */
+	struct PipelineBuffer ring[MAX_PIPELINE_DEPTH];	/* Buffers passed from stage to stage. */
+	int depth;				/* Number of buffers in ring. */
+	struct PipelineWorker workers[MAX_PIPELINE_STAGES];	/* Threads running the reader and every stage
+						 * but the sender. */
+};
+
+/* Function prototypes. */
+int runSendPipeline(int fileFD, const struct PipelineStage* stages, int numStages);
+int fillPipelineBuffer(struct SendPipeline* pipeline, struct PipelineBuffer* buffer);
+int reclaimPipelineBuffer(struct SendPipeline* pipeline, struct PipelineBuffer* buffer);
+void runPipelineStage(struct SendPipeline* pipeline, int stage);
+void* pipelineWorker(void* arg);
+
+#endif
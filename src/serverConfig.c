@@ -0,0 +1,308 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverConfig.c
+ * File Description: 	Implementation of functions for reading the server configuration file.
+ * 			Each line of the file is either blank, a comment beginning with '#', or
+ * 			a key followed by whitespace and a value.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <ctype.h>
+#include <stddef.h>
+#include "serverConfig.h"
+
+/* Global variable definitions. */
+char* configFilename = NULL;			/* CONFIG_FILE received on command line, or NULL. */
+
+/* Static variables. */
+static struct ServerConfig defaultConfig =	/* Settings in effect until a configuration file is loaded. */
+{
+	.totalRateLimit = 0,
+	.clientRateLimit = 0,
+	.transferRateLimit = 0,
+	.rateBurst = DEFAULT_RATE_BURST,
+	.intakeThreads = DEFAULT_INTAKE_THREADS,
+	.fastLaneThreads = DEFAULT_FAST_LANE_THREADS,
+	.bulkLaneSlots = DEFAULT_BULK_LANE_SLOTS,
+	.fastLaneMaxSize = DEFAULT_FAST_LANE_MAX_SIZE,
+	.shards = 0,
+	.listenBacklog = DEFAULT_LISTEN_BACKLOG,
+	.maxSessions = DEFAULT_MAX_SESSIONS,
+	.busyRetryMs = DEFAULT_BUSY_RETRY_MS,
+	.handshakeTimeoutMs = DEFAULT_HANDSHAKE_TIMEOUT_MS,
+	.commandTimeoutMs = DEFAULT_COMMAND_TIMEOUT_MS,
+	.dataConnectTimeoutMs = DEFAULT_DATA_CONNECT_TIMEOUT_MS,
+	.sendStallTimeoutMs = DEFAULT_SEND_STALL_TIMEOUT_MS,
+	.finalAckTimeoutMs = DEFAULT_FINAL_ACK_TIMEOUT_MS,
+	.tcpSampleIntervalMs = DEFAULT_TCP_SAMPLE_INTERVAL_MS,
+	.socketNodelay = DEFAULT_SOCKET_NODELAY,
+	.socketFrameMore = DEFAULT_SOCKET_FRAME_MORE,
+	.socketCork = DEFAULT_SOCKET_CORK,
+	.socketNotsentLowat = 0,
+	.socketBdpBuffers = DEFAULT_SOCKET_BDP_BUFFERS,
+	.socketCongestion = "",
+	.traceFile = "",
+	.accessLog = "",
+	.unixSocket = "",
+	.uploadWriteBlock = DEFAULT_UPLOAD_WRITE_BLOCK,
+	.uploadWriteBehind = DEFAULT_UPLOAD_WRITE_BEHIND,
+	.uploadFsync = DEFAULT_UPLOAD_FSYNC,
+	.directIoMinSize = DEFAULT_DIRECT_IO_MIN_SIZE,
+	.directIoBuffers = DEFAULT_DIRECT_IO_BUFFERS,
+	.directIoBlock = DEFAULT_DIRECT_IO_BLOCK,
+	.directIoDepth = DEFAULT_DIRECT_IO_DEPTH,
+	.readPolicy = DEFAULT_READ_POLICY,
+	.readaheadMin = DEFAULT_READAHEAD_MIN,
+	.readaheadMax = DEFAULT_READAHEAD_MAX,
+	.dropBehindMinSize = DEFAULT_DROP_BEHIND_MIN_SIZE,
+	.pipelineDepth = DEFAULT_PIPELINE_DEPTH,
+	.pipelineBuffer = DEFAULT_PIPELINE_BUFFER,
+	.zerocopyMinSize = DEFAULT_ZEROCOPY_MIN_SIZE,
+	.coalesceMinSize = DEFAULT_COALESCE_MIN_SIZE,
+	.coalesceRing = DEFAULT_COALESCE_RING,
+	.tlsKtls = DEFAULT_TLS_KTLS
+};
+static struct ServerConfig* currentConfig = &defaultConfig;	/* Settings in effect (never modified once published). */
+static int configLoaded = 0;			/* Nonzero once a configuration file has been put into effect. */
+
+/* Types of value a setting may hold: a non-negative integer (unsigned long long field) or a string
+ * without spaces (char array field of MAX_CONFIG_LINE characters). */
+enum ConfigType
+{
+	CONFIG_NUMBER,
+	CONFIG_STRING
+};
+
+/* Definition of struct mapping a configuration file key to the field of struct ServerConfig it sets. */
+struct ConfigOption
+{
+	char* key;		/* Key as written in configuration file. */
+	size_t offset;		/* Offset of corresponding field within struct ServerConfig. */
+	enum ConfigType type;	/* Type of value the field holds. */
+	int startupOnly;	/* Nonzero if the setting is only read at startup, so a reload keeps its value. */
+};
+
+/* Table of keys accepted in the configuration file. */
+static const struct ConfigOption configOptions[] =
+{
+	{ "total_rate_limit", offsetof(struct ServerConfig, totalRateLimit), CONFIG_NUMBER, 0 },
+	{ "client_rate_limit", offsetof(struct ServerConfig, clientRateLimit), CONFIG_NUMBER, 0 },
+	{ "transfer_rate_limit", offsetof(struct ServerConfig, transferRateLimit), CONFIG_NUMBER, 0 },
+	{ "rate_burst", offsetof(struct ServerConfig, rateBurst), CONFIG_NUMBER, 0 },
+	{ "intake_threads", offsetof(struct ServerConfig, intakeThreads), CONFIG_NUMBER, 1 },
+	{ "fast_lane_threads", offsetof(struct ServerConfig, fastLaneThreads), CONFIG_NUMBER, 1 },
+	{ "bulk_lane_slots", offsetof(struct ServerConfig, bulkLaneSlots), CONFIG_NUMBER, 1 },
+	{ "fast_lane_max_size", offsetof(struct ServerConfig, fastLaneMaxSize), CONFIG_NUMBER, 0 },
+	{ "shards", offsetof(struct ServerConfig, shards), CONFIG_NUMBER, 1 },
+	{ "listen_backlog", offsetof(struct ServerConfig, listenBacklog), CONFIG_NUMBER, 0 },
+	{ "max_sessions", offsetof(struct ServerConfig, maxSessions), CONFIG_NUMBER, 0 },
+	{ "busy_retry_ms", offsetof(struct ServerConfig, busyRetryMs), CONFIG_NUMBER, 0 },
+	{ "handshake_timeout_ms", offsetof(struct ServerConfig, handshakeTimeoutMs), CONFIG_NUMBER, 0 },
+	{ "command_timeout_ms", offsetof(struct ServerConfig, commandTimeoutMs), CONFIG_NUMBER, 0 },
+	{ "data_connect_timeout_ms", offsetof(struct ServerConfig, dataConnectTimeoutMs), CONFIG_NUMBER, 0 },
+	{ "send_stall_timeout_ms", offsetof(struct ServerConfig, sendStallTimeoutMs), CONFIG_NUMBER, 0 },
+	{ "final_ack_timeout_ms", offsetof(struct ServerConfig, finalAckTimeoutMs), CONFIG_NUMBER, 0 },
+	{ "tcp_sample_interval_ms", offsetof(struct ServerConfig, tcpSampleIntervalMs), CONFIG_NUMBER, 0 },
+	{ "socket_nodelay", offsetof(struct ServerConfig, socketNodelay), CONFIG_NUMBER, 0 },
+	{ "socket_frame_more", offsetof(struct ServerConfig, socketFrameMore), CONFIG_NUMBER, 0 },
+	{ "socket_cork", offsetof(struct ServerConfig, socketCork), CONFIG_NUMBER, 0 },
+	{ "socket_notsent_lowat", offsetof(struct ServerConfig, socketNotsentLowat), CONFIG_NUMBER, 0 },
+	{ "socket_bdp_buffers", offsetof(struct ServerConfig, socketBdpBuffers), CONFIG_NUMBER, 0 },
+	{ "socket_congestion", offsetof(struct ServerConfig, socketCongestion), CONFIG_STRING, 0 },
+	{ "trace_file", offsetof(struct ServerConfig, traceFile), CONFIG_STRING, 0 },
+	{ "access_log", offsetof(struct ServerConfig, accessLog), CONFIG_STRING, 0 },
+	{ "unix_socket", offsetof(struct ServerConfig, unixSocket), CONFIG_STRING, 1 },
+	{ "upload_write_block", offsetof(struct ServerConfig, uploadWriteBlock), CONFIG_NUMBER, 0 },
+	{ "upload_write_behind", offsetof(struct ServerConfig, uploadWriteBehind), CONFIG_NUMBER, 0 },
+	{ "upload_fsync", offsetof(struct ServerConfig, uploadFsync), CONFIG_NUMBER, 0 },
+	{ "direct_io_min_size", offsetof(struct ServerConfig, directIoMinSize), CONFIG_NUMBER, 0 },
+	{ "direct_io_buffers", offsetof(struct ServerConfig, directIoBuffers), CONFIG_NUMBER, 1 },
+	{ "direct_io_block", offsetof(struct ServerConfig, directIoBlock), CONFIG_NUMBER, 1 },
+	{ "direct_io_depth", offsetof(struct ServerConfig, directIoDepth), CONFIG_NUMBER, 0 },
+	{ "read_policy", offsetof(struct ServerConfig, readPolicy), CONFIG_NUMBER, 0 },
+	{ "readahead_min", offsetof(struct ServerConfig, readaheadMin), CONFIG_NUMBER, 0 },
+	{ "readahead_max", offsetof(struct ServerConfig, readaheadMax), CONFIG_NUMBER, 0 },
+	{ "drop_behind_min_size", offsetof(struct ServerConfig, dropBehindMinSize), CONFIG_NUMBER, 0 },
+	{ "pipeline_depth", offsetof(struct ServerConfig, pipelineDepth), CONFIG_NUMBER, 0 },
+	{ "pipeline_buffer", offsetof(struct ServerConfig, pipelineBuffer), CONFIG_NUMBER, 0 },
+	{ "zerocopy_min_size", offsetof(struct ServerConfig, zerocopyMinSize), CONFIG_NUMBER, 0 },
+	{ "coalesce_min_size", offsetof(struct ServerConfig, coalesceMinSize), CONFIG_NUMBER, 0 },
+	{ "coalesce_ring", offsetof(struct ServerConfig, coalesceRing), CONFIG_NUMBER, 0 },
+	{ "tls_cert", offsetof(struct ServerConfig, tlsCert), CONFIG_STRING, 1 },
+	{ "tls_key", offsetof(struct ServerConfig, tlsKey), CONFIG_STRING, 1 },
+	{ "tls_ktls", offsetof(struct ServerConfig, tlsKtls), CONFIG_NUMBER, 1 }
+};
+
+
+/***********************************************************************************************
+ * Function Name:	getServerConfig
+ * Description:		Returns the settings currently in effect. A reload publishes new settings
+ * 			in a new struct rather than changing this one, so a caller that reads
+ * 			several settings through the pointer returned sees them all from the
+ * 			same configuration file.
+ * Receives: 		nothing
+ * Returns: 		A pointer to the settings in effect, which remain valid (and unchanged)
+ * 			for the life of the process.
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+struct ServerConfig* getServerConfig()
+{
+	return __atomic_load_n(&currentConfig, __ATOMIC_ACQUIRE);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	loadServerConfig
+ * Description:		Reads the configuration file with the name passed in, starting from the
+ * 			settings currently in effect and overwriting each setting that appears in
+ * 			the file. The new settings are put into effect only if the whole file
+ * 			is read without error, so a bad edit never leaves the server half-configured.
+ * 			Once settings have been loaded, a setting only read at startup keeps its
+ * 			value when the file is loaded again.
+ * Receives: 		The name of the configuration file.
+ * Returns: 		0 on success; -1 if the file could not be opened or contains an error.
+ * Pre-Conditions: 	filename is a non-null string.
+ * Post-Conditions: 	If 0 is returned, getServerConfig returns the settings from the file.
+ * 			Otherwise, the settings in effect are unchanged and the error has been
+ * 			reported.
+**********************************************************************************************/
+
+int loadServerConfig(char* filename)
+{
+	/* Open configuration file, reporting error and returning -1 upon failure. */
+	FILE* configFile = fopen(filename, "r");
+	if (configFile == NULL)
+	{
+		fprintf(stderr, "CONFIG ERROR: could not open %s: ", filename);
+		perror("");
+		return -1;
+	}
+
+	/* Start from the settings currently in effect so keys omitted from the file keep their values. */
+	struct ServerConfig* oldConfig = getServerConfig();
+	struct ServerConfig newConfig = *oldConfig;
+
+	/* Read file one line at a time until end of file is reached or an error is found. */
+	char line[MAX_CONFIG_LINE];
+	int lineNumber = 0;
+	int configError = 0;
+	while (!configError && fgets(line, sizeof(line), configFile) != NULL)
+	{
+		lineNumber++;
+
+		/* Split line into key and value, skipping blank lines and comments. */
+		char key[MAX_CONFIG_LINE];
+		char value[MAX_CONFIG_LINE];
+		int fieldsRead = sscanf(line, "%s %s", key, value);
+		if (fieldsRead <= 0 || key[0] == '#')
+		{
+			continue;
+		}
+
+		/* Find the option matching key. */
+		const struct ConfigOption* option = NULL;
+		int numOptions = sizeof(configOptions) / sizeof(configOptions[0]);
+		for (int i = 0; i < numOptions && option == NULL; i++)
+		{
+			if (strcmp(configOptions[i].key, key) == 0)
+			{
+				option = &configOptions[i];
+			}
+		}
+
+		/* If key is a string setting with a value, store value in the field of newConfig the option
+		 * refers to (storing an empty string if value is CONFIG_NONE). */
+		if (option != NULL && fieldsRead == 2 && option->type == CONFIG_STRING)
+		{
+			strcpy((char*)&newConfig + option->offset, (strcmp(value, CONFIG_NONE) == 0) ? "" : value);
+			continue;
+		}
+
+		/* If key is unknown or has no value, or value is not a non-negative integer, report error. */
+		char* valueEnd = NULL;
+		unsigned long long number = 0;
+		if (option != NULL && fieldsRead == 2 && isdigit(value[0]))
+		{
+			number = strtoull(value, &valueEnd, 10);
+		}
+		if (valueEnd == NULL || *valueEnd != '\0')
+		{
+			fprintf(stderr, "CONFIG ERROR: %s line %d: invalid setting \"%s\"\n", filename, lineNumber, key);
+			configError = 1;
+		}
+
+		/* Otherwise, store value in the field of newConfig the option refers to. */
+		else
+		{
+			*(unsigned long long*)((char*)&newConfig + option->offset) = number;
+		}
+	}
+
+	/* Close file now that it is no longer in use. */
+	fclose(configFile);
+
+	/* If an error was found, leave settings unchanged and return -1. */
+	if (configError)
+	{
+		return -1;
+	}
+
+	/* On a reload, keep the value in effect of each setting only read at startup (threads, sockets,
+	 * and buffers already created from it), noting any that the file changed. */
+	int numOptions = sizeof(configOptions) / sizeof(configOptions[0]);
+	for (int i = 0; configLoaded && i < numOptions; i++)
+	{
+		if (configOptions[i].startupOnly)
+		{
+			size_t size = (configOptions[i].type == CONFIG_STRING) ? MAX_CONFIG_LINE : sizeof(unsigned long long);
+			char* newValue = (char*)&newConfig + configOptions[i].offset;
+			char* currentValue = (char*)oldConfig + configOptions[i].offset;
+			if (memcmp(newValue, currentValue, size) != 0)
+			{
+				fprintf(stderr, "CONFIG NOTE: %s takes effect only at startup; keeping current value\n",
+					configOptions[i].key);
+				memcpy(newValue, currentValue, size);
+			}
+		}
+	}
+
+	/* Put new settings into effect by publishing a copy of them, and return 0. The old settings are
+	 * never freed, since threads serving requests may still be reading them. */
+	struct ServerConfig* publishedConfig = (struct ServerConfig*)malloc(sizeof(newConfig));
+	if (publishedConfig == NULL)
+	{
+		perror("CONFIG ERROR");
+		return -1;
+	}
+	*publishedConfig = newConfig;
+	__atomic_store_n(&currentConfig, publishedConfig, __ATOMIC_RELEASE);
+	configLoaded = 1;
+	return 0;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverConfig.h
+ * File Description: 	Header file for the server configuration read from the optional CONFIG_FILE
+ * 			named on the command line. The file may be edited and reloaded at runtime
+ * 			by sending the server a SIGHUP.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SERVER_CONFIG
+#define SERVER_CONFIG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Global constant representing default token bucket depth (in bytes) used when shaping transfers. */
+#define DEFAULT_RATE_BURST 262144
+
+/* Global constants representing default number of threads serving each scheduler queue
+ * and default size (in bytes) of the smallest file sent on the bulk lane. */
+#define DEFAULT_INTAKE_THREADS 4
+#define DEFAULT_FAST_LANE_THREADS 4
+#define DEFAULT_BULK_LANE_SLOTS 2
+#define DEFAULT_FAST_LANE_MAX_SIZE 1048576
+
+/* Global constants representing default maximum number of connections awaiting acceptance,
+ * default maximum number of sessions served at once, and default number of milliseconds
+ * after which clients turned away are told to retry. */
+#define DEFAULT_LISTEN_BACKLOG 10
+#define DEFAULT_MAX_SESSIONS 64
+#define DEFAULT_BUSY_RETRY_MS 250
+
+/* Global constants representing default number of milliseconds a client is allowed for each
+ * blocking step of a session: sending the data port, sending the request, accepting the data
+ * connection, making room for a single send, and acknowledging the end of a transfer. */
+#define DEFAULT_HANDSHAKE_TIMEOUT_MS 5000
+#define DEFAULT_COMMAND_TIMEOUT_MS 5000
+#define DEFAULT_DATA_CONNECT_TIMEOUT_MS 5000
+#define DEFAULT_SEND_STALL_TIMEOUT_MS 30000
+#define DEFAULT_FINAL_ACK_TIMEOUT_MS 30000
+
+/* Global constant representing default number of milliseconds between TCP samples of a transfer. */
+#define DEFAULT_TCP_SAMPLE_INTERVAL_MS 1000
+
+/* Global constants representing default socket options (see socketTuning.h). */
+#define DEFAULT_SOCKET_NODELAY 1
+#define DEFAULT_SOCKET_FRAME_MORE 1
+#define DEFAULT_SOCKET_CORK 1
+#define DEFAULT_SOCKET_BDP_BUFFERS 0
+
+/* Global constants representing default size (in bytes) of the blocks in which uploads are written,
+ * whether uploads are written behind, and how uploads are synced (see fileUpload.h). */
+#define DEFAULT_UPLOAD_WRITE_BLOCK 1048576
+#define DEFAULT_UPLOAD_WRITE_BEHIND 1
+#define DEFAULT_UPLOAD_FSYNC 1
+
+/* Global constants representing default size (in bytes) of the smallest file read with direct I/O,
+ * number and size of buffers in the direct I/O pool, and number of direct reads a transfer keeps in
+ * flight (see directRead.h). */
+#define DEFAULT_DIRECT_IO_MIN_SIZE 1073741824
+#define DEFAULT_DIRECT_IO_BUFFERS 16
+#define DEFAULT_DIRECT_IO_BLOCK 1048576
+#define DEFAULT_DIRECT_IO_DEPTH 4
+
+/* Global constants representing default policy for files sent through the page cache, bounds (in
+ * bytes) of its readahead window, and size of the smallest file whose pages are dropped once sent
+ * (see readPolicy.h). */
+#define DEFAULT_READ_POLICY 2
+#define DEFAULT_READAHEAD_MIN 131072
+#define DEFAULT_READAHEAD_MAX 16777216
+#define DEFAULT_DROP_BEHIND_MIN_SIZE 67108864
+
+/* Global constants representing default number and size (in bytes) of the buffers between the reader
+ * and the sender of files sent through the page cache (see sendPipeline.h). */
+#define DEFAULT_PIPELINE_DEPTH 4
+#define DEFAULT_PIPELINE_BUFFER 262144
+
+/* Global constants representing default size (in bytes) of the smallest file sent through a shared
+ * stream, and number of chunks in each stream's ring (see sharedStream.h). */
+#define DEFAULT_COALESCE_MIN_SIZE 67108864
+#define DEFAULT_COALESCE_RING 32
+
+/* Global constant representing default size (in bytes) of the smallest frame sent with MSG_ZEROCOPY
+ * (see zeroCopySend.h). */
+#define DEFAULT_ZEROCOPY_MIN_SIZE 65536
+
+/* Global constant representing whether TLS record encryption is handed to the kernel by default
+ * (see tlsTransport.h). */
+#define DEFAULT_TLS_KTLS 1
+
+/* Global constant representing maximum length of a line in the configuration file. */
+#define MAX_CONFIG_LINE 256
+
+/* Global constant representing the value of a string setting that turns it off. */
+#define CONFIG_NONE "none"
+
+/* Definition of struct containing all tunable server settings. Every field can be set in the
+ * configuration file using the key listed in configOptions in serverConfig.c. Rates are in
+ * bytes per second, with 0 meaning unlimited. String settings are empty when off. */
+struct ServerConfig
+{
+	unsigned long long totalRateLimit;	/* Bandwidth shared fairly by all active transfers. */
+	unsigned long long clientRateLimit;	/* Bandwidth shared by all transfers to one client host. */
+	unsigned long long transferRateLimit;	/* Bandwidth of any single transfer. */
+	unsigned long long rateBurst;		/* Bytes a transfer may send at once after being idle. */
+	unsigned long long intakeThreads;	/* Threads receiving requests (read at startup only). */
+	unsigned long long fastLaneThreads;	/* Threads serving listings and small files (startup only). */
+	unsigned long long bulkLaneSlots;	/* Threads serving large files (read at startup only). */
+	unsigned long long fastLaneMaxSize;	/* Files of at least this many bytes use the bulk lane. */
+	unsigned long long shards;		/* Processes serving requests (0 = one, unsharded; startup only). */
+	unsigned long long listenBacklog;	/* Maximum connections awaiting acceptance. */
+	unsigned long long maxSessions;		/* Maximum sessions admitted at once (0 = unlimited). */
+	unsigned long long busyRetryMs;		/* Delay suggested to clients turned away. */
+	unsigned long long handshakeTimeoutMs;	/* Time allowed to receive data port (0 = no limit). */
+	unsigned long long commandTimeoutMs;	/* Time allowed to receive request (0 = no limit). */
+	unsigned long long dataConnectTimeoutMs;	/* Time allowed to connect and validate data socket. */
+	unsigned long long sendStallTimeoutMs;	/* Time one send may wait for buffer space (0 = no limit). */
+	unsigned long long finalAckTimeoutMs;	/* Time allowed for client to close data socket. */
+	char traceFile[MAX_CONFIG_LINE];	/* File to which a record of each session is appended. */
+	unsigned long long tcpSampleIntervalMs;	/* Time between TCP samples of a transfer (0 = none). */
+	unsigned long long socketNodelay;	/* Set TCP_NODELAY on control and data sockets (0 or 1). */
+	unsigned long long socketFrameMore;	/* Send length prefixes with MSG_MORE (0 or 1). */
+	unsigned long long socketCork;		/* Cork data sockets while sending a file or listing (0 or 1). */
+	unsigned long long socketNotsentLowat;	/* TCP_NOTSENT_LOWAT of data sockets (0 = kernel default). */
+	unsigned long long socketBdpBuffers;	/* Size data send buffers from bandwidth-delay product (0 or 1). */
+	char socketCongestion[MAX_CONFIG_LINE];	/* Congestion control algorithm (empty = system default). */
+	char accessLog[MAX_CONFIG_LINE];	/* File to which access log is appended (empty = stdout). */
+	char unixSocket[MAX_CONFIG_LINE];	/* Path of Unix-domain socket for local clients (startup only). */
+	unsigned long long uploadWriteBlock;	/* Bytes of an upload received and written at a time. */
+	unsigned long long uploadWriteBehind;	/* Flush and drop uploads from the page cache as written (0 or 1). */
+	unsigned long long uploadFsync;		/* Sync uploads before commit: 0 none, 1 file, 2 file and directory. */
+	unsigned long long directIoMinSize;	/* Files of at least this many bytes bypass the page cache (0 = never). */
+	unsigned long long directIoBuffers;	/* Aligned buffers shared by direct reads (startup only). */
+	unsigned long long directIoBlock;	/* Bytes of each direct read and buffer (startup only). */
+	unsigned long long directIoDepth;	/* Direct reads each transfer keeps in flight. */
+	unsigned long long readPolicy;		/* Readahead policy: 0 kernel, 1 sequential, 2 adaptive. */
+	unsigned long long readaheadMin;	/* Smallest adaptive readahead window. */
+	unsigned long long readaheadMax;	/* Largest adaptive readahead window. */
+	unsigned long long dropBehindMinSize;	/* Files of at least this size leave the page cache once sent (0 = never). */
+	unsigned long long pipelineDepth;	/* Buffers between reader and sender (below 2 = no reader thread). */
+	unsigned long long pipelineBuffer;	/* Size of each of those buffers. */
+	unsigned long long zerocopyMinSize;	/* Frames of at least this size are sent with MSG_ZEROCOPY (0 = never). */
+	unsigned long long coalesceMinSize;	/* Files of at least this size are sent through shared streams (0 = never). */
+	unsigned long long coalesceRing;	/* Chunks (of pipelineBuffer bytes) in each shared stream's ring. */
+	char tlsCert[MAX_CONFIG_LINE];		/* PEM certificate chain; TLS is on if set (startup only). */
+	char tlsKey[MAX_CONFIG_LINE];		/* PEM private key, if not in tlsCert (startup only). */
+	unsigned long long tlsKtls;		/* Hand record encryption to the kernel (startup only). */
+};
+
+/* Global variable declarations. */
+extern char* configFilename;			/* CONFIG_FILE received on command line, or NULL. */
+
+/* Function prototypes. */
+struct ServerConfig* getServerConfig();
+int loadServerConfig(char* filename);
+
+#endif
@@ -0,0 +1,433 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverShards.c
+ * File Description: 	Implementation of functions for running the server as shards. See
+ * 			serverShards.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+/* Needed for CPU affinity and getcpu. */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <linux/filter.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "clientServerMessaging.h"
+#include "serverShards.h"
+
+/* Global constant representing number of nodes in the NUMA node mask passed to set_mempolicy. */
+#define MAX_NUMA_NODES 1024
+
+/* Global variable definitions. */
+int shardIndex = -1;				/* Number of this shard, or -1 if server is not sharded. */
+int numShards = 0;				/* Number of shards, or 0 if server is not sharded. */
+
+/* State kept by the supervising process: each shard's listening socket, the CPU it is pinned to,
+ * and the process ID of the process serving it (0 once it has exited). */
+static int shardSockets[MAX_SHARDS];
+static int shardCpus[MAX_SHARDS];
+static pid_t shardPids[MAX_SHARDS];
+
+/* Set by catchShardSignal in the supervising process: the signals to forward to the shards. */
+static volatile sig_atomic_t stopRequested = 0;
+static volatile sig_atomic_t reloadRequested = 0;
+static volatile sig_atomic_t statsRequested = 0;
+
+
+/***********************************************************************************************
+ * Function Name:	startShards
+ * Description:		Binds one listening socket per shard to serverPort with SO_REUSEPORT,
+ * 			chooses the CPU each shard is pinned to (the CPUs this process may run on,
+ * 			in turn), steers each connection to the shard on the CPU that received it
+ * 			when every shard's CPU number equals its shard number, and forks the
+ * 			shards. The calling process then supervises the shards until SIGINT is
+ * 			received; only the shards return.
+ * Receives: 		The port at which to listen, represented as a string, the number of shards,
+ * 			and the maximum number of connections awaiting acceptance by each shard.
+ * Returns: 		In each shard, the shard's listening socket. (The supervising process
+ * 			exits instead of returning.)
+ * Pre-Conditions: 	serverPort is a valid nonnegative integer, and shards is at least 1. No
+ * 			threads have been started.
+ * Post-Conditions: 	shardIndex and numShards identify the shard that returned, which has
+ * 			been pinned to its CPU.
+**********************************************************************************************/
+
+int startShards(char* serverPort, int shards, int backlog)
+{
+	if (shards > MAX_SHARDS)
+	{
+		fprintf(stderr, "SHARD ERROR: at most %d shards may be run; running %d.\n", MAX_SHARDS, MAX_SHARDS);
+		shards = MAX_SHARDS;
+	}
+	numShards = shards;
+
+	/* Bind every shard's socket before forking, so that an error binding exits before any shard
+	 * starts and so that a shard that is restarted keeps connections awaiting its socket. */
+	for (int i = 0; i < shards; i++)
+	{
+		shardSockets[i] = establishListeningSocket(serverPort, backlog, 1);
+	}
+
+	/* Assign CPUs in the order they appear in this process's affinity mask, noting whether shard i
+	 * landed on CPU i for every shard. */
+	cpu_set_t allowed;
+	int steerable = 1;
+	int numCpus = 0;
+	int cpuList[CPU_SETSIZE];
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1)
+	{
+		perror("SHARD ERROR: could not get CPU affinity");
+		CPU_ZERO(&allowed);
+	}
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (CPU_ISSET(cpu, &allowed))
+		{
+			cpuList[numCpus] = cpu;
+			numCpus++;
+		}
+	}
+	for (int i = 0; i < shards; i++)
+	{
+		shardCpus[i] = (numCpus > 0) ? cpuList[i % numCpus] : -1;
+		if (shardCpus[i] != i)
+		{
+			steerable = 0;
+		}
+	}
+	int steered = (steerable && attachShardSteering(shardSockets[0], shards) == 0);
+	printf("Server listening on port %s with %d shards%s.\n", serverPort, shards,
+		steered ? " (connections steered to the shard on the receiving CPU)" : "");
+
+	/* Forward SIGINT, SIGHUP, and SIGUSR1 to the shards. Shards register their own handlers. No
+	 * flags are set, so the signals interrupt waitpid in superviseShards. */
+	struct sigaction shard_action;
+	memset(&shard_action, 0, sizeof(struct sigaction));
+	shard_action.sa_handler = catchShardSignal;
+	sigfillset(&shard_action.sa_mask);
+	shard_action.sa_flags = 0;
+	sigaction(SIGINT, &shard_action, NULL);
+	sigaction(SIGHUP, &shard_action, NULL);
+	sigaction(SIGUSR1, &shard_action, NULL);
+
+	/* Fork shards, returning the listening socket in each one. */
+	for (int i = 0; i < shards; i++)
+	{
+		if (forkShard(i) == 0)
+		{
+			return shardSockets[i];
+		}
+	}
+
+	/* Supervise shards, returning only in a shard restarted by the supervisor. */
+	return superviseShards();
+}
+
+
+/***********************************************************************************************
+ * Function Name:	attachShardSteering
+ * Description:		Attaches a classic BPF program to the group of sockets sharing the
+ * 			listening port that hands each new connection to the socket whose index
+ * 			in the group is the number of the CPU that received the connection (modulo
+ * 			the number of shards), so a connection is accepted on the CPU whose caches
+ * 			already hold it.
+ * Receives: 		Any listening socket in the group, and the number of sockets in the group.
+ * Returns: 		0 on success; -1 upon error (the kernel's default hash is used instead).
+ * Pre-Conditions: 	Every socket in the group has been bound, in shard order.
+ * Post-Conditions: 	Upon success, connections are steered by CPU.
+**********************************************************************************************/
+
+int attachShardSteering(int listeningSocketFD, int shards)
+{
+	struct sock_filter code[] =
+	{
+		{ BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },	/* A = CPU number. */
+		{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, shards },			/* A = A % shards. */
+		{ BPF_RET | BPF_A, 0, 0, 0 }					/* Use socket A. */
+	};
+	struct sock_fprog program;
+	program.len = sizeof(code) / sizeof(code[0]);
+	program.filter = code;
+	if (setsockopt(listeningSocketFD, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == -1)
+	{
+		perror("SHARD ERROR: could not steer connections by CPU");
+		return -1;
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	placeShard
+ * Description:		Pins the calling process to the CPU chosen for a shard and makes the
+ * 			memory it allocates from then on come from that CPU's NUMA node where
+ * 			possible. Threads started later inherit both, so every allocation the
+ * 			shard makes is local to the CPU serving it. Failures are reported but
+ * 			not fatal.
+ * Receives: 		The shard number.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Called in the shard's process before it starts any threads.
+ * Post-Conditions: 	The process runs only on the shard's CPU.
+**********************************************************************************************/
+
+void placeShard(int shard)
+{
+	if (shardCpus[shard] < 0)
+	{
+		return;
+	}
+
+	/* Pin process to CPU. sched_setaffinity moves the process there before returning. */
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(shardCpus[shard], &cpuSet);
+	if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == -1)
+	{
+		fprintf(stderr, "SHARD ERROR: could not pin shard %d to CPU %d: %s\n", shard, shardCpus[shard], strerror(errno));
+		return;
+	}
+
+	/* Prefer the CPU's node for all allocations (falling back to other nodes when it is full). */
+	unsigned int cpu, node;
+	if (getcpu(&cpu, &node) == -1 || node >= MAX_NUMA_NODES)
+	{
+		return;
+	}
+	unsigned long nodeMask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))];
+	memset(nodeMask, 0, sizeof(nodeMask));
+	nodeMask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+	if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodeMask, MAX_NUMA_NODES) == -1)
+	{
+		fprintf(stderr, "SHARD ERROR: could not prefer NUMA node %u for shard %d: %s\n", node, shard, strerror(errno));
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	forkShard
+ * Description:		Forks the process serving a shard. In the new process, closes the other
+ * 			shards' sockets, places the shard on its CPU, and makes standard output line
+ * 			buffered so that lines printed by different shards are not interleaved.
+ * Receives: 		The shard number.
+ * Returns: 		0 in the new process; its process ID in the supervising process; -1 upon
+ * 			error (an error is printed).
+ * Pre-Conditions: 	Called by the supervising process.
+ * Post-Conditions: 	Unless an error occurred, the shard's process ID is in shardPids.
+**********************************************************************************************/
+
+pid_t forkShard(int shard)
+{
+	/* Flush output so that the new process does not print it again. */
+	fflush(stdout);
+	fflush(stderr);
+	pid_t pid = fork();
+	if (pid == -1)
+	{
+		fprintf(stderr, "SHARD ERROR: could not start shard %d: %s\n", shard, strerror(errno));
+		return -1;
+	}
+	if (pid > 0)
+	{
+		shardPids[shard] = pid;
+		return pid;
+	}
+
+	shardIndex = shard;
+	for (int i = 0; i < numShards; i++)
+	{
+		if (i != shard)
+		{
+			close(shardSockets[i]);
+		}
+	}
+	placeShard(shard);
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	superviseShards
+ * Description:		Waits for shards to exit, forwarding SIGHUP and SIGUSR1 to every shard.
+ * 			A shard killed by a signal is restarted on the same socket. Upon SIGINT,
+ * 			or when a shard exits on its own (a fatal error), every shard is sent
+ * 			SIGINT and the process exits once all have exited, with the exiting
+ * 			shard's status (or 0 upon SIGINT).
+ * Receives: 		nothing
+ * Returns: 		In a restarted shard, the shard's listening socket. (The supervising
+ * 			process exits instead of returning.)
+ * Pre-Conditions: 	startShards has forked the shards.
+ * Post-Conditions: 	Every shard has exited, or the caller is a restarted shard.
+**********************************************************************************************/
+
+int superviseShards()
+{
+	int exitStatus = 0;
+	int stopping = 0;
+	int remaining = numShards;
+	while (remaining > 0)
+	{
+		/* Forward signals received since the last iteration. */
+		int forwardSignal = 0;
+		if (stopRequested)
+		{
+			stopRequested = 0;
+			forwardSignal = SIGINT;
+		}
+		else if (reloadRequested)
+		{
+			reloadRequested = 0;
+			forwardSignal = SIGHUP;
+		}
+		else if (statsRequested)
+		{
+			statsRequested = 0;
+			forwardSignal = SIGUSR1;
+		}
+		for (int i = 0; forwardSignal != 0 && i < numShards; i++)
+		{
+			if (shardPids[i] > 0)
+			{
+				kill(shardPids[i], forwardSignal);
+			}
+		}
+		if (forwardSignal == SIGINT)
+		{
+			stopping = 1;
+		}
+		if (forwardSignal != 0)
+		{
+			continue;
+		}
+
+		/* Wait for a shard to exit, returning to the top of the loop when a signal is received. */
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid == -1)
+		{
+			if (errno == ECHILD)
+			{
+				break;
+			}
+			continue;
+		}
+		int shard = 0;
+		while (shard < numShards && shardPids[shard] != pid)
+		{
+			shard++;
+		}
+		if (shard == numShards)
+		{
+			continue;
+		}
+		shardPids[shard] = 0;
+		remaining--;
+
+		/* Restart a shard that crashed, unless the server is stopping. */
+		if (WIFSIGNALED(status) && !stopping)
+		{
+			fprintf(stderr, "SHARD ERROR: shard %d was killed by signal %d; restarting it.\n", shard, WTERMSIG(status));
+			if (forkShard(shard) == 0)
+			{
+				return shardSockets[shard];
+			}
+			if (shardPids[shard] > 0)
+			{
+				remaining++;
+			}
+			continue;
+		}
+
+		/* Otherwise, stop the remaining shards, keeping the status of the first shard to exit on its own. */
+		if (!stopping)
+		{
+			exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : 3;
+			stopRequested = 1;
+		}
+	}
+	exit(exitStatus);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	catchShardSignal
+ * Description:		Signal handler for SIGINT, SIGHUP, and SIGUSR1 in the supervising process.
+ * 			Sets the flag telling superviseShards which signal to forward to the shards.
+ * Receives: 		The number of the signal received.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The signal has been received.
+ * Post-Conditions: 	The flag corresponding to signo is set.
+**********************************************************************************************/
+
+void catchShardSignal(int signo)
+{
+	if (signo == SIGINT)
+	{
+		stopRequested = 1;
+	}
+	else if (signo == SIGHUP)
+	{
+		reloadRequested = 1;
+	}
+	else
+	{
+		statsRequested = 1;
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	shardName
+ * Description:		Makes the name a shard uses for a file or segment that each process
+ * 			serving requests has its own of, by appending the shard number to name
+ * 			(unchanged if the server is not sharded or name is empty).
+ * Receives: 		The name, and a buffer of size characters in which to write the shard's name.
+ * Returns: 		nothing
+ * Pre-Conditions: 	buffer is at least as long as name plus 5 characters.
+ * Post-Conditions: 	buffer holds the shard's name.
+**********************************************************************************************/
+
+void shardName(char* name, char* buffer, size_t size)
+{
+	if (shardIndex < 0 || name[0] == '\0')
+	{
+		snprintf(buffer, size, "%s", name);
+	}
+	else
+	{
+		snprintf(buffer, size, SHARD_NAME_FORMAT, name, shardIndex);
+	}
+}
@@ -0,0 +1,66 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverShards.h
+ * File Description: 	Header file for running the server as shards. When the configuration sets
+ * 			shards, the process started from the command line only supervises: it binds
+ * 			one listening socket per shard to SERVER_PORT with SO_REUSEPORT, so that the
+ * 			kernel spreads incoming connections across them, and forks one shard per
+ * 			socket. Each shard is a complete server with its own socket, threads, and
+ * 			statistics segment, pinned to one CPU and allocating memory from that CPU's
+ * 			NUMA node, so that shards share no data while serving requests.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SERVER_SHARDS
+#define SERVER_SHARDS
+
+#include <signal.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/* Global constant representing maximum number of shards. */
+#define MAX_SHARDS 256
+
+/* Global constant representing format of a shard's name (SERVER_PORT followed by the shard number),
+ * used to name its statistics segment and the files it writes. */
+#define SHARD_NAME_FORMAT "%s.%d"
+
+/* Global variable declarations. */
+extern int shardIndex;				/* Number of this shard, or -1 if server is not sharded. */
+extern int numShards;				/* Number of shards, or 0 if server is not sharded. */
+
+/* Function prototypes. */
+int startShards(char* serverPort, int shards, int backlog);
+int attachShardSteering(int listeningSocketFD, int shards);
+void placeShard(int shard);
+pid_t forkShard(int shard);
+int superviseShards();
+void catchShardSignal(int signo);
+void shardName(char* name, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,216 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverStats.c
+ * File Description: 	Implementation of functions for publishing server counters in shared
+ * 			memory and reporting them.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "requestScheduler.h"
+#include "serverConfig.h"
+#include "serverShards.h"
+#include "serverStats.h"
+
+/* Global variable definitions. */
+static struct ServerStats localStats;		/* Counters used until (or if) shared segment is mapped. */
+struct ServerStats* serverStats = &localStats;	/* Server counters, all initially 0. */
+static char segmentName[STATS_SEGMENT_NAME_LEN];	/* Name of shared segment, or empty if none. */
+
+
+/***********************************************************************************************
+ * Function Name:	openStatsSegment
+ * Description:		Creates (or replaces) the shared-memory segment named after the server
+ * 			port, maps it, and points serverStats at it so that every counter
+ * 			update is visible to ftstat without any further work on the hot path.
+ * Receives: 		The port the server listens on, as a string.
+ * Returns: 		0 on success; -1 on failure, in which case counters are still kept
+ * 			(in process memory) and printed on SIGUSR1, but ftstat cannot read them.
+ * Pre-Conditions: 	No other thread has been started yet.
+ * Post-Conditions: 	If 0 is returned, serverStats points to the initialized shared segment.
+**********************************************************************************************/
+
+int openStatsSegment(char* serverPort)
+{
+	/* Create segment readable by any user, sized to hold struct ServerStats. */
+	char name[STATS_SEGMENT_NAME_LEN];
+	snprintf(name, sizeof(name), STATS_SEGMENT_FORMAT, serverPort);
+	int segmentFD = shm_open(name, O_CREAT | O_RDWR, 0644);
+	if (segmentFD < 0)
+	{
+		perror("STATS SEGMENT ERROR");
+		return -1;
+	}
+	if (ftruncate(segmentFD, sizeof(struct ServerStats)) < 0)
+	{
+		perror("STATS SEGMENT ERROR");
+		close(segmentFD);
+		shm_unlink(name);
+		return -1;
+	}
+
+	/* Map segment, closing descriptor since the mapping keeps the segment alive. */
+	struct ServerStats* sharedStats = mmap(NULL, sizeof(struct ServerStats), PROT_READ | PROT_WRITE,
+		MAP_SHARED, segmentFD, 0);
+	close(segmentFD);
+	if (sharedStats == MAP_FAILED)
+	{
+		perror("STATS SEGMENT ERROR");
+		shm_unlink(name);
+		return -1;
+	}
+
+	/* Copy any counters and command names recorded so far, fill in header, and publish
+	 * magic number last so readers never see a partially initialized segment. */
+	memcpy(sharedStats, &localStats, sizeof(struct ServerStats));
+	sharedStats->version = STATS_VERSION;
+	sharedStats->serverPid = getpid();
+	sharedStats->startTime = time(NULL);
+	__atomic_store_n(&sharedStats->magic, STATS_MAGIC, __ATOMIC_RELEASE);
+	serverStats = sharedStats;
+	strcpy(segmentName, name);
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	closeStatsSegment
+ * Description:		Removes the shared-memory segment name so that ftstat reports that
+ * 			the server is no longer running.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	The segment (if one was created) has been unlinked.
+**********************************************************************************************/
+
+void closeStatsSegment()
+{
+	if (segmentName[0] != '\0')
+	{
+		shm_unlink(segmentName);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	setStatsCommandName
+ * Description:		Records the syntax of the command counted in commandCounts[index].
+ * Receives: 		The index of the command and its syntax.
+ * Returns: 		nothing
+ * Pre-Conditions: 	index is less than STATS_MAX_COMMANDS.
+ * Post-Conditions: 	commandNames[index] holds name (truncated if necessary).
+**********************************************************************************************/
+
+void setStatsCommandName(int index, char* name)
+{
+	snprintf(serverStats->commandNames[index], STATS_COMMAND_NAME_LEN, "%s", name);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	dumpServerStats
+ * Description:		Prints server counters and the current depth of every queue a connection
+ * 			may wait in: the kernel's queue of connections awaiting accept (read
+ * 			from TCP_INFO on the listening socket) and each scheduler queue.
+ * Receives: 		The stream to print to and the listening socket file descriptor.
+ * Returns: 		nothing
+ * Pre-Conditions: 	listeningSocketFD represents a socket activated for listening.
+ * Post-Conditions: 	Counters have been printed to out.
+**********************************************************************************************/
+
+void dumpServerStats(FILE* out, int listeningSocketFD)
+{
+	/* Get depths of scheduler queues. */
+	int intakeDepth, fastDepth, bulkDepth, sharedDepth;
+	getQueueDepths(&intakeDepth, &fastDepth, &bulkDepth, &sharedDepth);
+
+	if (shardIndex >= 0)
+	{
+		fprintf(out, "=== ftserver statistics (shard %d of %d) ===\n", shardIndex, numShards);
+	}
+	else
+	{
+		fprintf(out, "=== ftserver statistics ===\n");
+	}
+	fprintf(out, "Sessions accepted: %llu\n", STAT_GET(sessionsAccepted));
+	fprintf(out, "Sessions rejected (busy): %llu\n", STAT_GET(sessionsRejected));
+	fprintf(out, "Active sessions: %llu of %llu allowed\n", STAT_GET(activeSessions), getServerConfig()->maxSessions);
+	fprintf(out, "Transfers: %llu active, %llu completed, %llu bytes sent\n",
+		STAT_GET(activeTransfers), STAT_GET(completedTransfers), STAT_GET(bytesSent));
+	fprintf(out, "Files passed to local clients: %llu, %llu bytes\n", STAT_GET(filesPassed), STAT_GET(bytesPassed));
+	fprintf(out, "Files received from clients: %llu, %llu bytes\n", STAT_GET(filesReceived), STAT_GET(bytesReceived));
+	fprintf(out, "Files sent with direct I/O: %llu, %llu bytes\n", STAT_GET(filesReadDirect), STAT_GET(bytesReadDirect));
+	fprintf(out, "TLS handshakes: %llu completed (%llu with kernel encryption), %llu failed\n",
+		STAT_GET(tlsHandshakes), STAT_GET(tlsKernelSends), STAT_GET(tlsHandshakeFailures));
+	fprintf(out, "Zero-copy sends: %llu, %llu bytes (%llu completed by copying); %llu transfers failed waiting\n",
+		STAT_GET(zeroCopySends), STAT_GET(zeroCopyBytes), STAT_GET(zeroCopyCopied), STAT_GET(zeroCopyFailures));
+	fprintf(out, "Shared streams: %llu started, %llu transfers joined; chunks %llu from ring, %llu read privately\n",
+		STAT_GET(sharedStreams), STAT_GET(coalescedTransfers), STAT_GET(sharedChunks), STAT_GET(privateChunks));
+	fprintf(out, "Failures: handshake %llu, invalid request %llu, data connection %llu\n",
+		STAT_GET(handshakeFailures), STAT_GET(invalidRequests), STAT_GET(validationFailures));
+	fprintf(out, "Timeouts: handshake %llu, command %llu, data connect %llu, send stall %llu, final ack %llu\n",
+		STAT_GET(handshakeTimeouts), STAT_GET(commandTimeouts), STAT_GET(dataConnectTimeouts),
+		STAT_GET(sendStallTimeouts), STAT_GET(finalAckTimeouts));
+
+	/* Print request count of each command, then count of each error seen. */
+	fprintf(out, "Requests:");
+	for (int i = 0; i < STATS_MAX_COMMANDS && serverStats->commandNames[i][0] != '\0'; i++)
+	{
+		fprintf(out, " %s %llu", serverStats->commandNames[i], STAT_GET(commandCounts[i]));
+	}
+	fprintf(out, "\n");
+	for (int i = 0; i < STATS_MAX_ERRNO; i++)
+	{
+		unsigned long long errorCount = STAT_GET(errorsByErrno[i]);
+		if (errorCount > 0)
+		{
+			fprintf(out, "Errors (%s): %llu\n", (i == 0) ? "other" : strerror(i), errorCount);
+		}
+	}
+
+	/* For a listening socket, TCP_INFO reports the number of connections awaiting accept in
+	 * tcpi_unacked and the backlog in tcpi_sacked. */
+	struct tcp_info listenInfo;
+	socklen_t infoLen = sizeof(listenInfo);
+	if (getsockopt(listeningSocketFD, IPPROTO_TCP, TCP_INFO, &listenInfo, &infoLen) == 0)
+	{
+		fprintf(out, "Awaiting accept: %u of %u backlog\n", listenInfo.tcpi_unacked, listenInfo.tcpi_sacked);
+	}
+	fprintf(out, "Queue depth: intake %d, fast lane %d, bulk lane %d, shared lane %d\n",
+		intakeDepth, fastDepth, bulkDepth, sharedDepth);
+	printTcpStats(out, serverStats);
+	printLatencyPercentiles(out, serverStats);
+	fflush(out);
+}
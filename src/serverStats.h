@@ -0,0 +1,129 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		serverStats.h
+ * File Description: 	Header file for counters describing server load and activity. Counters are
+ * 			updated with atomic operations so that any thread may update them without
+ * 			taking a lock, and are printed when the server receives a SIGUSR1. Counters
+ * 			live in a shared-memory segment named after the server port so that ftstat
+ * 			can read them while the server runs, along with latency histograms (see
+ * 			latencyHistogram.h).
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SERVER_STATS
+#define SERVER_STATS
+
+#include <stdio.h>
+#include "latencyHistogram.h"
+#include "tcpSampler.h"
+
+/* Macros for updating and reading a counter in serverStats from any thread. */
+#define STAT_ADD(counter, amount) __atomic_add_fetch(&serverStats->counter, (amount), __ATOMIC_RELAXED)
+#define STAT_SUB(counter, amount) __atomic_sub_fetch(&serverStats->counter, (amount), __ATOMIC_RELAXED)
+#define STAT_GET(counter) __atomic_load_n(&serverStats->counter, __ATOMIC_RELAXED)
+
+/* Macro counting an error by its errno value. Values of 0 or too large for errorsByErrno are
+ * counted in errorsByErrno[0]. */
+#define STAT_ERRNO(errnum) STAT_ADD(errorsByErrno[((errnum) > 0 && (errnum) < STATS_MAX_ERRNO) ? (errnum) : 0], 1)
+
+/* Global constants describing the shared-memory segment: its name (formatted with the server
+ * port), a magic number and version that readers check before trusting its layout, the number
+ * of commands and errno values counted individually, and the max length of a command name. */
+#define STATS_SEGMENT_FORMAT "/ftserver.%s"
+#define STATS_SEGMENT_NAME_LEN 32
+#define STATS_MAGIC 0x46545354u
+#define STATS_VERSION 9
+#define STATS_MAX_COMMANDS 8
+#define STATS_MAX_ERRNO 136
+#define STATS_COMMAND_NAME_LEN 8
+
+/* Definition of struct containing server counters. See below for variable descriptions. The
+ * header fields are written once at startup; every other field is updated only through the
+ * macros above. */
+struct ServerStats
+{
+	unsigned int magic;			/* STATS_MAGIC once the segment is initialized. */
+	unsigned int version;			/* STATS_VERSION of the layout below. */
+	long long serverPid;			/* Process ID of the server writing the segment. */
+	long long startTime;			/* Time (seconds since the epoch) the server started. */
+	unsigned long long sessionsAccepted;	/* Connections admitted and submitted to the scheduler. */
+	unsigned long long sessionsRejected;	/* Connections turned away because server was busy. */
+	unsigned long long activeSessions;	/* Admitted connections not yet deleted. */
+	unsigned long long activeTransfers;	/* Requests whose handler is currently running. */
+	unsigned long long completedTransfers;	/* Requests whose handler has returned. */
+	unsigned long long bytesSent;		/* Bytes of file and listing data sent to clients. */
+	unsigned long long handshakeFailures;	/* Sessions ending before a valid DATA_PORT message. */
+	unsigned long long invalidRequests;	/* Requests rejected by the command parser. */
+	unsigned long long validationFailures;	/* Data connections not established and validated. */
+	unsigned long long handshakeTimeouts;	/* Sessions aborted waiting for the data port. */
+	unsigned long long commandTimeouts;	/* Sessions aborted waiting for the request. */
+	unsigned long long dataConnectTimeouts;	/* Sessions aborted connecting or validating data socket. */
+	unsigned long long sendStallTimeouts;	/* Sends aborted waiting for the client to read. */
+	unsigned long long finalAckTimeouts;	/* Sessions aborted waiting for client to close data socket. */
+	char commandNames[STATS_MAX_COMMANDS][STATS_COMMAND_NAME_LEN];	/* Syntax of each counted command. */
+	unsigned long long commandCounts[STATS_MAX_COMMANDS];	/* Valid requests received per command. */
+	unsigned long long errorsByErrno[STATS_MAX_ERRNO];	/* Errors reported, indexed by errno. */
+	unsigned long long latencyCounts[NUM_PHASES][STATS_MAX_COMMANDS + 1][LATENCY_BUCKETS];	/* Latency
+						 * histograms by phase and command index (STATS_MAX_COMMANDS
+						 * for sessions without a valid command). */
+	unsigned long long transfersByBottleneck[NUM_TCP_BOTTLENECKS];	/* File transfers by bottleneck. */
+	unsigned long long tcpElapsedUs;	/* Time file transfers took. */
+	unsigned long long tcpBusyUs;		/* Time file transfers' sockets had data to send. */
+	unsigned long long tcpRwndLimitedUs;	/* Time file transfers were limited by receiver's window. */
+	unsigned long long tcpSndbufLimitedUs;	/* Time file transfers were limited by send buffer. */
+	unsigned long long tcpRetransSegs;	/* Segments file transfers retransmitted. */
+	unsigned long long rttCounts[LATENCY_BUCKETS];	/* Histogram of round-trip times (ns) sampled. */
+	unsigned long long filesPassed;		/* Files passed to local clients as descriptors. */
+	unsigned long long bytesPassed;		/* Size of files passed to local clients. */
+	unsigned long long filesReceived;	/* Files uploaded by clients and committed. */
+	unsigned long long bytesReceived;	/* Bytes of uploads received from clients. */
+	unsigned long long filesReadDirect;	/* Files sent with direct I/O. */
+	unsigned long long bytesReadDirect;	/* Bytes of files sent with direct I/O. */
+	unsigned long long tlsHandshakes;	/* TLS handshakes completed. */
+	unsigned long long tlsKernelSends;	/* TLS handshakes after which the kernel encrypted sends. */
+	unsigned long long tlsHandshakeFailures;	/* TLS handshakes that failed or timed out. */
+	unsigned long long zeroCopySends;	/* Frames sent with MSG_ZEROCOPY. */
+	unsigned long long zeroCopyBytes;	/* Bytes of those frames. */
+	unsigned long long zeroCopyCopied;	/* Zero-copy sends the kernel completed by copying anyway. */
+	unsigned long long zeroCopyFailures;	/* Transfers dropped waiting for zero-copy sends to complete. */
+	unsigned long long sharedStreams;	/* Shared streams started. */
+	unsigned long long coalescedTransfers;	/* Transfers that joined a shared stream already started. */
+	unsigned long long sharedChunks;	/* Chunks sent from a shared stream's ring. */
+	unsigned long long privateChunks;	/* Chunks of shared streams that transfers read themselves. */
+};
+
+/* Global variable declarations. */
+extern struct ServerStats* serverStats;
+
+/* Function prototypes. */
+int openStatsSegment(char* serverPort);
+void closeStatsSegment();
+void setStatsCommandName(int index, char* name);
+void dumpServerStats(FILE* out, int listeningSocketFD);
+
+#endif
@@ -0,0 +1,177 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sessionTrace.c
+ * File Description: 	Implementation of functions for writing session traces. See sessionTrace.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include "commandRegistry.h"
+#include "FTInfo.h"
+#include "serverConfig.h"
+#include "sessionTrace.h"
+
+/* Global constant representing size of the buffer records are written through. */
+#define TRACE_BUFFER_SIZE 65536
+
+/* Static variables describing the open trace. traceLock is held while writing a record and while
+ * opening or closing the trace, so records from different threads never interleave. Records still
+ * buffered when the server exits upon SIGINT are written by exit, which flushes every stream. */
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* traceFile = NULL;			/* Trace being written, or NULL if tracing is off. */
+static char traceFilename[MAX_CONFIG_LINE];	/* Name of trace being written. */
+static unsigned long long traceStartNs = 0;	/* Monotonic time at which trace was opened. */
+
+
+/***********************************************************************************************
+ * Function Name:	openSessionTrace
+ * Description:		Starts writing session records to the named file (creating it, or
+ * 			replacing it if it exists), or stops tracing if filename is empty. Does
+ * 			nothing if filename names the trace already being written, so reloading
+ * 			an unchanged configuration does not restart the trace.
+ * Receives: 		The name of the trace file, or an empty string.
+ * Returns: 		0 on success; -1 if the file could not be opened (tracing is then off).
+ * Pre-Conditions: 	filename is shorter than MAX_CONFIG_LINE.
+ * Post-Conditions: 	Sessions finishing from now on are recorded in filename (if not empty).
+**********************************************************************************************/
+
+int openSessionTrace(char* filename)
+{
+	pthread_mutex_lock(&traceLock);
+	if (traceFile != NULL && strcmp(filename, traceFilename) == 0)
+	{
+		pthread_mutex_unlock(&traceLock);
+		return 0;
+	}
+
+	/* Close any trace already open. */
+	if (traceFile != NULL)
+	{
+		fclose(traceFile);
+		traceFile = NULL;
+	}
+	traceFilename[0] = '\0';
+	int result = 0;
+
+	/* Open new trace and write its header. */
+	if (filename[0] != '\0')
+	{
+		traceFile = fopen(filename, "wb");
+		if (traceFile == NULL)
+		{
+			fprintf(stderr, "TRACE ERROR: could not open %s: %s\n", filename, strerror(errno));
+			result = -1;
+		}
+		else
+		{
+			setvbuf(traceFile, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+			struct TraceHeader header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+			header.version = TRACE_VERSION;
+			header.recordSize = sizeof(struct TraceRecord);
+			header.startTime = time(NULL);
+			fwrite(&header, sizeof(header), 1, traceFile);
+			strcpy(traceFilename, filename);
+			traceStartNs = monotonicNs();
+		}
+	}
+	pthread_mutex_unlock(&traceLock);
+	return result;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	closeSessionTrace
+ * Description:		Writes any buffered records and closes the trace.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	Tracing is off, and every record has been written to the file.
+**********************************************************************************************/
+
+void closeSessionTrace()
+{
+	openSessionTrace("");
+}
+
+
+/***********************************************************************************************
+ * Function Name:	traceSession
+ * Description:		Appends a record of a finished session to the trace, if tracing is on.
+ * 			Records are buffered, so this costs a memory copy for most sessions.
+ * Receives: 		A struct FTInfo pointer for the session.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The session's phase times are final.
+ * Post-Conditions: 	The session has been recorded (if tracing is on).
+**********************************************************************************************/
+
+void traceSession(struct FTInfo* myFT)
+{
+	/* Skip building record entirely if tracing is off. */
+	if (__atomic_load_n(&traceFile, __ATOMIC_RELAXED) == NULL)
+	{
+		return;
+	}
+
+	/* Build record. A valid request was tokenized in place, so rebuild it from its command, filename, and
+	 * the size a command taking a second argument (as PUT_FILE does) was parsed into; otherwise keep
+	 * whatever part of the request was received. */
+	struct TraceRecord record;
+	memset(&record, 0, sizeof(record));
+	memcpy(record.phaseNs, myFT->phaseNs, sizeof(record.phaseNs));
+	record.phasesMarked = myFT->phasesMarked;
+	record.command = (myFT->handler != NULL) ? commandIndex(myFT->handler) : STATS_MAX_COMMANDS;
+	record.requestSize = myFT->requestSize;
+	record.bytesSent = myFT->bytesSent;
+	if (myFT->command != NULL)
+	{
+		int requestLen = snprintf(record.request, sizeof(record.request), "%s%s%s", myFT->command,
+			(myFT->filename != NULL) ? " " : "", (myFT->filename != NULL) ? myFT->filename : "");
+		if (myFT->handler != NULL && myFT->handler->arity > 1 && requestLen < (int)sizeof(record.request))
+		{
+			snprintf(record.request + requestLen, sizeof(record.request) - requestLen, " %lld",
+				(long long)myFT->requestSize);
+		}
+	}
+	else if (myFT->request != NULL)
+	{
+		snprintf(record.request, sizeof(record.request), "%s", myFT->request);
+	}
+
+	/* Write record if tracing is still on, timing acceptance from start of the current trace. */
+	pthread_mutex_lock(&traceLock);
+	if (traceFile != NULL)
+	{
+		record.acceptedAt = (myFT->acceptedAt > traceStartNs) ? myFT->acceptedAt - traceStartNs : 0;
+		fwrite(&record, sizeof(record), 1, traceFile);
+	}
+	pthread_mutex_unlock(&traceLock);
+}
@@ -0,0 +1,83 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sessionTrace.h
+ * File Description: 	Header file for session traces. When trace_file is set in the
+ * 			configuration file, the server appends one fixed-size binary record per
+ * 			finished session to it: when the session was accepted, what was
+ * 			requested, how large the file and the transfer were, and the time spent
+ * 			in each phase. ftreplay reads these records to replay the same traffic
+ * 			against a test server.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SESSION_TRACE
+#define SESSION_TRACE
+
+#include <stdint.h>
+#include "latencyHistogram.h"
+#include "serverStats.h"
+
+/* Global constants identifying a trace file and its layout, and the max length of a request
+ * kept in a record (longer requests are truncated). */
+#define TRACE_MAGIC "FTTRACE\n"
+#define TRACE_VERSION 1
+#define TRACE_MAX_REQUEST 64
+
+/* Definition of struct written once at the start of every trace file. */
+struct TraceHeader
+{
+	char magic[8];			/* TRACE_MAGIC (not null-terminated). */
+	uint32_t version;		/* TRACE_VERSION. */
+	uint32_t recordSize;		/* sizeof(struct TraceRecord). */
+	int64_t startTime;		/* Time (seconds since the epoch) the trace was started. */
+};
+
+/* Definition of struct recording one session. Every field has a fixed width so that traces can
+ * be read by any build of ftreplay. */
+struct TraceRecord
+{
+	uint64_t acceptedAt;		/* Nanoseconds from start of trace until session was accepted. */
+	uint64_t phaseNs[NUM_PHASES];	/* Time spent in each phase (0 if phase was not reached). */
+	uint32_t phasesMarked;		/* Bit mask of phases reached. */
+	uint8_t command;		/* Command index in registry, or STATS_MAX_COMMANDS if invalid. */
+	uint8_t reserved[3];		/* Padding, always 0. */
+	int64_t requestSize;		/* Size of file requested, or -1 if unknown or not applicable. */
+	uint64_t bytesSent;		/* Bytes sent over data connection. */
+	char request[TRACE_MAX_REQUEST];	/* Request as received (command and arguments separated by
+					 * spaces), null-terminated; empty if none was received. */
+};
+
+/* Forward declaration of struct describing a session (see FTInfo.h). */
+struct FTInfo;
+
+/* Function prototypes. */
+int openSessionTrace(char* filename);
+void closeSessionTrace();
+void traceSession(struct FTInfo* myFT);
+
+#endif
@@ -0,0 +1,635 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sharedStream.c
+ * File Description: 	Implementation of request coalescing through shared streams. See
+ * 			sharedStream.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include "manageConnections.h"
+#include "sharedStream.h"
+
+/* Static variables. */
+static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;	/* Protects files and every entry. */
+static struct SharedFile* files = NULL;		/* Files being downloaded, as a linked list. */
+
+/* Function prototypes of static functions. */
+static void releaseSharedFile(struct SharedFile* file);
+static void dropSharedPages(struct SharedStream* stream);
+static void freeSharedStream(struct SharedStream* stream);
+static int readSharedChunk(int fileFD, char* data, int len, unsigned long long offset);
+
+
+/***********************************************************************************************
+ * Function Name:	enterSharedFile
+ * Description:		Counts a download of a file of at least coalesce_min_size bytes among
+ * 			the downloads of that file in progress, registering the file if it is the
+ * 			first.
+ * Receives: 		A struct FTInfo pointer for the download and the file's status.
+ * Returns: 		The number of downloads of the file in progress, including this one, or 0 if
+ * 			the download is not counted (coalesce_min_size is 0, or the file is not a
+ * 			regular file or is too small).
+ * Pre-Conditions: 	myFT->sharedFile is NULL.
+ * Post-Conditions: 	If the download was counted, myFT->sharedFile points to the file's entry,
+ * 			and leaveSharedFile must be called once the download is finished.
+**********************************************************************************************/
+
+int enterSharedFile(struct FTInfo* myFT, struct stat* fileInfo)
+{
+	/* Check that coalescing is enabled and the file is large enough. */
+	unsigned long long minSize = getServerConfig()->coalesceMinSize;
+	if (minSize == 0 || !S_ISREG(fileInfo->st_mode) || (unsigned long long)fileInfo->st_size < minSize)
+	{
+		return 0;
+	}
+
+	/* Count download under the entry of the same file, or a new entry if there is none. */
+	pthread_mutex_lock(&registryLock);
+	struct SharedFile* file = files;
+	while (file != NULL && (file->device != fileInfo->st_dev || file->inode != fileInfo->st_ino
+		|| file->size != (unsigned long long)fileInfo->st_size
+		|| file->modified.tv_sec != fileInfo->st_mtim.tv_sec
+		|| file->modified.tv_nsec != fileInfo->st_mtim.tv_nsec))
+	{
+		file = file->next;
+	}
+	if (file == NULL)
+	{
+		file = (struct SharedFile*)calloc(1, sizeof(struct SharedFile));
+		if (file == NULL)
+		{
+			pthread_mutex_unlock(&registryLock);
+			return 0;
+		}
+		file->device = fileInfo->st_dev;
+		file->inode = fileInfo->st_ino;
+		file->size = fileInfo->st_size;
+		file->modified = fileInfo->st_mtim;
+		file->next = files;
+		files = file;
+	}
+	int transfers = ++file->transfers;
+	pthread_mutex_unlock(&registryLock);
+	myFT->sharedFile = file;
+	return transfers;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	leaveSharedFile
+ * Description:		Stops counting a download among the downloads of its file, removing the
+ * 			file's entry if no download or stream uses it any more.
+ * Receives: 		A struct FTInfo pointer.
+ * Returns: 		nothing
+ * Pre-Conditions: 	myFT has left any stream it joined.
+ * Post-Conditions: 	myFT->sharedFile is NULL.
+**********************************************************************************************/
+
+void leaveSharedFile(struct FTInfo* myFT)
+{
+	if (myFT->sharedFile == NULL)
+	{
+		return;
+	}
+	pthread_mutex_lock(&registryLock);
+	myFT->sharedFile->transfers--;
+	releaseSharedFile(myFT->sharedFile);
+	pthread_mutex_unlock(&registryLock);
+	myFT->sharedFile = NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	joinSharedStream
+ * Description:		If another download of the file opened is in progress, joins the stream
+ * 			being produced for the file or, if there is none, starts one (with its
+ * 			producer thread) for later downloads to join.
+ * Receives: 		A struct FTInfo pointer and the file opened for it.
+ * Returns: 		The stream joined, or NULL if the file is to be sent on its own (the download
+ * 			was not counted by enterSharedFile, the file opened is not the one counted,
+ * 			no other download of it is in progress, or the stream could not be started).
+ * Pre-Conditions: 	fileFD is open for reading.
+ * Post-Conditions: 	If a stream is returned, the caller must leave it with leaveSharedStream.
+**********************************************************************************************/
+
+struct SharedStream* joinSharedStream(struct FTInfo* myFT, int fileFD)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Check that the file opened is the one counted (it may have been replaced since). */
+	struct SharedFile* file = myFT->sharedFile;
+	struct stat fileInfo;
+	if (file == NULL || fstat(fileFD, &fileInfo) == -1 || file->device != fileInfo.st_dev
+		|| file->inode != fileInfo.st_ino || file->size != (unsigned long long)fileInfo.st_size
+		|| file->modified.tv_sec != fileInfo.st_mtim.tv_sec || file->modified.tv_nsec != fileInfo.st_mtim.tv_nsec)
+	{
+		return NULL;
+	}
+
+	/* Send file on its own unless another download of it is in progress, and join its stream if one
+	 * is being produced. Its producer clears file->stream (holding registryLock) as it stops. */
+	pthread_mutex_lock(&registryLock);
+	if (file->transfers < 2)
+	{
+		pthread_mutex_unlock(&registryLock);
+		return NULL;
+	}
+	if (file->stream != NULL)
+	{
+		struct SharedStream* stream = file->stream;
+		pthread_mutex_lock(&stream->lock);
+		stream->consumers++;
+		pthread_mutex_unlock(&stream->lock);
+		pthread_mutex_unlock(&registryLock);
+		STAT_ADD(coalescedTransfers, 1);
+		return stream;
+	}
+
+	/* Otherwise, size ring from settings and allocate stream, with a descriptor of its own for the
+	 * producer. */
+	unsigned long long chunkSize = config->pipelineBuffer;
+	chunkSize = (chunkSize < 1) ? 1 : (chunkSize > MAX_PIPELINE_BUFFER) ? MAX_PIPELINE_BUFFER : chunkSize;
+	unsigned long long depth = config->coalesceRing;
+	depth = (depth < 1) ? 1 : (depth > MAX_COALESCE_RING) ? MAX_COALESCE_RING : depth;
+	struct SharedStream* stream = (struct SharedStream*)calloc(1, sizeof(struct SharedStream));
+	char* memory = (char*)malloc(depth * chunkSize);
+	int producerFD = dup(fileFD);
+	if (stream == NULL || memory == NULL || producerFD == -1)
+	{
+		pthread_mutex_unlock(&registryLock);
+		free(stream);
+		free(memory);
+		if (producerFD != -1)
+		{
+			close(producerFD);
+		}
+		return NULL;
+	}
+
+	/* Initialize stream, with no chunk produced yet and the caller as its only consumer. Its pages are
+	 * dropped behind by the transfers rather than by the producer, since the producer runs ahead of
+	 * every transfer. */
+	pthread_mutex_init(&stream->lock, NULL);
+	pthread_cond_init(&stream->changed, NULL);
+	stream->file = file;
+	stream->size = file->size;
+	stream->fileFD = producerFD;
+	beginReadPolicy(&stream->readPolicy, producerFD);
+	stream->dropBehind = stream->readPolicy.dropBehind;
+	stream->readPolicy.dropBehind = 0;
+	stream->depth = (int)depth;
+	stream->chunkSize = (int)chunkSize;
+	stream->numChunks = (stream->size + chunkSize - 1) / chunkSize;
+	for (int i = 0; i < stream->depth; i++)
+	{
+		stream->ring[i].data = memory + i * chunkSize;
+		stream->ring[i].seq = NO_SHARED_CHUNK;
+	}
+	stream->consumers = 1;
+	stream->producing = 1;
+
+	/* Start producer, and register stream under the file. */
+	int createResult = pthread_create(&stream->producer, NULL, produceSharedStream, stream);
+	if (createResult != 0)
+	{
+		pthread_mutex_unlock(&registryLock);
+		logEvent(LOG_STREAM_FAILED, myFT, strerror(createResult), 0);
+		freeSharedStream(stream);
+		return NULL;
+	}
+	pthread_detach(stream->producer);
+	file->stream = stream;
+	pthread_mutex_unlock(&registryLock);
+	STAT_ADD(sharedStreams, 1);
+	return stream;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	leaveSharedStream
+ * Description:		Ends a transfer's use of a stream, freeing the stream if the transfer was
+ * 			the last to use it and its producer has exited. If other transfers still use
+ * 			it, the producer carries on; otherwise it stops, and if pages are dropped
+ * 			behind, every page of the file is dropped, since each transfer has passed it.
+ * Receives: 		The stream, the transfer's cursor, and the transfer's descriptor of the file.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The caller joined the stream, added its cursor to the stream's cursors, and
+ * 			has no chunk of it pinned.
+ * Post-Conditions: 	The caller must not use the stream again.
+**********************************************************************************************/
+
+void leaveSharedStream(struct SharedStream* stream, struct SharedCursor* cursor, int fileFD)
+{
+	pthread_mutex_lock(&stream->lock);
+	for (struct SharedCursor** link = &stream->cursors; *link != NULL; link = &(*link)->next)
+	{
+		if (*link == cursor)
+		{
+			*link = cursor->next;
+			break;
+		}
+	}
+	stream->consumers--;
+	int lastConsumer = stream->consumers == 0;
+	int lastOut = lastConsumer && !stream->producing;
+	pthread_cond_broadcast(&stream->changed);
+	pthread_mutex_unlock(&stream->lock);
+	if (lastConsumer && stream->dropBehind)
+	{
+		posix_fadvise(fileFD, 0, 0, POSIX_FADV_DONTNEED);
+	}
+	if (lastOut)
+	{
+		freeSharedStream(stream);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	produceSharedStream
+ * Description:		Thread function of a stream's producer: reads the file into the ring one
+ * 			chunk at a time, applying read_policy, and drops pages every transfer has
+ * 			passed if the stream drops pages behind. Before reusing a slot of the ring,
+ * 			waits until no transfer is sending from it and the fastest transfer has asked
+ * 			for a chunk less than a ring behind the one to be read. Stops at the end of
+ * 			the file, when a read fails (leaving transfers to read that chunk
+ * 			themselves), or when no transfer uses the stream any more.
+ * Receives: 		A pointer to the struct SharedStream.
+ * Returns: 		NULL
+ * Pre-Conditions: 	Thread was started by joinSharedStream.
+ * Post-Conditions: 	The stream is no longer registered under its file, and has been freed if no
+ * 			transfer uses it.
+**********************************************************************************************/
+
+void* produceSharedStream(void* arg)
+{
+	struct SharedStream* stream = (struct SharedStream*)arg;
+	for (unsigned long long seq = 0; seq < stream->numChunks; seq++)
+	{
+		/* Wait until slot may be reused, stopping if no transfer uses the stream. */
+		struct SharedChunk* chunk = &stream->ring[seq % stream->depth];
+		pthread_mutex_lock(&stream->lock);
+		while (stream->consumers > 0 && (chunk->pins > 0 || seq >= stream->leader + stream->depth))
+		{
+			pthread_cond_wait(&stream->changed, &stream->lock);
+		}
+		if (stream->consumers == 0)
+		{
+			pthread_mutex_unlock(&stream->lock);
+			break;
+		}
+		chunk->seq = NO_SHARED_CHUNK;
+		pthread_mutex_unlock(&stream->lock);
+
+		/* Read chunk, timing the read, and drop pages every transfer has passed. */
+		unsigned long long offset = seq * stream->chunkSize;
+		unsigned long long remaining = stream->size - offset;
+		int chunkLen = (remaining < (unsigned long long)stream->chunkSize) ? (int)remaining : stream->chunkSize;
+		unsigned long long readStart = monotonicNs();
+		int charsRead = readSharedChunk(stream->fileFD, chunk->data, chunkLen, offset);
+		if (charsRead > 0)
+		{
+			advanceReadPolicy(&stream->readPolicy, charsRead, monotonicNs() - readStart);
+		}
+		dropSharedPages(stream);
+
+		/* Publish chunk (unless the read failed), stopping after a failed or short read. */
+		pthread_mutex_lock(&stream->lock);
+		if (charsRead >= 0)
+		{
+			chunk->len = charsRead;
+			chunk->seq = seq;
+			stream->produced = seq + 1;
+		}
+		pthread_cond_broadcast(&stream->changed);
+		pthread_mutex_unlock(&stream->lock);
+		if (charsRead < chunkLen)
+		{
+			break;
+		}
+	}
+
+	/* Stop stream so no transfer joins or waits for it, then remove it from its file's entry (and the
+	 * entry from the registry if no download uses it). */
+	pthread_mutex_lock(&registryLock);
+	pthread_mutex_lock(&stream->lock);
+	stream->stopped = 1;
+	pthread_cond_broadcast(&stream->changed);
+	pthread_mutex_unlock(&stream->lock);
+	stream->file->stream = NULL;
+	releaseSharedFile(stream->file);
+	pthread_mutex_unlock(&registryLock);
+
+	/* Free stream if no transfer uses it. */
+	pthread_mutex_lock(&stream->lock);
+	stream->producing = 0;
+	int lastOut = stream->consumers == 0;
+	pthread_mutex_unlock(&stream->lock);
+	if (lastOut)
+	{
+		freeSharedStream(stream);
+	}
+	return NULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendFileShared
+ * Description:		Sends a file to the client through a stream joined for it, one chunk per
+ * 			frame, in file order. Each chunk waits for rate limits before it is taken, so a
+ * 			rate-limited transfer never holds a chunk while it waits. While the transfer is
+ * 			less than half a ring behind the fastest one, each chunk is sent straight from
+ * 			the ring, pinned meanwhile (and copied into the socket rather than sent with
+ * 			MSG_ZEROCOPY, so that it is released as soon as the send returns). Otherwise,
+ * 			chunks are read with positioned reads into a buffer of the transfer's own, so
+ * 			a slow client holds the producer back for one chunk at most. The file is sent
+ * 			as it was when the stream started; if it shrinks, the transfer ends at its new
+ * 			end. Finally, leaves the stream and sends the success message (or an error
+ * 			message if a read failed).
+ * Receives: 		A struct FTInfo pointer, the open file, and the stream joined for it.
+ * Returns: 		nothing
+ * Pre-Conditions: 	The data connection has been validated.
+ * Post-Conditions: 	The file has been closed and the stream left, and either the file and the
+ * 			success message or an error message have been sent to the client (unless
+ * 			sending failed).
+**********************************************************************************************/
+
+void sendFileShared(struct FTInfo* myFT, int fileToSend, struct SharedStream* stream)
+{
+	struct ServerConfig* config = getServerConfig();
+
+	/* Take the first TCP sample of the transfer, cork data socket until file has been sent, and send
+	 * every chunk by copying it. */
+	startTcpSampling(&myFT->tcp, myFT->dataSocketFD, config->tcpSampleIntervalMs);
+	corkSocket(myFT->dataSocketFD, 1);
+	memset(&myFT->zeroCopy, 0, sizeof(myFT->zeroCopy));
+	myFT->zeroCopy.socketFD = myFT->dataSocketFD;
+
+	/* Add the transfer's cursor to the stream, so that pages are not dropped before it passes them. */
+	struct SharedCursor cursor = {0, NULL};
+	pthread_mutex_lock(&stream->lock);
+	cursor.next = stream->cursors;
+	stream->cursors = &cursor;
+	pthread_mutex_unlock(&stream->lock);
+
+	/* Send chunks in file order, stopping upon error or once the file turns out to have shrunk. */
+	unsigned long long startBytes = myFT->bytesSent;
+	char* privateData = NULL;
+	int readFailed = 0;
+	int sendFailed = 0;
+	for (unsigned long long seq = 0; seq < stream->numChunks; seq++)
+	{
+		/* Wait until sending the chunk is within rate limits. */
+		unsigned long long offset = seq * stream->chunkSize;
+		unsigned long long remaining = stream->size - offset;
+		int chunkLen = (remaining < (unsigned long long)stream->chunkSize) ? (int)remaining : stream->chunkSize;
+		shapeTransfer(myFT->shaper, chunkLen);
+
+		/* Ask for chunk, waiting until the producer has produced it (or stopped). */
+		struct SharedChunk* chunk = &stream->ring[seq % stream->depth];
+		pthread_mutex_lock(&stream->lock);
+		cursor.seq = seq;
+		if (stream->leader < seq + 1)
+		{
+			stream->leader = seq + 1;
+			pthread_cond_broadcast(&stream->changed);
+		}
+		while (seq >= stream->produced && !stream->stopped)
+		{
+			pthread_cond_wait(&stream->changed, &stream->lock);
+		}
+
+		/* Pin chunk if it is still in the ring and this transfer is less than half a ring behind the
+		 * fastest. */
+		int shared = chunk->seq == seq && seq + (stream->depth + 1) / 2 >= stream->leader;
+		chunk->pins += shared;
+		pthread_mutex_unlock(&stream->lock);
+
+		/* Otherwise, read it into the transfer's own buffer. */
+		char* data;
+		int dataLen;
+		if (shared)
+		{
+			data = chunk->data;
+			dataLen = chunk->len;
+			STAT_ADD(sharedChunks, 1);
+		}
+		else
+		{
+			if (privateData == NULL && (privateData = (char*)malloc(stream->chunkSize)) == NULL)
+			{
+				errno = ENOMEM;
+				readFailed = 1;
+				break;
+			}
+			data = privateData;
+			dataLen = readSharedChunk(fileToSend, privateData, chunkLen, offset);
+			if (dataLen < 0)
+			{
+				readFailed = 1;
+				break;
+			}
+			STAT_ADD(privateChunks, 1);
+		}
+
+		/* Send chunk, then unpin it. */
+		unsigned int ticket;
+		int result = (dataLen > 0) ? sendZeroCopyFrame(&myFT->zeroCopy, data, dataLen, &ticket) : 0;
+		if (shared)
+		{
+			pthread_mutex_lock(&stream->lock);
+			chunk->pins--;
+			pthread_cond_broadcast(&stream->changed);
+			pthread_mutex_unlock(&stream->lock);
+		}
+		if (result == -1)
+		{
+			sendFailed = 1;
+			break;
+		}
+
+		/* Count chunk sent, and log a periodic TCP sample of the transfer if one is due, resizing the
+		 * send buffer for the rate and round-trip time sampled. */
+		countDataSent(myFT, dataLen);
+		if (sampleTcpIfDue(&myFT->tcp, config->tcpSampleIntervalMs))
+		{
+			logTcpEvent(LOG_TCP_SAMPLE, myFT, &myFT->tcp.latest, 0);
+			resizeDataBuffer(myFT->dataSocketFD, myFT->tcp.latest.rttUs, myFT->tcp.latest.deliveryRate);
+		}
+		if (dataLen < chunkLen)
+		{
+			break;
+		}
+	}
+
+	/* Release resources. */
+	int transferErrno = errno;
+	leaveSharedStream(stream, &cursor, fileToSend);
+	free(privateData);
+	close(fileToSend);
+	errno = transferErrno;
+
+	/* If sending failed, summarize transfer as TCP saw it and return. */
+	if (sendFailed)
+	{
+		reportTcpTransfer(myFT);
+		return;
+	}
+
+	/* Otherwise, uncork data socket, summarize transfer, and send success or error message. */
+	corkSocket(myFT->dataSocketFD, 0);
+	reportTcpTransfer(myFT);
+	if (readFailed)
+	{
+		sendErrorMessage(myFT);
+		return;
+	}
+	sendSuccessMessage(myFT, myFT->bytesSent - startBytes);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	releaseSharedFile
+ * Description:		Removes a file's entry from the registry and frees it if no download or
+ * 			stream uses it.
+ * Receives: 		The entry.
+ * Returns: 		nothing
+ * Pre-Conditions: 	registryLock is held.
+ * Post-Conditions: 	The entry must not be used again unless a download or stream uses it.
+**********************************************************************************************/
+
+static void releaseSharedFile(struct SharedFile* file)
+{
+	if (file->transfers > 0 || file->stream != NULL)
+	{
+		return;
+	}
+	for (struct SharedFile** link = &files; *link != NULL; link = &(*link)->next)
+	{
+		if (*link == file)
+		{
+			*link = file->next;
+			break;
+		}
+	}
+	free(file);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	dropSharedPages
+ * Description:		If the stream drops pages behind, drops the pages every transfer of the
+ * 			stream has passed from the page cache once there are a ring's worth of them.
+ * Receives: 		The stream.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Called by the stream's producer.
+ * Post-Conditions: 	Pages up to stream->droppedEnd have been dropped.
+**********************************************************************************************/
+
+static void dropSharedPages(struct SharedStream* stream)
+{
+	if (!stream->dropBehind)
+	{
+		return;
+	}
+
+	/* Find the chunk the slowest transfer is sending. Every page before it has been passed. */
+	pthread_mutex_lock(&stream->lock);
+	unsigned long long trailing = stream->leader;
+	for (struct SharedCursor* cursor = stream->cursors; cursor != NULL; cursor = cursor->next)
+	{
+		trailing = (cursor->seq < trailing) ? cursor->seq : trailing;
+	}
+	unsigned long long start = stream->droppedEnd;
+	unsigned long long end = trailing * stream->chunkSize;
+	end = (end > stream->size) ? stream->size : end;
+	int drop = end > start && end - start >= (unsigned long long)stream->chunkSize * stream->depth;
+	if (drop)
+	{
+		stream->droppedEnd = end;
+	}
+	pthread_mutex_unlock(&stream->lock);
+
+	if (drop)
+	{
+		posix_fadvise(stream->fileFD, (off_t)start, (off_t)(end - start), POSIX_FADV_DONTNEED);
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	freeSharedStream
+ * Description:		Frees a stream and closes its producer's descriptor.
+ * Receives: 		The stream.
+ * Returns: 		nothing
+ * Pre-Conditions: 	No transfer uses the stream, and its producer has exited (or never started).
+ * Post-Conditions: 	The stream has been freed.
+**********************************************************************************************/
+
+static void freeSharedStream(struct SharedStream* stream)
+{
+	close(stream->fileFD);
+	free(stream->ring[0].data);
+	pthread_mutex_destroy(&stream->lock);
+	pthread_cond_destroy(&stream->changed);
+	free(stream);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	readSharedChunk
+ * Description:		Reads a chunk of a file with positioned reads, retrying after signals and
+ * 			short reads until the chunk is full or the end of the file is reached.
+ * Receives: 		The file, the buffer, the length of the chunk, and its offset.
+ * Returns: 		The number of bytes read (less than len only if the file has shrunk), or -1
+ * 			on error (with errno set).
+ * Pre-Conditions: 	data holds at least len bytes.
+ * Post-Conditions: 	data holds the bytes read.
+**********************************************************************************************/
+
+static int readSharedChunk(int fileFD, char* data, int len, unsigned long long offset)
+{
+	int charsRead = 0;
+	while (charsRead < len)
+	{
+		ssize_t result = pread(fileFD, data + charsRead, len - charsRead, (off_t)(offset + charsRead));
+		if (result > 0)
+		{
+			charsRead += result;
+		}
+		else if (result == 0)
+		{
+			break;
+		}
+		else if (errno != EINTR)
+		{
+			return -1;
+		}
+	}
+	return charsRead;
+}
@@ -0,0 +1,122 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		sharedStream.h
+ * File Description: 	Header file for request coalescing. Downloads of files of at least
+ * 			coalesce_min_size bytes are counted per file (by device, inode, size and
+ * 			modification time) from the time they are classified. A download that is the
+ * 			only one of its file is sent on its own (so direct I/O, drop-behind and
+ * 			zero-copy sends all apply). Once a second download of the file is in progress,
+ * 			further downloads share a stream: the first starts a producer thread that reads
+ * 			the file once into a ring of coalesce_ring chunks of pipeline_buffer bytes,
+ * 			and the rest join it instead of reading the file themselves. Each transfer
+ * 			sends the chunks at its own pace; the producer stays at most one ring ahead
+ * 			of the fastest, so a transfer that falls more than half a ring behind it (or
+ * 			joins late) reads the chunks it missed itself, with positioned reads. Pages
+ * 			every transfer of a stream has passed are dropped from the page cache as
+ * 			drop_behind_min_size directs. Streams are per process, so shards do not
+ * 			share them.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SHARED_STREAM
+#define SHARED_STREAM
+
+#include <pthread.h>
+#include <sys/stat.h>
+#include "FTInfo.h"
+#include "readPolicy.h"
+
+/* Global constant representing the most chunks in a stream's ring. */
+#define MAX_COALESCE_RING 256
+
+/* Definition of struct describing one chunk of a stream's ring. */
+struct SharedChunk
+{
+	char* data;			/* Contents. */
+	int len;			/* Number of bytes of data in use. */
+	unsigned long long seq;		/* Index of the chunk of the file held (NO_SHARED_CHUNK if none). */
+	int pins;			/* Number of transfers sending from data. */
+};
+
+/* Value of seq of a chunk holding no part of the file. */
+#define NO_SHARED_CHUNK (~0ULL)
+
+/* Definition of struct tracking how far one transfer through a stream has got. */
+struct SharedCursor
+{
+	unsigned long long seq;		/* Chunk the transfer is sending (every chunk before it has been sent). */
+	struct SharedCursor* next;	/* Next cursor of the stream. */
+};
+
+/* Definition of struct counting the downloads of one file in progress. Entries are kept in a registry
+ * protected by a lock of sharedStream.c, which also protects every member. */
+struct SharedFile
+{
+	dev_t device;			/* Identity of the file: device, inode, size and modification time. */
+	ino_t inode;
+	unsigned long long size;
+	struct timespec modified;
+	int transfers;			/* Downloads of the file classified and not yet finished. */
+	struct SharedStream* stream;	/* Stream whose producer is producing the file, or NULL. */
+	struct SharedFile* next;	/* Next entry in the registry. */
+};
+
+/* Definition of struct holding the state of one shared stream. See below for variable descriptions.
+ * Chunk seq of the file is held in ring[seq % depth]. */
+struct SharedStream
+{
+	pthread_mutex_t lock;		/* Protects the fields below that change. */
+	pthread_cond_t changed;		/* Signaled when a chunk is produced or unpinned, or a transfer moves. */
+	struct SharedFile* file;	/* Registry entry of the file (used by the producer only). */
+	unsigned long long size;	/* Size of the file when the stream started. */
+	int fileFD;			/* Descriptor of the file read by the producer. */
+	struct ReadPolicy readPolicy;	/* read_policy applied by the producer. */
+	int dropBehind;			/* True if pages every transfer has passed are dropped. */
+	unsigned long long droppedEnd;	/* Offset up to which pages have been dropped. */
+	struct SharedChunk ring[MAX_COALESCE_RING];	/* Chunks read by the producer. */
+	int depth;			/* Number of chunks in ring. */
+	int chunkSize;			/* Size of each chunk. */
+	unsigned long long numChunks;	/* Number of chunks in the file. */
+	unsigned long long produced;	/* Number of chunks produced so far. */
+	unsigned long long leader;	/* Highest number of chunks any transfer has asked for. */
+	struct SharedCursor* cursors;	/* Cursor of each transfer using the stream, as a linked list. */
+	int consumers;			/* Number of transfers using the stream. */
+	int producing;			/* True while the producer thread runs. */
+	int stopped;			/* True once the producer will produce no more chunks. */
+	pthread_t producer;		/* The producer thread. */
+};
+
+/* Function prototypes. */
+int enterSharedFile(struct FTInfo* myFT, struct stat* fileInfo);
+void leaveSharedFile(struct FTInfo* myFT);
+struct SharedStream* joinSharedStream(struct FTInfo* myFT, int fileFD);
+void leaveSharedStream(struct SharedStream* stream, struct SharedCursor* cursor, int fileFD);
+void* produceSharedStream(void* arg);
+void sendFileShared(struct FTInfo* myFT, int fileToSend, struct SharedStream* stream);
+
+#endif
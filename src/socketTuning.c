@@ -0,0 +1,241 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		socketTuning.c
+ * File Description: 	Implementation of functions for socket tuning. See socketTuning.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include "socketTuning.h"
+
+/* Global constant representing the file holding the system's default congestion control algorithm. */
+#define DEFAULT_CONGESTION_FILE "/proc/sys/net/ipv4/tcp_congestion_control"
+
+/* Global variable definitions. */
+struct SocketTuning socketTuning =	/* Socket options in effect, initialized to defaults. */
+{
+	.noDelay = 1,
+	.frameMore = 1,
+	.cork = 1,
+	.notsentLowat = 0,
+	.bdpBuffers = 0,
+	.congestionSet = 0
+};
+
+
+/***********************************************************************************************
+ * Function Name:	setSocketTuning
+ * Description:		Puts new socket options into effect for connections accepted and data
+ * 			connections made from now on. The congestion control algorithm is set on
+ * 			the listening socket, from which accepted control sockets inherit it, and
+ * 			copied from the control socket to each data socket; an empty name
+ * 			restores the system default.
+ * Receives: 		The options to use (congestionSet is ignored), the name of the congestion
+ * 			control algorithm (or an empty string), and the listening socket.
+ * Returns: 		0 on success; -1 if the algorithm is not available (an error is printed,
+ * 			and the algorithm in effect is kept).
+ * Pre-Conditions: 	listeningSocketFD is a TCP socket.
+ * Post-Conditions: 	socketTuning holds the options in effect.
+**********************************************************************************************/
+
+int setSocketTuning(struct SocketTuning* tuning, char* congestion, int listeningSocketFD)
+{
+	int congestionSet = socketTuning.congestionSet;
+	int result = 0;
+
+	/* Set algorithm named, or restore the system default if one was set before. */
+	char defaultName[CONGESTION_NAME_LEN] = "";
+	if (congestion[0] == '\0' && congestionSet)
+	{
+		FILE* defaultFile = fopen(DEFAULT_CONGESTION_FILE, "r");
+		if (defaultFile != NULL)
+		{
+			if (fscanf(defaultFile, "%15s", defaultName) != 1)
+			{
+				defaultName[0] = '\0';
+			}
+			fclose(defaultFile);
+		}
+		congestion = defaultName;
+		congestionSet = 0;
+	}
+	if (congestion[0] != '\0')
+	{
+		if (setsockopt(listeningSocketFD, IPPROTO_TCP, TCP_CONGESTION, congestion, strlen(congestion)) == -1)
+		{
+			fprintf(stderr, "SOCKET TUNING ERROR: could not use congestion control \"%s\": %s\n",
+				congestion, strerror(errno));
+			result = -1;
+		}
+		else if (congestion != defaultName)
+		{
+			congestionSet = 1;
+		}
+	}
+
+	socketTuning = *tuning;
+	socketTuning.congestionSet = congestionSet;
+	return result;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tuneControlSocket
+ * Description:		Sets the options in effect for control sockets on a newly-accepted one.
+ * Receives: 		The control socket.
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected TCP socket.
+ * Post-Conditions: 	The options have been set.
+**********************************************************************************************/
+
+void tuneControlSocket(int socketFD)
+{
+	if (socketTuning.noDelay)
+	{
+		int on = 1;
+		setsockopt(socketFD, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tuneDataSocket
+ * Description:		Sets the options in effect for data sockets on a newly-connected one.
+ * 			If send buffers are sized from the bandwidth-delay product, the initial
+ * 			size uses the round-trip time measured on the control connection and
+ * 			BDP_INITIAL_RATE, and is raised by resizeDataBuffer as the transfer's
+ * 			own rate and round-trip time are sampled.
+ * Receives: 		The data socket and the control socket of the same session.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Both sockets are connected TCP sockets.
+ * Post-Conditions: 	The options have been set.
+**********************************************************************************************/
+
+void tuneDataSocket(int dataSocketFD, int controlSocketFD)
+{
+	struct SocketTuning tuning = socketTuning;
+	int on = 1;
+	if (tuning.noDelay)
+	{
+		setsockopt(dataSocketFD, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	}
+	if (tuning.notsentLowat > 0)
+	{
+		unsigned int lowat = (unsigned int)tuning.notsentLowat;
+		setsockopt(dataSocketFD, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowat, sizeof(lowat));
+	}
+
+	/* Copy congestion control algorithm from control socket. */
+	if (tuning.congestionSet)
+	{
+		char congestion[CONGESTION_NAME_LEN];
+		socklen_t congestionLen = sizeof(congestion);
+		if (getsockopt(controlSocketFD, IPPROTO_TCP, TCP_CONGESTION, congestion, &congestionLen) == 0)
+		{
+			setsockopt(dataSocketFD, IPPROTO_TCP, TCP_CONGESTION, congestion, strnlen(congestion, congestionLen));
+		}
+	}
+
+	/* Size send buffer from control connection's round-trip time. */
+	if (tuning.bdpBuffers)
+	{
+		struct tcp_info info;
+		socklen_t infoLen = sizeof(info);
+		if (getsockopt(controlSocketFD, IPPROTO_TCP, TCP_INFO, &info, &infoLen) == 0)
+		{
+			resizeDataBuffer(dataSocketFD, info.tcpi_rtt, BDP_INITIAL_RATE);
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	corkSocket
+ * Description:		Corks a data socket before a burst of frames (so the kernel sends only
+ * 			full segments) or uncorks it afterward (sending whatever is left), if
+ * 			corking is on.
+ * Receives: 		The data socket and 1 to cork it or 0 to uncork it.
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected TCP socket.
+ * Post-Conditions: 	The socket has been corked or uncorked.
+**********************************************************************************************/
+
+void corkSocket(int socketFD, int corked)
+{
+	if (socketTuning.cork)
+	{
+		setsockopt(socketFD, IPPROTO_TCP, TCP_CORK, &corked, sizeof(corked));
+	}
+}
+
+
+/***********************************************************************************************
+ * Function Name:	resizeDataBuffer
+ * Description:		If send buffers are sized from the bandwidth-delay product, raises a
+ * 			data socket's send buffer to BDP_BUFFER_MULTIPLE times the product of the
+ * 			round-trip time and rate given (within BDP_BUFFER_MIN and BDP_BUFFER_MAX).
+ * 			The buffer is never shrunk, so data already queued is not affected. Sizes
+ * 			above the system's net.core.wmem_max take effect only if the server may
+ * 			use SO_SNDBUFFORCE.
+ * Receives: 		The data socket, its round-trip time in microseconds, and its rate in
+ * 			bytes per second.
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected TCP socket.
+ * Post-Conditions: 	The send buffer is at least the size computed (if permitted).
+**********************************************************************************************/
+
+void resizeDataBuffer(int socketFD, uint32_t rttUs, uint64_t deliveryRate)
+{
+	if (!socketTuning.bdpBuffers)
+	{
+		return;
+	}
+
+	/* Compute buffer size. */
+	uint64_t size = deliveryRate * rttUs / 1000000 * BDP_BUFFER_MULTIPLE;
+	size = (size < BDP_BUFFER_MIN) ? BDP_BUFFER_MIN : (size > BDP_BUFFER_MAX) ? BDP_BUFFER_MAX : size;
+
+	/* Raise buffer if it is smaller. The kernel reports double the size set, to allow for overhead. */
+	int current = 0;
+	socklen_t currentLen = sizeof(current);
+	getsockopt(socketFD, SOL_SOCKET, SO_SNDBUF, &current, &currentLen);
+	if ((uint64_t)current >= size * 2)
+	{
+		return;
+	}
+	int newSize = (int)size;
+	if (setsockopt(socketFD, SOL_SOCKET, SO_SNDBUFFORCE, &newSize, sizeof(newSize)) == -1)
+	{
+		setsockopt(socketFD, SOL_SOCKET, SO_SNDBUF, &newSize, sizeof(newSize));
+	}
+}
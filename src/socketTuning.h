@@ -0,0 +1,81 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		socketTuning.h
+ * File Description: 	Header file for socket tuning. Each option can be switched on or off in
+ * 			the configuration file so its effect can be benchmarked:
+ * 			- TCP_NODELAY on control and data sockets, so short messages are sent
+ * 			  without waiting for earlier ones to be acknowledged.
+ * 			- MSG_MORE on the length prefix of each framed message, so the prefix
+ * 			  and message leave in the same segment.
+ * 			- TCP_CORK on data sockets while a file or listing is sent, so frames
+ * 			  are packed into full segments.
+ * 			- TCP_NOTSENT_LOWAT on data sockets, bounding data queued in the kernel
+ * 			  but not yet sent.
+ * 			- A congestion control algorithm for all connections.
+ * 			- Send buffers of data sockets sized from the bandwidth-delay product
+ * 			  measured on the connection instead of by kernel autotuning.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef SOCKET_TUNING
+#define SOCKET_TUNING
+
+#include <stdint.h>
+
+/* Global constants representing max length of a congestion control algorithm's name, smallest and
+ * largest send buffer chosen from the bandwidth-delay product, the multiple of the product
+ * allotted (leaving room for the rate to grow between samples), and the rate (bytes/s) assumed
+ * before any has been measured on a connection. */
+#define CONGESTION_NAME_LEN 16
+#define BDP_BUFFER_MIN 65536
+#define BDP_BUFFER_MAX 33554432
+#define BDP_BUFFER_MULTIPLE 2
+#define BDP_INITIAL_RATE 12500000
+
+/* Definition of struct holding the socket options in effect. See file description. */
+struct SocketTuning
+{
+	int noDelay;			/* Set TCP_NODELAY on control and data sockets. */
+	int frameMore;			/* Send length prefixes with MSG_MORE. */
+	int cork;			/* Cork data sockets while sending a file or listing. */
+	unsigned long long notsentLowat;	/* TCP_NOTSENT_LOWAT of data sockets (0 = kernel default). */
+	int bdpBuffers;			/* Size data sockets' send buffers from bandwidth-delay product. */
+	int congestionSet;		/* True if a congestion control algorithm was set on listening socket. */
+};
+
+/* Global variable declarations. */
+extern struct SocketTuning socketTuning;
+
+/* Function prototypes. */
+int setSocketTuning(struct SocketTuning* tuning, char* congestion, int listeningSocketFD);
+void tuneControlSocket(int socketFD);
+void tuneDataSocket(int dataSocketFD, int controlSocketFD);
+void corkSocket(int socketFD, int corked);
+void resizeDataBuffer(int socketFD, uint32_t rttUs, uint64_t deliveryRate);
+
+#endif
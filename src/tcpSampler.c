@@ -0,0 +1,314 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		tcpSampler.c
+ * File Description: 	Implementation of functions for TCP sampling of transfers. See tcpSampler.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include "latencyHistogram.h"
+#include "serverStats.h"
+#include "tcpSampler.h"
+
+/* Function prototypes for functions used only in this file. */
+static int readTcpSample(struct TcpTransfer* transfer, struct TcpSample* sample, unsigned long long now);
+static int classifyTransfer(struct TcpTransfer* transfer, unsigned long long bytesWritten, struct TcpSample* summary);
+
+
+/***********************************************************************************************
+ * Function Name:	readTcpSample
+ * Description:		Reads the data socket's TCP_INFO into a sample, and counts its round-trip
+ * 			time in the server's RTT histogram.
+ * Receives: 		The transfer, the sample to fill in, and the current monotonic time.
+ * Returns: 		0 on success; -1 if TCP_INFO could not be read.
+ * Pre-Conditions: 	transfer->socketFD is a connected TCP socket and transfer->startNs is set.
+ * Post-Conditions: 	The sample holds the socket's current state, and transfer->hasLimits
+ * 			is cleared if the kernel is too old to report busy and limited times.
+**********************************************************************************************/
+
+static int readTcpSample(struct TcpTransfer* transfer, struct TcpSample* sample, unsigned long long now)
+{
+	struct tcp_info info;
+	socklen_t infoLen = sizeof(info);
+	memset(&info, 0, sizeof(info));
+	if (getsockopt(transfer->socketFD, IPPROTO_TCP, TCP_INFO, &info, &infoLen) == -1)
+	{
+		return -1;
+	}
+	if (infoLen < offsetof(struct tcp_info, tcpi_sndbuf_limited) + sizeof(info.tcpi_sndbuf_limited))
+	{
+		transfer->hasLimits = 0;
+	}
+
+	sample->elapsedUs = (now - transfer->startNs) / 1000;
+	sample->deliveryRate = info.tcpi_delivery_rate;
+	sample->busyUs = info.tcpi_busy_time;
+	sample->rwndLimitedUs = info.tcpi_rwnd_limited;
+	sample->sndbufLimitedUs = info.tcpi_sndbuf_limited;
+	sample->bytesSent = info.tcpi_bytes_sent;
+	sample->bytesRetrans = info.tcpi_bytes_retrans;
+	sample->rttUs = info.tcpi_rtt;
+	sample->rttVarUs = info.tcpi_rttvar;
+	sample->minRttUs = info.tcpi_min_rtt;
+	sample->maxRttUs = info.tcpi_rtt;
+	sample->cwnd = info.tcpi_snd_cwnd;
+	sample->mss = info.tcpi_snd_mss;
+	sample->segsOut = info.tcpi_segs_out;
+	sample->retransSegs = info.tcpi_total_retrans;
+	STAT_ADD(rttCounts[latencyBucket((unsigned long long)info.tcpi_rtt * 1000)], 1);
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startTcpSampling
+ * Description:		Takes the first sample of a transfer and schedules the next one.
+ * Receives: 		The transfer's sampling state, its data socket, and the interval between
+ * 			periodic samples in milliseconds (0 for none).
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected TCP socket.
+ * Post-Conditions: 	Sampling is on for the transfer, unless TCP_INFO could not be read.
+**********************************************************************************************/
+
+void startTcpSampling(struct TcpTransfer* transfer, int socketFD, unsigned long long intervalMs)
+{
+	memset(transfer, 0, sizeof(*transfer));
+	transfer->socketFD = socketFD;
+	transfer->hasLimits = 1;
+	transfer->startNs = monotonicNs();
+	if (readTcpSample(transfer, &transfer->start, transfer->startNs) == -1)
+	{
+		transfer->socketFD = -1;
+		return;
+	}
+	transfer->latest = transfer->start;
+	transfer->nextSampleNs = (intervalMs > 0) ? transfer->startNs + intervalMs * 1000000ULL : ~0ULL;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sampleTcpIfDue
+ * Description:		Takes a periodic sample of a transfer if one is due. Cheap enough to call
+ * 			after every send, since it only reads the clock when none is due.
+ * Receives: 		The transfer's sampling state and the interval between samples in ms.
+ * Returns: 		1 if a sample was taken (it is in transfer->latest); 0 otherwise.
+ * Pre-Conditions: 	startTcpSampling has been called for the transfer.
+ * Post-Conditions: 	If a sample was taken, the next is scheduled intervalMs later.
+**********************************************************************************************/
+
+int sampleTcpIfDue(struct TcpTransfer* transfer, unsigned long long intervalMs)
+{
+	if (transfer->socketFD < 0)
+	{
+		return 0;
+	}
+	unsigned long long now = monotonicNs();
+	if (now < transfer->nextSampleNs)
+	{
+		return 0;
+	}
+
+	/* Take sample, keeping largest round-trip time seen. */
+	uint32_t maxRttUs = transfer->latest.maxRttUs;
+	if (readTcpSample(transfer, &transfer->latest, now) == -1)
+	{
+		return 0;
+	}
+	if (maxRttUs > transfer->latest.maxRttUs)
+	{
+		transfer->latest.maxRttUs = maxRttUs;
+	}
+	transfer->nextSampleNs = (intervalMs > 0) ? now + intervalMs * 1000000ULL : ~0ULL;
+	return 1;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	finishTcpSampling
+ * Description:		Takes the last sample of a transfer, summarizes the transfer, classifies
+ * 			its bottleneck, and counts both in the server's statistics.
+ * Receives: 		The transfer's sampling state, the bytes the server wrote to the socket during
+ * 			the transfer, and the summary to fill in.
+ * Returns: 		The transfer's bottleneck (an enum TcpBottleneck).
+ * Pre-Conditions: 	startTcpSampling has been called for the transfer, and all of its data
+ * 			has been sent.
+ * Post-Conditions: 	summary holds the transfer's summary (all zero if sampling was off),
+ * 			and sampling is off.
+**********************************************************************************************/
+
+int finishTcpSampling(struct TcpTransfer* transfer, unsigned long long bytesWritten, struct TcpSample* summary)
+{
+	memset(summary, 0, sizeof(*summary));
+	if (transfer->socketFD < 0)
+	{
+		STAT_ADD(transfersByBottleneck[TCP_BOTTLENECK_UNKNOWN], 1);
+		return TCP_BOTTLENECK_UNKNOWN;
+	}
+
+	/* Take last sample, then replace counters with their change since the first. */
+	transfer->nextSampleNs = 0;
+	if (sampleTcpIfDue(transfer, 0) == 0)
+	{
+		transfer->latest.elapsedUs = (monotonicNs() - transfer->startNs) / 1000;
+	}
+	*summary = transfer->latest;
+	summary->busyUs -= transfer->start.busyUs;
+	summary->rwndLimitedUs -= transfer->start.rwndLimitedUs;
+	summary->sndbufLimitedUs -= transfer->start.sndbufLimitedUs;
+	summary->bytesSent -= transfer->start.bytesSent;
+	summary->bytesRetrans -= transfer->start.bytesRetrans;
+	summary->segsOut -= transfer->start.segsOut;
+	summary->retransSegs -= transfer->start.retransSegs;
+	transfer->socketFD = -1;
+
+	/* Classify and count transfer. */
+	int bottleneck = classifyTransfer(transfer, bytesWritten, summary);
+	STAT_ADD(transfersByBottleneck[bottleneck], 1);
+	STAT_ADD(tcpRetransSegs, summary->retransSegs);
+	STAT_ADD(tcpElapsedUs, summary->elapsedUs);
+	STAT_ADD(tcpBusyUs, summary->busyUs);
+	STAT_ADD(tcpRwndLimitedUs, summary->rwndLimitedUs);
+	STAT_ADD(tcpSndbufLimitedUs, summary->sndbufLimitedUs);
+	return bottleneck;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	classifyTransfer
+ * Description:		Names a transfer's bottleneck. The time the socket had nothing to send
+ * 			(elapsed time not busy) is time spent waiting on the server; if that, the
+ * 			time limited by the receiver's window, or the time limited by the send
+ * 			buffer is at least TCP_BOTTLENECK_PERCENT of the transfer, the largest
+ * 			is the bottleneck. Otherwise the congestion window was the limit, and the
+ * 			bottleneck is loss if at least TCP_LOSS_PERCENT of segments were
+ * 			retransmitted, or the network's bandwidth if not.
+ * Receives: 		The transfer's sampling state, the bytes the server wrote, and its summary.
+ * Returns: 		An enum TcpBottleneck.
+ * Pre-Conditions: 	summary holds the transfer's change in counters.
+ * Post-Conditions: 	none
+**********************************************************************************************/
+
+static int classifyTransfer(struct TcpTransfer* transfer, unsigned long long bytesWritten, struct TcpSample* summary)
+{
+	if (!transfer->hasLimits)
+	{
+		return TCP_BOTTLENECK_UNKNOWN;
+	}
+	if (bytesWritten < TCP_SHORT_TRANSFER_BYTES || summary->elapsedUs < TCP_SHORT_TRANSFER_MS * 1000ULL)
+	{
+		return TCP_BOTTLENECK_SHORT;
+	}
+
+	/* Find largest of idle, receiver-limited, and send-buffer-limited times. */
+	uint64_t idleUs = (summary->elapsedUs > summary->busyUs) ? summary->elapsedUs - summary->busyUs : 0;
+	int bottleneck = TCP_BOTTLENECK_SERVER;
+	uint64_t largestUs = idleUs;
+	if (summary->rwndLimitedUs > largestUs)
+	{
+		bottleneck = TCP_BOTTLENECK_RECEIVER;
+		largestUs = summary->rwndLimitedUs;
+	}
+	if (summary->sndbufLimitedUs > largestUs)
+	{
+		bottleneck = TCP_BOTTLENECK_SEND_BUFFER;
+		largestUs = summary->sndbufLimitedUs;
+	}
+	if (largestUs * 100 >= summary->elapsedUs * TCP_BOTTLENECK_PERCENT)
+	{
+		return bottleneck;
+	}
+
+	/* Otherwise congestion window was the limit. */
+	if ((uint64_t)summary->retransSegs * 100 >= (uint64_t)summary->segsOut * TCP_LOSS_PERCENT && summary->retransSegs > 0)
+	{
+		return TCP_BOTTLENECK_LOSS;
+	}
+	return TCP_BOTTLENECK_NETWORK;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tcpBottleneckName
+ * Description:		Returns the name of a bottleneck.
+ * Receives: 		An enum TcpBottleneck.
+ * Returns: 		The bottleneck's name.
+**********************************************************************************************/
+
+const char* tcpBottleneckName(int bottleneck)
+{
+	static const char* bottleneckNames[] = TCP_BOTTLENECK_NAMES;
+	return bottleneckNames[bottleneck];
+}
+
+
+/***********************************************************************************************
+ * Function Name:	printTcpStats
+ * Description:		Prints how many transfers had each bottleneck, where the sampled
+ * 			transfers' time went, and percentiles of the round-trip times sampled.
+ * 			Prints nothing if no transfer has been sampled.
+ * Receives: 		The stream to print to and the server's counters.
+ * Returns: 		nothing
+ * Pre-Conditions: 	none
+ * Post-Conditions: 	TCP statistics have been printed to out.
+**********************************************************************************************/
+
+void printTcpStats(FILE* out, struct ServerStats* stats)
+{
+	unsigned long long transfers = 0;
+	for (int i = 0; i < NUM_TCP_BOTTLENECKS; i++)
+	{
+		transfers += __atomic_load_n(&stats->transfersByBottleneck[i], __ATOMIC_RELAXED);
+	}
+	if (transfers == 0)
+	{
+		return;
+	}
+
+	fprintf(out, "Transfer bottlenecks:");
+	for (int i = 0; i < NUM_TCP_BOTTLENECKS; i++)
+	{
+		fprintf(out, " %s %llu", tcpBottleneckName(i), __atomic_load_n(&stats->transfersByBottleneck[i], __ATOMIC_RELAXED));
+	}
+	fprintf(out, "\n");
+
+	unsigned long long elapsedUs = __atomic_load_n(&stats->tcpElapsedUs, __ATOMIC_RELAXED);
+	unsigned long long busyUs = __atomic_load_n(&stats->tcpBusyUs, __ATOMIC_RELAXED);
+	fprintf(out, "Transfer time (ms): %llu total, %llu idle waiting on server, %llu receiver window limited, "
+		"%llu send buffer limited; %llu segments retransmitted\n", elapsedUs / 1000,
+		(elapsedUs > busyUs) ? (elapsedUs - busyUs) / 1000 : 0,
+		__atomic_load_n(&stats->tcpRwndLimitedUs, __ATOMIC_RELAXED) / 1000,
+		__atomic_load_n(&stats->tcpSndbufLimitedUs, __ATOMIC_RELAXED) / 1000,
+		__atomic_load_n(&stats->tcpRetransSegs, __ATOMIC_RELAXED));
+	fprintf(out, "RTT (us) of transfers: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+		latencyPercentile(stats->rttCounts, 50) / 1000.0, latencyPercentile(stats->rttCounts, 90) / 1000.0,
+		latencyPercentile(stats->rttCounts, 99) / 1000.0, latencyPercentile(stats->rttCounts, 100) / 1000.0);
+}
@@ -0,0 +1,114 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		tcpSampler.h
+ * File Description: 	Header file for TCP sampling of transfers. While a file is sent, the
+ * 			kernel's TCP_INFO for the data socket is sampled when the transfer starts,
+ * 			every tcp_sample_interval_ms, and when it ends. The samples show the path
+ * 			as TCP sees it (round-trip time, congestion window, delivery rate,
+ * 			retransmissions) and how long the connection spent limited by the
+ * 			receiver's window, by the send buffer, or waiting on the server for data,
+ * 			from which each transfer's bottleneck is classified.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef TCP_SAMPLER
+#define TCP_SAMPLER
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Global constants representing the fewest bytes and milliseconds a transfer must take to be
+ * classified (shorter transfers end before TCP's behavior says anything about the path, and the
+ * kernel measures busy and limited times only to the clock tick), and the share of a transfer
+ * (in percent) a limit must account for to be named its bottleneck, or that retransmitted
+ * segments must reach to blame loss. */
+#define TCP_SHORT_TRANSFER_BYTES 262144
+#define TCP_SHORT_TRANSFER_MS 100
+#define TCP_BOTTLENECK_PERCENT 50
+#define TCP_LOSS_PERCENT 1
+
+/* Bottlenecks a transfer may be classified as having. */
+enum TcpBottleneck
+{
+	TCP_BOTTLENECK_SHORT,		/* Too short to classify. */
+	TCP_BOTTLENECK_SERVER,		/* Socket mostly idle waiting on server (disk, CPU, or rate limits). */
+	TCP_BOTTLENECK_RECEIVER,	/* Mostly limited by the receiver's advertised window. */
+	TCP_BOTTLENECK_SEND_BUFFER,	/* Mostly limited by the size of the send buffer. */
+	TCP_BOTTLENECK_LOSS,		/* Limited by the congestion window, with heavy retransmission. */
+	TCP_BOTTLENECK_NETWORK,		/* Limited by the congestion window (the path's bandwidth). */
+	TCP_BOTTLENECK_UNKNOWN,		/* Kernel did not report the statistics needed. */
+	NUM_TCP_BOTTLENECKS
+};
+
+/* Names of bottlenecks as printed, indexed by enum TcpBottleneck. */
+#define TCP_BOTTLENECK_NAMES { "short", "server", "receiver", "send_buffer", "loss", "network", "unknown" }
+
+/* Definition of struct holding one sample of a data socket's TCP_INFO. In the summary of a
+ * transfer, counters (times, bytes, and segments) hold the change over the transfer, and the
+ * round-trip times and congestion window hold the latest values. */
+struct TcpSample
+{
+	uint64_t elapsedUs;		/* Time since transfer started. */
+	uint64_t deliveryRate;		/* Recent rate at which data was delivered (bytes/s). */
+	uint64_t busyUs;		/* Time with data outstanding or waiting to be sent. */
+	uint64_t rwndLimitedUs;		/* Time limited by receiver's window. */
+	uint64_t sndbufLimitedUs;	/* Time limited by send buffer. */
+	uint64_t bytesSent;		/* Bytes sent, including retransmissions. */
+	uint64_t bytesRetrans;		/* Bytes retransmitted. */
+	uint32_t rttUs;			/* Smoothed round-trip time. */
+	uint32_t rttVarUs;		/* Round-trip time variation. */
+	uint32_t minRttUs;		/* Minimum round-trip time seen on connection. */
+	uint32_t maxRttUs;		/* Largest smoothed round-trip time sampled during transfer. */
+	uint32_t cwnd;			/* Congestion window (segments). */
+	uint32_t mss;			/* Maximum segment size (bytes). */
+	uint32_t segsOut;		/* Segments sent, including retransmissions. */
+	uint32_t retransSegs;		/* Segments retransmitted. */
+};
+
+/* Definition of struct holding the sampling state of one transfer. */
+struct TcpTransfer
+{
+	int socketFD;			/* Data socket sampled, or -1 if sampling is off. */
+	int hasLimits;			/* True if kernel reports busy and limited times. */
+	unsigned long long startNs;	/* Monotonic time at which transfer started. */
+	unsigned long long nextSampleNs;	/* Monotonic time at which next periodic sample is due. */
+	struct TcpSample start;		/* Sample taken when transfer started. */
+	struct TcpSample latest;	/* Latest sample. */
+};
+
+/* Forward declaration of struct holding server counters (see serverStats.h). */
+struct ServerStats;
+
+/* Function prototypes. */
+void startTcpSampling(struct TcpTransfer* transfer, int socketFD, unsigned long long intervalMs);
+int sampleTcpIfDue(struct TcpTransfer* transfer, unsigned long long intervalMs);
+int finishTcpSampling(struct TcpTransfer* transfer, unsigned long long bytesWritten, struct TcpSample* summary);
+const char* tcpBottleneckName(int bottleneck);
+void printTcpStats(FILE* out, struct ServerStats* stats);
+
+#endif
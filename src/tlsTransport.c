@@ -0,0 +1,362 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		tlsTransport.c
+ * File Description: 	Implementation of functions for TLS on control and data connections. See
+ * 			tlsTransport.h. Without FT_TLS (make TLS=1), every socket is plaintext and
+ * 			tlsSend and tlsRecv are plain send and recv.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include "clientServerMessaging.h"
+#include "serverConfig.h"
+#include "serverStats.h"
+#include "tlsTransport.h"
+#ifdef FT_TLS
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+/* Definition of struct describing the TLS session of a socket. See below for variable descriptions. */
+struct TlsSocket
+{
+	SSL* ssl;		/* Session, or NULL if the socket has none. */
+	int kernelSend;		/* True if the kernel encrypts what is sent (kTLS). */
+	int kernelRecv;		/* True if the kernel decrypts what is received (kTLS). */
+};
+
+/* Global variables holding the context from which sessions are made (NULL if TLS is off) and the
+ * session of each socket, by file descriptor. Each entry is only touched by the thread owning the
+ * socket. */
+static SSL_CTX* tlsContext = NULL;
+static struct TlsSocket tlsSockets[MAX_TLS_SOCKETS];
+
+
+/***********************************************************************************************
+ * Function Name:	userspaceTlsSocket
+ * Description:		Looks up the session of a socket for a direction OpenSSL handles.
+ * Receives: 		A socket file descriptor and true for sending or false for receiving.
+ * Returns: 		The socket's struct TlsSocket if it has a session and the kernel does not
+ * 			handle that direction; NULL otherwise.
+**********************************************************************************************/
+
+static struct TlsSocket* userspaceTlsSocket(int socketFD, int sending)
+{
+	if (socketFD < 0 || socketFD >= MAX_TLS_SOCKETS || tlsSockets[socketFD].ssl == NULL)
+	{
+		return NULL;
+	}
+	struct TlsSocket* tlsSocket = &tlsSockets[socketFD];
+	return (sending ? tlsSocket->kernelSend : tlsSocket->kernelRecv) ? NULL : tlsSocket;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tlsFailure
+ * Description:		Translates a failed OpenSSL call into the errno a failed send or recv
+ * 			would have set, printing OpenSSL's reason for protocol errors.
+ * Receives: 		The session and the value the call returned.
+ * Returns: 		0 if the client closed the session (when receiving); -1 otherwise.
+**********************************************************************************************/
+
+static ssize_t tlsFailure(SSL* ssl, int result)
+{
+	int savedErrno = errno;
+	switch (SSL_get_error(ssl, result))
+	{
+		case SSL_ERROR_ZERO_RETURN:
+			return 0;
+		case SSL_ERROR_WANT_READ:
+		case SSL_ERROR_WANT_WRITE:
+			errno = EAGAIN;
+			break;
+		case SSL_ERROR_SYSCALL:
+			errno = (savedErrno != 0) ? savedErrno : ECONNRESET;
+			break;
+		default:
+			fprintf(stderr, "TLS ERROR: %s\n", ERR_reason_error_string(ERR_peek_last_error()));
+			errno = EPROTO;
+	}
+	ERR_clear_error();
+	return -1;
+}
+#endif
+
+
+/***********************************************************************************************
+ * Function Name:	initTls
+ * Description:		If tls_cert is set, loads the server's certificate and key and prepares
+ * 			the context every session is made from, asking OpenSSL to hand record
+ * 			encryption to the kernel if tls_ktls is set. Sessions need TLS 1.2 or
+ * 			later.
+ * Receives: 		nothing
+ * Returns: 		nothing
+ * Pre-Conditions: 	The configuration has been loaded. Called once, before any connection is
+ * 			handled.
+ * Post-Conditions: 	Unless an error occurs (in which case the process exits), tlsEnabled is
+ * 			true if and only if tls_cert is set.
+**********************************************************************************************/
+
+void initTls()
+{
+	struct ServerConfig* config = getServerConfig();
+
+	if (config->tlsCert[0] == '\0')
+	{
+		return;
+	}
+#ifndef FT_TLS
+	fprintf(stderr, "TLS ERROR: tls_cert is set, but ftserver was built without TLS support (make TLS=1)\n");
+	exit(2);
+#else
+	/* The key may be kept in the certificate's file. */
+	char* keyFile = (config->tlsKey[0] != '\0') ? config->tlsKey : config->tlsCert;
+	tlsContext = SSL_CTX_new(TLS_server_method());
+	if (tlsContext == NULL
+		|| SSL_CTX_set_min_proto_version(tlsContext, TLS1_2_VERSION) != 1
+		|| SSL_CTX_use_certificate_chain_file(tlsContext, config->tlsCert) != 1
+		|| SSL_CTX_use_PrivateKey_file(tlsContext, keyFile, SSL_FILETYPE_PEM) != 1
+		|| SSL_CTX_check_private_key(tlsContext) != 1)
+	{
+		fprintf(stderr, "TLS ERROR: could not load certificate %s and key %s\n", config->tlsCert, keyFile);
+		ERR_print_errors_fp(stderr);
+		exit(2);
+	}
+
+	/* Treat a client closing its connection without a close_notify alert as an ordinary close, since
+	 * every message is framed with its length and truncation is detected anyway. */
+	SSL_CTX_set_options(tlsContext, SSL_OP_IGNORE_UNEXPECTED_EOF);
+	if (config->tlsKtls)
+	{
+		SSL_CTX_set_options(tlsContext, SSL_OP_ENABLE_KTLS);
+	}
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tlsEnabled
+ * Description:		Reports whether connections are encrypted.
+ * Receives: 		nothing
+ * Returns: 		True if initTls prepared TLS; false otherwise.
+**********************************************************************************************/
+
+int tlsEnabled()
+{
+#ifdef FT_TLS
+	return tlsContext != NULL;
+#else
+	return 0;
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	startTls
+ * Description:		Performs the server side of a TLS handshake on a connected socket and
+ * 			records the session for tlsSend and tlsRecv, noting which directions the
+ * 			kernel took over. Does nothing if TLS is off.
+ * Receives: 		The socket and the longest time (in milliseconds) to wait for the client
+ * 			at any step of the handshake (0 for no limit).
+ * Returns: 		0 on success (or if TLS is off); -1 on failure (errno is ETIMEDOUT if the
+ * 			client did not answer in time).
+ * Pre-Conditions: 	Nothing has been sent or received on socketFD, and it has no receive
+ * 			timeout set.
+ * Post-Conditions: 	If 0 is returned and TLS is on, everything sent and received on socketFD
+ * 			through tlsSend and tlsRecv is encrypted until endTls is called.
+**********************************************************************************************/
+
+int startTls(int socketFD, int timeoutMs)
+{
+#ifdef FT_TLS
+	if (tlsContext == NULL)
+	{
+		return 0;
+	}
+	if (socketFD >= MAX_TLS_SOCKETS)
+	{
+		fprintf(stderr, "TLS ERROR: socket %d is beyond the %d sockets that may use TLS\n", socketFD, MAX_TLS_SOCKETS);
+		STAT_ADD(tlsHandshakeFailures, 1);
+		errno = EMFILE;
+		return -1;
+	}
+
+	/* Perform handshake, limiting how long each receive may wait for the client. */
+	SSL* ssl = SSL_new(tlsContext);
+	if (ssl == NULL || SSL_set_fd(ssl, socketFD) != 1)
+	{
+		fprintf(stderr, "TLS ERROR: could not create session\n");
+		SSL_free(ssl);
+		STAT_ADD(tlsHandshakeFailures, 1);
+		errno = ENOMEM;
+		return -1;
+	}
+	setRecvTimeout(socketFD, timeoutMs);
+	errno = 0;
+	int result = SSL_accept(ssl);
+	if (result != 1)
+	{
+		tlsFailure(ssl, result);
+		int handshakeErrno = (errno == EAGAIN) ? ETIMEDOUT : errno;
+		fprintf(stderr, "TLS HANDSHAKE ERROR: %s\n", strerror(handshakeErrno));
+		SSL_free(ssl);
+		STAT_ADD(tlsHandshakeFailures, 1);
+		errno = handshakeErrno;
+		return -1;
+	}
+	setRecvTimeout(socketFD, 0);
+
+	/* Record session and the directions the kernel took over. */
+	struct TlsSocket* tlsSocket = &tlsSockets[socketFD];
+	tlsSocket->ssl = ssl;
+	tlsSocket->kernelSend = BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0;
+	tlsSocket->kernelRecv = BIO_get_ktls_recv(SSL_get_rbio(ssl)) > 0;
+	STAT_ADD(tlsHandshakes, 1);
+	if (tlsSocket->kernelSend)
+	{
+		STAT_ADD(tlsKernelSends, 1);
+	}
+#endif
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	endTls
+ * Description:		Sends the close_notify alert on a socket's session, if it has one, and
+ * 			frees the session.
+ * Receives: 		A socket file descriptor.
+ * Returns: 		nothing
+ * Pre-Conditions: 	Called just before socketFD is closed.
+ * Post-Conditions: 	socketFD has no session.
+**********************************************************************************************/
+
+void endTls(int socketFD)
+{
+#ifdef FT_TLS
+	if (socketFD < 0 || socketFD >= MAX_TLS_SOCKETS || tlsSockets[socketFD].ssl == NULL)
+	{
+		return;
+	}
+	SSL_shutdown(tlsSockets[socketFD].ssl);
+	SSL_free(tlsSockets[socketFD].ssl);
+	memset(&tlsSockets[socketFD], 0, sizeof(struct TlsSocket));
+	ERR_clear_error();
+#endif
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tlsSend
+ * Description:		Sends on a socket as send does, encrypting with OpenSSL if the socket has
+ * 			a session whose sends the kernel does not encrypt (flags are then ignored).
+ * 			Sockets without a session, or with kTLS, are sent on directly.
+ * Receives: 		Same as send.
+ * Returns: 		The number of bytes sent, or -1 on error (with errno set).
+**********************************************************************************************/
+
+ssize_t tlsSend(int socketFD, const void* buffer, size_t length, int flags)
+{
+#ifdef FT_TLS
+	struct TlsSocket* tlsSocket = userspaceTlsSocket(socketFD, 1);
+	if (tlsSocket != NULL)
+	{
+		size_t written = 0;
+		int result = SSL_write_ex(tlsSocket->ssl, buffer, length, &written);
+		if (result == 1)
+		{
+			return written;
+		}
+		if (tlsFailure(tlsSocket->ssl, result) == 0)
+		{
+			errno = EPIPE;
+		}
+		return -1;
+	}
+#endif
+	return send(socketFD, buffer, length, flags);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tlsRecv
+ * Description:		Receives on a socket as recv does, decrypting with OpenSSL if the socket
+ * 			has a session whose receives the kernel does not decrypt. Of the flags, only
+ * 			MSG_WAITALL is then honored.
+ * Receives: 		Same as recv.
+ * Returns: 		The number of bytes received, 0 if the client closed the connection, or -1
+ * 			on error (with errno set, EAGAIN if a receive timeout expired).
+**********************************************************************************************/
+
+ssize_t tlsRecv(int socketFD, void* buffer, size_t length, int flags)
+{
+#ifdef FT_TLS
+	struct TlsSocket* tlsSocket = userspaceTlsSocket(socketFD, 0);
+	if (tlsSocket != NULL)
+	{
+		/* OpenSSL returns at most one record per call, so keep reading to fill buffer for MSG_WAITALL. */
+		size_t received = 0;
+		do
+		{
+			size_t charsRead = 0;
+			errno = 0;
+			int result = SSL_read_ex(tlsSocket->ssl, (char*)buffer + received, length - received, &charsRead);
+			if (result != 1)
+			{
+				ssize_t failure = tlsFailure(tlsSocket->ssl, result);
+				return (received > 0) ? (ssize_t)received : failure;
+			}
+			received += charsRead;
+		} while ((flags & MSG_WAITALL) && received < length);
+		return received;
+	}
+#endif
+	return recv(socketFD, buffer, length, flags);
+}
+
+
+/***********************************************************************************************
+ * Function Name:	tlsPending
+ * Description:		Reports whether a socket's session holds received data already decrypted,
+ * 			which poll cannot see.
+ * Receives: 		A socket file descriptor.
+ * Returns: 		True if tlsRecv can return data without reading from the socket.
+**********************************************************************************************/
+
+int tlsPending(int socketFD)
+{
+#ifdef FT_TLS
+	struct TlsSocket* tlsSocket = userspaceTlsSocket(socketFD, 0);
+	return tlsSocket != NULL && SSL_pending(tlsSocket->ssl) > 0;
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,59 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		tlsTransport.h
+ * File Description: 	Header file for TLS on control and data connections. When the server is
+ * 			built with TLS support (make TLS=1) and tls_cert and tls_key are set, the
+ * 			server performs a TLS handshake (with OpenSSL) as the server side of every
+ * 			TCP control and data connection before any message is exchanged. If
+ * 			tls_ktls is set, record encryption is then handed to the kernel (kTLS), so
+ * 			the socket is written with plain send calls and no data passes through
+ * 			OpenSSL; directions the kernel cannot take over are encrypted by OpenSSL.
+ * 			Every send and recv on a connection goes through tlsSend and tlsRecv,
+ * 			which look up the socket's session by file descriptor.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef TLS_TRANSPORT
+#define TLS_TRANSPORT
+
+#include <sys/types.h>
+
+/* Global constant representing the number of file descriptors that may carry TLS sessions. Sockets
+ * with larger descriptors are refused TLS. */
+#define MAX_TLS_SOCKETS 65536
+
+/* Function prototypes. */
+void initTls();
+int tlsEnabled();
+int startTls(int socketFD, int timeoutMs);
+void endTls(int socketFD);
+ssize_t tlsSend(int socketFD, const void* buffer, size_t length, int flags);
+ssize_t tlsRecv(int socketFD, void* buffer, size_t length, int flags);
+int tlsPending(int socketFD);
+
+#endif
@@ -0,0 +1,312 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		zeroCopySend.c
+ * File Description: 	Implementation of functions for sending frames with MSG_ZEROCOPY. See
+ * 			zeroCopySend.h.
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#include <time.h>
+#include <linux/errqueue.h>
+#include "clientServerMessaging.h"
+#include "latencyHistogram.h"
+#include "serverConfig.h"
+#include "zeroCopySend.h"
+
+/* Global constant representing how often (in nanoseconds) abortZeroCopy checks for completions. */
+#define ABORT_POLL_NS 1000000
+
+
+/***********************************************************************************************
+ * Function Name:	startZeroCopy
+ * Description:		Prepares to track the zero-copy sends of a socket, enabling MSG_ZEROCOPY on
+ * 			it unless zerocopy_min_size is 0, the socket is encrypted with TLS (whose
+ * 			sends cannot be zero-copy), or the socket does not support it.
+ * Receives: 		The struct to initialize and the socket.
+ * Returns: 		nothing
+ * Pre-Conditions: 	socketFD is a connected TCP socket.
+ * Post-Conditions: 	zeroCopy is ready for sendZeroCopyFrame.
+**********************************************************************************************/
+
+void startZeroCopy(struct ZeroCopySocket* zeroCopy, int socketFD)
+{
+	memset(zeroCopy, 0, sizeof(struct ZeroCopySocket));
+	zeroCopy->socketFD = socketFD;
+	int enable = 1;
+	zeroCopy->enabled = getServerConfig()->zerocopyMinSize > 0 && !tlsEnabled()
+		&& setsockopt(socketFD, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	sendZeroCopyFrame
+ * Description:		Sends a frame as sendFrame does, but sends a payload of at least
+ * 			zerocopy_min_size bytes with MSG_ZEROCOPY, unless the socket has gone back
+ * 			to ordinary sends. If the kernel runs out of memory for tracking sends
+ * 			(ENOBUFS), the rest of the payload is copied instead.
+ * Receives: 		The socket's struct ZeroCopySocket, the payload, its length, and a pointer
+ * 			to the ID to pass to awaitZeroCopy before changing the payload.
+ * Returns: 		0 on success; -1 on failure (as sendCompleteBuffer reports).
+ * Pre-Conditions: 	startZeroCopy has been called for the socket.
+ * Post-Conditions: 	If 0 is returned, the whole frame has been sent, and *sendEnd is set.
+ * 			Otherwise, zeroCopy->failed is set.
+**********************************************************************************************/
+
+int sendZeroCopyFrame(struct ZeroCopySocket* zeroCopy, char* data, int dataLen, unsigned int* sendEnd)
+{
+	/* Frame small payloads as usual, leaving nothing to await. */
+	*sendEnd = zeroCopy->sent;
+	if (!zeroCopy->enabled || __atomic_load_n(&zeroCopy->copying, __ATOMIC_RELAXED)
+		|| (unsigned long long)dataLen < getServerConfig()->zerocopyMinSize)
+	{
+		if (sendFrame(zeroCopy->socketFD, data, dataLen) == -1)
+		{
+			__atomic_store_n(&zeroCopy->failed, 1, __ATOMIC_RELAXED);
+			return -1;
+		}
+		return 0;
+	}
+
+	/* Send length prefix (copied, since it is tiny) as sendFrame does. */
+	char messageLenStr[50];
+	sprintf(messageLenStr, "%d@", dataLen);
+	if (sendCompleteString(zeroCopy->socketFD, messageLenStr, socketTuning.frameMore ? MSG_MORE : 0) == -1)
+	{
+		__atomic_store_n(&zeroCopy->failed, 1, __ATOMIC_RELAXED);
+		return -1;
+	}
+
+	/* Send payload. Every send that succeeds takes the next send ID. */
+	int charsRemaining = dataLen;
+	char* posInMessage = data;
+	while (charsRemaining > 0)
+	{
+		int charsSent = send(zeroCopy->socketFD, posInMessage, charsRemaining, MSG_ZEROCOPY);
+		if (charsSent < 0 && errno == ENOBUFS)
+		{
+			if (sendCompleteBuffer(zeroCopy->socketFD, posInMessage, charsRemaining, 0) == -1)
+			{
+				__atomic_store_n(&zeroCopy->failed, 1, __ATOMIC_RELAXED);
+				return -1;
+			}
+			break;
+		}
+		if (charsSent < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				STAT_ADD(sendStallTimeouts, 1);
+				errno = ETIMEDOUT;
+			}
+			STAT_ERRNO(errno);
+			perror("SEND ERROR");
+			fprintf(stderr, "Disconnecting from client.\n");
+			__atomic_store_n(&zeroCopy->failed, 1, __ATOMIC_RELAXED);
+			return -1;
+		}
+		zeroCopy->sent++;
+		charsRemaining -= charsSent;
+		posInMessage += charsSent;
+	}
+
+	/* Count send, and return ID every send of the payload is below. */
+	STAT_ADD(zeroCopySends, 1);
+	STAT_ADD(zeroCopyBytes, dataLen);
+	*sendEnd = zeroCopy->sent;
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	awaitZeroCopy
+ * Description:		Waits until every zero-copy send with an ID below sendEnd is complete, so
+ * 			that the buffers they were sent from may be reused. The socket's error queue
+ * 			is read whenever poll reports it is not empty.
+ * Receives: 		The socket's struct ZeroCopySocket, the ID returned by sendZeroCopyFrame,
+ * 			and the longest time to wait (in milliseconds; 0 for no limit).
+ * Returns: 		0 once the sends are complete; -1 on timeout (errno ETIMEDOUT) or if the
+ * 			connection failed first.
+ * Pre-Conditions: 	Only one thread awaits completions on the socket.
+ * Post-Conditions: 	If 0 is returned, the buffers of those sends belong to the caller again.
+**********************************************************************************************/
+
+int awaitZeroCopy(struct ZeroCopySocket* zeroCopy, unsigned int sendEnd, int timeoutMs)
+{
+	struct timespec deadline;
+	setDeadline(&deadline, timeoutMs);
+	while ((int)(sendEnd - zeroCopy->completed) > 0)
+	{
+		/* Read any completions queued, then wait for more (poll always reports POLLERR once the
+		 * error queue is not empty). */
+		int reaped = reapZeroCopy(zeroCopy);
+		if (reaped == -1)
+		{
+			return -1;
+		}
+		if (reaped > 0)
+		{
+			continue;
+		}
+		if (timeoutMs > 0 && waitForSocket(zeroCopy->socketFD, 0, &deadline) != 1)
+		{
+			return -1;
+		}
+		struct pollfd pollInfo = {zeroCopy->socketFD, 0, 0};
+		while (timeoutMs <= 0 && poll(&pollInfo, 1, -1) == -1)
+		{
+			if (errno != EINTR)
+			{
+				perror("POLL ERROR");
+				return -1;
+			}
+		}
+
+		/* If poll woke for something other than a completion, the connection has failed (or hung up). */
+		if (reapZeroCopy(zeroCopy) == 0)
+		{
+			int socketError = 0;
+			socklen_t errorLen = sizeof(socketError);
+			getsockopt(zeroCopy->socketFD, SOL_SOCKET, SO_ERROR, &socketError, &errorLen);
+			errno = (socketError != 0) ? socketError : EPIPE;
+			STAT_ERRNO(errno);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	abortZeroCopy
+ * Description:		Drops the zero-copy sends of a failed transfer: unless every send with an
+ * 			ID below sendEnd is complete already, resets the connection (connecting a
+ * 			TCP socket to AF_UNSPEC purges its send queue but keeps the descriptor open),
+ * 			then waits until the kernel reports those sends complete. poll cannot wait
+ * 			for completions on a reset socket (it always reports a hang-up), so the error
+ * 			queue is checked every ABORT_POLL_NS instead.
+ * Receives: 		The socket's struct ZeroCopySocket, the ID returned by sendZeroCopyFrame,
+ * 			and the longest time to wait (in milliseconds; 0 for no limit).
+ * Returns: 		0 once the sends are complete; -1 on timeout (errno ETIMEDOUT).
+ * Pre-Conditions: 	Only one thread awaits completions on the socket, and the transfer has
+ * 			failed (the client will receive nothing more on the connection).
+ * Post-Conditions: 	zeroCopy->failed is set. If 0 is returned, the buffers of those sends belong
+ * 			to the caller again.
+**********************************************************************************************/
+
+int abortZeroCopy(struct ZeroCopySocket* zeroCopy, unsigned int sendEnd, int timeoutMs)
+{
+	/* Reset connection unless there is nothing left to drop, clearing the error the reset leaves. */
+	__atomic_store_n(&zeroCopy->failed, 1, __ATOMIC_RELAXED);
+	reapZeroCopy(zeroCopy);
+	if ((int)(sendEnd - zeroCopy->completed) <= 0)
+	{
+		return 0;
+	}
+	struct sockaddr unspecified;
+	memset(&unspecified, 0, sizeof(unspecified));
+	unspecified.sa_family = AF_UNSPEC;
+	connect(zeroCopy->socketFD, &unspecified, sizeof(unspecified));
+	int socketError = 0;
+	socklen_t errorLen = sizeof(socketError);
+	getsockopt(zeroCopy->socketFD, SOL_SOCKET, SO_ERROR, &socketError, &errorLen);
+
+	/* Wait for the sends dropped to complete. */
+	unsigned long long deadline = monotonicNs() + (unsigned long long)timeoutMs * 1000000ULL;
+	struct timespec pause = {0, ABORT_POLL_NS};
+	while ((int)(sendEnd - zeroCopy->completed) > 0)
+	{
+		if (reapZeroCopy(zeroCopy) > 0)
+		{
+			continue;
+		}
+		if (timeoutMs > 0 && monotonicNs() >= deadline)
+		{
+			errno = ETIMEDOUT;
+			return -1;
+		}
+		nanosleep(&pause, NULL);
+	}
+	return 0;
+}
+
+
+/***********************************************************************************************
+ * Function Name:	reapZeroCopy
+ * Description:		Reads every completion queued on a socket's error queue without waiting.
+ * 			Each completion reports a range of send IDs that are complete; since TCP
+ * 			completes sends in order, the end of the latest range marks every earlier
+ * 			send complete too. If a completion reports that the kernel copied the data
+ * 			after all, the socket goes back to ordinary sends.
+ * Receives: 		The socket's struct ZeroCopySocket.
+ * Returns: 		The number of completions read, or -1 on error.
+ * Pre-Conditions: 	Only one thread awaits completions on the socket.
+ * Post-Conditions: 	zeroCopy->completed reflects every completion read.
+**********************************************************************************************/
+
+int reapZeroCopy(struct ZeroCopySocket* zeroCopy)
+{
+	int reaped = 0;
+	while (1)
+	{
+		/* Read next message from error queue, stopping once it is empty. */
+		char control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+		struct msghdr message;
+		memset(&message, 0, sizeof(message));
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		if (recvmsg(zeroCopy->socketFD, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+		{
+			return (errno == EAGAIN || errno == EWOULDBLOCK) ? reaped : -1;
+		}
+
+		/* Record each zero-copy completion it carries. */
+		for (struct cmsghdr* header = CMSG_FIRSTHDR(&message); header != NULL; header = CMSG_NXTHDR(&message, header))
+		{
+			if (!((header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR)
+				|| (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR)))
+			{
+				continue;
+			}
+			struct sock_extended_err* completion = (struct sock_extended_err*)CMSG_DATA(header);
+			if (completion->ee_origin != SO_EE_ORIGIN_ZEROCOPY || completion->ee_errno != 0)
+			{
+				continue;
+			}
+			if ((int)(completion->ee_data + 1 - zeroCopy->completed) > 0)
+			{
+				zeroCopy->completed = completion->ee_data + 1;
+			}
+			if (completion->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+			{
+				__atomic_store_n(&zeroCopy->copying, 1, __ATOMIC_RELAXED);
+				STAT_ADD(zeroCopyCopied, completion->ee_data - completion->ee_info + 1);
+			}
+			reaped++;
+		}
+	}
+}
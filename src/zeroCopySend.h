@@ -0,0 +1,67 @@
+/******************************************************************************************************
+ * Programmer Name: 	Alexander Densmore
+ * Program Name: 	ftserver
+ * Program Description:	Implementation of the server side of a client-server file transfer protocol. 
+ * 			Client receives SERVER_PORT from the command line. Once SERVER_PORT is verified
+ * 			to be a non-negative integer, server attempts to establish listening socket on
+ * 			SERVER_PORT. Upon success, server enters endless loop of listening for and then
+ * 			accepting incoming connections until a SIGINT is received.
+ * 			
+ * 			Upon accepting an incoming connection (which becomes the control connection
+ * 			for the file transfer), the server receives the desired data port at the client
+ * 			to which to send responses to valid commands. The server then receives and interprets
+ * 			the command from the client. If the command is valid, the server connects a new socket
+ * 			to the client at clienthost:dataport. The server sends the desired data through the
+ * 			data port and then sends a confirmation message that the transfer is complete
+ * 			through the control port. The server then closes the data port. 
+ * 			If the command from the client is invalid, the server sends an error message through
+ * 			the control port and does not initiate a data connection. 
+ * 			Then, the server leaves the client responsible for closing the control port connection and 
+ * 			awaits a new incoming client connection.
+ * *** EXTRA CREDIT ***	In addition to the required commands of -l (list all files in current directory)
+ *			and -g (get file with filename), I have implemented an option -ltxt (list all files
+ *			in current directory with .txt extension). Upon receiving -ltxt command,
+ *			server filters current directory listing for only files with .txt extension,
+ *			either sending list of such files to client or reporting that there
+ *			are no files with .txt extension in the current directory.
+ * File Name:		zeroCopySend.h
+ * File Description: 	Header file for sending frames with MSG_ZEROCOPY. A payload of at least
+ * 			zerocopy_min_size bytes is sent without being copied into the socket
+ * 			buffer: the kernel sends straight from the caller's pages and later
+ * 			reports, on the socket's error queue, which sends it has finished with. The
+ * 			caller must not change or free a buffer until awaitZeroCopy says the send
+ * 			holding it is complete. Smaller payloads (and the length prefix of every
+ * 			frame) are copied as usual. If the kernel reports that it had to copy a
+ * 			payload anyway (as it does over loopback), or the socket is encrypted with
+ * 			TLS, the socket goes back to ordinary sends. Once a transfer has failed,
+ * 			abortZeroCopy resets the connection so that the kernel drops the sends
+ * 			still queued instead of sending them from buffers the caller is about to
+ * 			free (a plain close() would leave them queued).
+ * Course Name: 	CS 372-400: Introduction to Computer Networks
+ * Last Modified:	10/18/2026
+*****************************************************************************************************/
+
+#ifndef ZERO_COPY_SEND
+#define ZERO_COPY_SEND
+
+/* Definition of struct tracking the zero-copy sends of one socket. See below for variable descriptions.
+ * sent is only changed by the thread sending, and completed and copying only by the thread awaiting
+ * completions; failed is set by either. Send IDs are compared modulo 2^32, as the kernel numbers them. */
+struct ZeroCopySocket
+{
+	int socketFD;			/* Socket sent on. */
+	int enabled;			/* True while payloads are sent with MSG_ZEROCOPY. */
+	int copying;			/* True once the kernel has reported copying a payload. */
+	unsigned int sent;		/* Number of zero-copy sends made (ID of the next one). */
+	unsigned int completed;		/* Every send with an ID below this one is complete. */
+	int failed;			/* True once a send has failed or the sends have been aborted. */
+};
+
+/* Function prototypes. */
+void startZeroCopy(struct ZeroCopySocket* zeroCopy, int socketFD);
+int sendZeroCopyFrame(struct ZeroCopySocket* zeroCopy, char* data, int dataLen, unsigned int* sendEnd);
+int awaitZeroCopy(struct ZeroCopySocket* zeroCopy, unsigned int sendEnd, int timeoutMs);
+int abortZeroCopy(struct ZeroCopySocket* zeroCopy, unsigned int sendEnd, int timeoutMs);
+int reapZeroCopy(struct ZeroCopySocket* zeroCopy);
+
+#endif